@@ -10,13 +10,25 @@
 #include "simploce/util/file.hpp"
 #include <boost/program_options.hpp>
 #include <cstdlib>
+#include <cmath>
+#include <csignal>
+#include <vector>
 #include <string>
 #include <iostream>
+#include <fstream>
 
 namespace po = boost::program_options;
 using namespace simploce;
 using namespace simploce::param;
 
+/*
+ * Requests a checkpoint, after which the simulation stops.
+ */
+static void onSignal(int)
+{
+  Checkpoint<Bead>::request();
+}
+
 /*
  * Coarse grained molecular dynamics.
  */
@@ -30,11 +42,15 @@ int main(int argc, char* argv[])
     std::string fnTrajectory{"trajectory.dat"};
     std::string fnSimulationData{"sim-data.dat"};
     std::string fnInputModel{};
+    std::string fnExchange{"exchange.dat"};
+    std::string fnProtonationEvents{};
+    std::string fnCheckpoint{};
 
     std::size_t nsteps = 1000;
     std::size_t nwrite = 10;
     real_t timestep{0.020};                          // 0.001 ps = 1 fs. Default is 20 fs.
     real_t boxSize{6.0};                             // nm.
+    real_t cutoff{0.0};                              // nm. Half the box size if 0.
     real_t molarity{0.1};                            // mol/l
     real_t density{997.0479};                        // kg/m^3
     real_t temperature{298.15};                      // K.
@@ -42,7 +58,34 @@ int main(int argc, char* argv[])
     std::size_t nmaxPolWaters = 1000000;             // Maximum number of polarizable waters
                                                      // (groups).
     std::string modelType{conf::POLARIZABLE_WATER};  // Coarse grained polarizable water.
+    std::string constraints{conf::NO_CONSTRAINTS};   // Bond constraints.
+    std::size_t ninner = 4;                          // Number of inner steps (r-RESPA).
+    real_t dxmax{0.03};                              // nm. Adaptive time step.
+    real_t etol{0.01};                               // kJ/mol. Adaptive time step.
+    bool minimize = false;                           // Energy minimization before dynamics.
+    std::string minimizer{conf::FIRE};               // Energy minimizer.
+    std::size_t nminsteps = 1000;                    // Maximum number of minimization steps.
+    real_t fmax{10.0};                               // kJ/(mol nm). Minimization convergence.
+    std::size_t nreplicas = 1;                       // Number of replicas.
+    real_t maxTemperature{350.0};                    // K. Highest replica temperature.
+    std::size_t nexchange = 100;                     // Number of steps between exchanges.
+    std::size_t npt = 1;                             // Number of steps between proton transfers.
+    std::string ptMethod = conf::PT_CONSTANT_RATE;   // Proton transfer method.
+    std::size_t ncheckpoint = 0;                     // Number of steps between checkpoints.
+    bool restart = false;                            // Continue from checkpoint.
+    std::string trajectoryFormat =
+      conf::TEXT_TRAJECTORY;                         // Trajectory format.
+    bool doublePrecision = false;                    // Binary trajectory in double precision.
+    real_t trajPrecision{0.001};                     // nm. Compressed trajectory.
+    std::size_t ntrajbuffers =
+      conf::NUMBER_OF_FRAME_BUFFERS;                 // Number of trajectory frame buffers.
     bool mc = false;
+    bool checkerboard = false;
+    bool hmc = false;
+    std::size_t nmd = 10;                            // Number of MD steps per HMC trajectory.
+    std::string mcMoves{conf::MC_TRANSLATE};         // Monte Carlo move types.
+    std::size_t ntune = 0;                           // Number of steps adjusting MC step sizes.
+    real_t acceptance{50.0};                         // %. Target MC acceptance ratio.
     bool protonatable = true;
     std::string displacerId =
       conf::LANGEVIN_VELOCITY_VERLET;                // Displacer.
@@ -68,6 +111,28 @@ int main(int argc, char* argv[])
        "fn-trajectory",  po::value<std::string>(&fnTrajectory),
        "Output file name trajectory. Default is 'trajectory.dat'."
        )
+      (
+       "trajectory-format", po::value<std::string>(&trajectoryFormat),
+       "Trajectory format. Choices are 'text', 'binary', and 'compressed'. A binary "
+       "trajectory holds fixed width frames and an index of frames, and is much faster to "
+       "read. A compressed trajectory holds positions of limited precision and no "
+       "velocities, and is much smaller. Default is 'text'."
+      )
+      (
+       "trajectory-precision", po::value<real_t>(&trajPrecision),
+       "Compressed trajectory only. Precision of positions (nm). Default is 0.001 nm."
+      )
+      (
+       "number-of-trajectory-buffers", po::value<std::size_t>(&ntrajbuffers),
+       "Number of frame buffers. Trajectory frames are copied into a free buffer and "
+       "written by a separate thread, while the simulation proceeds. Use 0 to write "
+       "frames directly. Default is 4."
+      )
+      (
+       "double-precision",
+       "Binary trajectory only. Write real values in double precision instead of single "
+       "precision."
+      )
       (
        "fn-output-model",  po::value<std::string>(&fnOutputModel),
        "Output file name model. Default is 'out.model'."
@@ -81,6 +146,12 @@ int main(int argc, char* argv[])
        "box-size", po::value<real_t>(&boxSize),
        "Box (cube, unit cell) size (nm). Default is 6.0 nm."
        )
+      (
+       "cutoff-distance", po::value<real_t>(&cutoff),
+       "Cutoff distance (nm) of non-bonded interactions, and of pair lists and Monte Carlo "
+       "neighbor cells. Lennard-Jones interactions are truncated, Coulomb interactions are "
+       "shifted to zero. Must not exceed half the box size. Default is half the box size."
+      )
       (
        "molarity", po::value<real_t>(&molarity),
        "Molarity of NaCl electrolyte (mol/l). Default is 0.1 M."
@@ -122,9 +193,12 @@ int main(int argc, char* argv[])
       )
       (
        "displacer", po::value<std::string>(&displacerId),
-       "Displacer specification. Default is 'lvv' (Langevin Velocity Verlet). Other choices are"
-       "'lf' (leapFrog), 'vv' (Velocity Verlet), and "
-       "'pt-lvv' (Langevin Velocity Verlet with Proton Transfer)"
+       "Displacer specification. Default is 'lvv' (Langevin Velocity Verlet). Other choices are "
+       "'lf' (leapFrog), 'vv' (Velocity Verlet), "
+       "'pt-lvv' (Langevin Velocity Verlet with Proton Transfer), 'baoab' (BAOAB Langevin), "
+       "and 'respa' (multiple time step Velocity Verlet). Prefix 'vv', 'lvv', 'pt-lvv', or 'baoab' "
+       "with 'adaptive-' (e.g. 'adaptive-lvv') to adapt the time step during the simulation, "
+       "starting from the given time step."
       )
       (
        "max-number-of-water-groups", po::value<std::size_t>(&nmaxPolWaters),
@@ -134,6 +208,135 @@ int main(int argc, char* argv[])
        "monte-carlo",
        "Perform a Monte Carlo simulation."
       )
+      (
+       "hybrid-monte-carlo",
+       "Perform a hybrid Monte Carlo simulation. Each step is a short velocity Verlet "
+       "trajectory from fresh Maxwell-Boltzmann velocities, accepted or rejected on "
+       "the change in total energy."
+      )
+      (
+       "number-of-md-steps", po::value<std::size_t>(&nmd),
+       "Hybrid Monte Carlo only. Number of velocity Verlet steps per trajectory. "
+       "Default is 10."
+      )
+      (
+       "checkerboard",
+       "Monte Carlo only. Perform sweeps of trial moves, concurrently in non-adjacent cells "
+       "of a checkerboard. The number of steps is then the number of sweeps. Requires a "
+       "cutoff distance well below half the box size."
+      )
+      (
+       "mc-moves", po::value<std::string>(&mcMoves),
+       "Monte Carlo only. Comma-separated trial move types. Choices are 'translate' "
+       "(one particle), 'group-translate', and 'group-rotate' (rigid moves of the "
+       "particle group of a particle). Default is 'translate'."
+      )
+      (
+       "number-of-tuning-steps", po::value<std::size_t>(&ntune),
+       "Monte Carlo only. Number of steps (or sweeps) in which step sizes are adjusted "
+       "toward the target acceptance ratio. Default is 0."
+      )
+      (
+       "acceptance", po::value<real_t>(&acceptance),
+       "Monte Carlo only. Target acceptance ratio (%). Default is 50%."
+      )
+      (
+       "constraints", po::value<std::string>(&constraints),
+       "Bond constraints. Default is 'none'. Choose 'rattle' to hold the CW-DP distance "
+       "in polarizable water fixed. Applies to 'vv', 'lvv', and 'pt-lvv'."
+      )
+      (
+       "minimize",
+       "Minimize the potential energy before the simulation, e.g. to remove close "
+       "contacts in a newly created model."
+      )
+      (
+       "minimizer", po::value<std::string>(&minimizer),
+       "Energy minimizer. Default is 'fire' (FIRE). Other choice is 'sd' (steepest descent)."
+      )
+      (
+       "number-of-minimization-steps", po::value<std::size_t>(&nminsteps),
+       "Maximum number of energy minimization steps. Default is 1000."
+      )
+      (
+       "max-force", po::value<real_t>(&fmax),
+       "Energy minimization stops when the largest force falls below this value "
+       "(kJ/(mol nm)). Default is 10 kJ/(mol nm)."
+      )
+      (
+       "number-of-inner-steps", po::value<std::size_t>(&ninner),
+       "Number of inner steps per time step for 'respa'. Bonded forces are evaluated "
+       "every inner step, non-bonded forces every time step. Default is 4."
+      )
+      (
+       "max-displacement", po::value<real_t>(&dxmax),
+       "Adaptive time step only. Largest displacement of any particle in one step (nm). "
+       "Default is 0.03 nm."
+      )
+      (
+       "energy-tolerance", po::value<real_t>(&etol),
+       "Adaptive time step only. Tolerance for the energy error per particle in one step "
+       "(kJ/mol). Default is 0.01 kJ/mol."
+      )
+      (
+       "seed", po::value<std::size_t>(),
+       "Seed for random numbers. If provided, simulations are reproducible. "
+       "Default is a random seed."
+      )
+      (
+       "number-of-replicas", po::value<std::size_t>(&nreplicas),
+       "Number of replicas. If larger than 1, a temperature replica exchange simulation is "
+       "performed with replica temperatures geometrically spaced between 'temperature' and "
+       "'max-temperature'. Output file names of trajectories and simulation data get the "
+       "suffix '-k', where k is the temperature index. Not available for the harmonic "
+       "potential model. Default is 1."
+      )
+      (
+       "max-temperature", po::value<real_t>(&maxTemperature),
+       "Highest replica temperature (K). Default is 350 K."
+      )
+      (
+       "number-of-steps-between-exchange", po::value<std::size_t>(&nexchange),
+       "Number of steps between replica exchange attempts. Default is 100."
+      )
+      (
+       "number-of-steps-between-pt", po::value<std::size_t>(&npt),
+       "Number of steps between proton transfer evaluations. Each evaluation covers all "
+       "of these steps. Default is 1."
+      )
+      (
+       "pt-method", po::value<std::string>(&ptMethod),
+       "Proton transfer method. Either 'constant-rate' (all pairs every "
+       "'number-of-steps-between-pt' steps), or 'event-driven' (only pairs whose next "
+       "transfer event is due). Default is 'constant-rate'."
+      )
+      (
+       "fn-exchange", po::value<std::string>(&fnExchange),
+       "Output file name of replica exchange statistics. Default is 'exchange.dat'."
+      )
+      (
+       "fn-protonation-events", po::value<std::string>(&fnProtonationEvents),
+       "MD simulation only. Output file name of a log of changes in protonation states, "
+       "with regular key records of all protonation states. Default is no log."
+      )
+      (
+       "fn-checkpoint", po::value<std::string>(&fnCheckpoint),
+       "MD simulation only. File name of a binary checkpoint holding the full simulation "
+       "state. It is written at the end, and when receiving SIGTERM or SIGINT, after which "
+       "the simulation stops. Default is no checkpoint."
+      )
+      (
+       "number-of-steps-between-checkpoints", po::value<std::size_t>(&ncheckpoint),
+       "Number of steps between writing checkpoints. Default is 0, i.e. no regular "
+       "checkpoints."
+      )
+      (
+       "restart",
+       "MD simulation only. Continue the simulation from the checkpoint given by "
+       "--fn-checkpoint. Requires the same input model and "
+       "options as the original simulation. New trajectory, simulation data and "
+       "protonation event files are written, and must not exist."
+      )
       (
        "help", "Help message"
       )
@@ -167,6 +370,9 @@ int main(int argc, char* argv[])
     if ( vm.count("box-size") ) {
       boxSize =  vm["box-size"].as<real_t>();
     }
+    if ( vm.count("cutoff-distance") ) {
+      cutoff = vm["cutoff-distance"].as<real_t>();
+    }
     if ( vm.count("molarity") ) {
       molarity = vm["molarity"].as<real_t>();
     }
@@ -200,6 +406,118 @@ int main(int argc, char* argv[])
     if ( vm.count("monte-carlo") ) {
       mc = true;
     }
+    if ( vm.count("hybrid-monte-carlo") ) {
+      hmc = true;
+    }
+    if ( vm.count("number-of-md-steps") ) {
+      nmd = vm["number-of-md-steps"].as<std::size_t>();
+    }
+    if ( vm.count("checkerboard") ) {
+      checkerboard = true;
+    }
+    if ( vm.count("mc-moves") ) {
+      mcMoves = vm["mc-moves"].as<std::string>();
+    }
+    if ( vm.count("number-of-tuning-steps") ) {
+      ntune = vm["number-of-tuning-steps"].as<std::size_t>();
+    }
+    if ( vm.count("acceptance") ) {
+      acceptance = vm["acceptance"].as<real_t>();
+    }
+    if ( vm.count("constraints") ) {
+      constraints = vm["constraints"].as<std::string>();
+    }
+    if ( vm.count("minimize") ) {
+      minimize = true;
+    }
+    if ( vm.count("minimizer") ) {
+      minimizer = vm["minimizer"].as<std::string>();
+    }
+    if ( vm.count("number-of-minimization-steps") ) {
+      nminsteps = vm["number-of-minimization-steps"].as<std::size_t>();
+    }
+    if ( vm.count("max-force") ) {
+      fmax = vm["max-force"].as<real_t>();
+    }
+    if ( vm.count("number-of-inner-steps") ) {
+      ninner = vm["number-of-inner-steps"].as<std::size_t>();
+    }
+    if ( vm.count("max-displacement") ) {
+      dxmax = vm["max-displacement"].as<real_t>();
+    }
+    if ( vm.count("energy-tolerance") ) {
+      etol = vm["energy-tolerance"].as<real_t>();
+    }
+    if ( vm.count("number-of-replicas") ) {
+      nreplicas = vm["number-of-replicas"].as<std::size_t>();
+    }
+    if ( vm.count("max-temperature") ) {
+      maxTemperature = vm["max-temperature"].as<real_t>();
+    }
+    if ( vm.count("number-of-steps-between-exchange") ) {
+      nexchange = vm["number-of-steps-between-exchange"].as<std::size_t>();
+    }
+    if ( vm.count("fn-exchange") ) {
+      fnExchange = vm["fn-exchange"].as<std::string>();
+    }
+    if ( vm.count("fn-protonation-events") ) {
+      fnProtonationEvents = vm["fn-protonation-events"].as<std::string>();
+    }
+    if ( vm.count("fn-checkpoint") ) {
+      fnCheckpoint = vm["fn-checkpoint"].as<std::string>();
+    }
+    if ( vm.count("number-of-steps-between-checkpoints") ) {
+      ncheckpoint = vm["number-of-steps-between-checkpoints"].as<std::size_t>();
+    }
+    if ( vm.count("restart") ) {
+      restart = true;
+    }
+    if ( vm.count("trajectory-format") ) {
+      trajectoryFormat = vm["trajectory-format"].as<std::string>();
+    }
+    if ( vm.count("double-precision") ) {
+      doublePrecision = true;
+    }
+    if ( vm.count("trajectory-precision") ) {
+      trajPrecision = vm["trajectory-precision"].as<real_t>();
+    }
+    if ( vm.count("number-of-trajectory-buffers") ) {
+      ntrajbuffers = vm["number-of-trajectory-buffers"].as<std::size_t>();
+    }
+    if ( vm.count("number-of-steps-between-pt") ) {
+      npt = vm["number-of-steps-between-pt"].as<std::size_t>();
+    }
+    if ( vm.count("pt-method") ) {
+      ptMethod = vm["pt-method"].as<std::string>();
+    }
+    if ( nreplicas > 1 && 
+         ( !fnProtonationEvents.empty() || !fnCheckpoint.empty() || restart || mc || hmc ) ) {
+      throw std::domain_error(
+        "Replica exchange does not support protonation events, checkpoints, "
+        "Monte Carlo, or hybrid Monte Carlo."
+      );
+    }
+    if ( nreplicas > 1 && fnInputModel.empty() && modelType == conf::HP ) {
+      throw std::domain_error(
+        modelType + ": Replica exchange does not support the harmonic potential model."
+      );
+    }
+    if ( restart && ( fnCheckpoint.empty() || mc || hmc ) ) {
+      throw std::domain_error(
+        "A restart requires a checkpoint (--fn-checkpoint), and is not supported by "
+        "Monte Carlo or hybrid Monte Carlo."
+      );
+    }
+    if ( restart ) {
+      for (const auto& fn : {fnTrajectory, fnSimulationData, fnProtonationEvents}) {
+        if ( !fn.empty() && std::ifstream(fn).good() ) {
+          throw std::domain_error(
+            fn + ": File exists. Use a new file name with --restart, so that output "
+            "of the original simulation is not overwritten."
+          );
+        }
+      }
+    }
     
     // Simulation parameters
     sim_param_t param;    
@@ -208,7 +526,32 @@ int main(int argc, char* argv[])
     param.add<real_t>("temperature", temperature);
     param.add<real_t>("timestep", timestep);
     param.add<real_t>("gamma", gamma);
+    param.add<real_t>("cutoff", cutoff);
     param.add<std::size_t>("npairlists", 10);
+    param.add<std::size_t>("nexchange", nexchange);
+    param.add<std::size_t>("npt", npt);
+    param.add<std::string>("trajectory", trajectoryFormat);
+    param.add<bool>("doubleprecision", doublePrecision);
+    param.add<real_t>("trajprecision", trajPrecision);
+    param.add<std::size_t>("ntrajbuffers", ntrajbuffers);
+    param.add<std::string>("checkpoint", fnCheckpoint);
+    param.add<std::size_t>("ncheckpoint", ncheckpoint);
+    param.add<bool>("restart", restart);
+    param.add<std::string>("constraints", constraints);
+    param.add<std::size_t>("ninner", ninner);
+    param.add<real_t>("dxmax", dxmax);
+    param.add<real_t>("etol", etol);
+    param.add<bool>("checkerboard", checkerboard);
+    param.add<std::size_t>("nmd", nmd);
+    param.add<std::string>("mcmoves", mcMoves);
+    param.add<std::size_t>("ntune", ntune);
+    param.add<real_t>("acceptance", acceptance);
+    param.add<std::string>("minimizer", minimizer);
+    param.add<std::size_t>("nminsteps", nminsteps);
+    param.add<real_t>("fmax", fmax);
+    if ( vm.count("seed") ) {
+      param.add<std::size_t>("seed", vm["seed"].as<std::size_t>());
+    }
     std::cout << "Simulation parameters:" << std::endl;
     std::cout << param << std::endl;
     
@@ -238,7 +581,7 @@ int main(int argc, char* argv[])
       } else {
 	throw std::domain_error(modelType + ": No such simulation model type available (yet).");
       }
-      factory::changeDisplacer(displacerId, model);
+      factory::changeDisplacer(displacerId, model, ptMethod);
       std::clog << std::endl;
       std::clog << "Created molecular model:" << std::endl;
       
@@ -255,14 +598,69 @@ int main(int argc, char* argv[])
       model = simModelFactory->readCoarseGrainedFrom(stream);
       stream.close();
       std::clog << "Read model from input file '" << fnInputModel << "'." << std::endl;
+      if ( vm.count("displacer") ) {
+        factory::changeDisplacer(displacerId, model, ptMethod);
+      }
+    }
+
+    // Minimize potential energy.
+    if ( minimize ) {
+      Minimizer<Bead> energyMinimizer(model);
+      energyMinimizer.perform(param, std::clog);
     }
 
     // Simulate.
-    file::open_output(traj, fnTrajectory);
+    auto trajMode = trajectoryFormat == conf::TEXT_TRAJECTORY ?
+      std::ios_base::out : std::ios_base::out | std::ios_base::binary;
+    if ( nreplicas > 1 ) {
+      std::vector<cg_sim_model_ptr_t> replicas{model};
+      std::vector<temperature_t> temperatures{};
+      std::vector<std::ofstream> trajs(nreplicas), datas(nreplicas);
+      for (std::size_t k = 0; k != nreplicas; ++k) {
+        real_t T = temperature * std::pow(maxTemperature / temperature,
+                                          real_t(k) / real_t(nreplicas - 1));
+        temperatures.push_back(T);
+        if ( k > 0 ) {
+          replicas.push_back(simModelFactory->replicate(model, ptMethod));
+        }
+        file::open_output(trajs[k], fnTrajectory + "-" + std::to_string(k), trajMode);
+        file::open_output(datas[k], fnSimulationData + "-" + std::to_string(k));
+      }
+      file::open_output(stream, fnExchange);
+      ReplicaExchange<Bead> replicaExchange(replicas, temperatures);
+      replicaExchange.perform(param, trajs, datas, stream);
+      stream.close();
+      for (std::size_t k = 0; k != nreplicas; ++k) {
+        trajs[k].close();
+        datas[k].close();
+      }
+      
+      // Write output model, which is the replica at the lowest temperature.
+      file::open_output(stream, fnOutputModel);
+      stream << *replicaExchange.replicaAt(0) << std::endl;
+      stream.close();
+      std::clog << "Wrote model to output file '" << fnOutputModel << "'." << std::endl;
+      
+      return 0;
+    }
+    file::open_output(traj, fnTrajectory, trajMode);
     file::open_output(data, fnSimulationData);
+    if ( !fnCheckpoint.empty() && !mc && !hmc ) {
+      std::signal(SIGTERM, onSignal);
+      std::signal(SIGINT, onSignal);
+    }
     if ( mc ) {
       MC<Bead> mc(model);
       mc.perform(param, traj, data);
+    } else if ( hmc ) {
+      HMC<Bead> hmc(model);
+      hmc.perform(param, traj, data);
+    } else if ( !fnProtonationEvents.empty() ) {
+      std::ofstream events;
+      file::open_output(events, fnProtonationEvents);
+      Simulation<Bead> simulation(model);
+      simulation.perform(param, traj, data, events);
+      events.close();
     } else {
       Simulation<Bead> simulation(model);
       simulation.perform(param, traj, data);
@@ -52,7 +52,8 @@ int main(int argc, char *argv[])
      "Input file name model. Default is 'in.model'.")
     (
      "fn-trajectory",  po::value<std::string>(&fnTrajectory),
-     "Input file name trajectory. Default is 'trajectory.dat'."
+     "Input file name trajectory, in text, binary, or compressed format. Default is "
+     "'trajectory.dat'."
     )
     (
      "time-interval", po::value<real_t>(&dt),
@@ -127,7 +128,7 @@ int main(int argc, char *argv[])
   // Perform analysis.
   analyzer_ptr_t analyzer = analyzer_t::create(dt, t0);
   analysis_t analysis(sm, analyzer);
-  file::open_input(istream, fnTrajectory);
+  file::open_input(istream, fnTrajectory, std::ios_base::in | std::ios_base::binary);
   analysis.perform(param, istream);
   istream.close();
 
@@ -49,7 +49,8 @@ int main(int argc, char *argv[])
      "Input file name model. Default is 'in.model'.")
     (
      "fn-trajectory",  po::value<std::string>(&fnTrajectory),
-     "Input file name trajectory. Default is 'trajectory.dat'."
+     "Input file name trajectory, in text, binary, or compressed format. Default is "
+     "'trajectory.dat'."
     )
     (
      "spec-name-1", po::value<std::string>(&specName1),
@@ -127,7 +128,7 @@ int main(int argc, char *argv[])
   gr_ptr_t gr = gr_t::create(dr, specName1, specName2, box, bc);
   
   analysis_t analysis(sm, gr);
-  file::open_input(istream, fnTrajectory);
+  file::open_input(istream, fnTrajectory, std::ios_base::in | std::ios_base::binary);
   analysis.perform(param, istream);
   istream.close();
 
@@ -23,15 +23,21 @@ namespace simploce {
          * Open input file.
          * @param stream Input stream with which file is associated.
          * @param fileName Input file name.
+         * @param mode Open mode, e.g. std::ios_base::in | std::ios_base::binary.
          */
-        void open_input(std::ifstream& stream, const std::string& fileName);
+        void open_input(std::ifstream& stream, 
+                        const std::string& fileName,
+                        std::ios_base::openmode mode = std::ios_base::in);
 
         /**
          * Open output file.
          * @param stream Output stream with which file is associated.
          * @param fileName Output file name.
+         * @param mode Open mode, e.g. std::ios_base::out | std::ios_base::binary.
          */
-        void open_output(std::ofstream& stream, const std::string& fileName);
+        void open_output(std::ofstream& stream, 
+                         const std::string& fileName,
+                         std::ios_base::openmode mode = std::ios_base::out);
         
     }
 }
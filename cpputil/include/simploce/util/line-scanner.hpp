@@ -0,0 +1,78 @@
+/*
+ * To change this license header, choose License Headers in Project Properties.
+ * To change this template file, choose Tools | Templates
+ * and open the template in the editor.
+ */
+
+/*
+ * File:   line-scanner.hpp
+ * Author: André H. Juffer, Biocenter Oulu.
+ *
+ * Created on November 30, 2019, 2:15 PM
+ */
+
+#ifndef LINE_SCANNER_HPP
+#define LINE_SCANNER_HPP
+
+#include "utypes.hpp"
+#include <iostream>
+#include <string>
+
+namespace simploce {
+
+    /**
+     * Reads values from an input stream, one line at a time. A line is read
+     * into a buffer that is reused for all lines, and values are converted
+     * directly from the buffer. This avoids the overhead of formatted input
+     * (operator >>) for large files. Only whole lines are taken from the
+     * stream, so that the stream can be read further after scanning. Values
+     * are separated by white space, and may span lines, as with operator >>.
+     */
+    class LineScanner {
+    public:
+
+        /**
+         * Constructor.
+         * @param stream Input stream.
+         */
+        explicit LineScanner(std::istream& stream);
+
+        /**
+         * Reads the next line.
+         * @return False at end of stream.
+         */
+        bool next();
+
+        /**
+         * Returns the next field of fixed width in the current line, without
+         * leading and trailing white space. Fields are shorter at the end of
+         * the line.
+         * @param width Width of field.
+         * @return Field.
+         */
+        std::string field(std::size_t width);
+
+        /**
+         * Returns next value as an unsigned integer, reading lines as needed.
+         * @return Value.
+         */
+        std::size_t size();
+
+        /**
+         * Returns next value as a real number, reading lines as needed.
+         * @return Value.
+         */
+        real_t real();
+
+    private:
+
+        void skip_();
+
+        std::istream* stream_;
+        std::string line_;
+        const char* pos_;
+    };
+}
+
+#endif /* LINE_SCANNER_HPP */
+
@@ -0,0 +1,164 @@
+/*
+ * To change this license header, choose License Headers in Project Properties.
+ * To change this template file, choose Tools | Templates
+ * and open the template in the editor.
+ */
+
+/*
+ * File:   philox.hpp
+ * Author: André H. Juffer, Biocenter Oulu.
+ *
+ * Created on November 15, 2019, 1:12 PM
+ */
+
+#ifndef PHILOX_HPP
+#define PHILOX_HPP
+
+#include "utypes.hpp"
+#include "math-constants.hpp"
+#include <array>
+#include <cstdint>
+#include <cmath>
+
+namespace simploce {
+
+    /**
+     * Counter-based random number generator Philox4x32-10. Random numbers are a
+     * (bijective) function of a counter and a key only, so there is no state to
+     * share between threads. Here, the key is a seed, and the counter is formed
+     * by a step number, an index (e.g. of a particle), and a stream number
+     * (distinguishing independent uses within the same step). Results are
+     * therefore reproducible, whatever the number of threads.
+     * @see <a href="https://doi.org/10.1145/2063384.2063405">
+     *   J. K. Salmon et al., Parallel random numbers: as easy as 1, 2, 3, SC11, 2011.
+     * </a>
+     */
+    class Philox {
+    public:
+
+        /**
+         * Counter type.
+         */
+        using counter_t = std::array<std::uint32_t, 4>;
+
+        /**
+         * Key type.
+         */
+        using key_t = std::array<std::uint32_t, 2>;
+
+        /**
+         * Constructor.
+         * @param seed Seed.
+         */
+        explicit Philox(std::uint64_t seed = 0) :
+            key_{{std::uint32_t(seed), std::uint32_t(seed >> 32)}}
+        {
+        }
+
+        /**
+         * Applies 10 Philox rounds.
+         * @param counter Counter.
+         * @param key Key.
+         * @return Four random 32-bit integers.
+         */
+        static counter_t generate(counter_t counter, key_t key)
+        {
+            for (int round = 0; round != 10; ++round) {
+                if ( round > 0 ) {
+                    key[0] += W0;
+                    key[1] += W1;
+                }
+                std::uint64_t p0 = std::uint64_t(M0) * counter[0];
+                std::uint64_t p1 = std::uint64_t(M1) * counter[2];
+                counter = counter_t{{
+                    std::uint32_t(p1 >> 32) ^ counter[1] ^ key[0],
+                    std::uint32_t(p1),
+                    std::uint32_t(p0 >> 32) ^ counter[3] ^ key[1],
+                    std::uint32_t(p0)
+                }};
+            }
+            return counter;
+        }
+
+        /**
+         * Returns four random 32-bit integers.
+         * @param step Step number.
+         * @param index Index, e.g. of a particle.
+         * @param stream Stream number.
+         * @return Random integers.
+         */
+        counter_t operator () (std::uint64_t step,
+                               std::uint32_t index,
+                               std::uint32_t stream = 0) const
+        {
+            counter_t counter{{std::uint32_t(step), std::uint32_t(step >> 32), index, stream}};
+            return generate(counter, key_);
+        }
+
+        /**
+         * Returns four uniformly distributed random numbers in (0,1).
+         * @param step Step number.
+         * @param index Index, e.g. of a particle.
+         * @param stream Stream number.
+         * @return Random numbers.
+         */
+        std::array<real_t, 4> uniform(std::uint64_t step,
+                                      std::uint32_t index,
+                                      std::uint32_t stream = 0) const
+        {
+            static const real_t factor = 1.0 / 4294967296.0;  // 2^-32
+
+            counter_t r = (*this)(step, index, stream);
+            std::array<real_t, 4> u;
+            for (std::size_t k = 0; k != 4; ++k) {
+                u[k] = ( real_t(r[k]) + 0.5 ) * factor;
+            }
+            return u;
+        }
+
+        /**
+         * Returns four standard normally distributed random numbers (Box-Muller).
+         * @param step Step number.
+         * @param index Index, e.g. of a particle.
+         * @param stream Stream number.
+         * @return Random numbers.
+         */
+        std::array<real_t, 4> normal(std::uint64_t step,
+                                     std::uint32_t index,
+                                     std::uint32_t stream = 0) const
+        {
+            static const real_t twoPI = 2.0 * MathConstants<real_t>::PI;
+
+            std::array<real_t, 4> u = this->uniform(step, index, stream);
+            std::array<real_t, 4> n;
+            for (std::size_t k = 0; k != 4; k += 2) {
+                real_t radius = std::sqrt(-2.0 * std::log(u[k]));
+                real_t angle = twoPI * u[k + 1];
+                n[k] = radius * std::cos(angle);
+                n[k + 1] = radius * std::sin(angle);
+            }
+            return n;
+        }
+
+        /**
+         * Returns seed.
+         * @return Seed.
+         */
+        std::uint64_t seed() const
+        {
+            return ( std::uint64_t(key_[1]) << 32 ) | key_[0];
+        }
+
+    private:
+
+        static const std::uint32_t M0 = 0xD2511F53;
+        static const std::uint32_t M1 = 0xCD9E8D57;
+        static const std::uint32_t W0 = 0x9E3779B9;
+        static const std::uint32_t W1 = 0xBB67AE85;
+
+        key_t key_;
+    };
+}
+
+#endif /* PHILOX_HPP */
+
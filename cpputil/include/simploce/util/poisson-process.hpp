@@ -2,6 +2,8 @@
 #define	POISSON_PROCESS_HPP
 
 #include "utypes.hpp"
+#include "philox.hpp"
+#include <cstdint>
 #include <utility>
 #include <vector>
 #include <ostream>
@@ -30,6 +32,24 @@ namespace simploce {
 					  const rate_t& lambda, 
 					  std::size_t n);
       
+      /**
+       * Generates Poisson process, with increments drawn in one batch from the 
+       * given counter-based generator. Reproducible and thread-safe.
+       * @param dt Time step.
+       * @param lambda Rate or intensity.
+       * @param n Number of values (pair) to be generated.
+       * @param rng Random number generator.
+       * @param counter Counter.
+       * @param stream Stream number.
+       * @return (t,N(t)) pairs.
+       */
+      static std::vector<pair_t> generate(const stime_t& dt, 
+					  const rate_t& lambda, 
+					  std::size_t n,
+					  const Philox& rng,
+					  std::uint64_t counter,
+					  std::uint32_t stream = 0);
+      
       /**
        * Returns increment.
        * @param dt Time interval.
@@ -38,6 +58,45 @@ namespace simploce {
        */
       static std::size_t increment(const stime_t& dt, 
                                    const rate_t& lambda);
+      
+      /**
+       * Returns a batch of independent increments with the same rate and time
+       * interval. The survival probability exp(-lambda * dt) is calculated 
+       * once. Increments are drawn from the given counter-based generator, 
+       * and are therefore reproducible. Thread-safe.
+       * @param dt Time interval.
+       * @param lambda Rate or intensity.
+       * @param n Number of increments.
+       * @param rng Random number generator.
+       * @param counter Counter. Batches drawn with different counters are 
+       * independent.
+       * @param stream Stream number, distinguishing this use of the generator
+       * from other uses with the same seed.
+       * @return Increments, each either 0 or 1.
+       */
+      static std::vector<std::size_t> increments(const stime_t& dt,
+                                                 const rate_t& lambda,
+                                                 std::size_t n,
+                                                 const Philox& rng,
+                                                 std::uint64_t counter,
+                                                 std::uint32_t stream = 0);
+      
+      /**
+       * Returns a batch of independent increments, one for each time interval 
+       * and rate, drawn from the given counter-based generator. Thread-safe.
+       * @param dts Time intervals.
+       * @param lambdas Rates or intensities. Same size as dts.
+       * @param rng Random number generator.
+       * @param counter Counter. Batches drawn with different counters are 
+       * independent.
+       * @param stream Stream number.
+       * @return Increments, each either 0 or 1.
+       */
+      static std::vector<std::size_t> increments(const std::vector<stime_t>& dts,
+                                                 const std::vector<rate_t>& lambdas,
+                                                 const Philox& rng,
+                                                 std::uint64_t counter,
+                                                 std::uint32_t stream = 0);
     };
     
     /**
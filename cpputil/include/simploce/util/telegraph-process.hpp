@@ -2,6 +2,8 @@
 #define TELEGRAPH_PROCESS_HPP
 
 #include "utypes.hpp"
+#include "philox.hpp"
+#include <cstdint>
 #include <utility>
 #include <vector>
 #include <iostream>
@@ -49,6 +51,52 @@ namespace simploce {
 					  std::size_t nValues,
 					  std::size_t a);
       
+      /**
+       * Generates symmetric Telegraph process jumping between -a and +a, a > 0.
+       * Jumps are drawn in one batch from the given counter-based generator. 
+       * Reproducible and thread-safe.
+       * @param dt Time step.
+       * @param lambda Rate.
+       * @param nValues Requested number of values.
+       * @param a Value of a. Should be a > 0.
+       * @param rng Random number generator.
+       * @param counter Counter.
+       * @param stream Stream number.
+       * @return Tuple of (t,T(t)) pairs. Initial value T(0) = -a.
+       */
+      static std::vector<pair_t> generate(const stime_t& dt, 
+					  const rate_t& lambda, 
+					  std::size_t nValues,
+					  std::size_t a,
+					  const Philox& rng,
+					  std::uint64_t counter,
+					  std::uint32_t stream = 0);
+      
+      /**
+       * Generates asymmetric Telegraph process jumping between -a and +a, a > 0.
+       * The rate of each step depends on the state reached by the previous 
+       * step, so that jumps are drawn step by step from the given counter-based
+       * generator, with counters counter, counter + 1, ..., 
+       * counter + nValues - 1. Reproducible and thread-safe.
+       * @param dt Time step.
+       * @param lambda_up Rate for going from -a to +a.
+       * @param lambda_down Rate for going from +a to -a.
+       * @param nValues Requested number of values.
+       * @param a Value of a. Should be a > 0.
+       * @param rng Random number generator.
+       * @param counter First counter.
+       * @param stream Stream number.
+       * @return Tuple of (t,T(t)) pairs. Initial value T(0) = -a.
+       */
+      static std::vector<pair_t> generate(const stime_t& dt, 
+					  const rate_t& lambda_up, 
+					  const rate_t& lambda_down, 
+					  std::size_t nValues,
+					  std::size_t a,
+					  const Philox& rng,
+					  std::uint64_t counter,
+					  std::uint32_t stream = 0);
+      
       /**
        * Returns increment for a symmetric telegraph process for jumping between 
        * -a and +a,
@@ -75,6 +123,45 @@ namespace simploce {
 		           const stime_t& dt, 
 			   const rate_t& rate_up, 
 			   const rate_t& rate_down);
+      
+      /**
+       * Returns increments for a batch of symmetric telegraph processes with 
+       * the same rate and time interval. Jumps are drawn from the given 
+       * counter-based generator. Thread-safe.
+       * @param currents Current state values.
+       * @param dt Time interval.
+       * @param lambda Jump rate.
+       * @param rng Random number generator.
+       * @param counter Counter. Batches drawn with different counters are 
+       * independent.
+       * @param stream Stream number.
+       * @return Increments, either 0, +2 * | current |, or -2 * | current |.
+       */
+      static std::vector<int> increments(const std::vector<int>& currents,
+                                         const stime_t& dt,
+                                         const rate_t& lambda,
+                                         const Philox& rng,
+                                         std::uint64_t counter,
+                                         std::uint32_t stream = 0);
+      
+      /**
+       * Returns increments for a batch of symmetric telegraph processes, each 
+       * with its own time interval and rate. Jumps are drawn from the given 
+       * counter-based generator. Thread-safe.
+       * @param currents Current state values.
+       * @param dts Time intervals. Same size as currents.
+       * @param lambdas Jump rates. Same size as currents.
+       * @param rng Random number generator.
+       * @param counter Counter.
+       * @param stream Stream number.
+       * @return Increments, either 0, +2 * | current |, or -2 * | current |.
+       */
+      static std::vector<int> increments(const std::vector<int>& currents,
+                                         const std::vector<stime_t>& dts,
+                                         const std::vector<rate_t>& lambdas,
+                                         const Philox& rng,
+                                         std::uint64_t counter,
+                                         std::uint32_t stream = 0);
     };
     
     /**
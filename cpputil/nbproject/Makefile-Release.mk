@@ -36,6 +36,7 @@ OBJECTDIR=${CND_BUILDDIR}/${CND_CONF}/${CND_PLATFORM}
 # Object Files
 OBJECTFILES= \
 	${OBJECTDIR}/src/file.o \
+	${OBJECTDIR}/src/line-scanner.o \
 	${OBJECTDIR}/src/param.o \
 	${OBJECTDIR}/src/poisson-process.o \
 	${OBJECTDIR}/src/telegraph-process.o \
@@ -48,9 +49,11 @@ TESTDIR=${CND_BUILDDIR}/${CND_CONF}/${CND_PLATFORM}/tests
 TESTFILES= \
 	${TESTDIR}/TestFiles/f5 \
 	${TESTDIR}/TestFiles/f1 \
+	${TESTDIR}/TestFiles/f11 \
 	${TESTDIR}/TestFiles/f6 \
 	${TESTDIR}/TestFiles/f9 \
 	${TESTDIR}/TestFiles/f8 \
+	${TESTDIR}/TestFiles/f10 \
 	${TESTDIR}/TestFiles/f4 \
 	${TESTDIR}/TestFiles/f7 \
 	${TESTDIR}/TestFiles/f3 \
@@ -60,9 +63,11 @@ TESTFILES= \
 TESTOBJECTFILES= \
 	${TESTDIR}/tests/box-cube-test.o \
 	${TESTDIR}/tests/cvector-test.o \
+	${TESTDIR}/tests/line-scanner-test.o \
 	${TESTDIR}/tests/matrix-map-test.o \
 	${TESTDIR}/tests/mu-units-test.o \
 	${TESTDIR}/tests/nint-test.o \
+	${TESTDIR}/tests/philox-test.o \
 	${TESTDIR}/tests/seed-value-test.o \
 	${TESTDIR}/tests/telegraph-process-test.o \
 	${TESTDIR}/tests/value-cvector-test.o \
@@ -97,6 +102,11 @@ ${OBJECTDIR}/src/file.o: src/file.cpp
 	${RM} "$@.d"
 	$(COMPILE.cc) -O2 -Iinclude -std=c++14 -fPIC  -MMD -MP -MF "$@.d" -o ${OBJECTDIR}/src/file.o src/file.cpp
 
+${OBJECTDIR}/src/line-scanner.o: src/line-scanner.cpp
+	${MKDIR} -p ${OBJECTDIR}/src
+	${RM} "$@.d"
+	$(COMPILE.cc) -O2 -Iinclude -std=c++14 -fPIC  -MMD -MP -MF "$@.d" -o ${OBJECTDIR}/src/line-scanner.o src/line-scanner.cpp
+
 ${OBJECTDIR}/src/param.o: src/param.cpp
 	${MKDIR} -p ${OBJECTDIR}/src
 	${RM} "$@.d"
@@ -132,6 +142,10 @@ ${TESTDIR}/TestFiles/f1: ${TESTDIR}/tests/cvector-test.o ${OBJECTFILES:%.o=%_nom
 	${MKDIR} -p ${TESTDIR}/TestFiles
 	${LINK.cc} -o ${TESTDIR}/TestFiles/f1 $^ ${LDLIBSOPTIONS}   
 
+${TESTDIR}/TestFiles/f11: ${TESTDIR}/tests/line-scanner-test.o ${OBJECTFILES:%.o=%_nomain.o}
+	${MKDIR} -p ${TESTDIR}/TestFiles
+	${LINK.cc} -o ${TESTDIR}/TestFiles/f11 $^ ${LDLIBSOPTIONS}   
+
 ${TESTDIR}/TestFiles/f6: ${TESTDIR}/tests/matrix-map-test.o ${OBJECTFILES:%.o=%_nomain.o}
 	${MKDIR} -p ${TESTDIR}/TestFiles
 	${LINK.cc} -o ${TESTDIR}/TestFiles/f6 $^ ${LDLIBSOPTIONS}   
@@ -144,6 +158,10 @@ ${TESTDIR}/TestFiles/f8: ${TESTDIR}/tests/nint-test.o ${OBJECTFILES:%.o=%_nomain
 	${MKDIR} -p ${TESTDIR}/TestFiles
 	${LINK.cc} -o ${TESTDIR}/TestFiles/f8 $^ ${LDLIBSOPTIONS}   
 
+${TESTDIR}/TestFiles/f10: ${TESTDIR}/tests/philox-test.o ${OBJECTFILES:%.o=%_nomain.o}
+	${MKDIR} -p ${TESTDIR}/TestFiles
+	${LINK.cc} -o ${TESTDIR}/TestFiles/f10 $^ ${LDLIBSOPTIONS}   
+
 ${TESTDIR}/TestFiles/f4: ${TESTDIR}/tests/seed-value-test.o ${OBJECTFILES:%.o=%_nomain.o}
 	${MKDIR} -p ${TESTDIR}/TestFiles
 	${LINK.cc} -o ${TESTDIR}/TestFiles/f4 $^ ${LDLIBSOPTIONS}   
@@ -173,6 +191,12 @@ ${TESTDIR}/tests/cvector-test.o: tests/cvector-test.cpp
 	$(COMPILE.cc) -O2 -Iinclude -I. -std=c++14 -MMD -MP -MF "$@.d" -o ${TESTDIR}/tests/cvector-test.o tests/cvector-test.cpp
 
 
+${TESTDIR}/tests/line-scanner-test.o: tests/line-scanner-test.cpp 
+	${MKDIR} -p ${TESTDIR}/tests
+	${RM} "$@.d"
+	$(COMPILE.cc) -O2 -Iinclude -I. -std=c++14 -MMD -MP -MF "$@.d" -o ${TESTDIR}/tests/line-scanner-test.o tests/line-scanner-test.cpp
+
+
 ${TESTDIR}/tests/matrix-map-test.o: tests/matrix-map-test.cpp 
 	${MKDIR} -p ${TESTDIR}/tests
 	${RM} "$@.d"
@@ -191,6 +215,12 @@ ${TESTDIR}/tests/nint-test.o: tests/nint-test.cpp
 	$(COMPILE.cc) -O2 -Iinclude -I. -std=c++14 -MMD -MP -MF "$@.d" -o ${TESTDIR}/tests/nint-test.o tests/nint-test.cpp
 
 
+${TESTDIR}/tests/philox-test.o: tests/philox-test.cpp 
+	${MKDIR} -p ${TESTDIR}/tests
+	${RM} "$@.d"
+	$(COMPILE.cc) -O2 -Iinclude -I. -std=c++14 -MMD -MP -MF "$@.d" -o ${TESTDIR}/tests/philox-test.o tests/philox-test.cpp
+
+
 ${TESTDIR}/tests/seed-value-test.o: tests/seed-value-test.cpp 
 	${MKDIR} -p ${TESTDIR}/tests
 	${RM} "$@.d"
@@ -228,6 +258,19 @@ ${OBJECTDIR}/src/file_nomain.o: ${OBJECTDIR}/src/file.o src/file.cpp
 	    ${CP} ${OBJECTDIR}/src/file.o ${OBJECTDIR}/src/file_nomain.o;\
 	fi
 
+${OBJECTDIR}/src/line-scanner_nomain.o: ${OBJECTDIR}/src/line-scanner.o src/line-scanner.cpp 
+	${MKDIR} -p ${OBJECTDIR}/src
+	@NMOUTPUT=`${NM} ${OBJECTDIR}/src/line-scanner.o`; \
+	if (echo "$$NMOUTPUT" | ${GREP} '|main$$') || \
+	   (echo "$$NMOUTPUT" | ${GREP} 'T main$$') || \
+	   (echo "$$NMOUTPUT" | ${GREP} 'T _main$$'); \
+	then  \
+	    ${RM} "$@.d";\
+	    $(COMPILE.cc) -O2 -Iinclude -std=c++14 -fPIC  -Dmain=__nomain -MMD -MP -MF "$@.d" -o ${OBJECTDIR}/src/line-scanner_nomain.o src/line-scanner.cpp;\
+	else  \
+	    ${CP} ${OBJECTDIR}/src/line-scanner.o ${OBJECTDIR}/src/line-scanner_nomain.o;\
+	fi
+
 ${OBJECTDIR}/src/param_nomain.o: ${OBJECTDIR}/src/param.o src/param.cpp 
 	${MKDIR} -p ${OBJECTDIR}/src
 	@NMOUTPUT=`${NM} ${OBJECTDIR}/src/param.o`; \
@@ -286,9 +329,11 @@ ${OBJECTDIR}/src/util_nomain.o: ${OBJECTDIR}/src/util.o src/util.cpp
 	then  \
 	    ${TESTDIR}/TestFiles/f5 || true; \
 	    ${TESTDIR}/TestFiles/f1 || true; \
+	    ${TESTDIR}/TestFiles/f11 || true; \
 	    ${TESTDIR}/TestFiles/f6 || true; \
 	    ${TESTDIR}/TestFiles/f9 || true; \
 	    ${TESTDIR}/TestFiles/f8 || true; \
+	    ${TESTDIR}/TestFiles/f10 || true; \
 	    ${TESTDIR}/TestFiles/f4 || true; \
 	    ${TESTDIR}/TestFiles/f7 || true; \
 	    ${TESTDIR}/TestFiles/f3 || true; \
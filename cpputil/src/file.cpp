@@ -17,18 +17,22 @@
 namespace simploce {
     namespace file {
             
-        void open_input(std::ifstream& stream, const std::string& fileName)
+        void open_input(std::ifstream& stream, 
+                        const std::string& fileName,
+                        std::ios_base::openmode mode)
         {
-            stream.open(fileName, std::ios_base::in);
+            stream.open(fileName, mode);
             if ( !stream.good() ) {
                 stream.close();
                 throw std::runtime_error(fileName + ": Cannot open this file.");
             }
         }
 
-        void open_output(std::ofstream& stream, const std::string& fileName)
+        void open_output(std::ofstream& stream, 
+                         const std::string& fileName,
+                         std::ios_base::openmode mode)
         {
-            stream.open(fileName, std::ios_base::out);
+            stream.open(fileName, mode);
             if ( !stream.good() ) {
                 stream.close();
                 throw std::runtime_error(fileName + ": Cannot open this file.");
@@ -0,0 +1,98 @@
+/*
+ * To change this license header, choose License Headers in Project Properties.
+ * To change this template file, choose Tools | Templates
+ * and open the template in the editor.
+ */
+
+/*
+ * File:   line-scanner.cpp
+ * Author: André H. Juffer, Biocenter Oulu.
+ *
+ * Created on November 30, 2019, 2:15 PM
+ */
+
+#include "simploce/util/line-scanner.hpp"
+#include <cstdlib>
+#include <cctype>
+#include <stdexcept>
+
+namespace simploce {
+
+    LineScanner::LineScanner(std::istream& stream) :
+        stream_{&stream}, line_{}, pos_{line_.c_str()}
+    {
+    }
+
+    bool
+    LineScanner::next()
+    {
+        bool read = static_cast<bool>(std::getline(*stream_, line_));
+        if ( !read ) {
+            line_.clear();
+        }
+        pos_ = line_.c_str();
+        return read;
+    }
+
+    std::string
+    LineScanner::field(std::size_t width)
+    {
+        const char* end = line_.c_str() + line_.size();
+        const char* last = ( std::size_t(end - pos_) < width ) ? end : pos_ + width;
+        const char* begin = pos_;
+        pos_ = last;
+        while ( begin != last && std::isspace(static_cast<unsigned char>(*begin)) ) {
+            ++begin;
+        }
+        while ( last != begin && std::isspace(static_cast<unsigned char>(*(last - 1))) ) {
+            --last;
+        }
+        return std::string(begin, last);
+    }
+
+    std::size_t
+    LineScanner::size()
+    {
+        this->skip_();
+        char* end;
+        unsigned long long value = std::strtoull(pos_, &end, 10);
+        if ( end == pos_ || *pos_ == '-' ) {
+            throw std::domain_error(
+                "LineScanner: Expected an unsigned integer, found '" + std::string(pos_) + "'."
+            );
+        }
+        pos_ = end;
+        return std::size_t(value);
+    }
+
+    real_t
+    LineScanner::real()
+    {
+        this->skip_();
+        char* end;
+        real_t value = std::strtod(pos_, &end);
+        if ( end == pos_ ) {
+            throw std::domain_error(
+                "LineScanner: Expected a real number, found '" + std::string(pos_) + "'."
+            );
+        }
+        pos_ = end;
+        return value;
+    }
+
+    void
+    LineScanner::skip_()
+    {
+        while ( true ) {
+            while ( std::isspace(static_cast<unsigned char>(*pos_)) ) {
+                ++pos_;
+            }
+            if ( *pos_ != '\0' ) {
+                return;
+            }
+            if ( !this->next() ) {
+                throw std::domain_error("LineScanner: Unexpected end of stream.");
+            }
+        }
+    }
+}
@@ -1,11 +1,13 @@
 #include "simploce/util/poisson-process.hpp"
 #include "simploce/util/uconf.hpp"
+#include "simploce/util/philox.hpp"
 #include <boost/lexical_cast.hpp>
 #include <cmath>
 #include <numeric>
 #include <string>
 #include <random>
 #include <iostream>
+#include <stdexcept>
 
 namespace simploce {
 
@@ -30,13 +32,35 @@ namespace simploce {
       return result;
     }
     
+    std::vector<pair_t> 
+    PoissonProcess::generate(const stime_t&  dt, 
+			     const rate_t& lambda, 
+			     std::size_t n,
+			     const Philox& rng,
+			     std::uint64_t counter,
+			     std::uint32_t stream)
+    {
+      std::vector<std::size_t> dNs = PoissonProcess::increments(dt, lambda, n, rng, counter, stream);
+      std::vector<pair_t> result;
+      std::size_t N_t = 0;
+      for (std::size_t k = 0; k != n; ++k ) {
+	real_t real_k = k;
+	stime_t t = real_k * dt;
+	N_t += dNs[k];
+	pair_t pair = std::make_pair(t, N_t);
+	result.push_back(pair);
+      }
+      
+      return result;
+    }
+    
     std::size_t 
     PoissonProcess::increment(const stime_t& dt, 
                               const rate_t& lambda)
     {
-      static std::random_device rd;
-      static std::mt19937 gen(rd());
-      static std::uniform_real_distribution<real_t> dis(0.0, 1.0);
+      // One generator per thread, so that concurrent simulations do not race.
+      static thread_local std::mt19937 gen(std::random_device{}());
+      static thread_local std::uniform_real_distribution<real_t> dis(0.0, 1.0);
       
       real_t v = dis(gen);
       real_t exp = std::exp( -lambda() * dt() );
@@ -45,6 +69,46 @@ namespace simploce {
       return result;
     }
     
+    std::vector<std::size_t>
+    PoissonProcess::increments(const stime_t& dt,
+                               const rate_t& lambda,
+                               std::size_t n,
+                               const Philox& rng,
+                               std::uint64_t counter,
+                               std::uint32_t stream)
+    {
+      real_t exp = std::exp( -lambda() * dt() );
+      std::vector<std::size_t> result(n);
+      for (std::size_t k = 0; k < n; k += 4) {
+	auto u = rng.uniform(counter, std::uint32_t(k / 4), stream);
+	for (std::size_t j = 0; j != 4 && k + j < n; ++j) {
+	  result[k + j] = ( u[j] > exp ? 1 : 0 );
+	}
+      }
+      return result;
+    }
+    
+    std::vector<std::size_t>
+    PoissonProcess::increments(const std::vector<stime_t>& dts,
+                               const std::vector<rate_t>& lambdas,
+                               const Philox& rng,
+                               std::uint64_t counter,
+                               std::uint32_t stream)
+    {
+      if ( dts.size() != lambdas.size() ) {
+	throw std::domain_error("PoissonProcess: Number of time intervals and rates differ.");
+      }
+      std::size_t n = dts.size();
+      std::vector<std::size_t> result(n);
+      for (std::size_t k = 0; k < n; k += 4) {
+	auto u = rng.uniform(counter, std::uint32_t(k / 4), stream);
+	for (std::size_t j = 0; j != 4 && k + j < n; ++j) {
+	  result[k + j] = ( u[j] > std::exp( -lambdas[k + j]() * dts[k + j]() ) ? 1 : 0 );
+	}
+      }
+      return result;
+    }
+    
     std::ostream& 
     operator << (std::ostream& stream, 
                  const std::vector<pair_t>& values)
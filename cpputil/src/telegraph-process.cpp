@@ -2,6 +2,7 @@
 #include "simploce/util/poisson-process.hpp"
 #include "simploce/util/uconf.hpp"
 #include <iomanip>
+#include <stdexcept>
 
 namespace simploce {
 
@@ -46,6 +47,55 @@ namespace simploce {
       return result;    
     }
     
+    std::vector<pair_t> 
+    TelegraphProcess::generate(const stime_t& dt, 
+			       const rate_t& lambda, 
+			       std::size_t nValues,
+			       std::size_t a,
+			       const Philox& rng,
+			       std::uint64_t counter,
+			       std::uint32_t stream)
+    {
+      // Jumps do not depend on the state, all are drawn at once.
+      std::vector<std::size_t> dNs = 
+        PoissonProcess::increments(dt, lambda, nValues, rng, counter, stream);
+      std::vector<pair_t> result;
+      int T_t = -int(a);
+      for (std::size_t k = 0; k != nValues; ++k) {
+	real_t real_k = k;
+	stime_t t = real_k * dt;
+	T_t -= 2 * T_t * int(dNs[k]);
+	pair_t pair = std::make_pair(t, T_t);
+	result.push_back(pair);
+      }
+      return result;
+    }
+    
+    std::vector<pair_t> 
+    TelegraphProcess::generate(const stime_t& dt, 
+                               const rate_t& lambda_up, 
+                               const rate_t& lambda_down, 
+			       std::size_t nValues,
+			       std::size_t a,
+			       const Philox& rng,
+			       std::uint64_t counter,
+			       std::uint32_t stream)
+    {
+      std::vector<pair_t> result;
+      std::vector<int> T_t{-int(a)};
+      std::vector<stime_t> dts{dt};
+      std::vector<rate_t> lambdas{lambda_up};
+      for (std::size_t k = 0; k != nValues; ++k) {
+	real_t real_k = k;
+	stime_t t = real_k * dt;
+	lambdas[0] = (T_t[0] > 0 ? lambda_down : lambda_up);
+	auto dTs = TelegraphProcess::increments(T_t, dts, lambdas, rng, counter + k, stream);
+	T_t[0] += dTs[0];
+	pair_t pair = std::make_pair(t, T_t[0]);
+	result.push_back(pair);
+      }
+      return result;    
+    }
     
     int
     TelegraphProcess::increment(int current, 
@@ -66,6 +116,42 @@ namespace simploce {
       return TelegraphProcess::increment(current, dt, lambda);
     }
     
+    std::vector<int>
+    TelegraphProcess::increments(const std::vector<int>& currents,
+                                 const stime_t& dt,
+                                 const rate_t& lambda,
+                                 const Philox& rng,
+                                 std::uint64_t counter,
+                                 std::uint32_t stream)
+    {
+      std::vector<std::size_t> dNs = 
+        PoissonProcess::increments(dt, lambda, currents.size(), rng, counter, stream);
+      std::vector<int> result(currents.size());
+      for (std::size_t k = 0; k != currents.size(); ++k) {
+	result[k] = -2 * currents[k] * int(dNs[k]);
+      }
+      return result;
+    }
+    
+    std::vector<int>
+    TelegraphProcess::increments(const std::vector<int>& currents,
+                                 const std::vector<stime_t>& dts,
+                                 const std::vector<rate_t>& lambdas,
+                                 const Philox& rng,
+                                 std::uint64_t counter,
+                                 std::uint32_t stream)
+    {
+      if ( currents.size() != dts.size() ) {
+	throw std::domain_error("TelegraphProcess: Number of states and time intervals differ.");
+      }
+      std::vector<std::size_t> dNs = PoissonProcess::increments(dts, lambdas, rng, counter, stream);
+      std::vector<int> result(currents.size());
+      for (std::size_t k = 0; k != currents.size(); ++k) {
+	result[k] = -2 * currents[k] * int(dNs[k]);
+      }
+      return result;
+    }
+    
     std::ostream& 
     operator << (std::ostream& stream, 
                  const std::vector<pair_t>& values)
@@ -0,0 +1,100 @@
+/*
+ * To change this license header, choose License Headers in Project Properties.
+ * To change this template file, choose Tools | Templates
+ * and open the template in the editor.
+ */
+
+/*
+ * File:   line-scanner-test.cpp
+ * Author: André H. Juffer, Biocenter Oulu.
+ *
+ * Created on November 30, 2019, 3:02 PM
+ */
+
+#include "simploce/util/line-scanner.hpp"
+#include <cstdlib>
+#include <iostream>
+#include <sstream>
+#include <stdexcept>
+#include <cmath>
+
+using namespace simploce;
+
+/*
+ * Simple C++ Test Suite
+ */
+
+/*
+ * Fixed width fields and values, also spanning lines.
+ */
+void test1() {
+    std::cout << "line-scanner-test test 1" << std::endl;
+
+    std::stringstream stream{
+        "2\n"
+        "        CW        CW          1  -2.3114816e-02   4.0329429e-01 0\n"
+        "        DP       DP2         17   4.6117571e-02 1.0\n"
+        " 1 2\n"
+        "   3\n"
+        "rest\n"
+    };
+    LineScanner scanner{stream};
+    bool ok = scanner.size() == 2 && scanner.next();
+    ok = ok && scanner.field(10) == "CW" && scanner.field(10) == "CW" && scanner.size() == 1;
+    ok = ok && std::fabs(scanner.real() + 2.3114816e-02) < 1.0e-12;
+    ok = ok && std::fabs(scanner.real() - 4.0329429e-01) < 1.0e-12 && scanner.size() == 0;
+    ok = ok && scanner.next() && scanner.field(10) == "DP" && scanner.field(10) == "DP2";
+    ok = ok && scanner.size() == 17 && std::fabs(scanner.real() - 4.6117571e-02) < 1.0e-12;
+    ok = ok && scanner.real() == 1.0;
+    ok = ok && scanner.size() == 1 && scanner.size() == 2 && scanner.size() == 3;
+
+    // Only whole lines are taken from the stream.
+    std::string rest;
+    ok = ok && std::getline(stream, rest) && rest == "rest";
+    if ( !ok ) {
+        std::cout << "%TEST_FAILED% time=0 testname=test1 (line-scanner-test) "
+                  << "message=Values not reproduced." << std::endl;
+    }
+}
+
+/*
+ * Malformed input.
+ */
+void test2() {
+    std::cout << "line-scanner-test test 2" << std::endl;
+
+    std::stringstream stream{"-1 x\n"};
+    LineScanner scanner{stream};
+    std::size_t nerrors = 0;
+    for (std::size_t k = 0; k != 3; ++k) {
+        try {
+            if ( k == 1 ) {
+                scanner.real();
+            }
+            scanner.size();
+        } catch (std::domain_error& exception) {
+            nerrors += 1;
+        }
+    }
+    if ( nerrors != 3 ) {
+        std::cout << "%TEST_FAILED% time=0 testname=test2 (line-scanner-test) "
+                  << "message=Malformed input accepted." << std::endl;
+    }
+}
+
+int main(int argc, char** argv) {
+    std::cout << "%SUITE_STARTING% line-scanner-test" << std::endl;
+    std::cout << "%SUITE_STARTED%" << std::endl;
+
+    std::cout << "%TEST_STARTED% test1 (line-scanner-test)" << std::endl;
+    test1();
+    std::cout << "%TEST_FINISHED% time=0 test1 (line-scanner-test)" << std::endl;
+
+    std::cout << "%TEST_STARTED% test2 (line-scanner-test)" << std::endl;
+    test2();
+    std::cout << "%TEST_FINISHED% time=0 test2 (line-scanner-test)" << std::endl;
+
+    std::cout << "%SUITE_FINISHED% time=0" << std::endl;
+
+    return (EXIT_SUCCESS);
+}
@@ -0,0 +1,96 @@
+/*
+ * To change this license header, choose License Headers in Project Properties.
+ * To change this template file, choose Tools | Templates
+ * and open the template in the editor.
+ */
+
+/*
+ * File:   philox-test.cpp
+ * Author: André H. Juffer, Biocenter Oulu.
+ *
+ * Created on November 15, 2019, 2:05 PM
+ */
+
+#include "simploce/util/philox.hpp"
+#include <cstdlib>
+#include <iostream>
+
+using namespace simploce;
+
+/*
+ * Simple C++ Test Suite
+ */
+
+/*
+ * Known answers, from the Random123 distribution.
+ */
+void test1() {
+    std::cout << "philox-test test 1" << std::endl;
+
+    Philox::counter_t r1 = Philox::generate({{0, 0, 0, 0}}, {{0, 0}});
+    Philox::counter_t e1{{0x6627e8d5, 0xe169c58d, 0xbc57ac4c, 0x9b00dbd8}};
+    Philox::counter_t r2 =
+        Philox::generate({{0xffffffff, 0xffffffff, 0xffffffff, 0xffffffff}},
+                         {{0xffffffff, 0xffffffff}});
+    Philox::counter_t e2{{0x408f276d, 0x41c83b0e, 0xa20bc7c6, 0x6d5451fd}};
+    Philox::counter_t r3 =
+        Philox::generate({{0x243f6a88, 0x85a308d3, 0x13198a2e, 0x03707344}},
+                         {{0xa4093822, 0x299f31d0}});
+    Philox::counter_t e3{{0xd16cfe09, 0x94fdcceb, 0x5001e420, 0x24126ea1}};
+    if ( r1 != e1 || r2 != e2 || r3 != e3 ) {
+        std::cout << "%TEST_FAILED% time=0 testname=test1 (philox-test) "
+                  << "message=Known answers not reproduced." << std::endl;
+    }
+}
+
+/*
+ * Mean and variance of normally distributed numbers, and reproducibility.
+ */
+void test2() {
+    std::cout << "philox-test test 2" << std::endl;
+
+    Philox rng(20191115);
+    std::size_t n = 0;
+    real_t sum = 0.0, sum2 = 0.0;
+    for (std::uint64_t step = 0; step != 1000; ++step) {
+        for (std::uint32_t index = 0; index != 100; ++index) {
+            auto values = rng.normal(step, index);
+            for (auto v : values) {
+                sum += v;
+                sum2 += v * v;
+                n += 1;
+            }
+        }
+    }
+    real_t mean = sum / n;
+    real_t variance = sum2 / n - mean * mean;
+    std::cout << "Mean: " << mean << ", variance: " << variance << std::endl;
+    if ( std::fabs(mean) > 0.01 || std::fabs(variance - 1.0) > 0.01 ) {
+        std::cout << "%TEST_FAILED% time=0 testname=test2 (philox-test) "
+                  << "message=Mean or variance out of range." << std::endl;
+    }
+
+    Philox other(rng.seed());
+    if ( other.normal(12, 34, 1) != rng.normal(12, 34, 1) ||
+         rng.normal(12, 34, 1) == rng.normal(12, 34, 0) ) {
+        std::cout << "%TEST_FAILED% time=0 testname=test2 (philox-test) "
+                  << "message=Not reproducible." << std::endl;
+    }
+}
+
+int main(int argc, char** argv) {
+    std::cout << "%SUITE_STARTING% philox-test" << std::endl;
+    std::cout << "%SUITE_STARTED%" << std::endl;
+
+    std::cout << "%TEST_STARTED% test1 (philox-test)" << std::endl;
+    test1();
+    std::cout << "%TEST_FINISHED% time=0 test1 (philox-test)" << std::endl;
+
+    std::cout << "%TEST_STARTED% test2 (philox-test)" << std::endl;
+    test2();
+    std::cout << "%TEST_FINISHED% time=0 test2 (philox-test)" << std::endl;
+
+    std::cout << "%SUITE_FINISHED% time=0" << std::endl;
+
+    return (EXIT_SUCCESS);
+}
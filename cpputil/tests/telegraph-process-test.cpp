@@ -12,8 +12,12 @@
  */
 
 #include "simploce/util/telegraph-process.hpp"
+#include "simploce/util/poisson-process.hpp"
+#include "simploce/util/philox.hpp"
 #include <cstdlib>
 #include <iostream>
+#include <vector>
+#include <cmath>
 
 using namespace simploce;
 
@@ -33,6 +37,114 @@ void test2() {
     std::cout << "%TEST_FAILED% time=0 testname=test2 (telegraph-process-test) message=error message sample" << std::endl;
 }
 
+/*
+ * Batch increments: jump probability and values.
+ */
+void test3() {
+    std::cout << "telegraph-process-test test 3" << std::endl;
+    
+    const std::size_t n = 100000;
+    std::vector<int> currents(n);
+    for (std::size_t k = 0; k != n; ++k) {
+        currents[k] = ( k % 2 == 0 ? 1 : -1 );
+    }
+    Philox rng(2019);
+    auto dTs = TelegraphProcess::increments(currents, 0.1, 1.0, rng, 0);
+    std::size_t njumps = 0;
+    bool valid = dTs.size() == n;
+    for (std::size_t k = 0; valid && k != n; ++k) {
+        if ( dTs[k] != 0 ) {
+            njumps += 1;
+            valid = dTs[k] == -2 * currents[k];
+        }
+    }
+    real_t fraction = real_t(njumps) / real_t(n);
+    real_t expected = 1.0 - std::exp(-0.1);
+    std::cout << "Fraction of jumps: " << fraction << ", expected: " << expected << std::endl;
+    if ( !valid || std::fabs(fraction - expected) > 0.005 ) {
+        std::cout << "%TEST_FAILED% time=0 testname=test3 (telegraph-process-test) "
+                  << "message=Wrong batch increments." << std::endl;
+    }
+    
+    // Same seed and counter, same increments. Another counter, other increments.
+    if ( TelegraphProcess::increments(currents, 0.1, 1.0, Philox(2019), 0) != dTs ) {
+        std::cout << "%TEST_FAILED% time=0 testname=test3 (telegraph-process-test) "
+                  << "message=Batch increments not reproducible." << std::endl;
+    }
+    if ( TelegraphProcess::increments(currents, 0.1, 1.0, rng, 1) == dTs ) {
+        std::cout << "%TEST_FAILED% time=0 testname=test3 (telegraph-process-test) "
+                  << "message=Batch increments do not depend on counter." << std::endl;
+    }
+}
+
+/*
+ * Processes generated from a counter-based generator: reproducible, with the 
+ * expected jump probability and, for the asymmetric process, fraction of time 
+ * in the up state.
+ */
+void test4() {
+    std::cout << "telegraph-process-test test 4" << std::endl;
+    
+    const std::size_t n = 200000;
+    const stime_t dt = 0.01;
+    Philox rng(2019);
+    
+    auto values = TelegraphProcess::generate(dt, 1.0, n, 1, rng, 0);
+    std::size_t njumps = values[0].second == 1 ? 1 : 0;
+    bool valid = values.size() == n;
+    for (std::size_t k = 1; valid && k != n; ++k) {
+        valid = std::abs(values[k].second) == 1;
+        if ( values[k].second != values[k-1].second ) {
+            njumps += 1;
+        }
+    }
+    real_t fraction = real_t(njumps) / real_t(n);
+    real_t expected = 1.0 - std::exp(-dt());
+    std::cout << "Symmetric, fraction of jumps: " << fraction 
+              << ", expected: " << expected << std::endl;
+    if ( !valid || std::fabs(fraction - expected) > 0.001 ) {
+        std::cout << "%TEST_FAILED% time=0 testname=test4 (telegraph-process-test) "
+                  << "message=Wrong symmetric telegraph process." << std::endl;
+    }
+    if ( TelegraphProcess::generate(dt, 1.0, n, 1, Philox(2019), 0) != values ) {
+        std::cout << "%TEST_FAILED% time=0 testname=test4 (telegraph-process-test) "
+                  << "message=Symmetric telegraph process not reproducible." << std::endl;
+    }
+    
+    const rate_t up = 1.0, down = 3.0;
+    values = TelegraphProcess::generate(dt, up, down, n, 1, rng, 0);
+    std::size_t nup = 0;
+    for (const auto& value : values) {
+        if ( value.second > 0 ) {
+            nup += 1;
+        }
+    }
+    fraction = real_t(nup) / real_t(n);
+    real_t pup = 1.0 - std::exp(-up() * dt());
+    real_t pdown = 1.0 - std::exp(-down() * dt());
+    expected = pup / (pup + pdown);
+    std::cout << "Asymmetric, fraction of time up: " << fraction 
+              << ", expected: " << expected << std::endl;
+    if ( std::fabs(fraction - expected) > 0.03 ) {
+        std::cout << "%TEST_FAILED% time=0 testname=test4 (telegraph-process-test) "
+                  << "message=Wrong asymmetric telegraph process." << std::endl;
+    }
+    if ( TelegraphProcess::generate(dt, up, down, n, 1, Philox(2019), 0) != values ) {
+        std::cout << "%TEST_FAILED% time=0 testname=test4 (telegraph-process-test) "
+                  << "message=Asymmetric telegraph process not reproducible." << std::endl;
+    }
+    
+    auto counts = PoissonProcess::generate(dt, 1.0, n, rng, 1);
+    fraction = real_t(counts.back().second) / real_t(n);
+    expected = 1.0 - std::exp(-dt());
+    std::cout << "Poisson, fraction of increments: " << fraction 
+              << ", expected: " << expected << std::endl;
+    if ( std::fabs(fraction - expected) > 0.001 ) {
+        std::cout << "%TEST_FAILED% time=0 testname=test4 (telegraph-process-test) "
+                  << "message=Wrong Poisson process." << std::endl;
+    }
+}
+
 int main(int argc, char** argv) {
     std::cout << "%SUITE_STARTING% telegraph-process-test" << std::endl;
     std::cout << "%SUITE_STARTED%" << std::endl;
@@ -41,6 +153,14 @@ int main(int argc, char** argv) {
     test1();
     std::cout << "%TEST_FINISHED% time=0 test1 (telegraph-process-test)" << std::endl;
 
+    std::cout << "%TEST_STARTED% test3 (telegraph-process-test)" << std::endl;
+    test3();
+    std::cout << "%TEST_FINISHED% time=0 test3 (telegraph-process-test)" << std::endl;
+
+    std::cout << "%TEST_STARTED% test4 (telegraph-process-test)" << std::endl;
+    test4();
+    std::cout << "%TEST_FINISHED% time=0 test4 (telegraph-process-test)" << std::endl;
+
     //std::cout << "%TEST_STARTED% test2 (telegraph-process-test)\n" << std::endl;
     //test2();
     //std::cout << "%TEST_FINISHED% time=0 test2 (telegraph-process-test)" << std::endl;
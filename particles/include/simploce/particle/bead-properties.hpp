@@ -0,0 +1,81 @@
+/*
+ * The MIT License
+ *
+ * Copyright 2019 André H. Juffer, Biocenter Oulu
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ */
+
+
+/* 
+ * File:   bead-properties.hpp
+ * Author: André H. Juffer, Biocenter Oulu.
+ *
+ * Created on November 18, 2019, 10:05 AM
+ */
+
+#ifndef BEAD_PROPERTIES_HPP
+#define BEAD_PROPERTIES_HPP
+
+#include "ptypes.hpp"
+#include <vector>
+
+namespace simploce {
+    
+    /**
+     * Protonation states, charges and masses of all beads in a coarse grained 
+     * particle model, held in contiguous arrays and indexed by bead index. 
+     * Protonatable beads update their entries only when their protonation state
+     * changes, so that charge and mass values are not recomputed every time 
+     * they are read.
+     */
+    struct BeadProperties {
+        
+        /**
+         * Adds entries for a new bead.
+         * @param protonationState Protonation state. Always 0 for a regular bead.
+         * @param charge Charge value.
+         * @param mass Mass value.
+         */
+        void add(std::size_t protonationState, const charge_t& charge, const mass_t& mass)
+        {
+            protonationStates.push_back(protonationState);
+            charges.push_back(charge);
+            masses.push_back(mass);
+        }
+        
+        /**
+         * Number of bound protons.
+         */
+        std::vector<std::size_t> protonationStates;
+        
+        /**
+         * Effective charge values.
+         */
+        std::vector<charge_t> charges;
+        
+        /**
+         * Effective mass values.
+         */
+        std::vector<mass_t> masses;
+    };
+}
+
+#endif /* BEAD_PROPERTIES_HPP */
+
@@ -35,11 +35,13 @@
 #include "particle-model.hpp"
 #include "ptypes.hpp"
 #include <utility>
+#include <vector>
 
 namespace simploce {
     
     /**
-     * A physical system composed of regular and protonatable beads.
+     * A physical system composed of regular and protonatable beads. Protonation
+     * states, charges and masses of all beads are held in contiguous arrays.
      */
     class CoarseGrained : public ParticleModel<Bead, bead_group_t> {
     public:
@@ -146,6 +148,13 @@ namespace simploce {
          * @return Number.
          */
         std::size_t numberOfBeads() const;   
+        
+        /**
+         * Returns charge values of all beads, indexed by bead index. Values 
+         * of protonatable beads reflect their current protonation state.
+         * @return Charge values.
+         */
+        const std::vector<charge_t>& charges() const;
                 
     private:
         
@@ -158,6 +167,7 @@ namespace simploce {
         
         std::vector<dprot_bead_ptr_t> discrete_;
         std::vector<cprot_bead_ptr_t> continuous_;
+        bead_props_ptr_t props_;
     };    
     
     /**
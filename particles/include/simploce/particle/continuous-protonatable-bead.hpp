@@ -46,7 +46,9 @@ namespace simploce {
      * the bead, respectively. If the state is denoted as x, then the associated 
      * current I = dx/dt, where t is time. Here, x is in [0,1], where a value 
      * of 1(0) represents a fully (de)protonated state. A maximum of one 
-     * proton can be bound or released.
+     * proton can be bound or released. Charge and mass values are kept in the
+     * bead properties of the coarse grained particle model, and are only 
+     * updated when the state or the protonation state changes.
      */
     class ContinuousProtonatableBead : public Bead, Protonatable  {
     public:
@@ -111,9 +113,16 @@ namespace simploce {
                                    std::size_t protonationState,
                                    const spec_ptr_t &spec);
         
+        // Assigns bead properties, and sets the entries of this bead.
+        void attach_(const bead_props_ptr_t& props);
+        
+        // Updates entries of this bead in the bead properties.
+        void update_();
+        
         real_t x_;
         real_t I_;
         std::size_t protonationState_;
+        bead_props_ptr_t props_;
         
     };
     
@@ -41,7 +41,9 @@ namespace simploce {
     
     /**
      * Protonatable bead undergoing -discrete- or -discontinuous- changes in 
-     * mass and charge values. Can bind more that one proton.
+     * mass and charge values. Can bind more that one proton. Charge and mass 
+     * values are kept in the bead properties of the coarse grained particle 
+     * model, and are only updated when the protonation state changes.
      */
     class DiscreteProtonatableBead: public Bead, Protonatable {
     public:
@@ -81,8 +83,15 @@ namespace simploce {
                                    const std::string &name,
                                    std::size_t numberOfBoundProtons,
                                    const spec_ptr_t &spec);
+        
+        // Assigns bead properties, and sets the entries of this bead.
+        void attach_(const bead_props_ptr_t& props);
+        
+        // Updates entries of this bead in the bead properties.
+        void update_();
                
         std::size_t numberOfBoundProtons_;
+        bead_props_ptr_t props_;
     };
     
     /**
@@ -37,8 +37,11 @@
 #include "ptypes.hpp"
 #include "pconf.hpp"
 #include "simploce/util/util.hpp"
+#include "simploce/util/line-scanner.hpp"
 #include <memory>
 #include <vector>
+#include <unordered_map>
+#include <unordered_set>
 #include <stdexcept>
 #include <algorithm>
 #include <iostream>
@@ -130,11 +133,11 @@ namespace simploce {
         bool empty() const { return this->numberOfParticles() == 0; }
         
         /**
-         * Finds particle with given identifier.
+         * Finds particle with given identifier. Takes constant time.
          * @param id Identifier.
          * @return Particle, or nullptr if not found.
          */
-        p_ptr_t find(std::size_t id) const { return properties::find(id, all_); }
+        p_ptr_t find(std::size_t id) const;
         
         /**
          * Contains a particle with given identifier.
@@ -190,7 +193,7 @@ namespace simploce {
         /**
          * Constructor. No particles.
          */
-        ParticleModel() : all_{}, free_{}, groups_{} {}
+        ParticleModel() : all_{}, free_{}, groups_{}, ids_{}, groupSet_{} {}
         
         /**
          * Adds particle.
@@ -216,6 +219,12 @@ namespace simploce {
          */
         void readFreeAndGroups(std::istream& stream);
         
+        /**
+         * Updates the lookup of particles and groups by identifier. Must be 
+         * called after removing particles or groups via all() or groups().
+         */
+        void reindex();
+        
         /**
          * Returns groups.
          * @return 
@@ -237,15 +246,23 @@ namespace simploce {
         
         // Particles groups.
         std::vector<pg_ptr_t> groups_;
+        
+        // Particles by identifier.
+        std::unordered_map<std::size_t, p_ptr_t> ids_;
+        
+        // Particle groups, for detecting duplicates.
+        std::unordered_set<pg_ptr_t> groupSet_;
     };
     
     template <typename P, typename PG>
     ParticleModel<P,PG>::ParticleModel(ParticleModel&& pm) :
-        all_{}, free_{}, groups_{}
+        all_{}, free_{}, groups_{}, ids_{}, groupSet_{}
     {
         all_ = std::move(pm.all_);
         free_ = std::move(pm.free_);
         groups_ = std::move(pm.groups_);
+        ids_ = std::move(pm.ids_);
+        groupSet_ = std::move(pm.groupSet_);
     }
         
     template <typename P, typename PG>
@@ -254,9 +271,19 @@ namespace simploce {
         all_ = std::move(pm.all_);
         free_ = std::move(pm.free_);
         groups_ = std::move(pm.groups_);
+        ids_ = std::move(pm.ids_);
+        groupSet_ = std::move(pm.groupSet_);
         return *this;
     }
     
+    template <typename P, typename PG>
+    typename ParticleModel<P,PG>::p_ptr_t 
+    ParticleModel<P,PG>::find(std::size_t id) const
+    {
+        auto iter = ids_.find(id);
+        return iter != ids_.end() ? iter->second : nullptr;
+    }
+    
     template <typename P, typename PG>
     void 
     ParticleModel<P,PG>::resetForces()
@@ -313,6 +340,7 @@ namespace simploce {
             throw std::domain_error(msg);
         }
         all_.push_back(p);
+        ids_.emplace(p->id(), p);
     }
     
     template <typename P, typename PG>
@@ -339,72 +367,70 @@ namespace simploce {
                 );
             }
         }
-        for (auto g : groups_ ) {
-            if ( g == pg) {
-                throw std::domain_error(
-                    "Particle group already added to particle model."
-                );
-            }
+        if ( groupSet_.count(pg) > 0 ) {
+            throw std::domain_error(
+                "Particle group already added to particle model."
+            );
         }
         groups_.push_back(pg);
+        groupSet_.insert(pg);
+    }
+    
+    template <typename P, typename PG>
+    void
+    ParticleModel<P,PG>::reindex()
+    {
+        ids_.clear();
+        for (const auto& p : all_) {
+            ids_.emplace(p->id(), p);
+        }
+        groupSet_ = std::unordered_set<pg_ptr_t>(groups_.begin(), groups_.end());
     }
         
     template <typename P, typename PG>
     void
     ParticleModel<P,PG>::readFreeAndGroups(std::istream& stream)
     {
-        std::string stringBuffer;
+        LineScanner scanner{stream};
         
         // Read free particles.
-        std::size_t nfree;
-        stream >> nfree;
-        std::getline(stream, stringBuffer);  // Read EOL.
+        std::size_t nfree = scanner.size();
+        free_.reserve(nfree);
         for (std::size_t counter = 0; counter != nfree; ++counter) {
-            std::size_t id;
-            stream >> id;
+            std::size_t id = scanner.size();
             p_ptr_t particle = this->find(id);
             if ( particle == nullptr ) {
                 throw std::domain_error(util::toString(id) + ": No such free particle.");
             }
             free_.push_back(particle);
         }
-        if ( nfree > 0 ) {
-            std::getline(stream, stringBuffer);  // Read EOL.
-        }
         
         // Read particle groups.
-        std::size_t ngroups;
-        stream >> ngroups;
-        std::getline(stream, stringBuffer);  // Read EOL.
+        std::size_t ngroups = scanner.size();
+        groups_.reserve(ngroups);
         for ( std::size_t counter = 0; counter != ngroups; ++counter) {
             
             // Read constituting particles.
+            std::size_t nparticles = scanner.size();
             std::vector<p_ptr_t> particles;
-            std::size_t nparticles;
-            stream >> nparticles;
-            std::getline(stream, stringBuffer);  // Read EOL.
+            particles.reserve(nparticles);
             for (std::size_t j = 0; j != nparticles; ++j) {
-                std::size_t id;
-                stream >> id;
+                std::size_t id = scanner.size();
                 p_ptr_t particle = this->find(id);
                 if ( particle == nullptr ) {
                     throw std::domain_error(util::toString(id) + ": No such particle.");
                 }
                 particles.push_back(particle);
             }                        
-            std::getline(stream, stringBuffer);  // Read EOL.
             
             // Read bonds.
+            std::size_t nbonds = scanner.size();
             std::vector<id_pair_t> bonds;
-            std::size_t nbonds;
-            stream >> nbonds;
-            std::getline(stream, stringBuffer);  // Read EOL.
+            bonds.reserve(nbonds);
             for (std::size_t j = 0; j != nbonds; ++j) {
-                std::size_t id1, id2;
-                stream >> id1 >> id2;
-                id_pair_t bond = std::make_pair(id1, id2);
-                bonds.push_back(bond);
-                std::getline(stream, stringBuffer);  // Read EOL.
+                std::size_t id1 = scanner.size();
+                std::size_t id2 = scanner.size();
+                bonds.push_back(std::make_pair(id1, id2));
             }
             
             // Create the group.
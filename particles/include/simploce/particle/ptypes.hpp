@@ -51,6 +51,7 @@ namespace simploce {
     class CoarseGrained;
     class PolarizableWater;
     class ParticleModelFactory;
+    struct BeadProperties;
     
     template <typename P>
     class ParticleGroup;
@@ -184,6 +185,11 @@ namespace simploce {
      */
     using cprot_bead_ptr_t = std::shared_ptr<ContinuousProtonatableBead>;
     
+    /**
+     * Bead properties pointer type.
+     */
+    using bead_props_ptr_t = std::shared_ptr<BeadProperties>;
+    
     /**
      * Particle specification pointer type
      */
@@ -36,11 +36,14 @@
 #include "simploce/particle/particle-spec.hpp"
 #include "simploce/particle/particle-spec-catalog.hpp"
 #include "simploce/particle/particle-group.hpp"
-#include <boost/algorithm/string.hpp>
+#include "simploce/particle/bead-properties.hpp"
+#include "simploce/util/line-scanner.hpp"
 #include <boost/lexical_cast.hpp>
 #include <vector>
 #include <utility>
 #include <memory>
+#include <algorithm>
+#include <stdexcept>
 #include <iostream>
 
 namespace simploce {
@@ -51,7 +54,8 @@ namespace simploce {
     }
         
     CoarseGrained::CoarseGrained() :
-        ParticleModel<Bead,bead_group_t>{}, discrete_{}, continuous_{}
+        ParticleModel<Bead,bead_group_t>{}, discrete_{}, continuous_{},
+        props_{std::make_shared<BeadProperties>()}
     {        
     }
     
@@ -64,6 +68,7 @@ namespace simploce {
     {
         auto index = indexGenerator_(*this);
         bead_ptr_t bead = Bead::create(id, index, name, spec);
+        props_->add(0, spec->charge(), spec->mass());
         bead->position(r);
         if ( free ) {
             this->addFree(bead);
@@ -85,6 +90,8 @@ namespace simploce {
         auto index = indexGenerator_(*this);
         dprot_bead_ptr_t bead = 
             DiscreteProtonatableBead::create(id, index, name, protonationState, spec);
+        props_->add(0, spec->charge(), spec->mass());
+        bead->attach_(props_);
         bead->position(r);
         discrete_.push_back(bead);
         if ( free ) {
@@ -106,6 +113,8 @@ namespace simploce {
         auto index = indexGenerator_(*this);
         cprot_bead_ptr_t bead = 
             ContinuousProtonatableBead::create(id, index, name, protonationState, spec);
+        props_->add(0, spec->charge(), spec->mass());
+        bead->attach_(props_);
         bead->position(r);
         continuous_.push_back(bead);
         if ( free ) {
@@ -149,37 +158,41 @@ namespace simploce {
                             const spec_catalog_ptr_t& catalog)
     {
         cg_ptr_t cg = std::make_shared<CoarseGrained>();
+        LineScanner scanner{stream};
         
-        std::string stringBuffer;
+        std::size_t nbeads = scanner.size();
+        cg->all().reserve(nbeads);
         
-        std::size_t nbeads;
-        stream >> nbeads;
-        std::getline(stream, stringBuffer);  // Read EOL.
-                
-        const size_t bufferSize = conf::NAME_WIDTH;
-        char charBuffer[bufferSize];
+        // Specifications met so far. Models hold few different specifications,
+        // so this avoids a catalog lookup per bead.
+        std::vector<std::pair<std::string, spec_ptr_t>> specs{};
         
         // Read beads.
+        const std::size_t width = conf::NAME_WIDTH;
         for (std::size_t counter = 0; counter != nbeads; ++counter) {
-            stream.read(charBuffer, bufferSize);
-            std::string name = std::string(charBuffer, bufferSize);
-            boost::trim(name);
-            stream.read(charBuffer, bufferSize);
-            std::string specName = std::string(charBuffer, bufferSize);
-            boost::trim(specName);
-            spec_ptr_t spec = catalog->lookup(specName);
-            std::size_t id;
-            stream >> id;
-            real_t x, y, z, vx, vy, vz;
-            stream >> x >> y >> z >> vx >> vy >> vz;
+            if ( !scanner.next() ) {
+                throw std::domain_error("CoarseGrained: Unexpected end of particle model.");
+            }
+            std::string name = scanner.field(width);
+            std::string specName = scanner.field(width);
+            auto iter = std::find_if(specs.begin(), specs.end(), 
+                                     [&specName] (const std::pair<std::string, spec_ptr_t>& s) {
+                return s.first == specName;
+            });
+            if ( iter == specs.end() ) {
+                specs.push_back(std::make_pair(specName, catalog->lookup(specName)));
+                iter = specs.end() - 1;
+            }
+            const spec_ptr_t& spec = iter->second;
+            std::size_t id = scanner.size();
+            real_t x = scanner.real(), y = scanner.real(), z = scanner.real();
+            real_t vx = scanner.real(), vy = scanner.real(), vz = scanner.real();
             position_t r{x, y, z};
             velocity_t v{vx, vy, vz};
-            std::size_t protonatable;
-            stream >> protonatable;
+            std::size_t protonatable = scanner.size();
             if ( protonatable == conf::DISCRETELY_PROTONATABLE) {
                 // Discrete changes in protonation state.
-                std::size_t protonationState;            
-                stream >> protonationState;
+                std::size_t protonationState = scanner.size();
                 dprot_bead_ptr_t bead = 
                     cg->addDiscreteProtonatableBead(id, 
                                                     name, 
@@ -190,9 +203,9 @@ namespace simploce {
                 bead->velocity(v);
             } else if ( protonatable == conf::CONTINUOUSLY_PROTONATABLE) {
                 // Continuous change in protonation state.
-                std::size_t protonationState;
-                real_t x, I;
-                stream >> protonationState >> x >> I;
+                std::size_t protonationState = scanner.size();
+                real_t x = scanner.real();
+                real_t I = scanner.real();
                 cprot_bead_ptr_t bead =
                     cg->addContinuousProtonatableBead(id, name, r, protonationState, spec, false);
                 bead->velocity(v);
@@ -203,8 +216,6 @@ namespace simploce {
                 bead_ptr_t bead = cg->addBead(id, name, r, spec, false);
                 bead->velocity(v);
             }
-            
-            std::getline(stream, stringBuffer);  // Read EOL.
         }
                 
         cg->readFreeAndGroups(stream);
@@ -226,6 +237,12 @@ namespace simploce {
         return this->numberOfParticles();
     }
     
+    const std::vector<charge_t>&
+    CoarseGrained::charges() const
+    {
+        return props_->charges;
+    }
+    
     position_t
     CoarseGrained::removeGroup_()
     {
@@ -24,6 +24,7 @@
 
 #include "simploce/particle/continuous-protonatable-bead.hpp"
 #include "simploce/particle/pconf.hpp"
+#include "simploce/particle/bead-properties.hpp"
 #include <stdexcept>
 #include <iomanip>
 #include <cassert>
@@ -45,6 +46,7 @@ namespace simploce {
     {
         assert(x >= 0.0 && x <= 1.0);
         x_ = x;
+        this->update_();
     }
     
     real_t
@@ -62,37 +64,39 @@ namespace simploce {
     charge_t
     ContinuousProtonatableBead::charge() const
     {
-        // Fully deprotonated state.
-        charge_t charge = Particle::charge();
-        
-        // From state of transfer.
-        charge += x_ * conf::CHARGE_PROTON;
+        if ( props_ ) {
+            return props_->charges[this->index()];
+        }
         
-        return charge;
+        // Not (yet) part of a coarse grained particle model.
+        return Particle::charge() + x_ * conf::CHARGE_PROTON;
     }
     
     mass_t 
     ContinuousProtonatableBead::mass() const
     {
-        // Fully deprotonated state.
-        mass_t mass = Particle::mass();
-        
-        // From state of proton transfer process.
-        mass += x_ * conf::MASS_PROTON;
-        
-        return mass;
+        if ( props_ ) {
+            return props_->masses[this->index()];
+        }
+        return Particle::mass() + x_ * conf::MASS_PROTON;
     }
     
     void 
     ContinuousProtonatableBead::protonate()
     {
         protonationState_ = 1;
+        if ( props_ ) {
+            props_->protonationStates[this->index()] = protonationState_;
+        }
     }
     
     void 
     ContinuousProtonatableBead::deprotonate()
     {
         protonationState_ = 0;
+        if ( props_ ) {
+            props_->protonationStates[this->index()] = protonationState_;
+        }
     }
     
     bool 
@@ -133,6 +137,7 @@ namespace simploce {
     {
         Particle::readState(stream);
         stream >> protonationState_ >> x_ >> I_;        
+        this->update_();
     }
         
     cprot_bead_ptr_t 
@@ -156,12 +161,41 @@ namespace simploce {
                                                            const std::string &name,
                                                            std::size_t protonationState,
                                                            const spec_ptr_t &spec) :
-        Bead(id, index, name, spec), x_{0.0}, I_{0.0}, protonationState_{protonationState}
+        Bead(id, index, name, spec), x_{0.0}, I_{0.0}, protonationState_{protonationState},
+        props_{}
     {        
         if ( protonationState_ > 1 ) {
             throw std::domain_error("ProtonatingBead: Illegal protonation state.");
         }        
     }
+    
+    void
+    ContinuousProtonatableBead::attach_(const bead_props_ptr_t& props)
+    {
+        props_ = props;
+        this->update_();
+    }
+    
+    void
+    ContinuousProtonatableBead::update_()
+    {
+        if ( !props_ ) {
+            return;
+        }
+        std::size_t index = this->index();
+        
+        // Fully deprotonated state.
+        charge_t charge = Particle::charge();
+        mass_t mass = Particle::mass();
+        
+        // From state of proton transfer process.
+        charge += x_ * conf::CHARGE_PROTON;
+        mass += x_ * conf::MASS_PROTON;
+        
+        props_->protonationStates[index] = protonationState_;
+        props_->charges[index] = charge;
+        props_->masses[index] = mass;
+    }
         
     std::ostream& 
     operator << (std::ostream& stream, 
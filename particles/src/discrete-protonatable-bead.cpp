@@ -34,6 +34,7 @@
 #include "simploce/particle/particle-spec.hpp"
 #include "simploce/particle/bead.hpp"
 #include "simploce/particle/pconf.hpp"
+#include "simploce/particle/bead-properties.hpp"
 #include <stdexcept>
 
 namespace simploce {
@@ -45,30 +46,28 @@ namespace simploce {
     charge_t 
     DiscreteProtonatableBead::charge() const 
     {
-        // Fully deprotonated state.
-        charge_t charge = Particle::charge();
+        if ( props_ ) {
+            return props_->charges[this->index()];
+        }
         
-        // Correct for bound proton.
-        charge += this->protonationState() * conf::CHARGE_PROTON;
-        return charge;
+        // Not (yet) part of a coarse grained particle model.
+        return Particle::charge() + numberOfBoundProtons_ * conf::CHARGE_PROTON;
     }
     
     mass_t 
     DiscreteProtonatableBead::mass() const
     {
-        // Fully deprotonated state.
-        mass_t mass = Particle::mass();
-        
-        // Correct for bound proton.
-        mass += this->protonationState() * conf::MASS_PROTON;
-        
-        return mass;
+        if ( props_ ) {
+            return props_->masses[this->index()];
+        }
+        return Particle::mass() + numberOfBoundProtons_ * conf::MASS_PROTON;
     }
     
     void 
     DiscreteProtonatableBead::protonate()
     {
         numberOfBoundProtons_ += 1;
+        this->update_();
     }
     
     void 
@@ -80,6 +79,7 @@ namespace simploce {
             );
         }
         numberOfBoundProtons_ -= 1;              
+        this->update_();
     }
     
     bool 
@@ -117,6 +117,7 @@ namespace simploce {
     {
         Particle::readState(stream);
         stream >> numberOfBoundProtons_;        
+        this->update_();
     }
     
     dprot_bead_ptr_t 
@@ -146,10 +147,39 @@ namespace simploce {
                                                        const std::string& name,
                                                        std::size_t numberOfBoundProtons,
                                                        const spec_ptr_t& spec) :
-        Bead(id, index, name, spec), numberOfBoundProtons_(numberOfBoundProtons)
+        Bead(id, index, name, spec), numberOfBoundProtons_(numberOfBoundProtons),
+        props_{}
     {        
     }
     
+    void
+    DiscreteProtonatableBead::attach_(const bead_props_ptr_t& props)
+    {
+        props_ = props;
+        this->update_();
+    }
+    
+    void
+    DiscreteProtonatableBead::update_()
+    {
+        if ( !props_ ) {
+            return;
+        }
+        std::size_t index = this->index();
+        
+        // Fully deprotonated state.
+        charge_t charge = Particle::charge();
+        mass_t mass = Particle::mass();
+        
+        // Correct for bound protons.
+        charge += numberOfBoundProtons_ * conf::CHARGE_PROTON;
+        mass += numberOfBoundProtons_ * conf::MASS_PROTON;
+        
+        props_->protonationStates[index] = numberOfBoundProtons_;
+        props_->charges[index] = charge;
+        props_->masses[index] = mass;
+    }
+    
     std::ostream& 
     operator << (std::ostream& stream, 
                  const DiscreteProtonatableBead& bead)
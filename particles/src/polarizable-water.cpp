@@ -52,6 +52,7 @@ namespace simploce {
         for (auto iter = iters.begin(); iter != iters.end(); ++iter) {
             particles.erase(*iter);
         }
+        this->reindex();
         
         return r;
     }
@@ -21,6 +21,10 @@
 #include "simploce/util/file.hpp"
 #include <cstdlib>
 #include <iostream>
+#include <sstream>
+#include <string>
+#include <stdexcept>
+#include <cmath>
 
 /*
  * Simple C++ Test Suite
@@ -154,6 +158,55 @@ void test1()
     std::clog << std::endl;
 }
 
+/*
+ * Writes and reads back a particle model with free particles and groups.
+ */
+void test2()
+{
+    std::clog << "coarse-grained-test test 2" << std::endl;
+    
+    std::stringstream specs{"# header\n"
+                            "0          CW         22.0 0.46 0.2\n"
+                            "0          DP         14.0 -0.46 0.1\n"};
+    spec_catalog_ptr_t catalog = ParticleSpecCatalog::create(specs);
+    spec_ptr_t cw = catalog->lookup("CW");
+    spec_ptr_t dp = catalog->lookup("DP");
+    
+    const std::size_t ngroups = 1000;
+    CoarseGrained cg;
+    for (std::size_t k = 0; k != ngroups; ++k) {
+        position_t r{0.001 * k, 0.5, -0.25};
+        bead_ptr_t b1 = cg.addBead(2 * k + 1, "CW", r, cw, false);
+        bead_ptr_t b2 = cg.addBead(2 * k + 2, "DP", r + position_t{0.0, 0.1, 0.0}, dp, false);
+        cg.addBeadGroup(std::vector<bead_ptr_t>{b1, b2}, 
+                        std::vector<id_pair_t>{std::make_pair(b1->id(), b2->id())});
+    }
+    cg.addBead(2 * ngroups + 1, "CW", position_t{1.0, 2.0, 3.0}, cw, true);
+    
+    std::stringstream stream;
+    stream << cg << std::endl << "rest" << std::endl;
+    cg_ptr_t cg2 = CoarseGrained::readFrom(stream, catalog);
+    std::string rest;
+    std::getline(stream, rest);
+    
+    bool ok = cg2->numberOfParticles() == 2 * ngroups + 1 &&
+              cg2->numberOfFreeParticles() == 1 &&
+              cg2->numberOfParticleGroups() == ngroups && rest == "rest";
+    bead_ptr_t bead = cg2->find(2 * ngroups);
+    ok = ok && bead && bead->spec() == dp && bead->name() == "DP" &&
+         std::fabs(bead->position()[0] - 0.999) < 1.0e-06 &&
+         std::fabs(bead->position()[1] - 0.6) < 1.0e-06;
+    ok = ok && cg2->find(2 * ngroups + 2) == nullptr;
+    try {
+        cg2->addBead(7, "CW", position_t{}, cw);
+        ok = false;
+    } catch (std::domain_error& exception) {
+    }
+    if ( !ok ) {
+        std::clog << "%TEST_FAILED% time=0 testname=test2 (coarse-grained-test) "
+                  << "message=Particle model not reproduced." << std::endl;
+    }
+}
 
 int main(int argc, char** argv) {
     std::clog << "%SUITE_STARTING% coarse-grained-test" << std::endl;
@@ -163,6 +216,10 @@ int main(int argc, char** argv) {
     test1();
     std::clog << "%TEST_FINISHED% time=0 test1 (coarse-grained-test)" << std::endl;
 
+    std::clog << "%TEST_STARTED% test2 (coarse-grained-test)" << std::endl;
+    test2();
+    std::clog << "%TEST_FINISHED% time=0 test2 (coarse-grained-test)" << std::endl;
+
     std::clog << "%SUITE_FINISHED% time=0" << std::endl;
 
     return (EXIT_SUCCESS);
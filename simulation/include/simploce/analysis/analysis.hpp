@@ -60,7 +60,7 @@ namespace simploce {
          * Drives the analysis.
          * @param param Parameters, such as the number of states in the trajectory
          * to skip (parameter name is "skip") before carrying out the analysis.
-         * @param trajectory Input trajectory stream.
+         * @param trajectory Input trajectory stream, in any format of TrajectoryWriter.
          */
         void perform(const sim_param_t& param,
                      std::istream& trajectory);
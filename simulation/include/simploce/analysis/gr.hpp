@@ -152,7 +152,7 @@ namespace simploce {
         }
         
         // Upper limit for g(r).
-        rmax_ = util::cutoffDistance(box_);
+        rmax_ = 0.5 * box_->size();
         std::size_t nbins = rmax_() / dr_();
         hr_.resize(nbins, 0);
         volume_ = box_->volume();
@@ -0,0 +1,117 @@
+/*
+ * The MIT License
+ *
+ * Copyright 2019 André H. Juffer, Biocenter Oulu
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ */
+
+
+/*
+ * File:   adaptive-timestep.hpp
+ * Author: André H. Juffer, Biocenter Oulu.
+ *
+ * Created on November 21, 2019, 9:15 AM
+ */
+
+#ifndef ADAPTIVE_TIMESTEP_HPP
+#define ADAPTIVE_TIMESTEP_HPP
+
+#include "cg-displacer.hpp"
+#include "sim-data.hpp"
+#include "stypes.hpp"
+#include "simploce/particle/coarse-grained.hpp"
+#include <vector>
+
+namespace simploce {
+
+    /**
+     * Adapts the time step of another displacer (e.g. velocity Verlet or 
+     * Langevin velocity Verlet) from step to step. The time step for the next 
+     * step is bounded by (1) a maximum displacement of any particle ("dxmax"), 
+     * predicted from current velocities and forces, and (2) an estimate of the 
+     * local energy error ("etol", per particle). The latter is the error of the 
+     * trapezoidal rule for the work done by the forces along the step, 
+     * |dU + (F(n) + F(n+1)).(r(n+1) - r(n)) / 2|, which scales as dt^3, does not 
+     * depend on any thermostat, and picks up sudden changes of the potential 
+     * energy, such as due to proton transfer. The time step is reduced at once, 
+     * but grows slowly, and always remains in [dtmin, dtmax]. The initial time 
+     * step is given by "timestep".
+     * @param M Particle model type.
+     */
+    template <typename M>
+    class AdaptiveTimestep;
+
+    /**
+     * Specialization for coarse grained particle model.
+     */
+    template <>
+    class AdaptiveTimestep<CoarseGrained> : public CoarseGrainedDisplacer {
+    public:
+
+        /**
+         * Constructor.
+         * @param displacer Displacer whose time step is adapted. Must read 
+         * the time step from the simulation parameters at every step.
+         */
+        AdaptiveTimestep(const cg_displacer_ptr_t& displacer);
+
+        /**
+         * Displaces beads of a coarse grained model, by one step of the 
+         * adapted time step.
+         * @param param Simulation parameters.
+         * @param cg Coarse grained particle model.
+         * @return kinetic, potential energy, temperature, and time step.
+         */
+        SimulationData displace(const sim_param_t& param,
+                                const cg_ptr_t& cg) const override;
+
+        /**
+         * Returns identifier, conf::ADAPTIVE_TIMESTEP followed by '-' and the 
+         * identifier of the wrapped displacer, e.g. 'adaptive-lvv'.
+         * @return Identifier.
+         */
+        std::string id() const override;
+
+        void writeCheckpoint(std::ostream& stream) const override;
+
+        void readCheckpoint(std::istream& stream, const cg_ptr_t& cg) override;
+
+    private:
+
+        cg_displacer_ptr_t displacer_;
+
+        mutable bool setup_;
+        mutable stime_t t_;
+        mutable stime_t dt_;
+        mutable stime_t dtmin_;
+        mutable stime_t dtmax_;
+        mutable real_t dxmax_;
+        mutable real_t etol_;
+
+        // Potential energy, positions and forces at time t(n).
+        mutable bool previous_;
+        mutable real_t epot_;
+        mutable std::vector<position_t> ris_;
+        mutable std::vector<force_t> fis_;
+    };
+}
+
+#endif /* ADAPTIVE_TIMESTEP_HPP */
+
@@ -0,0 +1,96 @@
+/*
+ * The MIT License
+ *
+ * Copyright 2019 André H. Juffer, Biocenter Oulu
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ */
+
+/*
+ * File:   baoab.hpp
+ * Author: André H. Juffer, Biocenter Oulu.
+ *
+ * Created on November 18, 2019, 10:05 AM
+ */
+
+#ifndef BAOAB_HPP
+#define BAOAB_HPP
+
+#include "cg-displacer.hpp"
+#include "sim-data.hpp"
+#include "stypes.hpp"
+#include "simploce/particle/coarse-grained.hpp"
+#include "simploce/util/philox.hpp"
+
+namespace simploce {
+
+    /**
+     * Displaces particles according to the BAOAB splitting of the Langevin 
+     * equation: half kick (B), half drift (A), exact Ornstein-Uhlenbeck velocity 
+     * update (O), half drift (A), and half kick (B). Provides for a canonical 
+     * ensemble (NVT constant) simulation, with accurate configurational 
+     * sampling at larger time steps. Requires force field, temperature, time step 
+     * and damping rate ("gamma"). A change of the temperature in the simulation 
+     * parameters is picked up in the next step. The random noise is reproducible
+     * for a given simulation parameter "seed". Bond constraints are not supported.
+     * @see <a href="https://doi.org/10.1093/amrx/abs010">
+     *   B. Leimkuhler and C. Matthews, Appl. Math. Res. eXpress, 2013, 34-56, 2013.
+     * </a>
+     * @param M Particle model type.
+     */
+    template <typename M>
+    class BAOAB;
+
+    /**
+     * Specialization for coarse grained particle model.
+     */
+    template <>
+    class BAOAB<CoarseGrained> : public CoarseGrainedDisplacer {
+    public:
+
+        BAOAB(const cg_interactor_ptr_t& interactor);
+
+        /**
+         * Displaces beads of a coarse grained model.
+         * @param cg Coarse grained particle model.
+         * @return kinetic, potential energy, and temperature.
+         */
+        SimulationData displace(const sim_param_t& param,
+                                const cg_ptr_t& cg) const override;
+
+        std::string id() const override;
+
+        void writeCheckpoint(std::ostream& stream) const override;
+
+        void readCheckpoint(std::istream& stream, const cg_ptr_t& cg) override;
+
+    private:
+
+        cg_interactor_ptr_t interactor_;
+
+        mutable bool setup_;
+        mutable std::size_t counter_;
+        mutable stime_t dt_;
+        mutable real_t gamma_;
+        mutable Philox rng_;
+    };
+}
+
+#endif /* BAOAB_HPP */
+
@@ -35,6 +35,7 @@
 #include "displacer.hpp"
 #include "sim-data.hpp"
 #include "stypes.hpp"
+#include <iostream>
 
 namespace simploce {
     
@@ -54,6 +55,20 @@ namespace simploce {
         virtual SimulationData displace(const sim_param_t& param, 
                                         const cg_ptr_t& cg) const = 0;        
         
+        /**
+         * Writes internal state, such as step counters and the seed of the 
+         * random number generator, in binary form to a checkpoint.
+         * @param stream Output stream.
+         */
+        virtual void writeCheckpoint(std::ostream& stream) const = 0;
+        
+        /**
+         * Restores internal state written by writeCheckpoint().
+         * @param stream Input stream.
+         * @param cg Coarse grained particle model, in its checkpointed state.
+         */
+        virtual void readCheckpoint(std::istream& stream, const cg_ptr_t& cg) = 0;
+        
     };
 }
 
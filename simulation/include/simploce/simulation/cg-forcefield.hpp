@@ -36,6 +36,7 @@
 #include "pair-lists.hpp"
 #include "stypes.hpp"
 #include <utility>
+#include <stdexcept>
 #include <vector>
 
 namespace simploce {
@@ -53,14 +54,18 @@ namespace simploce {
          * @param all All beads.
          * @param free Free beads.
          * @param groups All bead groups.
+         * @param charges Charge values of all beads, indexed by bead index.
          * @param pairLists Pair lists.
+         * @param virial Virial tensor. If not null, pair contributions are added.
          * @return Bonded and non-bonded potential energy.
          */
         virtual std::pair<energy_t, energy_t> 
         interact(const std::vector<bead_ptr_t>& all,
                  const std::vector<bead_ptr_t>& free,
                  const std::vector<bead_group_ptr_t>& groups,
-                 const PairLists<Bead>& pairLists) = 0;
+                 const std::vector<charge_t>& charges,
+                 const PairLists<Bead>& pairLists,
+                 virial_t* virial) = 0;
         
         /**
          * Computes forces due to bonded interactions on beads. Updates/adds forces 
@@ -69,14 +74,34 @@ namespace simploce {
          * @param free Free beads.
          * @param groups  All bead groups.
          * @param pairLists Pair lists.
+         * @param virial Virial tensor. If not null, pair contributions are added.
          * @return Potential energy for bonded interactions.
          */
         virtual energy_t 
         bonded(const std::vector<bead_ptr_t>& all,
                const std::vector<bead_ptr_t>& free,
                const std::vector<bead_group_ptr_t>& groups,
-               const PairLists<Bead>& pairLists) = 0;
+               const PairLists<Bead>& pairLists,
+               virial_t* virial) = 0;
         
+        /**
+         * Computes forces due to non-bonded interactions on beads. Updates/adds 
+         * non-bonded forces acting on beads.
+         * @param all All beads.
+         * @param free Free beads.
+         * @param groups  All bead groups.
+         * @param charges Charge values of all beads, indexed by bead index.
+         * @param pairLists Pair lists.
+         * @param virial Virial tensor. If not null, pair contributions are added.
+         * @return Potential energy for non-bonded interactions.
+         */
+        virtual energy_t 
+        nonBonded(const std::vector<bead_ptr_t>& all,
+                  const std::vector<bead_ptr_t>& free,
+                  const std::vector<bead_group_ptr_t>& groups,
+                  const std::vector<charge_t>& charges,
+                  const PairLists<Bead>& pairLists,
+                  virial_t* virial) = 0;
         
         /**
          * Returns the interaction energy of given bead with all other beads.
@@ -84,13 +109,49 @@ namespace simploce {
          * @param all All beads.
          * @param free Free beads.
          * @param groups bead groups.
+         * @param charges Charge values of all beads, indexed by bead index.
          * @return Bonded and non-bonded interaction energy (potential energy).
          */
         virtual std::pair<energy_t, energy_t> 
         interact(const bead_ptr_t& bead,
                  const std::vector<bead_ptr_t>& all,
                  const std::vector<bead_ptr_t>& free,
-                 const std::vector<bead_group_ptr_t>& groups) = 0;
+                 const std::vector<bead_group_ptr_t>& groups,
+                 const std::vector<charge_t>& charges) = 0;
+        
+        /**
+         * Corrects forces and non-bonded potential energy for changes in bead
+         * charges, e.g. upon (de)protonation, since the last force calculation. 
+         * Only interactions of these beads with beads in the pair lists are 
+         * recomputed, so that the cost is proportional to the number of 
+         * neighbors. Updates/adds forces acting on beads.
+         * @param changed Beads with changed charges, and their previous charges.
+         * @param pairLists Pair lists of the last force calculation.
+         * @param virial Virial tensor. If not null, pair contributions are added.
+         * @return Change in non-bonded potential energy.
+         */
+        virtual energy_t
+        chargesChanged(const std::vector<std::pair<bead_ptr_t, charge_t>>& changed,
+                       const PairLists<Bead>& pairLists,
+                       virial_t* virial) = 0;
+        
+        /**
+         * Returns the length of bonds in particle groups, e.g. for holding 
+         * bond lengths fixed. Throws std::domain_error by default, for force 
+         * fields without bonds.
+         * @return Bond length.
+         */
+        virtual length_t bondLength() const
+        {
+            throw std::domain_error(this->id() + ": Force field defines no bond length.");
+        }
+        
+        /**
+         * Sets the cutoff distance for non-bonded interactions. Ignored by 
+         * default, for force fields without non-bonded interactions.
+         * @param rc Cutoff distance. If not positive, half the box size is used.
+         */
+        virtual void cutoffDistance(const length_t& rc) {}
         
     };
 }
@@ -60,23 +60,48 @@ namespace simploce {
         interact(const std::vector<bead_ptr_t>& all,
                  const std::vector<bead_ptr_t>& free,
                  const std::vector<bead_group_ptr_t>& groups,
-                 const PairLists<Bead>& pairLists) override;
+                 const std::vector<charge_t>& charges,
+                 const PairLists<Bead>& pairLists,
+                 virial_t* virial) override;
         
         energy_t bonded(const std::vector<bead_ptr_t>& all,
                         const std::vector<bead_ptr_t>& free,
                         const std::vector<bead_group_ptr_t>& groups,
-                        const PairLists<Bead>& pairLists) override;
+                        const PairLists<Bead>& pairLists,
+                        virial_t* virial) override;
+
+        energy_t nonBonded(const std::vector<bead_ptr_t>& all,
+                           const std::vector<bead_ptr_t>& free,
+                           const std::vector<bead_group_ptr_t>& groups,
+                           const std::vector<charge_t>& charges,
+                           const PairLists<Bead>& pairLists,
+                           virial_t* virial) override;
         
         std::pair<energy_t, energy_t> 
         interact(const bead_ptr_t& bead,
                  const std::vector<bead_ptr_t>& all,
                  const std::vector<bead_ptr_t>& free,
-                 const std::vector<bead_group_ptr_t>& groups) override;
+                 const std::vector<bead_group_ptr_t>& groups,
+                 const std::vector<charge_t>& charges) override;
+        
+        /**
+         * There are no electrostatic interactions.
+         * @return 0.0.
+         */
+        energy_t chargesChanged(const std::vector<std::pair<bead_ptr_t, charge_t>>& changed,
+                                const PairLists<Bead>& pairLists,
+                                virial_t* virial) override;
         
         std::string id() const override;
         
         std::pair<lj_params_t, el_params_t> parameters() const override;
         
+        /**
+         * Returns reference bond length.
+         * @return Length, in nm.
+         */
+        length_t bondLength() const override;
+        
         
     private:
         
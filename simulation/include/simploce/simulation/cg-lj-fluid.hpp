@@ -50,19 +50,34 @@ namespace simploce {
         interact(const std::vector<bead_ptr_t>& all,
                  const std::vector<bead_ptr_t>& free,
                  const std::vector<bead_group_ptr_t>& groups,
-                 const PairLists<Bead>& pairLists) override;
+                 const std::vector<charge_t>& charges,
+                 const PairLists<Bead>& pairLists,
+                 virial_t* virial) override;
         
         energy_t 
         bonded(const std::vector<bead_ptr_t>& all,
                const std::vector<bead_ptr_t>& free,
                const std::vector<bead_group_ptr_t>& groups,
-               const PairLists<Bead>& pairLists) override;
+               const PairLists<Bead>& pairLists,
+               virial_t* virial) override;
+
+        energy_t nonBonded(const std::vector<bead_ptr_t>& all,
+                           const std::vector<bead_ptr_t>& free,
+                           const std::vector<bead_group_ptr_t>& groups,
+                           const std::vector<charge_t>& charges,
+                           const PairLists<Bead>& pairLists,
+                           virial_t* virial) override;
         
         std::pair<energy_t, energy_t> 
         interact(const bead_ptr_t& bead,
                  const std::vector<bead_ptr_t>& all,
                  const std::vector<bead_ptr_t>& free,
-                 const std::vector<bead_group_ptr_t>& groups) override;
+                 const std::vector<bead_group_ptr_t>& groups,
+                 const std::vector<charge_t>& charges) override;
+        
+        energy_t chargesChanged(const std::vector<std::pair<bead_ptr_t, charge_t>>& changed,
+                                const PairLists<Bead>& pairLists,
+                                virial_t* virial) override;
         
         std::string 
         id() const override;
@@ -70,11 +85,17 @@ namespace simploce {
         std::pair<lj_params_t, el_params_t> 
         parameters() const override;
         
+        void 
+        cutoffDistance(const length_t& rc) override;
+        
     private:
         
         spec_catalog_ptr_t catalog_;
         bc_ptr_t bc_;
         box_ptr_t box_;
+        lj_params_t ljParams_;
+        el_params_t elParams_;
+        cg_ff_ptr_t ljCoulombForces_;
     };
     
 }
@@ -0,0 +1,115 @@
+/*
+ * The MIT License
+ *
+ * Copyright 2019 André H. Juffer, Biocenter Oulu
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ */
+
+/*
+ * File:   checkpoint.hpp
+ * Author: André H. Juffer, Biocenter Oulu.
+ *
+ * Created on November 30, 2019, 9:40 AM
+ */
+
+#ifndef CHECKPOINT_HPP
+#define CHECKPOINT_HPP
+
+#include "stypes.hpp"
+#include <csignal>
+#include <string>
+
+namespace simploce {
+    
+    /**
+     * Binary checkpoint of a simulation, holding the full state of a simulation 
+     * model: positions, velocities, forces, protonation states, as well as the 
+     * state of the interactor (pair lists, counters) and of the displacer 
+     * (step counters, random number generator seeds, proton transfer state). 
+     * A simulation continued from a checkpoint is identical to an 
+     * uninterrupted one. A checkpoint is written atomically, by writing to a 
+     * temporary file first which then replaces the checkpoint file, so that 
+     * a valid checkpoint exists at any time. It is read with a single bulk 
+     * read. Data is in native byte order, checkpoints are therefore not 
+     * portable between platforms.
+     * @param P Particle type.
+     */
+    template <typename P>
+    class Checkpoint;
+    
+    /**
+     * Specialization for beads.
+     */
+    template <>
+    class Checkpoint<Bead> {
+    public:
+        
+        /**
+         * Constructor.
+         * @param fileName Checkpoint file name.
+         * @param ncheckpoint Number of steps between checkpoints. If 0, 
+         * checkpoints are only written upon request.
+         */
+        Checkpoint(const std::string& fileName, std::size_t ncheckpoint = 0);
+        
+        /**
+         * Writes checkpoint.
+         * @param sm Simulation model.
+         * @param step Step number of the last completed step.
+         */
+        void write(const cg_sim_model_ptr_t& sm, std::size_t step);
+        
+        /**
+         * Restores simulation model from checkpoint.
+         * @param sm Simulation model. Must be the same as the one for which 
+         * the checkpoint was written.
+         * @return Step number of the last completed step.
+         */
+        std::size_t read(const cg_sim_model_ptr_t& sm) const;
+        
+        /**
+         * Returns whether a checkpoint is due after the given step.
+         * @param step Step number.
+         * @return Result.
+         */
+        bool due(std::size_t step) const;
+        
+        /**
+         * Requests a checkpoint. Safe to call from a signal handler.
+         */
+        static void request();
+        
+        /**
+         * Returns whether a checkpoint was requested and not written yet.
+         * @return Result.
+         */
+        static bool requested();
+        
+    private:
+        
+        static volatile std::sig_atomic_t requested_;
+        
+        std::string fileName_;
+        std::size_t ncheckpoint_;
+    };
+}
+
+#endif /* CHECKPOINT_HPP */
+
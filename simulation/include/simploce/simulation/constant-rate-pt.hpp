@@ -33,11 +33,19 @@
 #define CONSTANT_RATE_PT_HPP
 
 #include "pt.hpp"
+#include "simploce/util/philox.hpp"
+#include <vector>
+#include <cstdint>
 
 namespace simploce {
     
     /**
-     * Transfer protons with the same constant proton transfer event rate.
+     * Transfer protons with the same constant proton transfer event rate. 
+     * Pairs are colored such that pairs of the same color share no bead, and 
+     * pairs of one color are handled concurrently for large pair lists. Jumps
+     * are reproducible for a given simulation parameter "seed". Since at most
+     * one jump is drawn per pair and transfer, events are timed at the start 
+     * of the time steps covered by the transfer.
      */
     class ConstantRateProtonTransfer : public ProtonTransfer {
     public:
@@ -57,12 +65,66 @@ namespace simploce {
         
         void transfer(const sim_param_t& param,
                       const std::vector<cprot_bead_ptr_t>& continuous,
-                      const prot_pair_list_t& pairList) const override;
+                      const prot_pair_list_t& pairList,
+                      std::vector<ProtonationEvent>& events) const override;
         
-    private:
+        /**
+         * Colors pairs. Must be called whenever the pair list is regenerated,
+         * also if its size is unchanged. Otherwise, pairs are colored at the 
+         * first transfer only.
+         * @param pairList New pair list.
+         */
+        void update(const prot_pair_list_t& pairList) const override;
+        
+        void writeCheckpoint(std::ostream& stream) const override;
+        
+        void readCheckpoint(std::istream& stream, const prot_pair_list_t& pairList) override;
+        
+    protected:
+        
+        /**
+         * Returns zero changes in protonation state, per bead index.
+         * @param continuous Protonatable beads with continuously varying 
+         * protonation states.
+         * @return Changes, sized by the largest bead index.
+         */
+        static std::vector<int> changes_(const std::vector<cprot_bead_ptr_t>& continuous);
+        
+        /**
+         * Updates continuous protonation states and currents, and velocities 
+         * due to mass transfer, after proton transfers. The relaxation of the
+         * current over the time steps following the transfers, without 
+         * further transfers, is integrated analytically.
+         * @param continuous Protonatable beads with continuously varying 
+         * protonation states.
+         * @param pairList Pairs of protonatables possibly involved in proton transfer.
+         * @param dX Change in protonation state, per bead index.
+         * @param dt Time step.
+         * @param nsteps Number of time steps covered.
+         */
+        void relax_(const std::vector<cprot_bead_ptr_t>& continuous,
+                    const prot_pair_list_t& pairList,
+                    const std::vector<int>& dX,
+                    const stime_t& dt,
+                    std::size_t nsteps) const;
         
         rate_t rate_;
         real_t gamma_;
+        
+        // Start of the time steps covered by the next transfer.
+        mutable real_t t_;
+        
+    private:
+        
+        // Pair indices, per color.
+        mutable std::vector<std::vector<std::size_t>> colors_;
+        mutable bool colored_;
+        mutable std::size_t ncolored_;
+        
+        // Generator of jumps, and number of batches of jumps drawn.
+        mutable bool seeded_;
+        mutable Philox jumps_;
+        mutable std::uint64_t nbatches_;
     };
 }
 
@@ -0,0 +1,100 @@
+/*
+ * The MIT License
+ *
+ * Copyright 2019 André H. Juffer, Biocenter Oulu
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ */
+
+
+/*
+ * File:   coordinate-codec.hpp
+ * Author: André H. Juffer, Biocenter Oulu.
+ *
+ * Created on November 19, 2019, 10:05 AM
+ */
+
+#ifndef COORDINATE_CODEC_HPP
+#define COORDINATE_CODEC_HPP
+
+#include "stypes.hpp"
+#include <vector>
+#include <array>
+#include <cstdint>
+
+namespace simploce {
+    
+    /**
+     * Lossy compression of positions, similar to the XTC format of GROMACS. 
+     * Positions are quantized to a given precision. In a key frame, particles
+     * are sorted along a space-filling (Morton) curve, and each quantized 
+     * position is encoded as difference to the one of the preceding particle 
+     * in that order. In any other frame, differences to the quantized positions
+     * of the previous frame are encoded, in the same order. Differences are 
+     * entropy coded with adaptive Golomb-Rice codes. Encoder and decoder keep
+     * the previous frame, so frames must be encoded and decoded in the same 
+     * sequence, starting with a key frame.
+     */
+    class CoordinateCodec {
+    public:
+        
+        /**
+         * Constructor.
+         * @param precision Precision of positions. Must be positive.
+         */
+        CoordinateCodec(const length_t& precision = length_t{0.001});
+        
+        /**
+         * Encodes positions.
+         * @param rs Positions, indexed by particle index.
+         * @param key If true, encodes a key frame, which does not depend on the
+         * previous frame. Always true for the first frame.
+         * @return Encoded positions.
+         */
+        std::vector<std::uint8_t> encode(const std::vector<position_t>& rs, bool key);
+        
+        /**
+         * Decodes positions.
+         * @param bytes Encoded positions.
+         * @param size Number of bytes.
+         * @param rs Positions, indexed by particle index. Resized if required.
+         */
+        void decode(const std::uint8_t* bytes, std::size_t size, std::vector<position_t>& rs);
+        
+        /**
+         * Returns precision.
+         * @return Precision.
+         */
+        length_t precision() const;
+        
+    private:
+        
+        using qpos_t = std::array<std::int32_t, 3>;
+        
+        real_t precision_;
+        
+        // Quantized positions of the previous frame, indexed by particle index.
+        std::vector<qpos_t> previous_;
+        
+        // Particle indices, in the order of the last key frame.
+        std::vector<std::uint32_t> order_;
+    };
+}
+
+#endif /* COORDINATE_CODEC_HPP */
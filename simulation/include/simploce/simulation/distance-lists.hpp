@@ -60,10 +60,14 @@ namespace simploce {
                  const std::vector<atom_ptr_t>& free,
                  const std::vector<atom_group_ptr_t>& groups) const override;
         
+        void 
+        cutoffDistance(const length_t& rc) override;
+        
     private:
         
         box_ptr_t box_;
         bc_ptr_t bc_;
+        length_t rc_;
                 
     };
     
@@ -83,10 +87,14 @@ namespace simploce {
                  const std::vector<bead_ptr_t>& free,
                  const std::vector<bead_group_ptr_t>& groups) const override;
         
+        void 
+        cutoffDistance(const length_t& rc) override;
+        
     private:
         
         box_ptr_t box_;
         bc_ptr_t bc_;
+        length_t rc_;
                 
     };
 }
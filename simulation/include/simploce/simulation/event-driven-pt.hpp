@@ -0,0 +1,125 @@
+/*
+ * The MIT License
+ *
+ * Copyright 2019 André H. Juffer, Biocenter Oulu
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ */
+
+
+/* 
+ * File:   event-driven-pt.hpp
+ * Author: André H. Juffer, Biocenter Oulu.
+ *
+ * Created on November 26, 2019, 9:15 AM
+ */
+
+#ifndef EVENT_DRIVEN_PT_HPP
+#define EVENT_DRIVEN_PT_HPP
+
+#include "constant-rate-pt.hpp"
+#include "simploce/util/philox.hpp"
+#include <map>
+#include <queue>
+#include <tuple>
+#include <utility>
+#include <vector>
+#include <functional>
+
+namespace simploce {
+    
+    /**
+     * Transfers protons with the same constant proton transfer event rate, 
+     * as ConstantRateProtonTransfer, but event-driven (kinetic Monte Carlo). 
+     * Every pair in the pair list carries the time of its next event, drawn 
+     * from an exponential distribution, and pairs are kept in a priority queue 
+     * ordered by event time. Per step, only events falling within the step are 
+     * fired, in order of their times, such that the cost is proportional to the 
+     * number of events rather than to the number of pairs. An event transfers 
+     * the proton if exactly one of the beads is protonated at that time, and 
+     * is otherwise void. Since the rate does not depend on the state, this is 
+     * exact. When the pair list is regenerated, only pairs that entered the 
+     * list are scheduled; pairs that remain in the list keep their event time.
+     * @see <a href="https://doi.org/10.1021/j100540a008">
+     *   D. T. Gillespie, J. Phys. Chem., 81, 2340-2361, 1977.
+     * </a>
+     */
+    class EventDrivenProtonTransfer : public ConstantRateProtonTransfer {
+    public:
+        
+        /**
+         * Default constructor with default values for rate and gamma.
+         */
+        EventDrivenProtonTransfer();
+        
+        /**
+         * Constructor
+         * @param rate Rate.
+         * @param gamma gamma^-1 is time constant of decay.
+         */
+        EventDrivenProtonTransfer(const rate_t& rate, 
+                                  const real_t& gamma);
+        
+        /**
+         * Fires all events within one time step. If provided, the simulation 
+         * parameter "seed" seeds random numbers at the first call. Events are 
+         * reported at their own times.
+         */
+        void transfer(const sim_param_t& param,
+                      const std::vector<cprot_bead_ptr_t>& continuous,
+                      const prot_pair_list_t& pairList,
+                      std::vector<ProtonationEvent>& events) const override;
+        
+        void update(const prot_pair_list_t& pairList) const override;
+        
+        void writeCheckpoint(std::ostream& stream) const override;
+        
+        void readCheckpoint(std::istream& stream, const prot_pair_list_t& pairList) override;
+        
+    private:
+        
+        using prot_pair_t = ProtonTransferPairListGenerator::prot_pair_t;
+        
+        using key_t = std::pair<std::size_t, std::size_t>;
+        
+        // Event time, pair, and version of the pair's schedule.
+        using event_t = std::tuple<real_t, key_t, std::size_t>;
+        
+        struct Entry {
+            prot_pair_t pair;
+            real_t time;
+            std::size_t version;
+        };
+        
+        real_t nextTime_(real_t t) const;
+        
+        void schedule_(const key_t& key, Entry& entry) const;
+        
+        void compact_() const;
+        
+        mutable bool setup_;
+        mutable Philox rng_;
+        mutable std::uint64_t ndraws_;
+        mutable std::map<key_t, Entry> pairs_;
+        mutable std::priority_queue<event_t, std::vector<event_t>, std::greater<event_t>> events_;
+    };
+}
+
+#endif /* EVENT_DRIVEN_PT_HPP */
+
@@ -0,0 +1,108 @@
+/*
+ * The MIT License
+ *
+ * Copyright 2019 André H. Juffer, Biocenter Oulu
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ */
+
+
+/*
+ * File:   hmc.hpp
+ * Author: André H. Juffer, Biocenter Oulu.
+ *
+ * Created on November 25, 2019, 10:05 AM
+ */
+
+#ifndef HMC_HPP
+#define HMC_HPP
+
+#include "stypes.hpp"
+#include "simploce/particle/bead.hpp"
+#include "simploce/util/philox.hpp"
+#include <iostream>
+
+namespace simploce {
+    
+    /**
+     * Hybrid Monte Carlo. Every step, velocities are drawn from the 
+     * Maxwell-Boltzmann distribution, the system is propagated over a short 
+     * trajectory by velocity Verlet, and the end point is accepted or rejected 
+     * on the change in total energy. This samples the canonical ensemble 
+     * exactly, with moves of all particles at once. If rejected, positions and
+     * forces are restored.
+     * @see <a href="https://doi.org/10.1016/0370-2693(87)91197-X">
+     *   S. Duane et al., Phys. Lett. B, 195, 216-222, 1987.
+     * </a>
+     * @param P Particle type.
+     */
+    template <typename P>
+    class HMC;
+    
+    /**
+     * Specialization for beads.
+     */
+    template <>
+    class HMC<Bead> {
+    public:
+        
+        /**
+         * Constructor.
+         * @param sm Simulation model. Its displacer is replaced by velocity 
+         * Verlet during perform(), and restored afterwards, also if perform() 
+         * throws.
+         */
+        HMC(const cg_sim_model_ptr_t& sm);
+        
+        /**
+         * Performs the simulation.
+         * @param param Parameters. Must provide,
+         * <ul>
+         *  <li>nsteps: Number of steps (trajectories).</li>
+         *  <li>
+         *      nwrite: Number of steps between writing simulation data and saving state
+         *      in the trajectectory.
+         *  </li>
+         *  <li>nmd: Number of velocity Verlet steps per trajectory (optional, default 10).</li>
+         *  <li>timestep: Time step.</li>
+         *  <li>temperature: Temperature.</li>
+         *  <li>seed: Seed for random numbers (optional).</li>
+         *  <li>
+         *      trajectory: Trajectory format, conf::TEXT_TRAJECTORY or 
+         *      conf::BINARY_TRAJECTORY (optional). See TrajectoryWriter.
+         *  </li>
+         * </ul>
+         * Bond constraints are not applied.
+         * @param trajStream Output trajectory stream.
+         * @param dataStream Output simulation data stream.
+         */
+        void perform(const sim_param_t& param,
+                     std::ofstream& trajStream,
+                     std::ofstream& dataStream);
+        
+    private:
+    
+        cg_sim_model_ptr_t sm_;
+        Philox rng_;
+        
+    };
+}
+
+#endif /* HMC_HPP */
+
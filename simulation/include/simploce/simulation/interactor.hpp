@@ -101,6 +101,10 @@ namespace simploce {
         at_ff_ptr_t forcefield_;
         at_ppair_list_gen_ptr_t pairListGenerator_;
         PairLists<Atom> pairLists_;
+        
+        bool setup_;
+        std::size_t npairlists_;
+        std::size_t counter_;
     };
     
     /**
@@ -120,7 +124,10 @@ namespace simploce {
                    const cg_ppair_list_gen_ptr_t& pairListGenerator);
         
         /**
-         * Computes force on beads.
+         * Computes force on beads. If simulation parameter "virial" is true, 
+         * the virial tensor is computed as well. Simulation parameter "cutoff"
+         * is the cutoff distance of non-bonded interactions. If absent or 
+         * zero, half the box size is used.
          * @param param Simulation parameters.
          * @param cg Coarse grained particle model.
          * @return Non-bonded and bonded potential energy.
@@ -129,6 +136,27 @@ namespace simploce {
         interact(const sim_param_t& param, 
                  const cg_ptr_t& cg);
         
+        /**
+         * Computes bonded forces on beads only. Pair lists are not updated.
+         * @param param Simulation parameters.
+         * @param cg Coarse grained particle model.
+         * @return Bonded potential energy.
+         */
+        energy_t 
+        bonded(const sim_param_t& param, 
+               const cg_ptr_t& cg);
+        
+        /**
+         * Computes non-bonded forces on beads only. Pair lists are updated
+         * as for interact().
+         * @param param Simulation parameters.
+         * @param cg Coarse grained particle model.
+         * @return Non-bonded potential energy.
+         */
+        energy_t 
+        nonBonded(const sim_param_t& param, 
+                  const cg_ptr_t& cg);
+        
         /**
          * Calculates interaction energy of given bead with all other beads.
          * @param bead Bead.
@@ -140,6 +168,71 @@ namespace simploce {
         interact(const bead_ptr_t& bead,
                  const sim_param_t& param, 
                  const cg_ptr_t& cg);
+        
+        /**
+         * Calculates interaction energy of given bead with the given free beads
+         * and bead groups only.
+         * @param bead Bead.
+         * @param free Free beads, e.g. neighbors of bead.
+         * @param groups Bead groups, e.g. neighbors of bead. Must include the 
+         * group of bead, if any.
+         * @param param Simulation parameters.
+         * @param cg Coarse grained particle model.
+         * @return Interaction (potential) energy.
+         */
+        std::pair<energy_t, energy_t> 
+        interact(const bead_ptr_t& bead,
+                 const std::vector<bead_ptr_t>& free,
+                 const std::vector<bead_group_ptr_t>& groups,
+                 const sim_param_t& param, 
+                 const cg_ptr_t& cg);
+        
+        /**
+         * Corrects forces and the non-bonded potential energy of the last force
+         * calculation for changes in bead charges, e.g. upon (de)protonation. 
+         * Only interactions of the given beads with their neighbors in the 
+         * current pair lists are recomputed. If simulation parameter "virial" 
+         * is true, the virial tensor is corrected as well.
+         * @param changed Beads with changed charges, and their previous charges.
+         * @param param Simulation parameters.
+         * @return Change in non-bonded potential energy.
+         */
+        energy_t
+        chargesChanged(const std::vector<std::pair<bead_ptr_t, charge_t>>& changed,
+                       const sim_param_t& param);
+        
+        /**
+         * Returns virial tensor of the last bonded and non-bonded force 
+         * calculations for which the virial was requested.
+         * @return Virial tensor.
+         */
+        virial_t 
+        virial() const;
+        
+        /**
+         * Returns the length of bonds in particle groups, as defined by the 
+         * force field.
+         * @return Bond length.
+         */
+        length_t
+        bondLength() const;
+        
+        /**
+         * Writes internal state, including the particle pair list and the step 
+         * counter for updating it, in binary form to a checkpoint.
+         * @param stream Output stream.
+         */
+        void
+        writeCheckpoint(std::ostream& stream) const;
+        
+        /**
+         * Restores internal state written by writeCheckpoint().
+         * @param stream Input stream.
+         * @param cg Coarse grained particle model.
+         */
+        void
+        readCheckpoint(std::istream& stream, const cg_ptr_t& cg);
+        
         /**
          * Returns identifying name.
          * @return Identifying name.
@@ -149,11 +242,25 @@ namespace simploce {
         
     private:
         
-        void updatePairLists_(const cg_ptr_t& cg);
+        void updatePairLists_(const sim_param_t& param, const cg_ptr_t& cg);
+        
+        void cutoffDistance_(const sim_param_t& param);
         
         cg_ff_ptr_t forcefield_;
         cg_ppair_list_gen_ptr_t pairListGenerator_;
         PairLists<Bead> pairLists_;
+        
+        bool setup_;
+        
+        // Whether the cutoff distance is passed to the force field and pair
+        // list generator. Not part of checkpoints, it is a simulation parameter.
+        bool cutoff_;
+        std::size_t npairlists_;
+        std::size_t counter_;
+        
+        // Virial tensors, bonded and non-bonded contributions.
+        virial_t bvirial_;
+        virial_t nbvirial_;
     };
     
 }
@@ -38,14 +38,48 @@
 #include "stypes.hpp"
 #include "simploce/particle/atomistic.hpp"
 #include "simploce/particle/coarse-grained.hpp"
+#include "simploce/util/philox.hpp"
+#include <vector>
+#include <array>
 
 namespace simploce {
     
+    /**
+     * Holds helper values and intermediate results of the Langevin Velocity 
+     * Verlet algorithm. Each displacer keeps its own, so that multiple 
+     * displacers (e.g. one per replica) can be used concurrently.
+     */
+    struct LangevinVelocityVerletHelpers {
+        
+        bool setup{false};
+        std::size_t counter{0};
+        stime_t dt{0.0};
+        temperature_t temperature{0.0};
+        real_t gamma{0.0};
+        
+        // Per particle constant factors.
+        std::vector<real_t> FC{};
+        std::vector<real_t> B{};
+        std::vector<real_t> A1{};
+        std::vector<real_t> A2{};
+        std::vector<real_t> strengths{};
+        
+        std::vector<force_t> fis{};             // Forces at time t(n).
+        std::vector<position_t> ris{};          // Positions at time t(n).
+        
+        // Random vector W, each element is a array of size 3.
+        std::vector<std::array<real_t, 3>> W{};
+        
+        // Random number generator, keyed by step and particle index.
+        Philox rng{};
+    };
     
     /**
      * Displaces particles according a stochastic Verlet-type algorithm applicable to 
      * an Langevin equation. Provides for a canonical ensemble (NVT constant) simulation. 
-     * Requires force field, temperature, time step and damping rate.
+     * Requires force field, temperature, time step and damping rate. A change 
+     * of the temperature in the simulation parameters is picked up in the next step.
+     * The random noise is reproducible for a given simulation parameter "seed".
      * @see <a href="http://dx.doi.org/10.1080/00268976.2012.760055">
      *   Grønbech-Jensen and Oded Farago, Molec Phys,111, 983-991, 2013
      * </a>
@@ -78,11 +112,14 @@ namespace simploce {
         
         at_interactor_ptr_t interactor_;
         
+        mutable LangevinVelocityVerletHelpers helpers_;
     };
     
     
     /**
-     * Specialization for coarse grained particle model.
+     * Specialization for coarse grained particle model. If the simulation parameter 
+     * "constraints" is 'rattle', bonds in particle groups are held at the bond
+     * length of the force field.
      */
     template <>
     class LangevinVelocityVerlet<CoarseGrained> : public CoarseGrainedDisplacer {
@@ -100,11 +137,17 @@ namespace simploce {
                                 const cg_ptr_t& cg) const override;
         
         std::string id() const override;
+        
+        void writeCheckpoint(std::ostream& stream) const override;
+        
+        void readCheckpoint(std::istream& stream, const cg_ptr_t& cg) override;
                 
     private:
         
         cg_interactor_ptr_t interactor_;
         
+        mutable LangevinVelocityVerletHelpers helpers_;
+        mutable cg_rattle_ptr_t rattle_;
     };
     
 }
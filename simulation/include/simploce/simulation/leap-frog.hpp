@@ -71,8 +71,12 @@ namespace simploce {
         
     private:
         
-       at_interactor_ptr_t interactor_;
+        at_interactor_ptr_t interactor_;
         
+        mutable bool setup_;
+        mutable std::size_t counter_;
+        mutable stime_t dt_;
+
     };
     
     /**
@@ -91,9 +95,19 @@ namespace simploce {
         std::string 
         id() const override;
         
+        void 
+        writeCheckpoint(std::ostream& stream) const override;
+        
+        void 
+        readCheckpoint(std::istream& stream, const cg_ptr_t& cg) override;
+        
     private:
     
         cg_interactor_ptr_t interactor_;
+        
+        mutable bool setup_;
+        mutable std::size_t counter_;
+        mutable stime_t dt_;
     };
     
         
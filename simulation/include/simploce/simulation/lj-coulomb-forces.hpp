@@ -33,11 +33,13 @@
 #define LJ_COULOMB_HPP
 
 #include "cg-forcefield.hpp"
+#include "pair-lists.hpp"
 #include "stypes.hpp"
 #include "simploce/util/map2.hpp"
 #include <string>
 #include <map>
 #include <vector>
+#include <utility>
 
 namespace simploce {
     
@@ -64,13 +66,16 @@ namespace simploce {
         interact(const std::vector<bead_ptr_t>& all,
                  const std::vector<bead_ptr_t>& free,
                  const std::vector<bead_group_ptr_t>& groups,
-                 const PairLists<Bead>& pairLists) override;
+                 const std::vector<charge_t>& charges,
+                 const PairLists<Bead>& pairLists,
+                 virial_t* virial) override;
         
         std::pair<energy_t, energy_t>
         interact(const bead_ptr_t& bead,
                  const std::vector<bead_ptr_t>& all,
                  const std::vector<bead_ptr_t>& free,
-                 const std::vector<bead_group_ptr_t>& groups) override;
+                 const std::vector<bead_group_ptr_t>& groups,
+                 const std::vector<charge_t>& charges) override;
         
         /**
          * There are non bonded interactions.
@@ -79,18 +84,47 @@ namespace simploce {
         energy_t bonded(const std::vector<bead_ptr_t>& all,
                         const std::vector<bead_ptr_t>& free,
                         const std::vector<bead_group_ptr_t>& groups,
-                        const PairLists<Bead>& pairLists) override;
+                        const PairLists<Bead>& pairLists,
+                        virial_t* virial) override;
+
+        energy_t nonBonded(const std::vector<bead_ptr_t>& all,
+                           const std::vector<bead_ptr_t>& free,
+                           const std::vector<bead_group_ptr_t>& groups,
+                           const std::vector<charge_t>& charges,
+                           const PairLists<Bead>& pairLists,
+                           virial_t* virial) override;
+        
+        /**
+         * Recomputes the Coulomb interactions of beads with changed charges,
+         * for pairs in the particle pair list.
+         */
+        energy_t chargesChanged(const std::vector<std::pair<bead_ptr_t, charge_t>>& changed,
+                                const PairLists<Bead>& pairLists,
+                                virial_t* virial) override;
         
         std::string id() const override;
         
         std::pair<lj_params_t, el_params_t> parameters() const override;
         
+        void cutoffDistance(const length_t& rc) override;
+        
     private:
         
         lj_params_t ljParams_;
         el_params_t elParams_;
         bc_ptr_t bc_;
         box_ptr_t box_;
+        
+        // Cutoff distance, at most half the box size of this force field.
+        length_t rc_;
+        
+        // Sub lists of the particle pair list, for concurrent force calculations.
+        std::vector<PairLists<Bead>::pp_list_cont_t> subPairLists_;
+        bool firstTime_;
+        
+        // Indices of pairs in the particle pair list, per bead index.
+        std::vector<std::vector<std::size_t>> pairsOf_;
+        bool indexed_;
     };
 }
 
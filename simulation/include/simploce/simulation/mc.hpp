@@ -33,13 +33,84 @@
 #define MC_HPP
 
 #include "stypes.hpp"
+#include "sim-data.hpp"
 #include "simploce/particle/bead.hpp"
+#include "simploce/util/philox.hpp"
 #include <iostream>
+#include <string>
+#include <vector>
 
 namespace simploce {
     
     /**
-     * Monte Carlo
+     * Type of Monte Carlo trial move, with its step size and statistics.
+     */
+    struct MCMove {
+        
+        /**
+         * Constructor.
+         * @param id Identifier, one of conf::MC_TRANSLATE, conf::MC_GROUP_TRANSLATE,
+         * or conf::MC_GROUP_ROTATE.
+         */
+        MCMove(const std::string& id);
+        
+        /**
+         * Identifier.
+         */
+        std::string id;
+        
+        /**
+         * Step size. Width of the interval of displacements along each axis in 
+         * nm, or of the interval of rotation angles in radians.
+         */
+        real_t stepSize;
+        
+        /**
+         * Largest step size allowed when tuning.
+         */
+        real_t maxStepSize;
+        
+        /**
+         * Number of trial moves.
+         */
+        std::size_t trials;
+        
+        /**
+         * Number of accepted trial moves.
+         */
+        std::size_t accepted;
+        
+        /**
+         * Number of trial moves since the last adjustment of the step size.
+         */
+        std::size_t windowTrials;
+        
+        /**
+         * Number of accepted trial moves since the last adjustment of the step 
+         * size.
+         */
+        std::size_t windowAccepted;
+        
+        /**
+         * Total time spent on trial moves, in microseconds.
+         */
+        real_t time;
+    };
+    
+    /**
+     * Monte Carlo. One trial move is performed per step. Trial moves are 
+     * selected randomly from a set of move types: translation of a single 
+     * particle, and rigid translation or rotation (about the center of mass) 
+     * of the particle group the selected particle belongs to. Step sizes are 
+     * optionally adjusted during the first steps toward a target acceptance 
+     * ratio. Energies before and after a trial move are calculated with 
+     * neighboring particles only, found in a grid of cells with a side length
+     * of at least the cutoff distance that is updated after every accepted 
+     * move. Optionally, the box is divided into a checkerboard of cells 
+     * (eight colors) larger than the cutoff distance, and trial moves in all 
+     * cells of one color are carried out concurrently. Particles may not leave
+     * their cell, and the checkerboard is shifted randomly in every sweep. 
+     * Concurrency requires at least four cells per edge.
      */
     template <typename P>
     class MC;
@@ -61,11 +132,35 @@ namespace simploce {
          * Performs the simulation.
          * @param param Parameters. Must provide,
          * <ul>
-         *  <li>nsteps: Number of steps.</li>
+         *  <li>nsteps: Number of steps, or sweeps.</li>
          *  <li>
          *      nwrite: Number of steps between writing simulation data and saving state
          *      in the trajectectory.
          *  </li>
+         *  <li>seed: Seed for random numbers (optional).</li>
+         *  <li>
+         *      cutoff: Cutoff distance of non-bonded interactions (optional, 
+         *      default half the box size). Sets the grid cell size.
+         *  </li>
+         *  <li>
+         *      checkerboard: If true, performs sweeps of about one trial move 
+         *      per particle, concurrently in non-adjacent cells (optional). 
+         *      Throws std::domain_error if the box does not hold two cells per
+         *      edge, which requires a cutoff distance below half the box size.
+         *  </li>
+         *  <li>
+         *      mcmoves: Comma-separated move types (optional, default 
+         *      conf::MC_TRANSLATE).
+         *  </li>
+         *  <li>
+         *      ntune: Number of steps, or sweeps, in which step sizes are 
+         *      adjusted (optional, default 0).
+         *  </li>
+         *  <li>acceptance: Target acceptance ratio, in % (optional, default 50).</li>
+         *  <li>
+         *      trajectory: Trajectory format, conf::TEXT_TRAJECTORY or 
+         *      conf::BINARY_TRAJECTORY (optional). See TrajectoryWriter.
+         *  </li>
          * </ul>
          * @param trajStream Output trajectory stream.
          * @param dataStream Output simulation data stream.
@@ -74,9 +169,45 @@ namespace simploce {
                      std::ofstream& trajStream,
                      std::ofstream& dataStream);
         
+        /**
+         * Returns move types, with their step sizes and statistics.
+         * @return Move types.
+         */
+        const std::vector<MCMove>& moves() const { return moves_; }
+        
+        /**
+         * Returns number of cells of the grid in which neighbors were found, 
+         * in the last simulation or checkerboard sweep.
+         * @return Number.
+         */
+        std::size_t numberOfCells() const { return numberOfCells_; }
+        
+        /**
+         * Returns smallest number of cells of one color, in the last 
+         * checkerboard sweep.
+         * @return Number, or 0 without checkerboard sweeps.
+         */
+        std::size_t cellsPerColor() const { return cellsPerColor_; }
+        
+        /**
+         * Returns smallest number of cells of one color in which trial moves
+         * were performed concurrently, in the last checkerboard sweep. 
+         * @return Number, or 0 without checkerboard sweeps.
+         */
+        std::size_t concurrentCells() const { return concurrentCells_; }
+        
     private:
+        
+        void performSweeps_(const sim_param_t& param,
+                            TrajectoryWriter<Bead>& trajectory,
+                            std::ofstream& dataStream);
     
         cg_sim_model_ptr_t sm_;
+        Philox rng_;
+        std::vector<MCMove> moves_;
+        std::size_t numberOfCells_;
+        std::size_t cellsPerColor_;
+        std::size_t concurrentCells_;
         
     };
 }
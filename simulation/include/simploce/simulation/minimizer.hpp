@@ -0,0 +1,101 @@
+/*
+ * The MIT License
+ *
+ * Copyright 2019 André H. Juffer, Biocenter Oulu
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ */
+
+/*
+ * File:   minimizer.hpp
+ * Author: André H. Juffer, Biocenter Oulu.
+ *
+ * Created on November 20, 2019, 9:22 AM
+ */
+
+#ifndef MINIMIZER_HPP
+#define MINIMIZER_HPP
+
+#include "sim-data.hpp"
+#include "stypes.hpp"
+#include <iostream>
+
+namespace simploce {
+
+    /**
+     * Minimizes the potential energy of a simulation model, e.g. to remove 
+     * close contacts in a newly created model before dynamics. Minimization 
+     * stops when the largest force on any particle falls below a given value. 
+     * Particle velocities are not changed.
+     * @param P Particle type.
+     */
+    template <typename P>
+    class Minimizer;
+
+    /**
+     * Specialization for beads.
+     */
+    template <>
+    class Minimizer<Bead> {
+    public:
+
+        /**
+         * Constructor.
+         * @param sm Simulation model.
+         */
+        Minimizer(const cg_sim_model_ptr_t& sm);
+
+        /**
+         * Performs the energy minimization.
+         * @param param Parameters. May provide,
+         * <ul>
+         *  <li>minimizer: 'fire' (FIRE, default) or 'sd' (steepest descent).</li>
+         *  <li>nminsteps: Maximum number of steps. Default is 1000.</li>
+         *  <li>fmax: Convergence criterion, largest force (kJ/(mol nm)). Default is 10.</li>
+         *  <li>
+         *      emstep: Maximum displacement of a particle per step (nm) for 
+         *      FIRE, initial displacement of the particle with the largest 
+         *      force for steepest descent. Default is 0.01 nm.
+         *  </li>
+         *  <li>
+         *      emstepmax: Largest displacement of the particle with the 
+         *      largest force for steepest descent (nm). Default is 10 * emstep.
+         *  </li>
+         *  <li>timestep: Initial time step for FIRE (ps).</li>
+         *  <li>nwrite: Number of steps between writing progress.</li>
+         * </ul>
+         * @param stream Output stream for progress, one line per nwrite steps 
+         * holding the step, potential energy, and largest force.
+         * @return Bonded and non-bonded potential energy at the minimum found.
+         */
+        SimulationData perform(const sim_param_t& param,
+                               std::ostream& stream);
+
+    private:
+
+        SimulationData fire_(const sim_param_t& param, std::ostream& stream);
+
+        SimulationData steepestDescent_(const sim_param_t& param, std::ostream& stream);
+
+        cg_sim_model_ptr_t sm_;
+    };
+}
+
+#endif /* MINIMIZER_HPP */
+
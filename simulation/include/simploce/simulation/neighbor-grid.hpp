@@ -0,0 +1,386 @@
+/*
+ * The MIT License
+ *
+ * Copyright 2019 André H. Juffer, Biocenter Oulu
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ */
+
+
+/*
+ * File:   neighbor-grid.hpp
+ * Author: André H. Juffer, Biocenter Oulu.
+ *
+ * Created on November 21, 2019, 2:30 PM
+ */
+
+#ifndef NEIGHBOR_GRID_HPP
+#define NEIGHBOR_GRID_HPP
+
+#include "stypes.hpp"
+#include "simploce/particle/particle-group.hpp"
+#include <vector>
+#include <memory>
+#include <algorithm>
+#include <limits>
+#include <cmath>
+
+namespace simploce {
+
+    /**
+     * Assigns free particles and particle groups to cubic cells with a side 
+     * length of at least the cutoff distance, such that all interaction 
+     * partners of a particle are found in the surrounding 27 cells. Groups 
+     * are assigned by their position (center of mass). Cell locations are 
+     * periodic, and positions need not be inside the box. Unlike cell lists, 
+     * assignments are updated for one particle at a time, e.g. after an 
+     * accepted Monte Carlo move, so neighbors of one particle are found in 
+     * O(number of neighbors) time. With an even number of cells in one 
+     * dimension, cells of the same color (checkerboard, eight colors) are never 
+     * neighbors of each other.
+     * @param P Particle type.
+     */
+    template <typename P>
+    class NeighborGrid {
+    public:
+
+        /**
+         * Particle pointer type.
+         */
+        using p_ptr_t = std::shared_ptr<P>;
+
+        /**
+         * Particle group pointer type.
+         */
+        using pg_ptr_t = std::shared_ptr<ParticleGroup<P>>;
+
+        /**
+         * Constructor. Creates empty grid.
+         * @param box Simulation box.
+         * @param cutoff Cutoff distance. Smallest side length of cells.
+         * @param even If true, the number of cells in one dimension is even.
+         */
+        NeighborGrid(const box_ptr_t& box, const length_t& cutoff, bool even = false);
+
+        /**
+         * Places all free particles and particle groups in cells.
+         * @param all All particles.
+         * @param free Free particles.
+         * @param groups Particle groups.
+         * @param offset Shift of the grid relative to the box.
+         */
+        void place(const std::vector<p_ptr_t>& all,
+                   const std::vector<p_ptr_t>& free,
+                   const std::vector<pg_ptr_t>& groups,
+                   const dist_vect_t& offset = dist_vect_t{});
+
+        /**
+         * Moves given particle, or the particle group it belongs to, to the 
+         * cell of its current position.
+         * @param particle Particle.
+         */
+        void update(const p_ptr_t& particle);
+
+        /**
+         * Collects free particles and particle groups in the cells around the 
+         * cell of given particle, i.e. of its particle group, if any. Always 
+         * includes the particle group of the particle.
+         * @param particle Particle.
+         * @param free Receives free particles, which may include the particle.
+         * @param groups Receives particle groups.
+         */
+        void neighbors(const p_ptr_t& particle,
+                       std::vector<p_ptr_t>& free,
+                       std::vector<pg_ptr_t>& groups) const;
+
+        /**
+         * Collects free particles and particle groups in the cells around the 
+         * given cell, including the cell itself.
+         * @param c Cell index.
+         * @param free Receives free particles.
+         * @param groups Receives particle groups.
+         */
+        void neighbors(std::size_t c,
+                       std::vector<p_ptr_t>& free,
+                       std::vector<pg_ptr_t>& groups) const;
+
+        /**
+         * Returns particles that were placed in given cell, i.e. free particles
+         * and all particles of particle groups.
+         * @param c Cell index.
+         * @return Particles.
+         */
+        std::vector<p_ptr_t> particles(std::size_t c) const;
+
+        /**
+         * Returns the cell that given particle, or the particle group it belongs 
+         * to, is in at its current position. 
+         * @param particle Particle.
+         * @return Cell index.
+         */
+        std::size_t cellOf(const p_ptr_t& particle) const;
+
+        /**
+         * Returns the particle group given particle belongs to.
+         * @param particle Particle.
+         * @return Particle group, or nullptr for a free particle.
+         */
+        pg_ptr_t groupOf(const p_ptr_t& particle) const;
+
+        /**
+         * Returns color of given cell, in [0, 8).
+         * @param c Cell index.
+         * @return Color.
+         */
+        std::size_t color(std::size_t c) const;
+
+        /**
+         * Returns total number of cells.
+         * @return Number.
+         */
+        std::size_t numberOfCells() const { return n_ * n_ * n_; }
+
+        /**
+         * Returns number of cells in one dimension.
+         * @return Number.
+         */
+        std::size_t numberOfCells1D() const { return n_; }
+
+    private:
+
+        static const std::size_t NONE = std::numeric_limits<std::size_t>::max();
+
+        std::size_t cell_(const position_t& r) const;
+
+        template <typename T>
+        static void remove_(std::vector<T>& items, const T& item);
+
+        std::size_t n_;                    // Number of cells in one dimension.
+        real_t sideLength_;
+        dist_vect_t offset_;
+        std::vector<std::vector<std::size_t>> neighborCells_;
+        std::vector<std::vector<p_ptr_t>> free_;
+        std::vector<std::vector<pg_ptr_t>> groups_;
+        std::vector<pg_ptr_t> allGroups_;
+        std::vector<std::size_t> freeCell_;     // Per particle index.
+        std::vector<std::size_t> groupOf_;      // Per particle index.
+        std::vector<std::size_t> groupCell_;    // Per group.
+    };
+
+    template <typename P>
+    const std::size_t NeighborGrid<P>::NONE;
+
+    template <typename P>
+    NeighborGrid<P>::NeighborGrid(const box_ptr_t& box, const length_t& cutoff, bool even) :
+        n_{1}, sideLength_{0.0}, offset_{}, neighborCells_{}, free_{}, groups_{}, 
+        allGroups_{}, freeCell_{}, groupOf_{}, groupCell_{}
+    {
+        real_t edgeLength = box->edgeLength();
+        n_ = std::max(std::size_t(1), std::size_t(edgeLength / cutoff()));
+        if ( even && n_ % 2 == 1 && n_ > 1 ) {
+            n_ -= 1;
+        }
+        sideLength_ = edgeLength / real_t(n_);
+        std::size_t ncells = n_ * n_ * n_;
+        free_.resize(ncells);
+        groups_.resize(ncells);
+
+        // Surrounding cells, each cell counted once also for small grids.
+        neighborCells_.resize(ncells);
+        std::size_t n = n_;
+        for (std::size_t i = 0; i != n; ++i) {
+            for (std::size_t j = 0; j != n; ++j) {
+                for (std::size_t k = 0; k != n; ++k) {
+                    auto& cells = neighborCells_[(i * n + j) * n + k];
+                    for (std::size_t di = 0; di != 3; ++di) {
+                        for (std::size_t dj = 0; dj != 3; ++dj) {
+                            for (std::size_t dk = 0; dk != 3; ++dk) {
+                                std::size_t ii = (i + n + di - 1) % n;
+                                std::size_t jj = (j + n + dj - 1) % n;
+                                std::size_t kk = (k + n + dk - 1) % n;
+                                cells.push_back((ii * n + jj) * n + kk);
+                            }
+                        }
+                    }
+                    std::sort(cells.begin(), cells.end());
+                    cells.erase(std::unique(cells.begin(), cells.end()), cells.end());
+                }
+            }
+        }
+    }
+
+    template <typename P>
+    void
+    NeighborGrid<P>::place(const std::vector<p_ptr_t>& all,
+                           const std::vector<p_ptr_t>& free,
+                           const std::vector<pg_ptr_t>& groups,
+                           const dist_vect_t& offset)
+    {
+        offset_ = offset;
+        for (auto& cell : free_) {
+            cell.clear();
+        }
+        for (auto& cell : groups_) {
+            cell.clear();
+        }
+        allGroups_ = groups;
+        freeCell_ = std::vector<std::size_t>(all.size(), NONE);
+        groupOf_ = std::vector<std::size_t>(all.size(), NONE);
+        groupCell_ = std::vector<std::size_t>(groups.size(), NONE);
+
+        for (const auto& p : free) {
+            std::size_t c = this->cell_(p->position());
+            free_[c].push_back(p);
+            freeCell_[p->index()] = c;
+        }
+        for (std::size_t g = 0; g != groups.size(); ++g) {
+            std::size_t c = this->cell_(groups[g]->position());
+            groups_[c].push_back(groups[g]);
+            groupCell_[g] = c;
+            for (const auto& p : groups[g]->particles()) {
+                groupOf_[p->index()] = g;
+            }
+        }
+    }
+
+    template <typename P>
+    void
+    NeighborGrid<P>::update(const p_ptr_t& particle)
+    {
+        std::size_t index = particle->index();
+        std::size_t g = groupOf_[index];
+        std::size_t c = this->cellOf(particle);
+        if ( g == NONE ) {
+            if ( c != freeCell_[index] ) {
+                remove_(free_[freeCell_[index]], particle);
+                free_[c].push_back(particle);
+                freeCell_[index] = c;
+            }
+        } else {
+            const auto& group = allGroups_[g];
+            if ( c != groupCell_[g] ) {
+                remove_(groups_[groupCell_[g]], group);
+                groups_[c].push_back(group);
+                groupCell_[g] = c;
+            }
+        }
+    }
+
+    template <typename P>
+    void
+    NeighborGrid<P>::neighbors(const p_ptr_t& particle,
+                               std::vector<p_ptr_t>& free,
+                               std::vector<pg_ptr_t>& groups) const
+    {
+        free.clear();
+        groups.clear();
+        std::size_t g = groupOf_[particle->index()];
+        bool found = false;
+        for (auto c : neighborCells_[this->cellOf(particle)]) {
+            free.insert(free.end(), free_[c].begin(), free_[c].end());
+            groups.insert(groups.end(), groups_[c].begin(), groups_[c].end());
+            found = found || ( g != NONE && c == groupCell_[g] );
+        }
+        if ( g != NONE && !found ) {
+            groups.push_back(allGroups_[g]);
+        }
+    }
+
+    template <typename P>
+    void
+    NeighborGrid<P>::neighbors(std::size_t c,
+                               std::vector<p_ptr_t>& free,
+                               std::vector<pg_ptr_t>& groups) const
+    {
+        free.clear();
+        groups.clear();
+        for (auto cc : neighborCells_[c]) {
+            free.insert(free.end(), free_[cc].begin(), free_[cc].end());
+            groups.insert(groups.end(), groups_[cc].begin(), groups_[cc].end());
+        }
+    }
+
+    template <typename P>
+    std::vector<typename NeighborGrid<P>::p_ptr_t>
+    NeighborGrid<P>::particles(std::size_t c) const
+    {
+        std::vector<p_ptr_t> particles = free_[c];
+        for (const auto& g : groups_[c]) {
+            const auto& gp = g->particles();
+            particles.insert(particles.end(), gp.begin(), gp.end());
+        }
+        return particles;
+    }
+
+    template <typename P>
+    std::size_t
+    NeighborGrid<P>::cellOf(const p_ptr_t& particle) const
+    {
+        std::size_t g = groupOf_[particle->index()];
+        return g == NONE ? 
+               this->cell_(particle->position()) : 
+               this->cell_(allGroups_[g]->position());
+    }
+
+    template <typename P>
+    typename NeighborGrid<P>::pg_ptr_t
+    NeighborGrid<P>::groupOf(const p_ptr_t& particle) const
+    {
+        std::size_t g = groupOf_[particle->index()];
+        return g == NONE ? nullptr : allGroups_[g];
+    }
+
+    template <typename P>
+    std::size_t
+    NeighborGrid<P>::color(std::size_t c) const
+    {
+        std::size_t k = c % n_;
+        std::size_t j = ( c / n_ ) % n_;
+        std::size_t i = c / ( n_ * n_ );
+        return ( ( i % 2 ) * 2 + j % 2 ) * 2 + k % 2;
+    }
+
+    template <typename P>
+    std::size_t
+    NeighborGrid<P>::cell_(const position_t& r) const
+    {
+        long n = n_;
+        std::size_t c = 0;
+        for (std::size_t k = 0; k != 3; ++k) {
+            long i = long(std::floor(( r[k] + offset_[k] ) / sideLength_)) % n;
+            c = c * n_ + std::size_t(i < 0 ? i + n : i);
+        }
+        return c;
+    }
+
+    template <typename P>
+    template <typename T>
+    void
+    NeighborGrid<P>::remove_(std::vector<T>& items, const T& item)
+    {
+        auto iter = std::find(items.begin(), items.end(), item);
+        if ( iter != items.end() ) {
+            *iter = items.back();
+            items.pop_back();
+        }
+    }
+}
+
+#endif /* NEIGHBOR_GRID_HPP */
+
@@ -72,6 +72,12 @@ namespace simploce {
         generate(const std::vector<p_ptr_t>& all,
                  const std::vector<p_ptr_t>& free,
                  const std::vector<pg_ptr_t>& groups) const = 0;
+        
+        /**
+         * Sets the cutoff distance for particle pairs. Ignored by default.
+         * @param rc Cutoff distance. If not positive, half the box size is used.
+         */
+        virtual void cutoffDistance(const length_t& rc) {}
     };
     
 }
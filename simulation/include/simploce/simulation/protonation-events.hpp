@@ -0,0 +1,204 @@
+/*
+ * The MIT License
+ *
+ * Copyright 2019 André H. Juffer, Biocenter Oulu
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ */
+
+
+/*
+ * File:   protonation-events.hpp
+ * Author: André H. Juffer, Biocenter Oulu.
+ *
+ * Created on November 29, 2019, 10:14 AM
+ */
+
+#ifndef PROTONATION_EVENTS_HPP
+#define PROTONATION_EVENTS_HPP
+
+#include "stypes.hpp"
+#include "sconf.hpp"
+#include <iostream>
+#include <vector>
+#include <map>
+#include <utility>
+
+namespace simploce {
+    
+    /**
+     * Change of the protonation state of one protonatable bead.
+     */
+    struct ProtonationEvent {
+        
+        /**
+         * Time.
+         */
+        stime_t t;
+        
+        /**
+         * Bead index.
+         */
+        std::size_t index;
+        
+        /**
+         * Protonation state before the event.
+         */
+        std::size_t oldState;
+        
+        /**
+         * Protonation state after the event.
+         */
+        std::size_t newState;
+    };
+    
+    /**
+     * Writes changes of protonation states, as reported by proton transfer, to 
+     * a text log, one line per event,
+     * <pre>
+     *   E t index old new
+     * </pre>
+     * Since proton hops are rare, such a log is much smaller than a trajectory.
+     * Key records with the protonation states of all protonatable beads,
+     * <pre>
+     *   K t n index_1 state_1 ... index_n state_n
+     * </pre>
+     * are written at the start, and after every given number of events, so 
+     * that a reader can start at any key record.
+     * @param P Particle type.
+     */
+    template <typename P>
+    class ProtonationEventWriter;
+    
+    /**
+     * Specialization for beads.
+     */
+    template <>
+    class ProtonationEventWriter<Bead> {
+    public:
+        
+        /**
+         * Constructor.
+         * @param stream Output stream.
+         * @param keyInterval Number of events between key records.
+         */
+        ProtonationEventWriter(std::ostream& stream, 
+                               std::size_t keyInterval = conf::KEY_RECORD_INTERVAL);
+        
+        /**
+         * Writes a key record with the current protonation states. Must be 
+         * called before any events are recorded.
+         * @param t Time.
+         * @param sm Simulation model.
+         */
+        void start(const stime_t& t, const cg_sim_model_ptr_t& sm);
+        
+        /**
+         * Records events, as reported by proton transfer. 
+         * @param events Changes of protonation states, in order of time.
+         */
+        void record(const std::vector<ProtonationEvent>& events);
+        
+        /**
+         * Returns number of written events.
+         * @return Number.
+         */
+        std::size_t numberOfEvents() const;
+        
+    private:
+        
+        void writeKey_(const stime_t& t);
+        
+        std::ostream* stream_;
+        std::size_t keyInterval_;
+        std::size_t nevents_;
+        std::size_t nsinceKey_;
+        bool started_;
+        
+        // Protonation state, per bead index.
+        std::map<std::size_t, std::size_t> states_;
+    };
+    
+    /**
+     * Reads a log written by ProtonationEventWriter. Keeps track of the 
+     * protonation states of all protonatable beads.
+     * @param P Particle type.
+     */
+    template <typename P>
+    class ProtonationEventReader;
+    
+    /**
+     * Specialization for beads.
+     */
+    template <>
+    class ProtonationEventReader<Bead> {
+    public:
+        
+        /**
+         * Constructor. Locates all key records, and positions the log at the
+         * first one.
+         * @param stream Input stream.
+         */
+        ProtonationEventReader(std::istream& stream);
+        
+        /**
+         * Reads the next event, and updates protonation states.
+         * @param event Event.
+         * @return True if an event was read, false at the end of the log.
+         */
+        bool next(ProtonationEvent& event);
+        
+        /**
+         * Positions the log at the given time, starting from the last key 
+         * record not later than t. Afterwards, protonation states are those 
+         * at time t, and next() returns the first event later than t.
+         * @param t Time.
+         */
+        void seek(const stime_t& t);
+        
+        /**
+         * Returns current protonation states.
+         * @return Protonation state for each protonatable bead index.
+         */
+        const std::map<std::size_t, std::size_t>& states() const;
+        
+        /**
+         * Returns number of key records.
+         * @return Number.
+         */
+        std::size_t numberOfKeys() const;
+        
+    private:
+        
+        bool readEvent_(ProtonationEvent& event);
+        
+        std::istream* stream_;
+        
+        // Time and stream position of each key record.
+        std::vector<std::pair<real_t, std::streampos>> keys_;
+        std::map<std::size_t, std::size_t> states_;
+        
+        // Event read ahead by seek().
+        bool pending_;
+        ProtonationEvent event_;
+    };
+}
+
+#endif /* PROTONATION_EVENTS_HPP */
+
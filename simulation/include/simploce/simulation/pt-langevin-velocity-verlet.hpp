@@ -33,12 +33,16 @@
 #define PT_LANGEVIN_VELOCITY_VERLET_HPP
 
 #include "cg-displacer.hpp"
+#include "pt-pair-list-generator.hpp"
 #include "stypes.hpp"
 
 namespace simploce {
     
     /**
      * Displaces protonatable beads with continuous varying charges and mass values.
+     * Protons are transferred every "npt" (default 1) steps, covering all of 
+     * these steps. The pair list of protonatable beads is regenerated at the 
+     * first transfer after "npairlists" steps.
      */
     class ProtonTransferLangevinVelocityVerlet : public CoarseGrainedDisplacer {
     public:
@@ -52,11 +56,25 @@ namespace simploce {
         
         std::string id() const override;
         
+        void writeCheckpoint(std::ostream& stream) const override;
+        
+        void readCheckpoint(std::istream& stream, const cg_ptr_t& cg) override;
+        
     private:
         
+        using prot_pair_list_t = ProtonTransferPairListGenerator::prot_pair_list_t;
+        
         cg_interactor_ptr_t interactor_;
         pt_pair_list_gen_ptr_t generator_;
         pt_displacer_ptr_t displacer_;
+        cg_displacer_ptr_t lvv_;
+        
+        mutable bool setup_;
+        mutable std::size_t npairlists_;
+        mutable std::size_t npt_;
+        mutable std::size_t counter_;
+        mutable std::size_t generated_;   // Step at which pair list was generated.
+        mutable prot_pair_list_t pairlist_;
     };
 }
 
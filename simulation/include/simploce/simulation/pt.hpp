@@ -33,8 +33,10 @@
 #define PT_HPP
 
 #include "pt-pair-list-generator.hpp"
+#include "protonation-events.hpp"
 #include "stypes.hpp"
 #include <vector>
+#include <iostream>
 
 namespace simploce {
     
@@ -52,15 +54,39 @@ namespace simploce {
         virtual ~ProtonTransfer() {}
         
         /**
-         * Transfers proton between two beads.
-         * @param param Simulation parameters.
+         * Transfers proton between two beads. Covers "npt" (default 1) time 
+         * steps, so that proton transfer may be evaluated every npt steps only.
+         * @param param Simulation parameters. Must hold "timestep". May hold
+         * "npt", the number of time steps covered.
          * @param continuous Protonatable beads with continuously varying 
          * protonation states.
          * @param pairList Pairs of protonatables possibly involved in proton transfer.
+         * @param events Receives every change of protonation state, in order 
+         * of time. Events are appended.
          */
         virtual void transfer(const sim_param_t& param,
                               const std::vector<cprot_bead_ptr_t>& continuous,
-                              const prot_pair_list_t& pairList) const = 0;
+                              const prot_pair_list_t& pairList,
+                              std::vector<ProtonationEvent>& events) const = 0;
+        
+        /**
+         * Notifies that the pair list was regenerated. Does nothing by default.
+         * @param pairList New pair list.
+         */
+        virtual void update(const prot_pair_list_t& pairList) const {}
+        
+        /**
+         * Writes internal state in binary form to a checkpoint.
+         * @param stream Output stream.
+         */
+        virtual void writeCheckpoint(std::ostream& stream) const = 0;
+        
+        /**
+         * Restores internal state written by writeCheckpoint().
+         * @param stream Input stream.
+         * @param pairList Pair list at the time of the checkpoint.
+         */
+        virtual void readCheckpoint(std::istream& stream, const prot_pair_list_t& pairList) = 0;
     };
 }
 
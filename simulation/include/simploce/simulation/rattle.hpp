@@ -0,0 +1,116 @@
+/*
+ * The MIT License
+ *
+ * Copyright 2019 André H. Juffer, Biocenter Oulu
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ */
+
+/*
+ * File:   rattle.hpp
+ * Author: André H. Juffer, Biocenter Oulu.
+ *
+ * Created on November 14, 2019, 9:40 AM
+ */
+
+#ifndef RATTLE_HPP
+#define RATTLE_HPP
+
+#include "stypes.hpp"
+#include <vector>
+
+namespace simploce {
+
+    /**
+     * Holds bond lengths fixed (holonomic constraints) by iteratively correcting
+     * positions (SHAKE) and velocities (RATTLE). Particle groups are independent
+     * of each other, and are handled concurrently for large systems.
+     * @see <a href="https://doi.org/10.1016/0021-9991(83)90014-1">
+     *   H. C. Andersen, J. Comput. Phys., 52, 24-34, 1983.
+     * </a>
+     * @param P Particle type.
+     */
+    template <typename P>
+    class Rattle;
+
+    /**
+     * Specialization for beads. All bonds in all particle groups are constrained
+     * to the same length.
+     */
+    template <>
+    class Rattle<Bead> {
+    public:
+
+        /**
+         * Constructor.
+         * @param length Bond length.
+         * @param tolerance Relative tolerance.
+         * @param maxIterations Maximum number of iterations per particle group.
+         */
+        Rattle(const length_t& length,
+               real_t tolerance = 1.0e-06,
+               std::size_t maxIterations = 500);
+
+        /**
+         * Saves current positions, at time t(n), as reference for the next
+         * call to constrainPositions().
+         * @param all All particles.
+         */
+        void reference(const std::vector<bead_ptr_t>& all);
+
+        /**
+         * Corrects positions at time t(n+1), such that all bonds have the required
+         * length. Particle positions are updated.
+         * @param all All particles.
+         * @param groups Particle groups.
+         * @return Displacement of each particle due to the constraints.
+         */
+        std::vector<dist_vect_t> constrainPositions(const std::vector<bead_ptr_t>& all,
+                                                    const std::vector<bead_group_ptr_t>& groups) const;
+
+        /**
+         * Corrects velocities at time t(n+1), such that all relative velocities
+         * are perpendicular to bonds. Particle velocities are updated.
+         * @param groups Particle groups.
+         * @param dt Time step.
+         * @return Virial tensor of the constraint forces at time t(n+1).
+         */
+        virial_t constrainVelocities(const std::vector<bead_group_ptr_t>& groups,
+                                     const stime_t& dt) const;
+
+        /**
+         * Returns number of constraints.
+         * @param groups Particle groups.
+         * @return Number.
+         */
+        std::size_t numberOfConstraints(const std::vector<bead_group_ptr_t>& groups) const;
+
+    private:
+
+        length_t length_;
+        real_t tolerance_;
+        std::size_t maxIterations_;
+
+        // Positions at time t(n).
+        std::vector<position_t> ris_;
+    };
+}
+
+#endif /* RATTLE_HPP */
+
@@ -0,0 +1,127 @@
+/*
+ * The MIT License
+ *
+ * Copyright 2019 André H. Juffer, Biocenter Oulu
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ */
+
+/*
+ * File:   replica-exchange.hpp
+ * Author: André H. Juffer, Biocenter Oulu.
+ *
+ * Created on November 12, 2019, 10:15 AM
+ */
+
+#ifndef REPLICA_EXCHANGE_HPP
+#define REPLICA_EXCHANGE_HPP
+
+#include "stypes.hpp"
+#include "simploce/util/philox.hpp"
+#include <vector>
+#include <fstream>
+#include <iostream>
+
+namespace simploce {
+
+    /**
+     * Performs a temperature replica exchange (parallel tempering) simulation.
+     * Replicas are simulated concurrently, one thread per replica. Periodically,
+     * replicas at neighbouring temperatures attempt to exchange temperatures
+     * according to the Metropolis criterion on their potential energies.
+     * @see <a href="https://doi.org/10.1016/S0009-2614(99)01123-9">
+     *   Sugita and Okamoto, Chem. Phys. Lett. 314, 141-151, 1999.
+     * </a>
+     * @param P Particle type.
+     */
+    template <typename P>
+    class ReplicaExchange;
+
+    template <>
+    class ReplicaExchange<Bead> {
+    public:
+
+        /**
+         * Constructor.
+         * @param replicas Simulation models, one per temperature. Each replica must
+         * hold its own interactor and displacer (see SimulationModelFactory::replicate),
+         * and the displacer must keep the temperature given by the parameter
+         * "temperature" (e.g. 'lvv' or 'pt-lvv').
+         * @param temperatures Temperatures (temperature ladder), in increasing order.
+         */
+        ReplicaExchange(const std::vector<cg_sim_model_ptr_t>& replicas,
+                        const std::vector<temperature_t>& temperatures);
+
+        /**
+         * Performs the simulation.
+         * @param param Parameters. Must provide,
+         * <ul>
+         *  <li>nsteps: Number of steps.</li>
+         *  <li>
+         *      nwrite: Number of steps between writing simulation data and saving state
+         *      in the trajectectory.
+         *  </li>
+         *  <li>nexchange: Number of steps between exchange attempts.</li>
+         *  <li>
+         *      seed: Seed (optional). Replica k is given seed + k, and exchanges 
+         *      are accepted or rejected with random numbers keyed by seed and the
+         *      exchange cycle, so that a simulation can be reproduced. Default is
+         *      a random seed.
+         *  </li>
+         *  <li>
+         *      trajectory: Trajectory format, conf::TEXT_TRAJECTORY or 
+         *      conf::BINARY_TRAJECTORY (optional). See TrajectoryWriter.
+         *  </li>
+         * </ul>
+         * The parameter "temperature" is set for each replica.
+         * @param trajStreams Output trajectory streams, one per temperature.
+         * @param dataStreams Output simulation data streams, one per temperature.
+         * @param exchangeStream Output stream for replica exchange statistics.
+         */
+        void perform(const sim_param_t& param,
+                     std::vector<std::ofstream>& trajStreams,
+                     std::vector<std::ofstream>& dataStreams,
+                     std::ostream& exchangeStream);
+
+        /**
+         * Returns replica currently at given temperature.
+         * @param k Temperature index, 0 <= k < number of replicas.
+         * @return Replica.
+         */
+        cg_sim_model_ptr_t replicaAt(std::size_t k) const;
+
+    private:
+
+        std::vector<cg_sim_model_ptr_t> replicas_;
+        std::vector<temperature_t> temperatures_;
+
+        // Replica index at each temperature.
+        std::vector<std::size_t> replicaAt_;
+
+        // Number of attempted and accepted exchanges between temperature k and k+1.
+        std::vector<std::size_t> attempted_;
+        std::vector<std::size_t> accepted_;
+
+        Philox rng_;
+    };
+
+}
+
+#endif /* REPLICA_EXCHANGE_HPP */
+
@@ -0,0 +1,97 @@
+/*
+ * The MIT License
+ *
+ * Copyright 2019 André H. Juffer, Biocenter Oulu
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ */
+
+/*
+ * File:   respa.hpp
+ * Author: André H. Juffer, Biocenter Oulu.
+ *
+ * Created on November 19, 2019, 9:14 AM
+ */
+
+#ifndef RESPA_HPP
+#define RESPA_HPP
+
+#include "cg-displacer.hpp"
+#include "sim-data.hpp"
+#include "stypes.hpp"
+#include "simploce/particle/coarse-grained.hpp"
+#include <vector>
+
+namespace simploce {
+
+    /**
+     * Reversible reference system propagator algorithm (r-RESPA), a multiple 
+     * time step Velocity Verlet algorithm. Bonded (fast) forces are evaluated 
+     * every inner step, non-bonded (slow) forces once every outer step. The 
+     * outer time step is the simulation parameter "timestep", the number of 
+     * inner steps per outer step is "ninner" (default 4). Pair lists are updated
+     * every "npairlists" outer steps. Provides for a microcanonical ensemble 
+     * (NVE constant) simulation. Bond constraints are not supported.
+     * @see <a href="https://doi.org/10.1063/1.463137">
+     *   M. Tuckerman et al, J. Chem. Phys., 97, 1990-2001, 1992.
+     * </a>
+     * @param M Particle model type.
+     */
+    template <typename M>
+    class RESPA;
+
+    /**
+     * Specialization for coarse grained particle model.
+     */
+    template <>
+    class RESPA<CoarseGrained> : public CoarseGrainedDisplacer {
+    public:
+
+        RESPA(const cg_interactor_ptr_t& interactor);
+
+        /**
+         * Displaces beads of a coarse grained model over one outer time step.
+         * @param cg Coarse grained particle model.
+         * @return kinetic, potential energy, and temperature.
+         */
+        SimulationData displace(const sim_param_t& param,
+                                const cg_ptr_t& cg) const override;
+
+        std::string id() const override;
+
+        void writeCheckpoint(std::ostream& stream) const override;
+
+        void readCheckpoint(std::istream& stream, const cg_ptr_t& cg) override;
+
+    private:
+
+        cg_interactor_ptr_t interactor_;
+
+        mutable bool setup_;
+        mutable std::size_t counter_;
+        mutable stime_t dt_;
+        mutable std::size_t ninner_;
+
+        // Non-bonded forces, at the last outer step.
+        mutable std::vector<force_t> fnbs_;
+    };
+}
+
+#endif /* RESPA_HPP */
+
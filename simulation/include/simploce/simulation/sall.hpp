@@ -35,6 +35,10 @@
 
 #include "stypes.hpp"
 #include "at-displacer.hpp"
+#include "baoab.hpp"
+#include "respa.hpp"
+#include "adaptive-timestep.hpp"
+#include "minimizer.hpp"
 #include "at-forcefield.hpp"
 #include "bc.hpp"
 #include "cg-displacer.hpp"
@@ -58,6 +62,13 @@
 #include "velocity-verlet.hpp"
 #include "pt-pair-list-generator.hpp"
 #include "mc.hpp"
+#include "hmc.hpp"
+#include "neighbor-grid.hpp"
+#include "replica-exchange.hpp"
+#include "rattle.hpp"
+#include "trajectory.hpp"
+#include "protonation-events.hpp"
+#include "checkpoint.hpp"
 
 #endif /* SALL_HPP */
 
@@ -42,6 +42,22 @@ namespace simploce {
         const std::string LANGEVIN_VELOCITY_VERLET = "lvv";
         const std::string PT_LANGEVIN_VELOCITY_VERLET = "pt-lvv";
         const std::string VELOCITY_VERLET = "vv";
+        const std::string BAOAB = "baoab";
+        const std::string RESPA = "respa";
+        const std::string ADAPTIVE_TIMESTEP = "adaptive";
+        
+        const std::string PT_CONSTANT_RATE = "constant-rate";
+        const std::string PT_EVENT_DRIVEN = "event-driven";
+        
+        const std::string NO_CONSTRAINTS = "none";
+        const std::string RATTLE = "rattle";
+        
+        const std::string FIRE = "fire";
+        const std::string STEEPEST_DESCENT = "sd";
+        
+        const std::string MC_TRANSLATE = "translate";
+        const std::string MC_GROUP_TRANSLATE = "group-translate";
+        const std::string MC_GROUP_ROTATE = "group-rotate";
         
         const std::string NOBC = "no-bc";
         const std::string PBC = "pbc";
@@ -52,6 +68,19 @@ namespace simploce {
         const std::string LJ_FLUID = "lj-fluid";
         const std::string HP = "hp";
         
+        const std::string TEXT_TRAJECTORY = "text";
+        const std::string BINARY_TRAJECTORY = "binary";
+        const std::string COMPRESSED_TRAJECTORY = "compressed";
+        
+        // Number of frames between key frames in compressed trajectories.
+        const std::size_t KEY_FRAME_INTERVAL = 100;
+        
+        // Default number of frame buffers for writing trajectories asynchronously.
+        const std::size_t NUMBER_OF_FRAME_BUFFERS = 4;
+        
+        // Number of events between key records in protonation event logs.
+        const std::size_t KEY_RECORD_INTERVAL = 1000;
+        
         // Default cutoff distance for non bonded interactions.
         static length_t RCUTOFF_DISTANCE_{2.5};  // nm.
         
@@ -33,6 +33,7 @@
 #define SFACTORY_HPP
 
 #include "stypes.hpp"
+#include "sconf.hpp"
 #include "simploce/particle/pfactory.hpp"
 
 namespace simploce {
@@ -117,7 +118,8 @@ namespace simploce {
         simulationModelFactory(const spec_catalog_ptr_t& catalog);
         
         /**
-         * Returns particle pair list generator for coarse grained particle models.
+         * Returns a new particle pair list generator for coarse grained particle 
+         * models. Generators are not shared between models.
          * @param box Simulation box.
          * @param bc Boundary condition.
          * @return Pair list generator.
@@ -252,6 +254,22 @@ namespace simploce {
         cg_displacer_ptr_t 
         langevinVelocityVerlet(cg_interactor_ptr_t& interactor);
         
+        /**
+         * BAOAB Langevin algorithm for coarse grained particle models.
+         * @param interactor Coarse grained interactor.
+         * @return Algorithm.
+         */
+        cg_displacer_ptr_t 
+        baoab(cg_interactor_ptr_t& interactor);
+        
+        /**
+         * Multiple time step (r-RESPA) algorithm for coarse grained particle models.
+         * @param interactor Coarse grained interactor.
+         * @return Algorithm.
+         */
+        cg_displacer_ptr_t 
+        respa(cg_interactor_ptr_t& interactor);
+        
         /**
          * Returns Langevin Velocity Verlet algorithm with proton transfer for 
          * coarse grained models.
@@ -269,8 +287,11 @@ namespace simploce {
          * Change displacer according to given specification.
          * @param displacerSpec Displacer specification.
          * @param sm Coarse grained simulation model.
+         * @param ptMethod Proton transfer method, used by 'pt-lvv' only.
          */
-        void changeDisplacer(std::string displacerSpec, cg_sim_model_ptr_t& sm);
+        void changeDisplacer(std::string displacerSpec, 
+                             cg_sim_model_ptr_t& sm,
+                             const std::string& ptMethod = conf::PT_CONSTANT_RATE);
         
         /**
          * Returns periodic boundary conditions.
@@ -281,8 +302,8 @@ namespace simploce {
         pbc(const box_ptr_t& box);
         
         /**
-         * Returns generator of pairs of protonatable beads possibly involved in proton
-         * transfer.
+         * Returns a new generator of pairs of protonatable beads possibly involved in 
+         * proton transfer. Generators are not shared between models.
          * @param bc Boundary condition.
          * @return Generator.
          */
@@ -290,13 +311,47 @@ namespace simploce {
         protonTransferPairListGenerator(const bc_ptr_t& bc);
         
         /**
-         * Returns proton transfer (PT) displacer with constant rate.
-         * @param rate Rate.
-         * @param gamma Inverse of time constant of decay.
+         * Returns new proton transfer (PT) displacer with constant rate.
+         * @param method PT method, either 'constant-rate' (default), which 
+         * evaluates all pairs every 'npt' steps, or 'event-driven', which only 
+         * visits pairs whose next transfer event is due.
          * @return PT displacer
          */
         pt_displacer_ptr_t 
-        protonTransferDisplacer();
+        protonTransferDisplacer(const std::string& method = conf::PT_CONSTANT_RATE);
+        
+        /**
+         * Returns a new coarse grained interactor, with its own force field. Unlike 
+         * the other interactors returned by this factory, it is not shared by other
+         * simulation models.
+         * @param forceFieldId Force field identifier, e.g. 'pol-water'.
+         * @param catalog Particle specifications catalog.
+         * @param box Simulation box.
+         * @param bc Boundary conditions.
+         * @return Interactor.
+         */
+        cg_interactor_ptr_t
+        makeInteractor(const std::string& forceFieldId,
+                       const spec_catalog_ptr_t& catalog,
+                       const box_ptr_t& box,
+                       const bc_ptr_t& bc);
+        
+        /**
+         * Returns a new coarse grained displacer. Unlike the other displacers 
+         * returned by this factory, it is not shared by other simulation models.
+         * @param displacerId Displacer identifier, e.g. 'lvv', or 'adaptive-lvv' for 
+         * Langevin velocity Verlet with an adaptive time step. The time step of 
+         * leap-frog and RESPA cannot be adapted.
+         * @param interactor Coarse grained interactor.
+         * @param bc Boundary conditions.
+         * @param ptMethod Proton transfer method, used by 'pt-lvv' only.
+         * @return Displacer.
+         */
+        cg_displacer_ptr_t
+        makeDisplacer(const std::string& displacerId,
+                      const cg_interactor_ptr_t& interactor,
+                      const bc_ptr_t& bc,
+                      const std::string& ptMethod = conf::PT_CONSTANT_RATE);
         
     }
 }
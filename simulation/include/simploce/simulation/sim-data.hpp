@@ -33,10 +33,39 @@
 #define SIM_DATA_HPP
 
 #include "stypes.hpp"
+#include "protonation-events.hpp"
 #include <iostream>
+#include <string>
+#include <vector>
 
 namespace simploce {
     
+    /**
+     * Statistics of one type of Monte Carlo trial move.
+     */
+    struct MCMoveStatistics {
+        
+        /**
+         * Move type identifier.
+         */
+        std::string id;
+        
+        /**
+         * Acceptance ratio, in [0, 100].
+         */
+        real_t acceptanceRatio;
+        
+        /**
+         * Step size, in nm (translations) or radians (rotations).
+         */
+        real_t stepSize;
+        
+        /**
+         * Average time per trial move, in microseconds.
+         */
+        real_t time;
+    };
+    
     struct SimulationData {
         
         SimulationData();
@@ -71,11 +100,28 @@ namespace simploce {
          */
         pressure_t pressure;
         
+        /**
+         * Virial tensor of constraint forces. Zero if there are no constraints.
+         */
+        virial_t cvirial;
+        
         /**
          * Number of particle pairs possibly involved in proton transfer.
          */
         std::size_t numberOfProtonTransferPairs;
         
+        /**
+         * Change in non-bonded potential energy due to proton transfers in 
+         * this step, before particles are displaced.
+         */
+        energy_t ptepot;
+        
+        /**
+         * Changes of protonation states due to proton transfers in this step,
+         * in order of time.
+         */
+        std::vector<ProtonationEvent> ptEvents;
+        
         /**
          * Move was accepted in a Monte Carlo simulation.
          */
@@ -85,6 +131,16 @@ namespace simploce {
          * Acceptance ratio in a Monte Carlo simulation, in [0, 100].
          */
         real_t acceptanceRatio;
+        
+        /**
+         * Time step, of an adaptive time step simulation.
+         */
+        stime_t dt;
+        
+        /**
+         * Statistics per type of trial move in a Monte Carlo simulation.
+         */
+        std::vector<MCMoveStatistics> moves;
     };
     
     /**
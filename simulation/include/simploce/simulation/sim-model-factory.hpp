@@ -34,6 +34,7 @@
 
 #include "cg-displacer.hpp"
 #include "sim-model.hpp"
+#include "sconf.hpp"
 #include "stypes.hpp"
 #include "simploce/particle/coarse-grained.hpp"
 
@@ -140,6 +141,19 @@ namespace simploce {
          */
         cg_sim_model_ptr_t readCoarseGrainedFrom(std::istream& stream);
         
+        /**
+         * Creates an independent copy of the given simulation model. The copy holds 
+         * its own particles, interactor (with force field) and displacer, and shares
+         * only the simulation box and boundary condition with the original. Copies 
+         * can therefore be simulated concurrently, e.g. as replicas.
+         * @param sm Coarse grained simulation model.
+         * @param ptMethod Proton transfer method of the given model, used by 'pt-lvv' 
+         * only.
+         * @return Coarse grained model.
+         */
+        cg_sim_model_ptr_t replicate(const cg_sim_model_ptr_t& sm,
+                                     const std::string& ptMethod = conf::PT_CONSTANT_RATE);
+        
     private:
         
         particle_model_fact_ptr_t particleModelFactory_;
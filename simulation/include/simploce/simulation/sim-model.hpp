@@ -96,10 +96,26 @@ namespace simploce {
         interact(const bead_ptr_t& bead, 
                  const sim_param_t& param);
         
+        /**
+         * Lets given bead interact with the given free beads and bead groups 
+         * only, e.g. its neighbors.
+         * @param bead Bead.
+         * @param free Free beads.
+         * @param groups Bead groups.
+         * @param param Simulation parameters. 
+         * @return Data (e.g. potential energy).
+         */
+        SimulationData 
+        interact(const bead_ptr_t& bead,
+                 const std::vector<bead_ptr_t>& free,
+                 const std::vector<bead_group_ptr_t>& groups,
+                 const sim_param_t& param);
+        
         /**
          * Displaces the particles.
          * @param param Simulation parameters. Must provide "npairlists" parameter, the
-         * number of steps between updating the particle pair list.
+         * number of steps between updating the particle pair list. If "virial" is 
+         * true, the pressure is obtained as well.
          * @return Simulation data (e.g. kinetic energy, temperature, etc).
          */
         SimulationData 
@@ -119,6 +135,25 @@ namespace simploce {
         void
         readState(std::istream& stream);
         
+        /**
+         * Writes a checkpoint in binary form, holding the full state of the 
+         * particles (positions, velocities, forces, and protonation states) 
+         * and of the interactor and displacer, such that a simulation can be 
+         * continued exactly.
+         * @param stream Output stream.
+         */
+        void
+        writeCheckpoint(std::ostream& stream) const;
+        
+        /**
+         * Restores state from a checkpoint written by writeCheckpoint(). This 
+         * simulation model must have the same particles and displacer as the 
+         * one the checkpoint was written for.
+         * @param stream Input stream.
+         */
+        void
+        readCheckpoint(std::istream& stream);
+        
         /**
          * Reads simulation model from input stream.
          * @param stream Input stream.
@@ -158,6 +193,18 @@ namespace simploce {
             return cg_->doWithAllFreeGroups<R>(task); 
         }
         
+        /**
+         * Performs a 'task' with protonatable beads. See 
+         * CoarseGrained::doWithProtBeads().
+         * @param task Task of type TASK. May be a lambda expression.
+         * @return Result of type R.
+         */
+        template <typename R, typename TASK>
+        R 
+        doWithProtBeads(const TASK task) { 
+            return cg_->doWithProtBeads<R>(task); 
+        }
+        
         /**
          * Assigns new displacer.
          * @param displacer Displacer.
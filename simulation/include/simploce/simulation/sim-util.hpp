@@ -36,9 +36,16 @@
 #include "simploce/util/mu-units.hpp"
 #include "pair-lists.hpp"
 #include "sconf.hpp"
+#include "simploce/util/util.hpp"
+#include "simploce/util/cube.hpp"
 #include <vector>
 #include <set>
 #include <thread>
+#include <future>
+#include <iostream>
+#include <stdexcept>
+#include <type_traits>
+#include <cstdint>
 
 namespace simploce {
     namespace util {        
@@ -47,14 +54,17 @@ namespace simploce {
          * Calculates instantaneous temperature for a collection of particles.
          * @param particles Particles.
          * @param ekin Kinetic energy.
+         * @param nconstraints Number of holonomic constraints, e.g. fixed bond lengths.
          * @return Instantaneous temperature.
          */
         template <typename T>
         temperature_t temperature(const std::vector<std::shared_ptr<T>>& particles, 
-                                  const energy_t& ekin)
+                                  const energy_t& ekin,
+                                  std::size_t nconstraints = 0)
         {
             std::size_t nparticles = particles.size();
             real_t ndof = 3 * nparticles - 3;  // Assuming total momentum is constant.
+            ndof -= nconstraints;
             if ( ndof > 3 ) {
                 return 2.0 * ekin() / ( ndof * MUUnits<real_t>::KB );  // In K.
             } else {
@@ -64,45 +74,79 @@ namespace simploce {
         }
         
         /**
-         * Returns pressure. Calculated from Virial Theorem.
-         * @param all All particles.
-         * @param temperature Temperature.
-         * @param box Simulation box.
-         * @return Pressure.
+         * Calculates kinetic energy for a collection of particles.
+         * @param particles Particles.
+         * @return Kinetic energy.
          */
         template <typename T>
-        pressure_t pressure(const std::vector<std::shared_ptr<T>>& all,
-                            const temperature_t& temperature,
-                            const box_ptr_t& box)
+        energy_t kineticEnergy(const std::vector<std::shared_ptr<T>>& particles)
         {
-            volume_t volume = box->volume();
-            real_t virial1 = 0.0;
-            pressure_t pressure{};
-
-            std::size_t nparticles = all.size();
-            for (const auto& particle : all) {
-                position_t r = particle->position();
-                force_t f = particle->force();
-                virial1 += inner<real_t>(f,r);
+            energy_t ekin{0.0};
+            for (const auto& particle : particles) {
+                mass_t mass = particle->mass();
+                velocity_t v = particle->velocity();
+                ekin += 0.5 * mass() * inner<real_t>(v, v);
             }
+            return ekin;
+        }
+        
+        /**
+         * Adds the contribution of one particle pair to the virial tensor.
+         * @param virial Virial tensor.
+         * @param rij Distance vector r_i - r_j, boundary condition applied.
+         * @param fij Force on particle i due to particle j.
+         */
+        inline void addToVirial(virial_t& virial,
+                                const dist_vect_t& rij,
+                                const force_t& fij)
+        {
+            for (std::size_t k = 0; k != 3; ++k) {
+                for (std::size_t l = 0; l != 3; ++l) {
+                    virial[k][l] += rij[k] * fij[l];
+                }
+            }
+        }
+        
+        /**
+         * Returns pressure. Calculated from Virial Theorem, 
+         * P = (2 * Ekin + trace(W)) / (3 * V), where W is the pair virial tensor.
+         * @param virial Virial tensor.
+         * @param ekin Kinetic energy.
+         * @param box Simulation box.
+         * @return Pressure, in kJ/(mol nm^3).
+         */
+        inline pressure_t pressure(const virial_t& virial,
+                                   const energy_t& ekin,
+                                   const box_ptr_t& box)
+        {
+            volume_t volume = box->volume();
             if ( volume() > 0.0 ) {
-                virial1 /= ( 3.0 * volume() );
-                real_t virial2 = 
-                    nparticles * MUUnits<real_t>::KB * temperature() / volume();
-                pressure = virial2 - virial1; // In kJ/(mol nm^3)    
+                real_t trace = virial[0][0] + virial[1][1] + virial[2][2];
+                return ( 2.0 * ekin() + trace ) / ( 3.0 * volume() );
             } else {
-                pressure = 0.0;
+                return 0.0;
             }
-            return pressure;            
         }
         
         /**
-         * Returns cutoff distance.
+         * Returns default cutoff distance for non-bonded interactions, half the
+         * box size.
          * @param box Simulation box.
          * @return Cutoff distance. Always <= 0.5 * box.size().
          */
         length_t cutoffDistance(const box_ptr_t& box);
         
+        /**
+         * Returns cutoff distance for non-bonded interactions, as requested by
+         * simulation parameter "cutoff". Throws std::domain_error if it 
+         * exceeds half the box size.
+         * @param box Simulation box.
+         * @param rc Requested cutoff distance. If not positive, half the box size
+         * is used.
+         * @return Cutoff distance. Always <= 0.5 * box.size().
+         */
+        length_t cutoffDistance(const box_ptr_t& box, const length_t& rc);
+        
         /**
          * Returns square of cutoff distance.
          * @param box Simulation box.
@@ -122,6 +166,100 @@ namespace simploce {
                         const temperature_t& temperature,
                         const box_ptr_t& box);
         
+        /**
+         * Returns the number of index ranges a collection of a given size is 
+         * divided into for concurrent processing. Returns 1 for a small collection.
+         * @param n Collection size.
+         * @return Number of ranges.
+         */
+        std::size_t numberOfRanges(std::size_t n);
+        
+        /**
+         * Divides the index range [0,n) into numberOfRanges(n) consecutive ranges,
+         * and executes a task on each range concurrently. One range is handled by 
+         * the current thread.
+         * @param R Return type of task.
+         * @param n Collection size.
+         * @param task Called as task(k, begin, end), where k is the range index.
+         * @return Results of task, in order of ranges.
+         */
+        template <typename R, typename TASK>
+        std::vector<R> forEachRange(std::size_t n, const TASK& task)
+        {
+            std::size_t nranges = numberOfRanges(n);
+            std::size_t size = n / nranges;
+            std::vector<std::future<R>> futures{};
+            for (std::size_t k = 0; k + 1 < nranges; ++k) {
+                futures.push_back(
+                    std::async(std::launch::async, task, k, k * size, (k + 1) * size)
+                );
+            }
+            R last = task(nranges - 1, (nranges - 1) * size, n);
+            std::vector<R> results = waitForAll<R>(futures);
+            results.push_back(last);
+            return results;
+        }
+        
+        /**
+         * Writes value in binary form, in the native byte order.
+         * @param T Value type. Must be trivially copyable.
+         * @param stream Output stream.
+         * @param value Value.
+         */
+        template <typename T>
+        void writeBinary(std::ostream& stream, const T& value)
+        {
+            static_assert(std::is_trivially_copyable<T>::value, "Not trivially copyable.");
+            stream.write(reinterpret_cast<const char*>(&value), sizeof(T));
+        }
+        
+        /**
+         * Writes values in binary form, preceded by their number.
+         * @param T Value type. Must be trivially copyable.
+         * @param stream Output stream.
+         * @param values Values.
+         */
+        template <typename T>
+        void writeBinary(std::ostream& stream, const std::vector<T>& values)
+        {
+            static_assert(std::is_trivially_copyable<T>::value, "Not trivially copyable.");
+            writeBinary<std::uint64_t>(stream, values.size());
+            stream.write(reinterpret_cast<const char*>(values.data()), values.size() * sizeof(T));
+        }
+        
+        /**
+         * Reads value written by writeBinary().
+         * @param T Value type.
+         * @param stream Input stream.
+         * @param value Value.
+         */
+        template <typename T>
+        void readBinary(std::istream& stream, T& value)
+        {
+            static_assert(std::is_trivially_copyable<T>::value, "Not trivially copyable.");
+            if ( !stream.read(reinterpret_cast<char*>(&value), sizeof(T)) ) {
+                throw std::domain_error("readBinary: Unexpected end of stream.");
+            }
+        }
+        
+        /**
+         * Reads values written by writeBinary().
+         * @param T Value type.
+         * @param stream Input stream.
+         * @param values Values.
+         */
+        template <typename T>
+        void readBinary(std::istream& stream, std::vector<T>& values)
+        {
+            static_assert(std::is_trivially_copyable<T>::value, "Not trivially copyable.");
+            std::uint64_t size;
+            readBinary<std::uint64_t>(stream, size);
+            values.resize(size);
+            if ( !stream.read(reinterpret_cast<char*>(values.data()), size * sizeof(T)) ) {
+                throw std::domain_error("readBinary: Unexpected end of stream.");
+            }
+        }
+        
         /**
          * Writes a warning to std::clog if particles are too close.
          * @param pi Particle 1
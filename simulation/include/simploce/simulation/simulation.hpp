@@ -65,6 +65,18 @@ namespace simploce {
          *      nwrite: Number of steps between writing simulation data and saving state
          *      in the trajectectory.
          *  </li>
+         *  <li>
+         *      trajectory: Trajectory format, conf::TEXT_TRAJECTORY or 
+         *      conf::BINARY_TRAJECTORY (optional). See TrajectoryWriter.
+         *  </li>
+         *  <li>
+         *      checkpoint: Checkpoint file name (optional). A checkpoint is 
+         *      written at the end, every "ncheckpoint" steps (optional), and 
+         *      upon Checkpoint::request(), after which the simulation stops.
+         *  </li>
+         *  <li>
+         *      restart: If true, continues from the checkpoint (optional). 
+         *  </li>
          * </ul>
          * @param trajStream Output trajectory stream.
          * @param dataStream Output simulation data stream.
@@ -73,8 +85,27 @@ namespace simploce {
                      std::ofstream& trajStream,
                      std::ofstream& dataStream);
         
+        /**
+         * Performs the simulation, and also logs changes of protonation states,
+         * as reported by proton transfer, at the times of the events. See 
+         * ProtonationEventWriter.
+         * @param param Parameters. See above.
+         * @param trajStream Output trajectory stream.
+         * @param dataStream Output simulation data stream.
+         * @param eventStream Output protonation event stream.
+         */
+        void perform(const sim_param_t& param,
+                     std::ofstream& trajStream,
+                     std::ofstream& dataStream,
+                     std::ofstream& eventStream);
+        
     private:
         
+        void perform_(const sim_param_t& param,
+                      std::ofstream& trajStream,
+                      std::ofstream& dataStream,
+                      std::ofstream* eventStream);
+        
         cg_sim_model_ptr_t sm_;
     };    
     
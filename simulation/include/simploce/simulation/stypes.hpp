@@ -35,6 +35,7 @@
 #include "simploce/particle/ptypes.hpp"
 #include "simploce/util/param.hpp"
 #include <tuple>
+#include <array>
 
 namespace simploce {
     
@@ -60,8 +61,38 @@ namespace simploce {
     template <typename P>
     class SimulationModel;
     
+    // P is particle type, e.g. Atom or Bead.
+    template <typename P>
+    class Rattle;
+    
+    // P is particle type, e.g. Atom or Bead.
+    template <typename P>
+    class TrajectoryWriter;
+    
+    // P is particle type, e.g. Atom or Bead.
+    template <typename P>
+    class TrajectoryReader;
+    
+    // P is particle type, e.g. Atom or Bead.
+    template <typename P>
+    class ProtonationEventWriter;
+    
+    // P is particle type, e.g. Atom or Bead.
+    template <typename P>
+    class ProtonationEventReader;
+    
+    // P is particle type, e.g. Atom or Bead.
+    template <typename P>
+    class Checkpoint;
+    
     using pressure_t = value_t<real_t, 1111>;
     
+    /**
+     * Virial tensor, sum of r_ij (x) f_ij over interacting particle pairs, in 
+     * kJ/mol. Element [k][l] holds sum of r_ij[k] * f_ij[l].
+     */
+    using virial_t = std::array<std::array<real_t, 3>, 3>;
+    
     using dipole_moment_t = cvector_t<real_t, 2222>;
     
     using bc_t = BoundaryCondition;
@@ -115,6 +146,11 @@ namespace simploce {
     using cg_sim_model_ptr_t = std::shared_ptr<SimulationModel<Bead>>;
     
     using sim_model_fact_ptr_t = std::shared_ptr<SimulationModelFactory>;
+    
+    /**
+     * Bond constraint solver pointer type.
+     */
+    using cg_rattle_ptr_t = std::shared_ptr<Rattle<Bead>>;
             
     /**
      * Type for holding simulation parameters, such as values for the time step 
@@ -0,0 +1,299 @@
+/*
+ * The MIT License
+ *
+ * Copyright 2019 André H. Juffer, Biocenter Oulu
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ */
+
+
+/*
+ * File:   trajectory.hpp
+ * Author: André H. Juffer, Biocenter Oulu.
+ *
+ * Created on November 18, 2019, 9:41 AM
+ */
+
+#ifndef TRAJECTORY_HPP
+#define TRAJECTORY_HPP
+
+#include "stypes.hpp"
+#include "sconf.hpp"
+#include "coordinate-codec.hpp"
+#include <iostream>
+#include <string>
+#include <vector>
+#include <cstdint>
+#include <thread>
+#include <mutex>
+#include <condition_variable>
+#include <exception>
+#include <memory>
+
+namespace simploce {
+    
+    /**
+     * Writes states of a simulation model to a trajectory. Three formats are
+     * supported, "text" (see SimulationModel::saveState()), "binary", and 
+     * "compressed". A binary trajectory starts with a header holding the number 
+     * of particles, the box size, the particle specification of each particle,
+     * and the indices of the protonatable particles. Each frame consists of 
+     * fixed width blocks of positions, velocities, and protonation states, 
+     * where real values are in single or double precision. A trailing index of
+     * frame offsets allows for seeking to any frame. Values are written in the 
+     * native byte order. A compressed trajectory is a binary trajectory, but 
+     * its frames hold positions quantized to a given precision and compressed
+     * by CoordinateCodec, followed by protonation states. Velocities are not 
+     * saved. Every conf::KEY_FRAME_INTERVAL frames is a key frame.
+     * <p>
+     * Frames may be written asynchronously. Then, a snapshot of the state is 
+     * copied into one of a fixed number of frame buffers, and a dedicated 
+     * thread serializes and writes buffered frames. Writing only waits if all
+     * buffers are in use.
+     * </p>
+     * @param P Particle type.
+     */
+    template <typename P>
+    class TrajectoryWriter;
+    
+    /**
+     * Specialization for beads.
+     */
+    template <>
+    class TrajectoryWriter<Bead> {
+    public:
+        
+        // Noncopyable.
+        TrajectoryWriter(const TrajectoryWriter&) = delete;
+        TrajectoryWriter& operator = (const TrajectoryWriter&) = delete;
+        
+        /**
+         * Constructor.
+         * @param stream Output stream. Should be opened in binary mode for the 
+         * binary format.
+         * @param format Format, either "text", "binary", or "compressed".
+         * @param doublePrecision If true, real values are written in double 
+         * precision. Binary format only.
+         * @param precision Precision of positions. Compressed format only.
+         * @param nbuffers Number of frame buffers. If 0, frames are written 
+         * synchronously.
+         */
+        TrajectoryWriter(std::ostream& stream,
+                         const std::string& format = conf::TEXT_TRAJECTORY,
+                         bool doublePrecision = false,
+                         const length_t& precision = length_t{0.001},
+                         std::size_t nbuffers = 0);
+        
+        /**
+         * Constructor.
+         * @param stream Output stream.
+         * @param param Simulation parameters. May provide "trajectory" for the 
+         * format (default is "text"), "doubleprecision" (default is false),
+         * "trajprecision" (default is 0.001 nm), and "ntrajbuffers", the number
+         * of frame buffers (default is conf::NUMBER_OF_FRAME_BUFFERS).
+         */
+        TrajectoryWriter(std::ostream& stream, const sim_param_t& param);
+        
+        /**
+         * Destructor. Waits for buffered frames to be written.
+         */
+        ~TrajectoryWriter();
+        
+        /**
+         * Writes current state of the given simulation model as a new frame. 
+         * The header of a binary trajectory is written with the first frame.
+         * The output stream is flushed after each frame. Errors raised while 
+         * writing buffered frames are rethrown by a later call to write() or 
+         * close().
+         * @param sm Simulation model.
+         */
+        void write(const cg_sim_model_ptr_t& sm);
+        
+        /**
+         * Closes the trajectory, after all buffered frames are written. For the
+         * binary format, the frame index is written. Without the index, a 
+         * binary trajectory can still be read.
+         */
+        void close();
+        
+        /**
+         * Returns number of written frames.
+         * @return Number.
+         */
+        std::size_t numberOfFrames() const;
+        
+    private:
+        
+        // Snapshot of a state. Values are indexed by bead index, or by the 
+        // position of the bead among the discrete and continuous protonatable
+        // beads.
+        struct Frame_ {
+            std::vector<position_t> rs;
+            std::vector<velocity_t> vs;
+            std::vector<std::size_t> dstates;
+            std::vector<std::size_t> cstates;
+            std::vector<real_t> xs;
+            std::vector<real_t> Is;
+        };
+        
+        // Frame buffers shared with the writing thread.
+        struct Buffers_ {
+            std::vector<Frame_> frames;
+            std::size_t head = 0;
+            std::size_t count = 0;
+            bool done = false;
+            std::exception_ptr error;
+            std::mutex mutex;
+            std::condition_variable notFull;
+            std::condition_variable notEmpty;
+            std::thread thread;
+        };
+        
+        void layout_(const cg_sim_model_ptr_t& sm);
+        
+        static void snapshot_(const cg_sim_model_ptr_t& sm, Frame_& frame);
+        
+        void writeFrame_(const Frame_& frame);
+        
+        void writeText_(const Frame_& frame);
+        
+        template <typename T>
+        void writeBinary_(const Frame_& frame);
+        
+        void writeCompressed_(const Frame_& frame);
+        
+        template <typename T>
+        void writeStates_(const Frame_& frame);
+        
+        void writeHeader_(const cg_sim_model_ptr_t& sm);
+        
+        void run_();
+        
+        void stop_();
+        
+        std::ostream* stream_;
+        bool binary_;
+        bool compressed_;
+        bool doublePrecision_;
+        bool closed_;
+        std::size_t nframes_;
+        std::size_t nwritten_;
+        std::vector<std::uint64_t> offsets_;
+        CoordinateCodec codec_;
+        
+        // Bead indices in the order of all beads, in the order of the discrete
+        // and in the order of the continuous protonatable beads. For each bead,
+        // the kind (0 for regular, 1 for discrete, and 2 for continuous 
+        // protonatable beads) and position among beads of the same kind.
+        std::vector<std::size_t> order_;
+        std::vector<std::size_t> dindices_;
+        std::vector<std::size_t> cindices_;
+        std::vector<std::uint8_t> kinds_;
+        std::vector<std::size_t> slots_;
+        
+        Frame_ frame_;
+        std::size_t nbuffers_;
+        std::unique_ptr<Buffers_> buffers_;
+    };
+    
+    /**
+     * Reads states of a simulation model from a trajectory. The format is 
+     * detected from the stream contents.
+     * @param P Particle type.
+     */
+    template <typename P>
+    class TrajectoryReader;
+    
+    /**
+     * Specialization for beads.
+     */
+    template <>
+    class TrajectoryReader<Bead> {
+    public:
+        
+        /**
+         * Constructor. For a binary trajectory, the header and the frame index
+         * are read.
+         * @param stream Input stream. Should be opened in binary mode for the 
+         * binary format.
+         */
+        TrajectoryReader(std::istream& stream);
+        
+        /**
+         * Reads the next frame into the given simulation model.
+         * @param sm Simulation model. Must match the trajectory.
+         * @return True if a frame was read, false at the end of the trajectory.
+         */
+        bool read(const cg_sim_model_ptr_t& sm);
+        
+        /**
+         * Positions the trajectory at the given frame, such that the next 
+         * read() returns that frame. Binary and compressed formats only.
+         * @param frame Frame number, starting at 0.
+         */
+        void seek(std::size_t frame);
+        
+        /**
+         * Returns number of frames. Binary and compressed formats only.
+         * @return Number.
+         */
+        std::size_t numberOfFrames() const;
+        
+        /**
+         * Returns whether the trajectory is in binary or compressed format.
+         * @return Result.
+         */
+        bool isBinary() const;
+        
+    private:
+        
+        void readHeader_();
+        
+        template <typename T>
+        void readFrame_(const cg_sim_model_ptr_t& sm);
+        
+        void readCompressedFrame_(const cg_sim_model_ptr_t& sm);
+        
+        void decode_(std::size_t frame);
+        
+        template <typename T>
+        void readStates_(const cg_sim_model_ptr_t& sm);
+        
+        std::istream* stream_;
+        bool binary_;
+        bool compressed_;
+        bool doublePrecision_;
+        std::size_t nbeads_;
+        std::size_t ndiscrete_;
+        std::size_t ncontinuous_;
+        std::uint64_t begin_;
+        std::uint64_t frameSize_;
+        std::size_t frame_;
+        std::vector<std::uint64_t> offsets_;
+        CoordinateCodec codec_;
+        std::size_t nkey_;
+        
+        // Frame that can be decoded next without first decoding a key frame.
+        std::size_t next_;
+        std::vector<std::uint8_t> buffer_;
+        std::vector<position_t> rs_;
+    };
+}
+
+#endif /* TRAJECTORY_HPP */
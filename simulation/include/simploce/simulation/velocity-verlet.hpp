@@ -72,10 +72,16 @@ namespace simploce {
     private:
         
         at_interactor_ptr_t interactor_;
+        
+        mutable bool setup_;
+        mutable std::size_t counter_;
+        mutable stime_t dt_;
     };
     
     /**
-     * Specialization for coarse grained model.
+     * Specialization for coarse grained model. If the simulation parameter 
+     * "constraints" is 'rattle', bonds in particle groups are held at the bond
+     * length of the force field.
      */
     template <>
     class VelocityVerlet<CoarseGrained> : public CoarseGrainedDisplacer {
@@ -95,10 +101,20 @@ namespace simploce {
         std::string 
         id() const override;
         
+        void 
+        writeCheckpoint(std::ostream& stream) const override;
+        
+        void 
+        readCheckpoint(std::istream& stream, const cg_ptr_t& cg) override;
+        
     private:
         
         cg_interactor_ptr_t interactor_;
-            
+        
+        mutable bool setup_;
+        mutable std::size_t counter_;
+        mutable stime_t dt_;
+        mutable cg_rattle_ptr_t rattle_;
     };
     
 }
@@ -36,29 +36,41 @@ OBJECTDIR=${CND_BUILDDIR}/${CND_CONF}/${CND_PLATFORM}
 # Object Files
 OBJECTFILES= \
 	${OBJECTDIR}/src/acid-base-solution.o \
+	${OBJECTDIR}/src/adaptive-timestep.o \
 	${OBJECTDIR}/src/analysis.o \
+	${OBJECTDIR}/src/baoab.o \
 	${OBJECTDIR}/src/cell-lists.o \
 	${OBJECTDIR}/src/cg-electrolyte.o \
 	${OBJECTDIR}/src/cg-hp.o \
 	${OBJECTDIR}/src/cg-lj-fluid.o \
 	${OBJECTDIR}/src/cg-pol-water.o \
+	${OBJECTDIR}/src/checkpoint.o \
 	${OBJECTDIR}/src/constant-rate-pt.o \
+	${OBJECTDIR}/src/coordinate-codec.o \
 	${OBJECTDIR}/src/distance-lists.o \
+	${OBJECTDIR}/src/event-driven-pt.o \
+	${OBJECTDIR}/src/hmc.o \
 	${OBJECTDIR}/src/interactor.o \
 	${OBJECTDIR}/src/langevin-velocity-verlet.o \
 	${OBJECTDIR}/src/leap-frog.o \
 	${OBJECTDIR}/src/lj-coulomb-forces.o \
 	${OBJECTDIR}/src/mc.o \
+	${OBJECTDIR}/src/minimizer.o \
 	${OBJECTDIR}/src/no-bc.o \
 	${OBJECTDIR}/src/pbc.o \
+	${OBJECTDIR}/src/protonation-events.o \
 	${OBJECTDIR}/src/pt-langevin-velocity-verlet.o \
 	${OBJECTDIR}/src/pt-pair-list-generator.o \
+	${OBJECTDIR}/src/rattle.o \
+	${OBJECTDIR}/src/replica-exchange.o \
+	${OBJECTDIR}/src/respa.o \
 	${OBJECTDIR}/src/sfactory.o \
 	${OBJECTDIR}/src/sim-data.o \
 	${OBJECTDIR}/src/sim-model-factory.o \
 	${OBJECTDIR}/src/sim-model.o \
 	${OBJECTDIR}/src/sim-util.o \
 	${OBJECTDIR}/src/simulation.o \
+	${OBJECTDIR}/src/trajectory.o \
 	${OBJECTDIR}/src/velocity-verlet.o
 
 # Test Directory
@@ -68,21 +80,31 @@ TESTDIR=${CND_BUILDDIR}/${CND_CONF}/${CND_PLATFORM}/tests
 TESTFILES= \
 	${TESTDIR}/TestFiles/f5 \
 	${TESTDIR}/TestFiles/f1 \
+	${TESTDIR}/TestFiles/f9 \
+	${TESTDIR}/TestFiles/f11 \
+	${TESTDIR}/TestFiles/f10 \
 	${TESTDIR}/TestFiles/f4 \
 	${TESTDIR}/TestFiles/f7 \
+	${TESTDIR}/TestFiles/f12 \
 	${TESTDIR}/TestFiles/f6 \
 	${TESTDIR}/TestFiles/f3 \
-	${TESTDIR}/TestFiles/f2
+	${TESTDIR}/TestFiles/f2 \
+	${TESTDIR}/TestFiles/f8
 
 # Test Object Files
 TESTOBJECTFILES= \
 	${TESTDIR}/tests/analyzers-test.o \
 	${TESTDIR}/tests/displacer-test.o \
+	${TESTDIR}/tests/integrator-test.o \
+	${TESTDIR}/tests/mc-test.o \
+	${TESTDIR}/tests/minimizer-test.o \
 	${TESTDIR}/tests/pair-list-test.o \
 	${TESTDIR}/tests/pdb-test.o \
+	${TESTDIR}/tests/proton-transfer-test.o \
 	${TESTDIR}/tests/pt-pairlist-test.o \
 	${TESTDIR}/tests/simulation-model-factory-test.o \
-	${TESTDIR}/tests/simulation-test.o
+	${TESTDIR}/tests/simulation-test.o \
+	${TESTDIR}/tests/trajectory-test.o
 
 # C Compiler Flags
 CFLAGS=
@@ -117,11 +139,21 @@ ${OBJECTDIR}/src/acid-base-solution.o: src/acid-base-solution.cpp
 	${RM} "$@.d"
 	$(COMPILE.cc) -O2 -Wall -Iinclude -I../cpputil/include -I../particles/include -std=c++14 -fPIC  -MMD -MP -MF "$@.d" -o ${OBJECTDIR}/src/acid-base-solution.o src/acid-base-solution.cpp
 
+${OBJECTDIR}/src/adaptive-timestep.o: src/adaptive-timestep.cpp
+	${MKDIR} -p ${OBJECTDIR}/src
+	${RM} "$@.d"
+	$(COMPILE.cc) -O2 -Wall -Iinclude -I../cpputil/include -I../particles/include -std=c++14 -fPIC  -MMD -MP -MF "$@.d" -o ${OBJECTDIR}/src/adaptive-timestep.o src/adaptive-timestep.cpp
+
 ${OBJECTDIR}/src/analysis.o: src/analysis.cpp
 	${MKDIR} -p ${OBJECTDIR}/src
 	${RM} "$@.d"
 	$(COMPILE.cc) -O2 -Wall -Iinclude -I../cpputil/include -I../particles/include -std=c++14 -fPIC  -MMD -MP -MF "$@.d" -o ${OBJECTDIR}/src/analysis.o src/analysis.cpp
 
+${OBJECTDIR}/src/baoab.o: src/baoab.cpp
+	${MKDIR} -p ${OBJECTDIR}/src
+	${RM} "$@.d"
+	$(COMPILE.cc) -O2 -Wall -Iinclude -I../cpputil/include -I../particles/include -std=c++14 -fPIC  -MMD -MP -MF "$@.d" -o ${OBJECTDIR}/src/baoab.o src/baoab.cpp
+
 ${OBJECTDIR}/src/cell-lists.o: src/cell-lists.cpp
 	${MKDIR} -p ${OBJECTDIR}/src
 	${RM} "$@.d"
@@ -147,16 +179,36 @@ ${OBJECTDIR}/src/cg-pol-water.o: src/cg-pol-water.cpp
 	${RM} "$@.d"
 	$(COMPILE.cc) -O2 -Wall -Iinclude -I../cpputil/include -I../particles/include -std=c++14 -fPIC  -MMD -MP -MF "$@.d" -o ${OBJECTDIR}/src/cg-pol-water.o src/cg-pol-water.cpp
 
+${OBJECTDIR}/src/checkpoint.o: src/checkpoint.cpp
+	${MKDIR} -p ${OBJECTDIR}/src
+	${RM} "$@.d"
+	$(COMPILE.cc) -O2 -Wall -Iinclude -I../cpputil/include -I../particles/include -std=c++14 -fPIC  -MMD -MP -MF "$@.d" -o ${OBJECTDIR}/src/checkpoint.o src/checkpoint.cpp
+
 ${OBJECTDIR}/src/constant-rate-pt.o: src/constant-rate-pt.cpp
 	${MKDIR} -p ${OBJECTDIR}/src
 	${RM} "$@.d"
 	$(COMPILE.cc) -O2 -Wall -Iinclude -I../cpputil/include -I../particles/include -std=c++14 -fPIC  -MMD -MP -MF "$@.d" -o ${OBJECTDIR}/src/constant-rate-pt.o src/constant-rate-pt.cpp
 
+${OBJECTDIR}/src/coordinate-codec.o: src/coordinate-codec.cpp
+	${MKDIR} -p ${OBJECTDIR}/src
+	${RM} "$@.d"
+	$(COMPILE.cc) -O2 -Wall -Iinclude -I../cpputil/include -I../particles/include -std=c++14 -fPIC  -MMD -MP -MF "$@.d" -o ${OBJECTDIR}/src/coordinate-codec.o src/coordinate-codec.cpp
+
 ${OBJECTDIR}/src/distance-lists.o: src/distance-lists.cpp
 	${MKDIR} -p ${OBJECTDIR}/src
 	${RM} "$@.d"
 	$(COMPILE.cc) -O2 -Wall -Iinclude -I../cpputil/include -I../particles/include -std=c++14 -fPIC  -MMD -MP -MF "$@.d" -o ${OBJECTDIR}/src/distance-lists.o src/distance-lists.cpp
 
+${OBJECTDIR}/src/event-driven-pt.o: src/event-driven-pt.cpp
+	${MKDIR} -p ${OBJECTDIR}/src
+	${RM} "$@.d"
+	$(COMPILE.cc) -O2 -Wall -Iinclude -I../cpputil/include -I../particles/include -std=c++14 -fPIC  -MMD -MP -MF "$@.d" -o ${OBJECTDIR}/src/event-driven-pt.o src/event-driven-pt.cpp
+
+${OBJECTDIR}/src/hmc.o: src/hmc.cpp
+	${MKDIR} -p ${OBJECTDIR}/src
+	${RM} "$@.d"
+	$(COMPILE.cc) -O2 -Wall -Iinclude -I../cpputil/include -I../particles/include -std=c++14 -fPIC  -MMD -MP -MF "$@.d" -o ${OBJECTDIR}/src/hmc.o src/hmc.cpp
+
 ${OBJECTDIR}/src/interactor.o: src/interactor.cpp
 	${MKDIR} -p ${OBJECTDIR}/src
 	${RM} "$@.d"
@@ -182,6 +234,11 @@ ${OBJECTDIR}/src/mc.o: src/mc.cpp
 	${RM} "$@.d"
 	$(COMPILE.cc) -O2 -Wall -Iinclude -I../cpputil/include -I../particles/include -std=c++14 -fPIC  -MMD -MP -MF "$@.d" -o ${OBJECTDIR}/src/mc.o src/mc.cpp
 
+${OBJECTDIR}/src/minimizer.o: src/minimizer.cpp
+	${MKDIR} -p ${OBJECTDIR}/src
+	${RM} "$@.d"
+	$(COMPILE.cc) -O2 -Wall -Iinclude -I../cpputil/include -I../particles/include -std=c++14 -fPIC  -MMD -MP -MF "$@.d" -o ${OBJECTDIR}/src/minimizer.o src/minimizer.cpp
+
 ${OBJECTDIR}/src/no-bc.o: src/no-bc.cpp
 	${MKDIR} -p ${OBJECTDIR}/src
 	${RM} "$@.d"
@@ -192,6 +249,11 @@ ${OBJECTDIR}/src/pbc.o: src/pbc.cpp
 	${RM} "$@.d"
 	$(COMPILE.cc) -O2 -Wall -Iinclude -I../cpputil/include -I../particles/include -std=c++14 -fPIC  -MMD -MP -MF "$@.d" -o ${OBJECTDIR}/src/pbc.o src/pbc.cpp
 
+${OBJECTDIR}/src/protonation-events.o: src/protonation-events.cpp
+	${MKDIR} -p ${OBJECTDIR}/src
+	${RM} "$@.d"
+	$(COMPILE.cc) -O2 -Wall -Iinclude -I../cpputil/include -I../particles/include -std=c++14 -fPIC  -MMD -MP -MF "$@.d" -o ${OBJECTDIR}/src/protonation-events.o src/protonation-events.cpp
+
 ${OBJECTDIR}/src/pt-langevin-velocity-verlet.o: src/pt-langevin-velocity-verlet.cpp
 	${MKDIR} -p ${OBJECTDIR}/src
 	${RM} "$@.d"
@@ -202,6 +264,21 @@ ${OBJECTDIR}/src/pt-pair-list-generator.o: src/pt-pair-list-generator.cpp
 	${RM} "$@.d"
 	$(COMPILE.cc) -O2 -Wall -Iinclude -I../cpputil/include -I../particles/include -std=c++14 -fPIC  -MMD -MP -MF "$@.d" -o ${OBJECTDIR}/src/pt-pair-list-generator.o src/pt-pair-list-generator.cpp
 
+${OBJECTDIR}/src/rattle.o: src/rattle.cpp
+	${MKDIR} -p ${OBJECTDIR}/src
+	${RM} "$@.d"
+	$(COMPILE.cc) -O2 -Wall -Iinclude -I../cpputil/include -I../particles/include -std=c++14 -fPIC  -MMD -MP -MF "$@.d" -o ${OBJECTDIR}/src/rattle.o src/rattle.cpp
+
+${OBJECTDIR}/src/replica-exchange.o: src/replica-exchange.cpp
+	${MKDIR} -p ${OBJECTDIR}/src
+	${RM} "$@.d"
+	$(COMPILE.cc) -O2 -Wall -Iinclude -I../cpputil/include -I../particles/include -std=c++14 -fPIC  -MMD -MP -MF "$@.d" -o ${OBJECTDIR}/src/replica-exchange.o src/replica-exchange.cpp
+
+${OBJECTDIR}/src/respa.o: src/respa.cpp
+	${MKDIR} -p ${OBJECTDIR}/src
+	${RM} "$@.d"
+	$(COMPILE.cc) -O2 -Wall -Iinclude -I../cpputil/include -I../particles/include -std=c++14 -fPIC  -MMD -MP -MF "$@.d" -o ${OBJECTDIR}/src/respa.o src/respa.cpp
+
 ${OBJECTDIR}/src/sfactory.o: src/sfactory.cpp
 	${MKDIR} -p ${OBJECTDIR}/src
 	${RM} "$@.d"
@@ -232,6 +309,11 @@ ${OBJECTDIR}/src/simulation.o: src/simulation.cpp
 	${RM} "$@.d"
 	$(COMPILE.cc) -O2 -Wall -Iinclude -I../cpputil/include -I../particles/include -std=c++14 -fPIC  -MMD -MP -MF "$@.d" -o ${OBJECTDIR}/src/simulation.o src/simulation.cpp
 
+${OBJECTDIR}/src/trajectory.o: src/trajectory.cpp
+	${MKDIR} -p ${OBJECTDIR}/src
+	${RM} "$@.d"
+	$(COMPILE.cc) -O2 -Wall -Iinclude -I../cpputil/include -I../particles/include -std=c++14 -fPIC  -MMD -MP -MF "$@.d" -o ${OBJECTDIR}/src/trajectory.o src/trajectory.cpp
+
 ${OBJECTDIR}/src/velocity-verlet.o: src/velocity-verlet.cpp
 	${MKDIR} -p ${OBJECTDIR}/src
 	${RM} "$@.d"
@@ -254,6 +336,18 @@ ${TESTDIR}/TestFiles/f1: ${TESTDIR}/tests/displacer-test.o ${OBJECTFILES:%.o=%_n
 	${MKDIR} -p ${TESTDIR}/TestFiles
 	${LINK.cc} -o ${TESTDIR}/TestFiles/f1 $^ ${LDLIBSOPTIONS}   
 
+${TESTDIR}/TestFiles/f9: ${TESTDIR}/tests/integrator-test.o ${OBJECTFILES:%.o=%_nomain.o}
+	${MKDIR} -p ${TESTDIR}/TestFiles
+	${LINK.cc} -o ${TESTDIR}/TestFiles/f9 $^ ${LDLIBSOPTIONS}   
+
+${TESTDIR}/TestFiles/f11: ${TESTDIR}/tests/mc-test.o ${OBJECTFILES:%.o=%_nomain.o}
+	${MKDIR} -p ${TESTDIR}/TestFiles
+	${LINK.cc} -o ${TESTDIR}/TestFiles/f11 $^ ${LDLIBSOPTIONS}   
+
+${TESTDIR}/TestFiles/f10: ${TESTDIR}/tests/minimizer-test.o ${OBJECTFILES:%.o=%_nomain.o}
+	${MKDIR} -p ${TESTDIR}/TestFiles
+	${LINK.cc} -o ${TESTDIR}/TestFiles/f10 $^ ${LDLIBSOPTIONS}   
+
 ${TESTDIR}/TestFiles/f4: ${TESTDIR}/tests/pair-list-test.o ${OBJECTFILES:%.o=%_nomain.o}
 	${MKDIR} -p ${TESTDIR}/TestFiles
 	${LINK.cc} -o ${TESTDIR}/TestFiles/f4 $^ ${LDLIBSOPTIONS}   
@@ -262,6 +356,10 @@ ${TESTDIR}/TestFiles/f7: ${TESTDIR}/tests/pdb-test.o ${OBJECTFILES:%.o=%_nomain.
 	${MKDIR} -p ${TESTDIR}/TestFiles
 	${LINK.cc} -o ${TESTDIR}/TestFiles/f7 $^ ${LDLIBSOPTIONS}   
 
+${TESTDIR}/TestFiles/f12: ${TESTDIR}/tests/proton-transfer-test.o ${OBJECTFILES:%.o=%_nomain.o}
+	${MKDIR} -p ${TESTDIR}/TestFiles
+	${LINK.cc} -o ${TESTDIR}/TestFiles/f12 $^ ${LDLIBSOPTIONS}   
+
 ${TESTDIR}/TestFiles/f6: ${TESTDIR}/tests/pt-pairlist-test.o ${OBJECTFILES:%.o=%_nomain.o}
 	${MKDIR} -p ${TESTDIR}/TestFiles
 	${LINK.cc} -o ${TESTDIR}/TestFiles/f6 $^ ${LDLIBSOPTIONS}   
@@ -274,6 +372,10 @@ ${TESTDIR}/TestFiles/f2: ${TESTDIR}/tests/simulation-test.o ${OBJECTFILES:%.o=%_
 	${MKDIR} -p ${TESTDIR}/TestFiles
 	${LINK.cc} -o ${TESTDIR}/TestFiles/f2 $^ ${LDLIBSOPTIONS}   
 
+${TESTDIR}/TestFiles/f8: ${TESTDIR}/tests/trajectory-test.o ${OBJECTFILES:%.o=%_nomain.o}
+	${MKDIR} -p ${TESTDIR}/TestFiles
+	${LINK.cc} -o ${TESTDIR}/TestFiles/f8 $^ ${LDLIBSOPTIONS}   
+
 
 ${TESTDIR}/tests/analyzers-test.o: tests/analyzers-test.cpp 
 	${MKDIR} -p ${TESTDIR}/tests
@@ -287,6 +389,24 @@ ${TESTDIR}/tests/displacer-test.o: tests/displacer-test.cpp
 	$(COMPILE.cc) -O2 -Wall -Iinclude -I../cpputil/include -I../particles/include -I. -std=c++14 -MMD -MP -MF "$@.d" -o ${TESTDIR}/tests/displacer-test.o tests/displacer-test.cpp
 
 
+${TESTDIR}/tests/integrator-test.o: tests/integrator-test.cpp 
+	${MKDIR} -p ${TESTDIR}/tests
+	${RM} "$@.d"
+	$(COMPILE.cc) -O2 -Wall -Iinclude -I../cpputil/include -I../particles/include -I. -std=c++14 -MMD -MP -MF "$@.d" -o ${TESTDIR}/tests/integrator-test.o tests/integrator-test.cpp
+
+
+${TESTDIR}/tests/mc-test.o: tests/mc-test.cpp 
+	${MKDIR} -p ${TESTDIR}/tests
+	${RM} "$@.d"
+	$(COMPILE.cc) -O2 -Wall -Iinclude -I../cpputil/include -I../particles/include -I. -std=c++14 -MMD -MP -MF "$@.d" -o ${TESTDIR}/tests/mc-test.o tests/mc-test.cpp
+
+
+${TESTDIR}/tests/minimizer-test.o: tests/minimizer-test.cpp 
+	${MKDIR} -p ${TESTDIR}/tests
+	${RM} "$@.d"
+	$(COMPILE.cc) -O2 -Wall -Iinclude -I../cpputil/include -I../particles/include -I. -std=c++14 -MMD -MP -MF "$@.d" -o ${TESTDIR}/tests/minimizer-test.o tests/minimizer-test.cpp
+
+
 ${TESTDIR}/tests/pair-list-test.o: tests/pair-list-test.cpp 
 	${MKDIR} -p ${TESTDIR}/tests
 	${RM} "$@.d"
@@ -299,6 +419,12 @@ ${TESTDIR}/tests/pdb-test.o: tests/pdb-test.cpp
 	$(COMPILE.cc) -O2 -Wall -Iinclude -I../cpputil/include -I../particles/include -I. -std=c++14 -MMD -MP -MF "$@.d" -o ${TESTDIR}/tests/pdb-test.o tests/pdb-test.cpp
 
 
+${TESTDIR}/tests/proton-transfer-test.o: tests/proton-transfer-test.cpp 
+	${MKDIR} -p ${TESTDIR}/tests
+	${RM} "$@.d"
+	$(COMPILE.cc) -O2 -Wall -Iinclude -I../cpputil/include -I../particles/include -I. -std=c++14 -MMD -MP -MF "$@.d" -o ${TESTDIR}/tests/proton-transfer-test.o tests/proton-transfer-test.cpp
+
+
 ${TESTDIR}/tests/pt-pairlist-test.o: tests/pt-pairlist-test.cpp 
 	${MKDIR} -p ${TESTDIR}/tests
 	${RM} "$@.d"
@@ -317,6 +443,12 @@ ${TESTDIR}/tests/simulation-test.o: tests/simulation-test.cpp
 	$(COMPILE.cc) -O2 -Wall -Iinclude -I../cpputil/include -I../particles/include -I. -std=c++14 -MMD -MP -MF "$@.d" -o ${TESTDIR}/tests/simulation-test.o tests/simulation-test.cpp
 
 
+${TESTDIR}/tests/trajectory-test.o: tests/trajectory-test.cpp 
+	${MKDIR} -p ${TESTDIR}/tests
+	${RM} "$@.d"
+	$(COMPILE.cc) -O2 -Wall -Iinclude -I../cpputil/include -I../particles/include -I. -std=c++14 -MMD -MP -MF "$@.d" -o ${TESTDIR}/tests/trajectory-test.o tests/trajectory-test.cpp
+
+
 ${OBJECTDIR}/src/acid-base-solution_nomain.o: ${OBJECTDIR}/src/acid-base-solution.o src/acid-base-solution.cpp 
 	${MKDIR} -p ${OBJECTDIR}/src
 	@NMOUTPUT=`${NM} ${OBJECTDIR}/src/acid-base-solution.o`; \
@@ -330,6 +462,19 @@ ${OBJECTDIR}/src/acid-base-solution_nomain.o: ${OBJECTDIR}/src/acid-base-solutio
 	    ${CP} ${OBJECTDIR}/src/acid-base-solution.o ${OBJECTDIR}/src/acid-base-solution_nomain.o;\
 	fi
 
+${OBJECTDIR}/src/adaptive-timestep_nomain.o: ${OBJECTDIR}/src/adaptive-timestep.o src/adaptive-timestep.cpp 
+	${MKDIR} -p ${OBJECTDIR}/src
+	@NMOUTPUT=`${NM} ${OBJECTDIR}/src/adaptive-timestep.o`; \
+	if (echo "$$NMOUTPUT" | ${GREP} '|main$$') || \
+	   (echo "$$NMOUTPUT" | ${GREP} 'T main$$') || \
+	   (echo "$$NMOUTPUT" | ${GREP} 'T _main$$'); \
+	then  \
+	    ${RM} "$@.d";\
+	    $(COMPILE.cc) -O2 -Wall -Iinclude -I../cpputil/include -I../particles/include -std=c++14 -fPIC  -Dmain=__nomain -MMD -MP -MF "$@.d" -o ${OBJECTDIR}/src/adaptive-timestep_nomain.o src/adaptive-timestep.cpp;\
+	else  \
+	    ${CP} ${OBJECTDIR}/src/adaptive-timestep.o ${OBJECTDIR}/src/adaptive-timestep_nomain.o;\
+	fi
+
 ${OBJECTDIR}/src/analysis_nomain.o: ${OBJECTDIR}/src/analysis.o src/analysis.cpp 
 	${MKDIR} -p ${OBJECTDIR}/src
 	@NMOUTPUT=`${NM} ${OBJECTDIR}/src/analysis.o`; \
@@ -343,6 +488,19 @@ ${OBJECTDIR}/src/analysis_nomain.o: ${OBJECTDIR}/src/analysis.o src/analysis.cpp
 	    ${CP} ${OBJECTDIR}/src/analysis.o ${OBJECTDIR}/src/analysis_nomain.o;\
 	fi
 
+${OBJECTDIR}/src/baoab_nomain.o: ${OBJECTDIR}/src/baoab.o src/baoab.cpp 
+	${MKDIR} -p ${OBJECTDIR}/src
+	@NMOUTPUT=`${NM} ${OBJECTDIR}/src/baoab.o`; \
+	if (echo "$$NMOUTPUT" | ${GREP} '|main$$') || \
+	   (echo "$$NMOUTPUT" | ${GREP} 'T main$$') || \
+	   (echo "$$NMOUTPUT" | ${GREP} 'T _main$$'); \
+	then  \
+	    ${RM} "$@.d";\
+	    $(COMPILE.cc) -O2 -Wall -Iinclude -I../cpputil/include -I../particles/include -std=c++14 -fPIC  -Dmain=__nomain -MMD -MP -MF "$@.d" -o ${OBJECTDIR}/src/baoab_nomain.o src/baoab.cpp;\
+	else  \
+	    ${CP} ${OBJECTDIR}/src/baoab.o ${OBJECTDIR}/src/baoab_nomain.o;\
+	fi
+
 ${OBJECTDIR}/src/cell-lists_nomain.o: ${OBJECTDIR}/src/cell-lists.o src/cell-lists.cpp 
 	${MKDIR} -p ${OBJECTDIR}/src
 	@NMOUTPUT=`${NM} ${OBJECTDIR}/src/cell-lists.o`; \
@@ -408,6 +566,19 @@ ${OBJECTDIR}/src/cg-pol-water_nomain.o: ${OBJECTDIR}/src/cg-pol-water.o src/cg-p
 	    ${CP} ${OBJECTDIR}/src/cg-pol-water.o ${OBJECTDIR}/src/cg-pol-water_nomain.o;\
 	fi
 
+${OBJECTDIR}/src/checkpoint_nomain.o: ${OBJECTDIR}/src/checkpoint.o src/checkpoint.cpp 
+	${MKDIR} -p ${OBJECTDIR}/src
+	@NMOUTPUT=`${NM} ${OBJECTDIR}/src/checkpoint.o`; \
+	if (echo "$$NMOUTPUT" | ${GREP} '|main$$') || \
+	   (echo "$$NMOUTPUT" | ${GREP} 'T main$$') || \
+	   (echo "$$NMOUTPUT" | ${GREP} 'T _main$$'); \
+	then  \
+	    ${RM} "$@.d";\
+	    $(COMPILE.cc) -O2 -Wall -Iinclude -I../cpputil/include -I../particles/include -std=c++14 -fPIC  -Dmain=__nomain -MMD -MP -MF "$@.d" -o ${OBJECTDIR}/src/checkpoint_nomain.o src/checkpoint.cpp;\
+	else  \
+	    ${CP} ${OBJECTDIR}/src/checkpoint.o ${OBJECTDIR}/src/checkpoint_nomain.o;\
+	fi
+
 ${OBJECTDIR}/src/constant-rate-pt_nomain.o: ${OBJECTDIR}/src/constant-rate-pt.o src/constant-rate-pt.cpp 
 	${MKDIR} -p ${OBJECTDIR}/src
 	@NMOUTPUT=`${NM} ${OBJECTDIR}/src/constant-rate-pt.o`; \
@@ -421,6 +592,19 @@ ${OBJECTDIR}/src/constant-rate-pt_nomain.o: ${OBJECTDIR}/src/constant-rate-pt.o
 	    ${CP} ${OBJECTDIR}/src/constant-rate-pt.o ${OBJECTDIR}/src/constant-rate-pt_nomain.o;\
 	fi
 
+${OBJECTDIR}/src/coordinate-codec_nomain.o: ${OBJECTDIR}/src/coordinate-codec.o src/coordinate-codec.cpp 
+	${MKDIR} -p ${OBJECTDIR}/src
+	@NMOUTPUT=`${NM} ${OBJECTDIR}/src/coordinate-codec.o`; \
+	if (echo "$$NMOUTPUT" | ${GREP} '|main$$') || \
+	   (echo "$$NMOUTPUT" | ${GREP} 'T main$$') || \
+	   (echo "$$NMOUTPUT" | ${GREP} 'T _main$$'); \
+	then  \
+	    ${RM} "$@.d";\
+	    $(COMPILE.cc) -O2 -Wall -Iinclude -I../cpputil/include -I../particles/include -std=c++14 -fPIC  -Dmain=__nomain -MMD -MP -MF "$@.d" -o ${OBJECTDIR}/src/coordinate-codec_nomain.o src/coordinate-codec.cpp;\
+	else  \
+	    ${CP} ${OBJECTDIR}/src/coordinate-codec.o ${OBJECTDIR}/src/coordinate-codec_nomain.o;\
+	fi
+
 ${OBJECTDIR}/src/distance-lists_nomain.o: ${OBJECTDIR}/src/distance-lists.o src/distance-lists.cpp 
 	${MKDIR} -p ${OBJECTDIR}/src
 	@NMOUTPUT=`${NM} ${OBJECTDIR}/src/distance-lists.o`; \
@@ -434,6 +618,32 @@ ${OBJECTDIR}/src/distance-lists_nomain.o: ${OBJECTDIR}/src/distance-lists.o src/
 	    ${CP} ${OBJECTDIR}/src/distance-lists.o ${OBJECTDIR}/src/distance-lists_nomain.o;\
 	fi
 
+${OBJECTDIR}/src/event-driven-pt_nomain.o: ${OBJECTDIR}/src/event-driven-pt.o src/event-driven-pt.cpp 
+	${MKDIR} -p ${OBJECTDIR}/src
+	@NMOUTPUT=`${NM} ${OBJECTDIR}/src/event-driven-pt.o`; \
+	if (echo "$$NMOUTPUT" | ${GREP} '|main$$') || \
+	   (echo "$$NMOUTPUT" | ${GREP} 'T main$$') || \
+	   (echo "$$NMOUTPUT" | ${GREP} 'T _main$$'); \
+	then  \
+	    ${RM} "$@.d";\
+	    $(COMPILE.cc) -O2 -Wall -Iinclude -I../cpputil/include -I../particles/include -std=c++14 -fPIC  -Dmain=__nomain -MMD -MP -MF "$@.d" -o ${OBJECTDIR}/src/event-driven-pt_nomain.o src/event-driven-pt.cpp;\
+	else  \
+	    ${CP} ${OBJECTDIR}/src/event-driven-pt.o ${OBJECTDIR}/src/event-driven-pt_nomain.o;\
+	fi
+
+${OBJECTDIR}/src/hmc_nomain.o: ${OBJECTDIR}/src/hmc.o src/hmc.cpp 
+	${MKDIR} -p ${OBJECTDIR}/src
+	@NMOUTPUT=`${NM} ${OBJECTDIR}/src/hmc.o`; \
+	if (echo "$$NMOUTPUT" | ${GREP} '|main$$') || \
+	   (echo "$$NMOUTPUT" | ${GREP} 'T main$$') || \
+	   (echo "$$NMOUTPUT" | ${GREP} 'T _main$$'); \
+	then  \
+	    ${RM} "$@.d";\
+	    $(COMPILE.cc) -O2 -Wall -Iinclude -I../cpputil/include -I../particles/include -std=c++14 -fPIC  -Dmain=__nomain -MMD -MP -MF "$@.d" -o ${OBJECTDIR}/src/hmc_nomain.o src/hmc.cpp;\
+	else  \
+	    ${CP} ${OBJECTDIR}/src/hmc.o ${OBJECTDIR}/src/hmc_nomain.o;\
+	fi
+
 ${OBJECTDIR}/src/interactor_nomain.o: ${OBJECTDIR}/src/interactor.o src/interactor.cpp 
 	${MKDIR} -p ${OBJECTDIR}/src
 	@NMOUTPUT=`${NM} ${OBJECTDIR}/src/interactor.o`; \
@@ -499,6 +709,19 @@ ${OBJECTDIR}/src/mc_nomain.o: ${OBJECTDIR}/src/mc.o src/mc.cpp
 	    ${CP} ${OBJECTDIR}/src/mc.o ${OBJECTDIR}/src/mc_nomain.o;\
 	fi
 
+${OBJECTDIR}/src/minimizer_nomain.o: ${OBJECTDIR}/src/minimizer.o src/minimizer.cpp 
+	${MKDIR} -p ${OBJECTDIR}/src
+	@NMOUTPUT=`${NM} ${OBJECTDIR}/src/minimizer.o`; \
+	if (echo "$$NMOUTPUT" | ${GREP} '|main$$') || \
+	   (echo "$$NMOUTPUT" | ${GREP} 'T main$$') || \
+	   (echo "$$NMOUTPUT" | ${GREP} 'T _main$$'); \
+	then  \
+	    ${RM} "$@.d";\
+	    $(COMPILE.cc) -O2 -Wall -Iinclude -I../cpputil/include -I../particles/include -std=c++14 -fPIC  -Dmain=__nomain -MMD -MP -MF "$@.d" -o ${OBJECTDIR}/src/minimizer_nomain.o src/minimizer.cpp;\
+	else  \
+	    ${CP} ${OBJECTDIR}/src/minimizer.o ${OBJECTDIR}/src/minimizer_nomain.o;\
+	fi
+
 ${OBJECTDIR}/src/no-bc_nomain.o: ${OBJECTDIR}/src/no-bc.o src/no-bc.cpp 
 	${MKDIR} -p ${OBJECTDIR}/src
 	@NMOUTPUT=`${NM} ${OBJECTDIR}/src/no-bc.o`; \
@@ -525,6 +748,19 @@ ${OBJECTDIR}/src/pbc_nomain.o: ${OBJECTDIR}/src/pbc.o src/pbc.cpp
 	    ${CP} ${OBJECTDIR}/src/pbc.o ${OBJECTDIR}/src/pbc_nomain.o;\
 	fi
 
+${OBJECTDIR}/src/protonation-events_nomain.o: ${OBJECTDIR}/src/protonation-events.o src/protonation-events.cpp 
+	${MKDIR} -p ${OBJECTDIR}/src
+	@NMOUTPUT=`${NM} ${OBJECTDIR}/src/protonation-events.o`; \
+	if (echo "$$NMOUTPUT" | ${GREP} '|main$$') || \
+	   (echo "$$NMOUTPUT" | ${GREP} 'T main$$') || \
+	   (echo "$$NMOUTPUT" | ${GREP} 'T _main$$'); \
+	then  \
+	    ${RM} "$@.d";\
+	    $(COMPILE.cc) -O2 -Wall -Iinclude -I../cpputil/include -I../particles/include -std=c++14 -fPIC  -Dmain=__nomain -MMD -MP -MF "$@.d" -o ${OBJECTDIR}/src/protonation-events_nomain.o src/protonation-events.cpp;\
+	else  \
+	    ${CP} ${OBJECTDIR}/src/protonation-events.o ${OBJECTDIR}/src/protonation-events_nomain.o;\
+	fi
+
 ${OBJECTDIR}/src/pt-langevin-velocity-verlet_nomain.o: ${OBJECTDIR}/src/pt-langevin-velocity-verlet.o src/pt-langevin-velocity-verlet.cpp 
 	${MKDIR} -p ${OBJECTDIR}/src
 	@NMOUTPUT=`${NM} ${OBJECTDIR}/src/pt-langevin-velocity-verlet.o`; \
@@ -551,6 +787,45 @@ ${OBJECTDIR}/src/pt-pair-list-generator_nomain.o: ${OBJECTDIR}/src/pt-pair-list-
 	    ${CP} ${OBJECTDIR}/src/pt-pair-list-generator.o ${OBJECTDIR}/src/pt-pair-list-generator_nomain.o;\
 	fi
 
+${OBJECTDIR}/src/rattle_nomain.o: ${OBJECTDIR}/src/rattle.o src/rattle.cpp 
+	${MKDIR} -p ${OBJECTDIR}/src
+	@NMOUTPUT=`${NM} ${OBJECTDIR}/src/rattle.o`; \
+	if (echo "$$NMOUTPUT" | ${GREP} '|main$$') || \
+	   (echo "$$NMOUTPUT" | ${GREP} 'T main$$') || \
+	   (echo "$$NMOUTPUT" | ${GREP} 'T _main$$'); \
+	then  \
+	    ${RM} "$@.d";\
+	    $(COMPILE.cc) -O2 -Wall -Iinclude -I../cpputil/include -I../particles/include -std=c++14 -fPIC  -Dmain=__nomain -MMD -MP -MF "$@.d" -o ${OBJECTDIR}/src/rattle_nomain.o src/rattle.cpp;\
+	else  \
+	    ${CP} ${OBJECTDIR}/src/rattle.o ${OBJECTDIR}/src/rattle_nomain.o;\
+	fi
+
+${OBJECTDIR}/src/replica-exchange_nomain.o: ${OBJECTDIR}/src/replica-exchange.o src/replica-exchange.cpp 
+	${MKDIR} -p ${OBJECTDIR}/src
+	@NMOUTPUT=`${NM} ${OBJECTDIR}/src/replica-exchange.o`; \
+	if (echo "$$NMOUTPUT" | ${GREP} '|main$$') || \
+	   (echo "$$NMOUTPUT" | ${GREP} 'T main$$') || \
+	   (echo "$$NMOUTPUT" | ${GREP} 'T _main$$'); \
+	then  \
+	    ${RM} "$@.d";\
+	    $(COMPILE.cc) -O2 -Wall -Iinclude -I../cpputil/include -I../particles/include -std=c++14 -fPIC  -Dmain=__nomain -MMD -MP -MF "$@.d" -o ${OBJECTDIR}/src/replica-exchange_nomain.o src/replica-exchange.cpp;\
+	else  \
+	    ${CP} ${OBJECTDIR}/src/replica-exchange.o ${OBJECTDIR}/src/replica-exchange_nomain.o;\
+	fi
+
+${OBJECTDIR}/src/respa_nomain.o: ${OBJECTDIR}/src/respa.o src/respa.cpp 
+	${MKDIR} -p ${OBJECTDIR}/src
+	@NMOUTPUT=`${NM} ${OBJECTDIR}/src/respa.o`; \
+	if (echo "$$NMOUTPUT" | ${GREP} '|main$$') || \
+	   (echo "$$NMOUTPUT" | ${GREP} 'T main$$') || \
+	   (echo "$$NMOUTPUT" | ${GREP} 'T _main$$'); \
+	then  \
+	    ${RM} "$@.d";\
+	    $(COMPILE.cc) -O2 -Wall -Iinclude -I../cpputil/include -I../particles/include -std=c++14 -fPIC  -Dmain=__nomain -MMD -MP -MF "$@.d" -o ${OBJECTDIR}/src/respa_nomain.o src/respa.cpp;\
+	else  \
+	    ${CP} ${OBJECTDIR}/src/respa.o ${OBJECTDIR}/src/respa_nomain.o;\
+	fi
+
 ${OBJECTDIR}/src/sfactory_nomain.o: ${OBJECTDIR}/src/sfactory.o src/sfactory.cpp 
 	${MKDIR} -p ${OBJECTDIR}/src
 	@NMOUTPUT=`${NM} ${OBJECTDIR}/src/sfactory.o`; \
@@ -629,6 +904,19 @@ ${OBJECTDIR}/src/simulation_nomain.o: ${OBJECTDIR}/src/simulation.o src/simulati
 	    ${CP} ${OBJECTDIR}/src/simulation.o ${OBJECTDIR}/src/simulation_nomain.o;\
 	fi
 
+${OBJECTDIR}/src/trajectory_nomain.o: ${OBJECTDIR}/src/trajectory.o src/trajectory.cpp 
+	${MKDIR} -p ${OBJECTDIR}/src
+	@NMOUTPUT=`${NM} ${OBJECTDIR}/src/trajectory.o`; \
+	if (echo "$$NMOUTPUT" | ${GREP} '|main$$') || \
+	   (echo "$$NMOUTPUT" | ${GREP} 'T main$$') || \
+	   (echo "$$NMOUTPUT" | ${GREP} 'T _main$$'); \
+	then  \
+	    ${RM} "$@.d";\
+	    $(COMPILE.cc) -O2 -Wall -Iinclude -I../cpputil/include -I../particles/include -std=c++14 -fPIC  -Dmain=__nomain -MMD -MP -MF "$@.d" -o ${OBJECTDIR}/src/trajectory_nomain.o src/trajectory.cpp;\
+	else  \
+	    ${CP} ${OBJECTDIR}/src/trajectory.o ${OBJECTDIR}/src/trajectory_nomain.o;\
+	fi
+
 ${OBJECTDIR}/src/velocity-verlet_nomain.o: ${OBJECTDIR}/src/velocity-verlet.o src/velocity-verlet.cpp 
 	${MKDIR} -p ${OBJECTDIR}/src
 	@NMOUTPUT=`${NM} ${OBJECTDIR}/src/velocity-verlet.o`; \
@@ -648,11 +936,16 @@ ${OBJECTDIR}/src/velocity-verlet_nomain.o: ${OBJECTDIR}/src/velocity-verlet.o sr
 	then  \
 	    ${TESTDIR}/TestFiles/f5 || true; \
 	    ${TESTDIR}/TestFiles/f1 || true; \
+	    ${TESTDIR}/TestFiles/f9 || true; \
+	    ${TESTDIR}/TestFiles/f11 || true; \
+	    ${TESTDIR}/TestFiles/f10 || true; \
 	    ${TESTDIR}/TestFiles/f4 || true; \
 	    ${TESTDIR}/TestFiles/f7 || true; \
+	    ${TESTDIR}/TestFiles/f12 || true; \
 	    ${TESTDIR}/TestFiles/f6 || true; \
 	    ${TESTDIR}/TestFiles/f3 || true; \
 	    ${TESTDIR}/TestFiles/f2 || true; \
+	    ${TESTDIR}/TestFiles/f8 || true; \
 	else  \
 	    ./${TEST} || true; \
 	fi
@@ -54,16 +54,13 @@ namespace simploce {
     using lj_params_t = ForceField::lj_params_t;
     using el_params_t = ForceField::el_params_t;
     
-    static lj_params_t ljParams_;
-    static el_params_t elParams_;
-    
-    static std::unique_ptr<LJCoulombForces<Bead>> LJ_COULOMB_F{};
-    
-    void
+    static void
     setup_(const spec_catalog_ptr_t& catalog,
            const bc_ptr_t& bc,
            const box_ptr_t& box, 
-           const cg_ff_ptr_t& water)
+           const cg_ff_ptr_t& water,
+           lj_params_t& ljParams,
+           el_params_t& elParams)
     {
         // Polarizable water.
         spec_ptr_t PCW = catalog->lookup("PCW");
@@ -77,19 +74,19 @@ namespace simploce {
         
         // Water parameters.
         auto parameters = water->parameters();
-        ljParams_ = parameters.first;
-        elParams_ = parameters.second;
+        ljParams = parameters.first;
+        elParams = parameters.second;
         
         // LJ, 
         auto zero = std::make_pair(0.0, 0.0);    // No/zero interaction parameters.
         
         // Protonatable water is required.
-        if ( !ljParams_.contains("PCW", "PCW") ) {
+        if ( !ljParams.contains("PCW", "PCW") ) {
             throw std::domain_error(
                 "Missing LJ parameters for polarizable/protonatable water."
             );
         }
-        auto PCW_PCW = ljParams_.at("PCW", "PCW");
+        auto PCW_PCW = ljParams.at("PCW", "PCW");
         
         auto c12 = PCW_PCW.first;
         auto c6 = PCW_PCW.second;
@@ -98,32 +95,30 @@ namespace simploce {
         
         // HCOOH-HCOOH, HCOOH-water
         auto HCOOH_HCOOH = std::make_pair(C12, C6);
-        ljParams_.add(HCOOH->name(), PCW->name(), HCOOH_HCOOH);
+        ljParams.add(HCOOH->name(), PCW->name(), HCOOH_HCOOH);
         auto s = (sigma + SIGMA) / 2.0;
         auto e = std::sqrt(eps + EPS);
         c12 = 4.0 * e * std::pow(s, 12);
         c6 = 4.0 * e * std::pow(s, 6);
         auto HCOOH_PCW = std::make_pair(c12, c6);
-        ljParams_.add(PCW->name(), HCOOH->name(), HCOOH_PCW);
-        ljParams_.add(HCOOH->name(), PCW->name(), HCOOH_PCW);
-        ljParams_.add(HCOOH->name(), DP->name(), zero);
-        ljParams_.add(DP->name(), HCOOH->name(), zero);
+        ljParams.add(PCW->name(), HCOOH->name(), HCOOH_PCW);
+        ljParams.add(HCOOH->name(), PCW->name(), HCOOH_PCW);
+        ljParams.add(HCOOH->name(), DP->name(), zero);
+        ljParams.add(DP->name(), HCOOH->name(), zero);
         
         std::clog << "Acids/Bases in polarizable water:" << std::endl;
         std::clog << "Electrostatic interaction parameters:" << std::endl;
-        std::clog << elParams_ << std::endl;
+        std::clog << elParams << std::endl;
         std::clog << "LJ Interaction parameters" << std::endl;
-        std::clog << ljParams_ << std::endl;
-        
-        LJ_COULOMB_F = 
-            std::make_unique<LJCoulombForces<Bead>>(ljParams_, elParams_, bc, box);        
+        std::clog << ljParams << std::endl;
     }
     
     AcidBaseSolution::AcidBaseSolution(const spec_catalog_ptr_t& catalog,
                                        const bc_ptr_t& bc,
                                        const box_ptr_t& box,
                                        const cg_ff_ptr_t& water) :
-        catalog_{catalog}, bc_{bc}, box_{box}, water_{water}
+        catalog_{catalog}, bc_{bc}, box_{box}, water_{water}, 
+        ljParams_{}, elParams_{}, ljCoulombForces_{}
     {   
         if ( !catalog_ ) {
             throw std::domain_error(
@@ -146,17 +141,21 @@ namespace simploce {
             );                        
         }
         
-        setup_(catalog_, bc_, box_, water_);
+        setup_(catalog_, bc_, box_, water_, ljParams_, elParams_);
+        ljCoulombForces_ = 
+            std::make_shared<LJCoulombForces<Bead>>(ljParams_, elParams_, bc_, box_);
     }
     
     std::pair<energy_t, energy_t>
     AcidBaseSolution::interact(const std::vector<bead_ptr_t>& all,
                                const std::vector<bead_ptr_t>& free,
                                const std::vector<bead_group_ptr_t>& groups,
-                               const PairLists<Bead>& pairLists)
+                               const std::vector<charge_t>& charges,
+                               const PairLists<Bead>& pairLists,
+                               virial_t* virial)
     {
-        auto bepot = water_->bonded(all, free, groups, pairLists);
-        auto nb = LJ_COULOMB_F->interact(all, free, groups, pairLists);
+        auto bepot = water_->bonded(all, free, groups, pairLists, virial);
+        auto nb = ljCoulombForces_->interact(all, free, groups, charges, pairLists, virial);
         return std::make_pair(bepot, nb.second);
     }
     
@@ -164,18 +163,39 @@ namespace simploce {
     AcidBaseSolution::interact(const bead_ptr_t& bead,
                                const std::vector<bead_ptr_t>& all,
                                const std::vector<bead_ptr_t>& free,
-                               const std::vector<bead_group_ptr_t>& groups)
+                               const std::vector<bead_group_ptr_t>& groups,
+                               const std::vector<charge_t>& charges)
     {
-        return LJ_COULOMB_F->interact(bead, all, free, groups);
+        return ljCoulombForces_->interact(bead, all, free, groups, charges);
     }
     
     energy_t 
     AcidBaseSolution::bonded(const std::vector<bead_ptr_t>& all,
                              const std::vector<bead_ptr_t>& free,
                              const std::vector<bead_group_ptr_t>& groups,
-                             const PairLists<Bead>& pairLists)
+                             const PairLists<Bead>& pairLists,
+                             virial_t* virial)
+    {
+        return water_->bonded(all, free, groups, pairLists, virial);
+    }
+
+    energy_t 
+    AcidBaseSolution::nonBonded(const std::vector<bead_ptr_t>& all,
+                                const std::vector<bead_ptr_t>& free,
+                                const std::vector<bead_group_ptr_t>& groups,
+                                const std::vector<charge_t>& charges,
+                                const PairLists<Bead>& pairLists,
+                                virial_t* virial)
+    {
+        return ljCoulombForces_->nonBonded(all, free, groups, charges, pairLists, virial);
+    }
+    
+    energy_t 
+    AcidBaseSolution::chargesChanged(const std::vector<std::pair<bead_ptr_t, charge_t>>& changed,
+                                     const PairLists<Bead>& pairLists,
+                                     virial_t* virial)
     {
-        return water_->bonded(all, free, groups, pairLists);
+        return ljCoulombForces_->chargesChanged(changed, pairLists, virial);
     }
     
     std::string 
@@ -184,6 +204,19 @@ namespace simploce {
         return conf::ACID_BASE_SOLUTION;
     }
     
+    length_t
+    AcidBaseSolution::bondLength() const
+    {
+        return water_->bondLength();
+    }
+    
+    void
+    AcidBaseSolution::cutoffDistance(const length_t& rc)
+    {
+        water_->cutoffDistance(rc);
+        ljCoulombForces_->cutoffDistance(rc);
+    }
+    
     std::pair<lj_params_t, el_params_t> 
     AcidBaseSolution::parameters() const
     {
@@ -0,0 +1,210 @@
+/*
+ * The MIT License
+ *
+ * Copyright 2019 André H. Juffer, Biocenter Oulu
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ */
+
+
+/*
+ * File:   adaptive-timestep.cpp
+ * Author: André H. Juffer, Biocenter Oulu.
+ *
+ * Created on November 21, 2019, 9:15 AM
+ */
+
+#include "simploce/simulation/adaptive-timestep.hpp"
+#include "simploce/simulation/sim-util.hpp"
+#include "simploce/simulation/sconf.hpp"
+#include "simploce/particle/bead.hpp"
+#include <algorithm>
+#include <utility>
+#include <limits>
+#include <stdexcept>
+#include <cmath>
+
+namespace simploce {
+
+    // Largest increase of the time step from one step to the next.
+    static const real_t GROWTH = 1.1;
+
+    // Safety factor for the time step from the energy error.
+    static const real_t SAFETY = 0.9;
+
+    /*
+     * Returns the work term (F(n) + F(n+1)).(r(n+1) - r(n)) / 2 of the trapezoidal
+     * rule, and the largest time step for which no particle is displaced by 
+     * more than dxmax. Saves current positions and forces.
+     * @param T Particle type.
+     * @param dxmax Maximum displacement.
+     * @param previous If true, ris and fis hold positions and forces at t(n).
+     * @param ris Positions, at t(n) on input, at t(n+1) on output.
+     * @param fis Forces, at t(n) on input, at t(n+1) on output.
+     * @param particles Particles.
+     */
+    template <typename T>
+    std::pair<real_t, real_t>
+    analyze_(real_t dxmax,
+             bool previous,
+             std::vector<position_t>& ris,
+             std::vector<force_t>& fis,
+             const std::vector<std::shared_ptr<T>>& particles)
+    {
+        using result_t = std::pair<real_t, real_t>;
+        
+        auto results = 
+            util::forEachRange<result_t>(particles.size(), [&] (std::size_t k,
+                                                                std::size_t begin,
+                                                                std::size_t end) {
+            real_t work = 0.0;
+            real_t dt = std::numeric_limits<real_t>::max();
+            for (std::size_t i = begin; i != end; ++i) {
+                T& particle = *particles[i];
+                auto index = particle.index();
+                
+                position_t r = particle.position();
+                force_t f = particle.force();
+                if ( previous ) {
+                    for (std::size_t k = 0; k != 3; ++k) {
+                        work += 0.5 * ( fis[index][k] + f[k] ) * ( r[k] - ris[index][k] );
+                    }
+                }
+                ris[index] = r;
+                fis[index] = f;
+                
+                // Solves dxmax = |v| dt + |a| dt^2 / 2 for dt.
+                velocity_t v = particle.velocity();
+                real_t vn = norm<real_t>(v);
+                real_t an = norm<real_t>(f) / particle.mass()();
+                real_t denominator = vn + std::sqrt(vn * vn + 2.0 * an * dxmax);
+                if ( denominator > 0.0 ) {
+                    dt = std::min(dt, 2.0 * dxmax / denominator);
+                }
+            }
+            return std::make_pair(work, dt);
+        });
+        
+        result_t result{0.0, std::numeric_limits<real_t>::max()};
+        for (const auto& r : results) {
+            result.first += r.first;
+            result.second = std::min(result.second, r.second);
+        }
+        return result;
+    }
+    
+    AdaptiveTimestep<CoarseGrained>::AdaptiveTimestep(const cg_displacer_ptr_t& displacer) :
+        CoarseGrainedDisplacer{}, displacer_{displacer}, setup_{false}, t_{0.0}, dt_{0.0},
+        dtmin_{0.0}, dtmax_{0.0}, dxmax_{0.0}, etol_{0.0}, previous_{false}, epot_{0.0},
+        ris_{}, fis_{}
+    {
+        if ( !displacer_ ) {
+            throw std::domain_error("AdaptiveTimestep: Missing displacer.");
+        }
+    }
+    
+    SimulationData 
+    AdaptiveTimestep<CoarseGrained>::displace(const sim_param_t& param, 
+                                              const cg_ptr_t& cg) const
+    {
+        if ( !setup_ ) {
+            dt_ = param.get<real_t>("timestep");
+            dtmin_ = param.get<real_t>("dtmin", 0.1 * dt_());
+            dtmax_ = param.get<real_t>("dtmax", 4.0 * dt_());
+            dxmax_ = param.get<real_t>("dxmax", 0.03);
+            etol_ = param.get<real_t>("etol", 0.01);
+            if ( dtmin_() <= 0.0 || dtmin_() > dtmax_() ) {
+                throw std::domain_error(
+                    "AdaptiveTimestep: Time step range must be positive and not empty."
+                );
+            }
+            dt_ = std::min(std::max(dt_(), dtmin_()), dtmax_());
+            std::size_t nbeads = cg->numberOfBeads();
+            ris_ = std::vector<position_t>(nbeads, position_t{});
+            fis_ = std::vector<force_t>(nbeads, force_t{});
+            setup_ = true;
+        }
+        
+        // Displace with the current time step.
+        sim_param_t stepParam = param;
+        stepParam.put<real_t>("timestep", dt_());
+        SimulationData data = displacer_->displace(stepParam, cg);
+        t_ += dt_;
+        data.t = t_;
+        data.dt = dt_;
+        
+        // Time step for the next step.
+        auto result = cg->doWithAll<std::pair<real_t, real_t>>([this] (const std::vector<bead_ptr_t>& beads) {
+            return analyze_<Bead>(this->dxmax_, this->previous_, this->ris_, this->fis_, beads);
+        });
+        real_t epot = data.bepot() + data.nbepot();
+        real_t dt = std::min(result.second, GROWTH * dt_());
+        if ( previous_ ) {
+            real_t error = std::fabs(epot - epot_ + result.first) / ris_.size();
+            if ( error > 0.0 ) {
+                dt = std::min(dt, SAFETY * dt_() * std::cbrt(etol_ / error));
+            }
+        }
+        dt_ = std::min(std::max(dt, dtmin_()), dtmax_());
+        epot_ = epot;
+        previous_ = true;
+        
+        return data;
+    }
+    
+    std::string 
+    AdaptiveTimestep<CoarseGrained>::id() const
+    {
+        return conf::ADAPTIVE_TIMESTEP + "-" + displacer_->id();
+    }
+
+    void
+    AdaptiveTimestep<CoarseGrained>::writeCheckpoint(std::ostream& stream) const
+    {
+        util::writeBinary(stream, setup_);
+        util::writeBinary(stream, t_);
+        util::writeBinary(stream, dt_);
+        util::writeBinary(stream, dtmin_);
+        util::writeBinary(stream, dtmax_);
+        util::writeBinary(stream, dxmax_);
+        util::writeBinary(stream, etol_);
+        util::writeBinary(stream, previous_);
+        util::writeBinary(stream, epot_);
+        util::writeBinary(stream, ris_);
+        util::writeBinary(stream, fis_);
+        displacer_->writeCheckpoint(stream);
+    }
+
+    void
+    AdaptiveTimestep<CoarseGrained>::readCheckpoint(std::istream& stream, const cg_ptr_t& cg)
+    {
+        util::readBinary(stream, setup_);
+        util::readBinary(stream, t_);
+        util::readBinary(stream, dt_);
+        util::readBinary(stream, dtmin_);
+        util::readBinary(stream, dtmax_);
+        util::readBinary(stream, dxmax_);
+        util::readBinary(stream, etol_);
+        util::readBinary(stream, previous_);
+        util::readBinary(stream, epot_);
+        util::readBinary(stream, ris_);
+        util::readBinary(stream, fis_);
+        displacer_->readCheckpoint(stream, cg);
+    }
+}
@@ -25,7 +25,9 @@
 #include "simploce/analysis/analysis.hpp"
 #include "simploce/analysis/analyzer.hpp"
 #include "simploce/simulation/sim-model.hpp"
+#include "simploce/simulation/trajectory.hpp"
 #include <iostream>
+#include <algorithm>
 
 namespace simploce {
     
@@ -42,9 +44,14 @@ namespace simploce {
         const auto nskip = param.get<std::size_t>("nskip");
         std::clog << "Skipping first " << nskip << " states in trajectory." << std::endl;
         
+        // Binary trajectories allow for skipping states without reading them.
+        TrajectoryReader<Bead> reader{trajectory};
         std::size_t counter = 0;
-        sm_->readState(trajectory);
-        while (trajectory.good() ) {
+        if ( reader.isBinary() ) {
+            reader.seek(nskip);
+            counter = std::min(nskip, reader.numberOfFrames());
+        }
+        while ( reader.read(sm_) ) {
             counter += 1;
             if ( counter > nskip ) {
                 sm_->doWithAllFreeGroups<void>([this] (const std::vector<bead_ptr_t>& all,
@@ -53,7 +60,6 @@ namespace simploce {
                     this->analyzer_->perform(all, free, groups);
                 });
             }
-            sm_->readState(trajectory);
         }
     }
     
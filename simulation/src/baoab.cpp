@@ -0,0 +1,218 @@
+/*
+ * The MIT License
+ *
+ * Copyright 2019 André H. Juffer, Biocenter Oulu
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ */
+
+/*
+ * File:   baoab.cpp
+ * Author: André H. Juffer, Biocenter Oulu.
+ *
+ * Created on November 18, 2019, 10:31 AM
+ */
+
+#include "simploce/simulation/baoab.hpp"
+#include "simploce/simulation/interactor.hpp"
+#include "simploce/simulation/sim-util.hpp"
+#include "simploce/simulation/sconf.hpp"
+#include "simploce/particle/bead.hpp"
+#include "simploce/util/mu-units.hpp"
+#include <random>
+#include <cmath>
+#include <iostream>
+
+namespace simploce {
+
+    /*
+     * Half kick, half drift, Ornstein-Uhlenbeck velocity update, and half drift
+     * (BAOA), in one pass.
+     * @param T Particle type.
+     * @param dt Time step.
+     * @param c1 Velocity damping factor exp(-gamma * dt).
+     * @param kT Thermal energy.
+     * @param rng Random number generator.
+     * @param step Step number.
+     * @param particles Particles.
+     */
+    template <typename T>
+    void
+    displacePosition_(const stime_t& dt,
+                      real_t c1,
+                      real_t kT,
+                      const Philox& rng,
+                      std::size_t step,
+                      const std::vector<std::shared_ptr<T>>& particles)
+    {
+        real_t c2 = std::sqrt(1.0 - c1 * c1);
+        util::forEachRange<bool>(particles.size(), [&] (std::size_t k,
+                                                        std::size_t begin,
+                                                        std::size_t end) {
+            for (std::size_t i = begin; i != end; ++i) {
+                T& particle = *particles[i];
+                
+                mass_t mass = particle.mass();
+                real_t a1 = dt() / ( 2.0 * mass() );
+                real_t strength = c2 * std::sqrt(kT / mass());  // nm/ps
+                auto w = rng.normal(step, particle.index());    // Standard Wiener/Brownian.
+
+                force_t fi = particle.force();                  // Force at time t(n).
+                position_t r = particle.position();             // Position at time t(n).
+                velocity_t v = particle.velocity();             // Velocity at time t(n).
+                for (std::size_t k = 0; k != 3; ++k) {
+                    v[k] += a1 * fi[k];                         // B
+                    r[k] += 0.5 * dt() * v[k];                  // A
+                    v[k] = c1 * v[k] + strength * w[k];         // O
+                    r[k] += 0.5 * dt() * v[k];                  // A, position at time t(n+1).
+                }
+                
+                particle.velocity(v);
+                particle.position(r);
+            }
+            return true;
+        });
+    }
+    
+    /*
+     * Final half kick (B).
+     * @param T Particle type.
+     * @param dt Time step.
+     * @param particles Particles.
+     * @return Kinetic energy and temperature.
+     */
+    template <typename T>
+    SimulationData
+    displaceVelocity_(const stime_t& dt,
+                      const std::vector<std::shared_ptr<T>>& particles)
+    {
+        SimulationData data;
+        
+        auto ekins = 
+            util::forEachRange<real_t>(particles.size(), [&dt, &particles] (std::size_t k,
+                                                                            std::size_t begin,
+                                                                            std::size_t end) {
+            real_t ekin = 0.0;
+            for (std::size_t i = begin; i != end; ++i) {
+                T& particle = *particles[i];
+                
+                mass_t mass = particle.mass();
+                real_t a1 = dt() / ( 2.0 * mass() );
+
+                force_t ff = particle.force();                  // Force at time t(n+1).
+                velocity_t v = particle.velocity();
+                for (std::size_t k = 0; k != 3; ++k) {
+                    v[k] += a1 * ff[k];                         // B, velocity at time t(n+1).
+                }
+                particle.velocity(v);
+                
+                ekin += 0.5 * mass() * inner<real_t>(v, v);
+            }
+            return ekin;
+        });
+        
+        // Kinetic energy at t(n+1).
+        data.ekin = 0.0;
+        for (auto ekin : ekins) {
+            data.ekin += ekin;
+        }
+        
+        // Instantaneous temperature at t(n+1).
+        data.temperature = util::temperature<T>(particles, data.ekin);
+        
+        return data;
+    }
+    
+    BAOAB<CoarseGrained>::BAOAB(const cg_interactor_ptr_t& interactor) :
+        CoarseGrainedDisplacer{}, interactor_{interactor}, setup_{false}, counter_{0}, 
+        dt_{0.0}, gamma_{0.0}, rng_{}
+    {        
+    }
+    
+    SimulationData 
+    BAOAB<CoarseGrained>::displace(const sim_param_t& param, 
+                                   const cg_ptr_t& cg) const
+    {
+        counter_ += 1;
+        dt_ = param.get<real_t>("timestep");  // May change between steps.
+        if ( !setup_ ) {
+            gamma_ = param.get<real_t>("gamma", 0.5);
+            std::uint64_t seed = param.get<std::uint64_t>("seed", std::random_device{}());
+            rng_ = Philox(seed);
+            if ( param.get<std::string>("constraints", conf::NO_CONSTRAINTS) != conf::NO_CONSTRAINTS ) {
+                std::clog << "WARNING: BAOAB: Bond constraints are not supported, "
+                          << "and are ignored." << std::endl;
+            }
+            interactor_->interact(param, cg); // Initial forces.
+            setup_ = true;
+        }
+        
+        temperature_t temperature = param.get<real_t>("temperature", 298.15);
+        real_t kT = MUUnits<real_t>::KB * temperature();
+        real_t c1 = std::exp(-gamma_ * dt_());
+        
+        // Displace bead positions.
+        cg->doWithAll<void>([this, c1, kT] (const std::vector<bead_ptr_t>& beads) {
+            displacePosition_<Bead>(this->dt_, c1, kT, this->rng_, this->counter_, beads);
+        });
+        
+        // Compute forces and potential energy at t(n+1) using positions at t(n+1).
+        auto result = interactor_->interact(param, cg);
+        
+        // Displace bead velocities.
+        SimulationData data = cg->doWithAll<SimulationData>([this] (const std::vector<bead_ptr_t>& beads) {
+            return displaceVelocity_<Bead>(this->dt_, beads);
+        });
+        
+        // Save simulation data.
+        data.bepot = result.first;
+        data.nbepot = result.second;
+        data.t = counter_ * dt_;
+        
+        return data;
+    }
+    
+    std::string 
+    BAOAB<CoarseGrained>::id() const
+    {
+        return conf::BAOAB;
+    }
+
+    void
+    BAOAB<CoarseGrained>::writeCheckpoint(std::ostream& stream) const
+    {
+        util::writeBinary(stream, setup_);
+        util::writeBinary(stream, counter_);
+        util::writeBinary(stream, dt_);
+        util::writeBinary(stream, gamma_);
+        util::writeBinary(stream, rng_.seed());
+    }
+
+    void
+    BAOAB<CoarseGrained>::readCheckpoint(std::istream& stream, const cg_ptr_t& cg)
+    {
+        std::uint64_t seed;
+        util::readBinary(stream, setup_);
+        util::readBinary(stream, counter_);
+        util::readBinary(stream, dt_);
+        util::readBinary(stream, gamma_);
+        util::readBinary(stream, seed);
+        rng_ = Philox(seed);
+    }
+}
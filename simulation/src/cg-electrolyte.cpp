@@ -53,19 +53,16 @@ namespace simploce {
     static const length_t NA_CL_SIGMA = 2.796 * 0.1;      // LJ sigma in nm.
     static const energy_t CL_CL_EPS = 117.7604 * KB;      // LJ eps in kJ/mol.
     static const length_t CL_CL_SIGMA = 3.487 * 0.1;      // LJ sigma in nm.
-
-    static std::unique_ptr<LJCoulombForces<Bead>> LJ_COULOMB_F{};
-    
-    static el_params_t elParams_;
-    static lj_params_t ljParams_;
     
     static void setup_(const spec_catalog_ptr_t& catalog,
                        const bc_ptr_t& bc,
-                       const box_ptr_t& box)
+                       const box_ptr_t& box,
+                       lj_params_t& ljParams,
+                       el_params_t& elParams)
     {
         // Electrostatics.
         auto eps_r = std::make_pair("eps_r", EPS_R);
-        elParams_.insert(eps_r);
+        elParams.insert(eps_r);
 
         // LJ.
         spec_ptr_t Na = catalog->lookup("Na+");
@@ -74,64 +71,86 @@ namespace simploce {
         real_t C12_Na_Na = 4.0 * NA_NA_EPS() * std::pow(NA_NA_SIGMA(), 12.0);
         real_t C6_Na_Na = 4.0 * NA_NA_EPS() * std::pow(NA_NA_SIGMA(), 6.0);
         auto Na_Na = std::make_pair(C12_Na_Na, C6_Na_Na);
-        ljParams_.add(Na->name(), Na->name(), Na_Na);
+        ljParams.add(Na->name(), Na->name(), Na_Na);
 
         real_t C12_Cl_Cl = 4.0 * CL_CL_EPS() * std::pow(CL_CL_SIGMA(), 12.0);
         real_t C6_Cl_Cl = 4.0 * CL_CL_EPS() * std::pow(CL_CL_SIGMA(), 6.0);
         auto Cl_Cl = std::make_pair(C12_Cl_Cl, C6_Cl_Cl);
-        ljParams_.add(Cl->name(), Cl->name(), Cl_Cl);
+        ljParams.add(Cl->name(), Cl->name(), Cl_Cl);
     
         real_t C12_Na_Cl = 4.0 * NA_CL_EPS() * std::pow(NA_CL_SIGMA(), 12.0);
         real_t C6_Na_Cl = 4.0 * NA_CL_EPS() * std::pow(NA_CL_SIGMA(), 6.0);
         auto Na_Cl = std::make_pair(C12_Na_Cl, C6_Na_Cl);
-        ljParams_.add(Na->name(), Cl->name(), Na_Cl);
-        ljParams_.add(Cl->name(), Na->name(), Na_Cl);
+        ljParams.add(Na->name(), Cl->name(), Na_Cl);
+        ljParams.add(Cl->name(), Na->name(), Na_Cl);
         
         std::clog << "Electrolyte:" << std::endl;
         std::clog << "Electrostatic interaction parameters:" << std::endl;
-        std::clog << elParams_ << std::endl;
+        std::clog << elParams << std::endl;
         std::clog << "LJ Interaction parameters" << std::endl;
-        std::clog << ljParams_ << std::endl;        
-
-        LJ_COULOMB_F = 
-            std::make_unique<LJCoulombForces<Bead>>(ljParams_, elParams_, bc, box);
-    }    
+        std::clog << ljParams << std::endl;        
+}    
     
     
     CoarseGrainedElectrolyte::CoarseGrainedElectrolyte(const spec_catalog_ptr_t& catalog,
                                                        const bc_ptr_t& bc,
                                                        const box_ptr_t& box) :
-        catalog_{catalog}, bc_{bc}, box_{box}
+        catalog_{catalog}, bc_{bc}, box_{box}, ljParams_{}, elParams_{}, ljCoulombForces_{}
     {        
-            setup_(catalog_, bc_, box_);
+            setup_(catalog_, bc_, box_, ljParams_, elParams_);
+            ljCoulombForces_ = 
+                std::make_shared<LJCoulombForces<Bead>>(ljParams_, elParams_, bc_, box_);
     }
     
     std::pair<energy_t, energy_t>
     CoarseGrainedElectrolyte::interact(const std::vector<bead_ptr_t>& all,
                                        const std::vector<bead_ptr_t>& free,
                                        const std::vector<bead_group_ptr_t>& groups,
-                                       const PairLists<Bead>& pairLists)
+                                       const std::vector<charge_t>& charges,
+                                       const PairLists<Bead>& pairLists,
+                                       virial_t* virial)
     {
-        return LJ_COULOMB_F->interact(all, free, groups, pairLists);
+        return ljCoulombForces_->interact(all, free, groups, charges, pairLists, virial);
     }
     
     energy_t 
     CoarseGrainedElectrolyte::bonded(const std::vector<bead_ptr_t>& all,
                                      const std::vector<bead_ptr_t>& free,
                                      const std::vector<bead_group_ptr_t>& groups,
-                                     const PairLists<Bead>& pairLists)
+                                     const PairLists<Bead>& pairLists,
+                                     virial_t* virial)
     {
         // There are no bonded interaction.
         return energy_t{0.0};
     }
+
+    energy_t 
+    CoarseGrainedElectrolyte::nonBonded(const std::vector<bead_ptr_t>& all,
+                                        const std::vector<bead_ptr_t>& free,
+                                        const std::vector<bead_group_ptr_t>& groups,
+                                        const std::vector<charge_t>& charges,
+                                        const PairLists<Bead>& pairLists,
+                                        virial_t* virial)
+    {
+        return ljCoulombForces_->nonBonded(all, free, groups, charges, pairLists, virial);
+    }
     
     std::pair<energy_t, energy_t>
     CoarseGrainedElectrolyte::interact(const bead_ptr_t& bead,
                                        const std::vector<bead_ptr_t>& all,
                                        const std::vector<bead_ptr_t>& free,
-                                       const std::vector<bead_group_ptr_t>& groups) 
+                                       const std::vector<bead_group_ptr_t>& groups,
+                                       const std::vector<charge_t>& charges) 
     {
-        return LJ_COULOMB_F->interact(bead, all, free, groups);
+        return ljCoulombForces_->interact(bead, all, free, groups, charges);
+    }
+    
+    energy_t 
+    CoarseGrainedElectrolyte::chargesChanged(const std::vector<std::pair<bead_ptr_t, charge_t>>& changed,
+                                             const PairLists<Bead>& pairLists,
+                                             virial_t* virial)
+    {
+        return ljCoulombForces_->chargesChanged(changed, pairLists, virial);
     }
     
     std::string 
@@ -145,4 +164,10 @@ namespace simploce {
     {
         return std::pair<lj_params_t, el_params_t>{};
     }
+    
+    void
+    CoarseGrainedElectrolyte::cutoffDistance(const length_t& rc)
+    {
+        ljCoulombForces_->cutoffDistance(rc);
+    }
 }
\ No newline at end of file
@@ -24,6 +24,7 @@
 
 #include "simploce/simulation/cg-hp.hpp"
 #include "simploce/simulation/sconf.hpp"
+#include "simploce/simulation/sim-util.hpp"
 #include <tuple>
 
 namespace simploce {
@@ -32,11 +33,16 @@ namespace simploce {
     using el_params_t = ForceField::el_params_t;
     using result_t = std::pair<energy_t, std::vector<force_t>>;
     
+    /*
+     * Bonded energy of one group. Forces are added to forces, if not null, so
+     * that the energy alone costs no more than the group.
+     */
     static energy_t
     bonded_(const bead_group_ptr_t& group,
-            std::vector<force_t>& forces,
+            std::vector<force_t>* forces,
             real_t fc,
-            const length_t& Rref)
+            const length_t& Rref,
+            virial_t* virial)
     {
         using bond_cont_t = typename ParticleGroup<Bead>::bond_cont_t;
         
@@ -68,8 +74,13 @@ namespace simploce {
             }
         
             // Store energy and forces.
-            forces[index_i] += f;
-            forces[index_j] -= f;
+            if ( forces ) {
+                (*forces)[index_i] += f;
+                (*forces)[index_j] -= f;
+            }
+            if ( virial ) {
+                util::addToVirial(*virial, rij, f);
+            }
         }
         
         return epot;
@@ -79,14 +90,15 @@ namespace simploce {
     bonded_(std::size_t nparticles, 
             const std::vector<bead_group_ptr_t>& groups,
             real_t fc,
-            const length_t& Rref)
+            const length_t& Rref,
+            virial_t* virial)
     {        
         // Potential energy and forces.
         energy_t epot{0.0};
         std::vector<force_t> forces(nparticles, force_t{});
                 
         for (auto g : groups) {            
-            epot += bonded_(g, forces, fc, Rref);
+            epot += bonded_(g, &forces, fc, Rref, virial);
         }        
         
         return std::make_pair(epot, forces);
@@ -105,9 +117,11 @@ namespace simploce {
     HarmonicPotential::interact(const std::vector<bead_ptr_t>& all,
                                 const std::vector<bead_ptr_t>& free,
                                 const std::vector<bead_group_ptr_t>& groups,
-                                const PairLists<Bead>& pairLists)
+                                const std::vector<charge_t>& charges,
+                                const PairLists<Bead>& pairLists,
+                                virial_t* virial)
     {
-        auto epot = this->bonded(all, free, groups, pairLists);
+        auto epot = this->bonded(all, free, groups, pairLists, virial);
         return std::make_pair(epot, 0.0);
     }
     
@@ -115,9 +129,10 @@ namespace simploce {
     HarmonicPotential::bonded(const std::vector<bead_ptr_t>& all,
                               const std::vector<bead_ptr_t>& free,
                               const std::vector<bead_group_ptr_t>& groups,
-                              const PairLists<Bead>& pairLists)
+                              const PairLists<Bead>& pairLists,
+                              virial_t* virial)
     {
-        auto bonded = bonded_(all.size(), groups, fc_, Rref_);
+        auto bonded = bonded_(all.size(), groups, fc_, Rref_, virial);
         auto& forces = bonded.second;
         for (auto bead : all) {
             auto index = bead->index();
@@ -128,30 +143,54 @@ namespace simploce {
         
         return bonded.first;
     }
+
+    energy_t 
+    HarmonicPotential::nonBonded(const std::vector<bead_ptr_t>& all,
+                                 const std::vector<bead_ptr_t>& free,
+                                 const std::vector<bead_group_ptr_t>& groups,
+                                 const std::vector<charge_t>& charges,
+                                 const PairLists<Bead>& pairLists,
+                                 virial_t* virial)
+    {
+        // There are no non-bonded interactions.
+        return energy_t{0.0};
+    }
     
     std::pair<energy_t, energy_t> 
     HarmonicPotential::interact(const bead_ptr_t& bead,
                                 const std::vector<bead_ptr_t>& all,
                                 const std::vector<bead_ptr_t>& free,
-                                const std::vector<bead_group_ptr_t>& groups)
+                                const std::vector<bead_group_ptr_t>& groups,
+                                const std::vector<charge_t>& charges)
     {
-        // Forces are not used.
-        std::vector<force_t> forces(all.size(), force_t{});
-        
         energy_t epot{0.0};
         for (auto g : groups) {            
             if ( g->contains(bead) ) {
-                epot += bonded_(g, forces, fc_, Rref_);
+                epot += bonded_(g, nullptr, fc_, Rref_, nullptr);
             }
         }
         return std::make_pair(epot, 0.0);
     }
     
+    energy_t 
+    HarmonicPotential::chargesChanged(const std::vector<std::pair<bead_ptr_t, charge_t>>& changed,
+                                      const PairLists<Bead>& pairLists,
+                                      virial_t* virial)
+    {
+        return 0.0;
+    }
+    
     std::string 
     HarmonicPotential::id() const
     {
         return conf::HP;
     }
+    
+    length_t
+    HarmonicPotential::bondLength() const
+    {
+        return Rref_;
+    }
         
     std::pair<lj_params_t, el_params_t> 
     HarmonicPotential::parameters() const
@@ -44,18 +44,15 @@ namespace simploce {
     static const energy_t EPS = 3.5;                // LJ eps in kJ/mol.
     static const length_t SIGMA = 0.47;             // LJ sigma in nm.
     
-    static std::unique_ptr<LJCoulombForces<Bead>> LJ_COULOMB_F{};
-    
-    static el_params_t elParams_;
-    static lj_params_t ljParams_;
-    
     static void setup_(const spec_catalog_ptr_t& catalog,
                        const bc_ptr_t& bc,
-                       const box_ptr_t& box)
+                       const box_ptr_t& box,
+                       lj_params_t& ljParams,
+                       el_params_t& elParams)
     {
         // Electrostatics. Not used, but must be present.
         auto eps_r = std::make_pair("eps_r", EPS_R);
-        elParams_.insert(eps_r);
+        elParams.insert(eps_r);
 
         // LJ.
         spec_ptr_t spec = catalog->lookup("AP");
@@ -63,50 +60,72 @@ namespace simploce {
         real_t C12 = 4.0 * EPS() * std::pow(SIGMA(), 12.0);
         real_t C6 = 4.0 * EPS() * std::pow(SIGMA(), 6.0);
         auto pair = std::make_pair(C12, C6);
-        ljParams_.add(spec->name(), spec->name(), pair);
+        ljParams.add(spec->name(), spec->name(), pair);
 
         std::clog << "LJ Fluid:" << std::endl;
         std::clog << "LJ Interaction parameters" << std::endl;
-        std::clog << ljParams_ << std::endl;        
-
-        LJ_COULOMB_F = 
-            std::make_unique<LJCoulombForces<Bead>>(ljParams_, elParams_, bc, box);
+        std::clog << ljParams << std::endl;
     }
     
     CoarseGrainedLJFluid::CoarseGrainedLJFluid(const spec_catalog_ptr_t& catalog,
                                                const bc_ptr_t& bc,
                                                const box_ptr_t& box) :
-        catalog_{catalog}, bc_{bc}, box_{box}
+        catalog_{catalog}, bc_{bc}, box_{box}, ljParams_{}, elParams_{}, ljCoulombForces_{}
     {        
-            setup_(catalog_, bc_, box_);
+            setup_(catalog_, bc_, box_, ljParams_, elParams_);
+            ljCoulombForces_ = 
+                std::make_shared<LJCoulombForces<Bead>>(ljParams_, elParams_, bc_, box_);
     }
     
     std::pair<energy_t, energy_t> 
     CoarseGrainedLJFluid::interact(const std::vector<bead_ptr_t>& all,
                                    const std::vector<bead_ptr_t>& free,
                                    const std::vector<bead_group_ptr_t>& groups,
-                                   const PairLists<Bead>& pairLists)
+                                   const std::vector<charge_t>& charges,
+                                   const PairLists<Bead>& pairLists,
+                                   virial_t* virial)
     {
-        return LJ_COULOMB_F->interact(all, free, groups, pairLists);
+        return ljCoulombForces_->interact(all, free, groups, charges, pairLists, virial);
     }
     
     energy_t 
     CoarseGrainedLJFluid::bonded(const std::vector<bead_ptr_t>& all,
                                  const std::vector<bead_ptr_t>& free,
                                  const std::vector<bead_group_ptr_t>& groups,
-                                 const PairLists<Bead>& pairLists)
+                                 const PairLists<Bead>& pairLists,
+                                 virial_t* virial)
     {
         // There are no bonded interaction.
         return energy_t{0.0};
     }
+
+    energy_t 
+    CoarseGrainedLJFluid::nonBonded(const std::vector<bead_ptr_t>& all,
+                                    const std::vector<bead_ptr_t>& free,
+                                    const std::vector<bead_group_ptr_t>& groups,
+                                    const std::vector<charge_t>& charges,
+                                    const PairLists<Bead>& pairLists,
+                                    virial_t* virial)
+    {
+        return ljCoulombForces_->nonBonded(all, free, groups, charges, pairLists, virial);
+    }
     
     std::pair<energy_t, energy_t> 
     CoarseGrainedLJFluid::interact(const bead_ptr_t& bead,
                                    const std::vector<bead_ptr_t>& all,
                                    const std::vector<bead_ptr_t>& free,
-                                   const std::vector<bead_group_ptr_t>& groups) 
+                                   const std::vector<bead_group_ptr_t>& groups,
+                                   const std::vector<charge_t>& charges) 
     {
-        return LJ_COULOMB_F->interact(bead, all, free, groups);
+        return ljCoulombForces_->interact(bead, all, free, groups, charges);
+    }
+    
+    energy_t 
+    CoarseGrainedLJFluid::chargesChanged(const std::vector<std::pair<bead_ptr_t, charge_t>>& changed,
+                                         const PairLists<Bead>& pairLists,
+                                         virial_t* virial)
+    {
+        return ljCoulombForces_->chargesChanged(changed, pairLists, virial);
     }
     
     std::string 
@@ -120,4 +139,10 @@ namespace simploce {
     {
         return std::pair<lj_params_t, el_params_t>{};
     }
+    
+    void
+    CoarseGrainedLJFluid::cutoffDistance(const length_t& rc)
+    {
+        ljCoulombForces_->cutoffDistance(rc);
+    }
 }
\ No newline at end of file
@@ -35,6 +35,7 @@
 #include "simploce/particle/particle-spec-catalog.hpp"
 #include "simploce/particle/particle-spec.hpp"
 #include "simploce/simulation/sconf.hpp"
+#include "simploce/simulation/sim-util.hpp"
 #include "simploce/util/map2.hpp"
 #include "simploce/util/map.hpp"
 #include <utility>
@@ -50,57 +51,54 @@ namespace simploce {
     // Interaction parameters, adapted from Riniker et al, 2011.
     static const real_t EPS_R = 2.5;              // Relative permittivity
     static const length_t R_CW_DP = 0.2;          // nm.
-    static spec_ptr_t CW{};
-    static spec_ptr_t DP{};
     static const real_t FC = 2.0e+06;             // Force constant in kJ/(mol nm^4)
     static const real_t C12_CW_CW = 1.298e-03;    // kJ nm^12/mol
     static const real_t C6_CW_CW = 0.088;         // kJ nm^6 /mol
     
-    static std::unique_ptr<LJCoulombForces<Bead>> LJ_COULOMB_F{};
-    
-    static el_params_t elParams_;
-    static lj_params_t ljParams_;
-    
     static void setup_(const spec_catalog_ptr_t& catalog,
                        const bc_ptr_t& bc,
                        const box_ptr_t& box,
-                       bool protonatable)
+                       bool protonatable,
+                       lj_params_t& ljParams,
+                       el_params_t& elParams)
     {
-        CW = protonatable ? catalog->lookup("PCW") : catalog->lookup("CW");
-        DP = catalog->lookup("DP");
+        spec_ptr_t CW = protonatable ? catalog->lookup("PCW") : catalog->lookup("CW");
+        spec_ptr_t DP = catalog->lookup("DP");
     
         // Electrostatics.
         auto eps_r = std::make_pair("eps_r", EPS_R);
-        elParams_.insert(eps_r);
+        elParams.insert(eps_r);
 
         // LJ
         auto CW_CW = std::make_pair(C12_CW_CW, C6_CW_CW);    
-        ljParams_.add(CW->name(), CW->name(), CW_CW);
+        ljParams.add(CW->name(), CW->name(), CW_CW);
         auto zero = std::make_pair(0.0, 0.0);    
-        ljParams_.add(CW->name(), DP->name(), zero);
-        ljParams_.add(DP->name(), CW->name(), zero);
-        ljParams_.add(DP->name(), DP->name(), zero);
+        ljParams.add(CW->name(), DP->name(), zero);
+        ljParams.add(DP->name(), CW->name(), zero);
+        ljParams.add(DP->name(), DP->name(), zero);
 
         std::clog << "Polarizable water:" << std::endl;
         std::clog << "Electrostatic interaction parameters:" << std::endl;
-        std::clog << elParams_ << std::endl;
+        std::clog << elParams << std::endl;
         std::clog << "LJ Interaction parameters" << std::endl;
-        std::clog << ljParams_ << std::endl;
-    
-        LJ_COULOMB_F = 
-            std::make_unique<LJCoulombForces<Bead>>(ljParams_, elParams_, bc, box);
+        std::clog << ljParams << std::endl;
     }
     
+    /*
+     * Bonded energy of one water group. Forces are added to forces, if not 
+     * null, so that the energy alone costs no more than the group.
+     */
     static energy_t
     bonded_(const bead_group_ptr_t& group,
-            std::vector<force_t>& forces)
+            std::vector<force_t>* forces,
+            virial_t* virial)
     {
         using bond_cont_t = typename ParticleGroup<Bead>::bond_cont_t;
 
         static real_t fc2 = 2.0 * FC;
         static real_t halve_fc = 0.5 * FC;
-        static force_t fi;
-        static force_t fj;
+        force_t fi;
+        force_t fj;
         
         energy_t epot{0.0};
         
@@ -129,8 +127,13 @@ namespace simploce {
                 fi[k] = fv;
                 fj[k] = -fv;
             }
-            forces[index_i] += fi;
-            forces[index_j] += fj;
+            if ( forces ) {
+                (*forces)[index_i] += fi;
+                (*forces)[index_j] += fj;
+            }
+            if ( virial ) {
+                util::addToVirial(*virial, rij, fi);
+            }
         }        
         
 #ifdef _DEBUG        
@@ -152,14 +155,16 @@ namespace simploce {
 
     
     static std::pair<energy_t, std::vector<force_t>> 
-    bonded_(std::size_t nparticles, const std::vector<bead_group_ptr_t>& groups)
+    bonded_(std::size_t nparticles, 
+            const std::vector<bead_group_ptr_t>& groups,
+            virial_t* virial)
     {        
         // Potential energy and forces.
         energy_t epot{0.0};
         std::vector<force_t> forces(nparticles, force_t{});
                 
         for (auto g : groups) {            
-            epot += bonded_(g, forces);
+            epot += bonded_(g, &forces, virial);
         }        
         
         return std::make_pair(epot, forces);
@@ -169,21 +174,26 @@ namespace simploce {
                                                                  const bc_ptr_t& bc,
                                                                  const box_ptr_t& box,
                                                                  bool protonatable) :
-        CoarseGrainedForceField{}, catalog_{catalog}, bc_{bc}, box_{box}
+        CoarseGrainedForceField{}, catalog_{catalog}, bc_{bc}, box_{box}, 
+        ljParams_{}, elParams_{}, ljCoulombForces_{}
     {      
-            setup_(catalog, bc, box, protonatable);
+            setup_(catalog, bc, box, protonatable, ljParams_, elParams_);
+            ljCoulombForces_ = 
+                std::make_shared<LJCoulombForces<Bead>>(ljParams_, elParams_, bc_, box_);
     }
             
     std::pair<energy_t, energy_t> 
     CoarseGrainedPolarizableWater::interact(const std::vector<bead_ptr_t>& all,
                                             const std::vector<bead_ptr_t>& free,
                                             const std::vector<bead_group_ptr_t>& groups,
-                                            const PairLists<Bead>& pairLists)
+                                            const std::vector<charge_t>& charges,
+                                            const PairLists<Bead>& pairLists,
+                                            virial_t* virial)
     {
-        auto b = bonded_(all.size(), groups);        
+        auto b = bonded_(all.size(), groups, virial);        
         auto bepot = b.first;
 
-        auto nb = LJ_COULOMB_F->interact(all, free, groups, pairLists);
+        auto nb = ljCoulombForces_->interact(all, free, groups, charges, pairLists, virial);
         auto nbepot = nb.second;
         
         auto& forces = b.second;
@@ -201,9 +211,10 @@ namespace simploce {
     CoarseGrainedPolarizableWater::bonded(const std::vector<bead_ptr_t>& all,
                                           const std::vector<bead_ptr_t>& free,
                                           const std::vector<bead_group_ptr_t>& groups,
-                                          const PairLists<Bead>& pairLists)
+                                          const PairLists<Bead>& pairLists,
+                                          virial_t* virial)
     {
-        auto bonded = bonded_(all.size(), groups);
+        auto bonded = bonded_(all.size(), groups, virial);
         auto& forces = bonded.second;
         for (auto bead : all) {
             auto index = bead->index();
@@ -214,32 +225,61 @@ namespace simploce {
         
         return bonded.first;
     }
+
+    energy_t 
+    CoarseGrainedPolarizableWater::nonBonded(const std::vector<bead_ptr_t>& all,
+                                             const std::vector<bead_ptr_t>& free,
+                                             const std::vector<bead_group_ptr_t>& groups,
+                                             const std::vector<charge_t>& charges,
+                                             const PairLists<Bead>& pairLists,
+                                             virial_t* virial)
+    {
+        return ljCoulombForces_->nonBonded(all, free, groups, charges, pairLists, virial);
+    }
     
     std::pair<energy_t, energy_t>
     CoarseGrainedPolarizableWater::interact(const bead_ptr_t& bead,
                                             const std::vector<bead_ptr_t>& all,
                                             const std::vector<bead_ptr_t>& free,
-                                            const std::vector<bead_group_ptr_t>& groups)
+                                            const std::vector<bead_group_ptr_t>& groups,
+                                            const std::vector<charge_t>& charges)
     {
-        // Forces are not used.
-        std::vector<force_t> forces(all.size(), force_t{});
-        
-        auto nb = LJ_COULOMB_F->interact(bead, all, free, groups);
+        auto nb = ljCoulombForces_->interact(bead, all, free, groups, charges);
         energy_t bepot{0.0};
         for (auto g : groups) {            
             if ( g->contains(bead) ) {
-                bepot += bonded_(g, forces);
+                bepot += bonded_(g, nullptr, nullptr);
             }
         }
         return std::make_pair(bepot, nb.second);
     }
     
+    energy_t 
+    CoarseGrainedPolarizableWater::chargesChanged(const std::vector<std::pair<bead_ptr_t, charge_t>>& changed,
+                                                  const PairLists<Bead>& pairLists,
+                                                  virial_t* virial)
+    {
+        return ljCoulombForces_->chargesChanged(changed, pairLists, virial);
+    }
+    
     std::string 
     CoarseGrainedPolarizableWater::id() const
     {
         return conf::POLARIZABLE_WATER;
     }
     
+    length_t
+    CoarseGrainedPolarizableWater::bondLength() const
+    {
+        return idealDistanceCWDP();
+    }
+    
+    void
+    CoarseGrainedPolarizableWater::cutoffDistance(const length_t& rc)
+    {
+        ljCoulombForces_->cutoffDistance(rc);
+    }
+    
     std::pair<lj_params_t, el_params_t> 
     CoarseGrainedPolarizableWater::parameters() const
     {        
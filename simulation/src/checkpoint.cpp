@@ -0,0 +1,129 @@
+/*
+ * The MIT License
+ *
+ * Copyright 2019 André H. Juffer, Biocenter Oulu
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ */
+
+
+/*
+ * File:   checkpoint.cpp
+ * Author: André H. Juffer, Biocenter Oulu.
+ *
+ * Created on November 30, 2019, 9:40 AM
+ */
+
+#include "simploce/simulation/checkpoint.hpp"
+#include "simploce/simulation/sim-model.hpp"
+#include "simploce/simulation/sim-util.hpp"
+#include <fstream>
+#include <sstream>
+#include <cstdio>
+#include <cstdint>
+#include <stdexcept>
+
+namespace simploce {
+    
+    static const std::string MAGIC = "SCGK";
+    static const std::uint32_t VERSION = 1;
+    
+    volatile std::sig_atomic_t Checkpoint<Bead>::requested_ = 0;
+    
+    Checkpoint<Bead>::Checkpoint(const std::string& fileName, std::size_t ncheckpoint) :
+        fileName_{fileName}, ncheckpoint_{ncheckpoint}
+    {
+        if ( fileName_.empty() ) {
+            throw std::domain_error("Checkpoint: Missing file name.");
+        }
+    }
+    
+    void 
+    Checkpoint<Bead>::write(const cg_sim_model_ptr_t& sm, std::size_t step)
+    {
+        std::ostringstream buffer{};
+        buffer.write(MAGIC.data(), MAGIC.size());
+        util::writeBinary(buffer, VERSION);
+        util::writeBinary<std::uint64_t>(buffer, step);
+        sm->writeCheckpoint(buffer);
+        const std::string data = buffer.str();
+        
+        // Write all at once to a temporary file, then replace the checkpoint.
+        const std::string tmpName = fileName_ + ".tmp";
+        std::ofstream stream{tmpName, std::ios::binary | std::ios::trunc};
+        stream.write(data.data(), data.size());
+        stream.close();
+        if ( !stream ) {
+            throw std::domain_error("Checkpoint: Cannot write '" + tmpName + "'.");
+        }
+        if ( std::rename(tmpName.c_str(), fileName_.c_str()) != 0 ) {
+            throw std::domain_error("Checkpoint: Cannot replace '" + fileName_ + "'.");
+        }
+        requested_ = 0;
+    }
+    
+    std::size_t 
+    Checkpoint<Bead>::read(const cg_sim_model_ptr_t& sm) const
+    {
+        std::ifstream stream{fileName_, std::ios::binary};
+        if ( !stream ) {
+            throw std::domain_error("Checkpoint: Cannot open '" + fileName_ + "'.");
+        }
+        stream.seekg(0, std::ios::end);
+        std::string data(std::size_t(stream.tellg()), '\0');
+        stream.seekg(0, std::ios::beg);
+        if ( !stream.read(&data[0], data.size()) ) {
+            throw std::domain_error("Checkpoint: Cannot read '" + fileName_ + "'.");
+        }
+        
+        std::istringstream buffer{data};
+        std::string magic(MAGIC.size(), '\0');
+        std::uint32_t version;
+        std::uint64_t step;
+        buffer.read(&magic[0], magic.size());
+        if ( magic != MAGIC ) {
+            throw std::domain_error("Checkpoint: '" + fileName_ + "' is not a checkpoint.");
+        }
+        util::readBinary(buffer, version);
+        if ( version != VERSION ) {
+            throw std::domain_error("Checkpoint: Unsupported version.");
+        }
+        util::readBinary(buffer, step);
+        sm->readCheckpoint(buffer);
+        return step;
+    }
+    
+    bool 
+    Checkpoint<Bead>::due(std::size_t step) const
+    {
+        return ncheckpoint_ > 0 && step % ncheckpoint_ == 0;
+    }
+    
+    void 
+    Checkpoint<Bead>::request()
+    {
+        requested_ = 1;
+    }
+    
+    bool 
+    Checkpoint<Bead>::requested()
+    {
+        return requested_ != 0;
+    }
+}
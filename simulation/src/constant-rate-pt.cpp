@@ -31,15 +31,23 @@
 
 #include "simploce/simulation/constant-rate-pt.hpp"
 #include "simploce/simulation/sconf.hpp"
+#include "simploce/simulation/sim-util.hpp"
 #include "simploce/particle/continuous-protonatable-bead.hpp"
-#include "simploce/util/telegraph-process.hpp"
+#include "simploce/util/poisson-process.hpp"
 #include <stdexcept>
+#include <algorithm>
+#include <utility>
+#include <random>
+#include <cmath>
 
 namespace simploce {
     
     static const rate_t RATE = 1.0 / 1.5;
     static const real_t GAMMA = 1.0 / RATE(); 
     
+    // Stream number of jumps, distinct from the one of the Langevin noise.
+    static const std::uint32_t JUMPS = 1;
+    
     using prot_pair_t = ProtonTransferPairListGenerator::prot_pair_t;
     
     static bool hasProton_(const prot_pair_t& pair)
@@ -47,14 +55,78 @@ namespace simploce {
         return pair.first->isProtonated() || pair.second->isProtonated();
     }
     
+    /*
+     * Changes the protonation state of a bead by dX, and records the event.
+     */
+    static void change_(const cprot_bead_ptr_t& p, int dX, real_t t,
+                        std::vector<ProtonationEvent>& events)
+    {
+        std::size_t oldState = p->protonationState();
+        if ( dX > 0 ) {
+            p->protonate();
+        } else {
+            p->deprotonate();
+        }
+        events.push_back(ProtonationEvent{stime_t{t}, p->index(), oldState, p->protonationState()});
+    }
+    
+    /*
+     * Transfers the proton of one pair at time t, if one of the beads is 
+     * protonated and the telegraph process jumps an odd number of times (dN). 
+     * Records changes in protonation states in dX, and the events.
+     */
+    static void transfer_(const prot_pair_t& pair, int dN, real_t t, std::vector<int>& dX,
+                          std::vector<ProtonationEvent>& events)
+    {
+        // Two jumps return the proton.
+        dN = dN % 2;
+        
+        auto p1 = pair.first;
+        std::size_t index1 = p1->index();
+        int X1 = p1->protonationState();                
+        auto p2 = pair.second;
+        std::size_t index2 = p2->index();
+        int X2 = p2->protonationState();
+
+        // Transfer only if one of the beads is protonated.
+        int dX1 = 0;
+        int dX2 = 0;
+        if ( X1 == 1 && X2 == 0) {
+
+            // From X to Y.
+            //int T = 2 * X - 1;
+            int dT = -2 * X1 * dN;
+            dX1 = dT / 2;
+            dX2 = -dX1;
+        } else {
+            if ( X1 == 0 && X2 == 1 ) {
+
+                // From Y to X.
+                //int T = 2 * Y - 1;
+                int dT = -2 * X2 * dN;
+                dX2 = dT / 2;
+                dX1 = -dX2;
+            }
+        }
+        if ( dX1 != 0 ) {
+            change_(p1, dX1, t, events);
+            change_(p2, dX2, t, events);
+        }
+
+        dX[index1] += dX1;
+        dX[index2] += dX2;
+    }
+    
     ConstantRateProtonTransfer::ConstantRateProtonTransfer() :
-        rate_(RATE), gamma_(GAMMA)
+        rate_(RATE), gamma_(GAMMA), t_{0.0}, colors_{}, colored_{false}, ncolored_{0},
+        seeded_{false}, jumps_{}, nbatches_{0}
     {        
     }
     
     ConstantRateProtonTransfer::ConstantRateProtonTransfer(const rate_t& rate, 
                                                            const real_t& gamma) :
-        rate_{rate}, gamma_{gamma}
+        rate_{rate}, gamma_{gamma}, t_{0.0}, colors_{}, colored_{false}, ncolored_{0},
+        seeded_{false}, jumps_{}, nbatches_{0}
     {   
         if ( rate_() < 0.0 ) {
             throw std::domain_error(
@@ -73,100 +145,212 @@ namespace simploce {
     void 
     ConstantRateProtonTransfer::transfer(const sim_param_t& param,
                                          const std::vector<cprot_bead_ptr_t>& continuous,
-                                         const prot_pair_list_t& pairList) const
+                                         const prot_pair_list_t& pairList,
+                                         std::vector<ProtonationEvent>& events) const
     {
         stime_t dt = param.get<real_t>("timestep");
+        std::size_t npt = param.get<std::size_t>("npt", 1);
+        
+        if ( !seeded_ ) {
+            jumps_ = Philox(param.get<std::uint64_t>("seed", std::random_device{}()));
+            seeded_ = true;
+        }
+        if ( !colored_ ) {
+            this->update(pairList);
+        }
+        if ( ncolored_ != pairList.size() ) {
+            throw std::domain_error(
+                "ConstantRateProtonTransfer: Pair list changed without update()."
+            );
+        }
         
-        // Current protonation states.
-        std::vector<std::size_t> dX(continuous.size(), 0);
+        // Changes in protonation states.
+        std::vector<int> dX = changes_(continuous);
+        
+        // Jumps of the telegraph process over all npt time steps, drawn at once
+        // for all pairs. The rate does not depend on the state, so these can be
+        // drawn in advance. At most one jump is drawn per increment. Over npt
+        // time steps, the rate is rescaled such that a jump occurs with the 
+        // probability of an odd number of jumps in npt single time steps.
+        stime_t interval = real_t(npt) * dt();
+        rate_t rate = rate_;
+        if ( npt > 1 ) {
+            real_t p = 1.0 - std::exp(-rate_() * dt());
+            real_t podd = 0.5 * (1.0 - std::pow(1.0 - 2.0 * p, real_t(npt)));
+            rate = rate_t{-std::log(1.0 - podd) / interval()};
+        }
+        std::vector<std::size_t> dNs = 
+            PoissonProcess::increments(interval, rate, pairList.size(), jumps_, nbatches_, JUMPS);
+        nbatches_ += 1;
 
-        // Protonation states.
-        velocity_t u{0, 0, 0};
-        std::size_t npairs = 0;
-        for (auto pair : pairList) {
-            if ( hasProton_(pair) ) {
-                npairs += 1;
-                auto p1 = pair.first;
-                std::size_t index1 = p1->index();
-                int X1 = p1->protonationState();                
-                auto p2 = pair.second;
-                std::size_t index2 = p2->index();
-                int X2 = p2->protonationState();
-                
-                // Transfer only if one of the beads is protonated.
-                int dX1 = 0;
-                int dX2 = 0;
-                if ( X1 == 1 && X2 == 0) {
-            
-                    // From X to Y.
-                    //int T = 2 * X - 1;
-                    int dT = TelegraphProcess::increment(X1, dt, rate_);
-                    dX1 = dT / 2;
-                    dX2 = -dX1;
-                    X1 += dX1;
-                    X2 += dX2;
-                    if ( X1 == 0 ) {
-                        p1->deprotonate();
-                    }
-                    if ( X2 == 1) {
-                        p2->protonate();
-                    }
-                } else {
-                    if ( X1 == 0 && X2 == 1 ) {
-              
-                        // From Y to X.
-                        //int T = 2 * Y - 1;
-                        int dT = TelegraphProcess::increment(X2, dt, rate_);
-                        dX2 = dT / 2;
-                        dX1 = -dX2;
-                        X1 += dX1;
-                        X2 += dX2;
-                        if ( X1 == 1 ) {
-                            p1->protonate();
-                        }
-                        if ( X2 == 0 ) {
-                            p2->deprotonate();
+        // Protonation states. Pairs of one color share no bead. Events are 
+        // collected per range, and appended in pair order.
+        real_t t = t_;
+        for (const auto& pairs : colors_) {
+            auto ranges = 
+                util::forEachRange<std::vector<ProtonationEvent>>(pairs.size(), [&pairs, &pairList, &dNs, 
+                                                                                 &dX, t] (std::size_t k,
+                                                                                          std::size_t begin,
+                                                                                          std::size_t end) {
+                    std::vector<ProtonationEvent> events{};
+                    for (std::size_t i = begin; i != end; ++i) {
+                        const auto& pair = pairList[pairs[i]];
+                        if ( hasProton_(pair) ) {
+                            transfer_(pair, int(dNs[pairs[i]]), t, dX, events);
                         }
                     }
-                }
-                
-                dX[index1] += dX1;
-                dX[index2] += dX2;
-                
-                u += (p1->velocity() + p2->velocity());
+                    return events;
+                });
+            for (const auto& range : ranges) {
+                events.insert(events.end(), range.begin(), range.end());
             }
         }
+        t_ += interval();
         
-        // Assume an average.
-        u *= 0.5 / real_t(npairs);
-        
-        for (auto p : continuous) {
-            
-            mass_t m = p->mass();  // Just before mass transfer.
-            
-            // Update state x and current I of protonatable.
-            std::size_t index = p->index();
-            real_t x = p->state();
-            real_t I = p->current();
-            real_t dI = -gamma_ * I + gamma_ * dX[index];
-            I += dI;
-            real_t dx = I * dt();
-            x += dx;
-            p->state(x);
-            p->current(I);
-            
-            // Update momentum due to mass transfer.
-            mass_t dm = dI * conf::MASS_PROTON;
-            velocity_t v = p->velocity();
-            static velocity_t dv;
-            for (std::size_t k = 0; k != 3; ++k) {
-                dv[k] = - (v[k] - u[k]) * dm() / m();
+        this->relax_(continuous, pairList, dX, dt, npt);
+    }
+    
+    void
+    ConstantRateProtonTransfer::update(const prot_pair_list_t& pairList) const
+    {
+        // Greedy edge coloring: Each pair gets the lowest color not yet used 
+        // by pairs of either bead.
+        colors_.clear();
+        std::vector<std::vector<std::size_t>> used{};   // Colors, per bead index.
+        for (std::size_t i = 0; i != pairList.size(); ++i) {
+            std::size_t index1 = pairList[i].first->index();
+            std::size_t index2 = pairList[i].second->index();
+            std::size_t n = std::max(index1, index2) + 1;
+            if ( used.size() < n ) {
+                used.resize(n);
+            }
+            auto isUsed = [&used, index1, index2] (std::size_t color) {
+                return std::find(used[index1].begin(), used[index1].end(), color) != used[index1].end() ||
+                       std::find(used[index2].begin(), used[index2].end(), color) != used[index2].end();
+            };
+            std::size_t color = 0;
+            while ( isUsed(color) ) {
+                color += 1;
             }
-            v += dv;
-            p->velocity(v);
+            used[index1].push_back(color);
+            used[index2].push_back(color);
+            if ( colors_.size() <= color ) {
+                colors_.resize(color + 1);
+            }
+            colors_[color].push_back(i);
+        }
+        ncolored_ = pairList.size();
+        colored_ = true;
+    }
+    
+    void
+    ConstantRateProtonTransfer::writeCheckpoint(std::ostream& stream) const
+    {
+        util::writeBinary(stream, seeded_);
+        util::writeBinary(stream, jumps_.seed());
+        util::writeBinary(stream, nbatches_);
+        util::writeBinary(stream, t_);
+    }
+    
+    void
+    ConstantRateProtonTransfer::readCheckpoint(std::istream& stream, 
+                                               const prot_pair_list_t& pairList)
+    {
+        std::uint64_t seed;
+        util::readBinary(stream, seeded_);
+        util::readBinary(stream, seed);
+        util::readBinary(stream, nbatches_);
+        util::readBinary(stream, t_);
+        jumps_ = Philox(seed);
+        
+        // Not update(), which may be overridden.
+        ConstantRateProtonTransfer::update(pairList);
+    }
+    
+    std::vector<int>
+    ConstantRateProtonTransfer::changes_(const std::vector<cprot_bead_ptr_t>& continuous)
+    {
+        // Bead indices run over all beads, not only the protonatable ones.
+        std::size_t size = 0;
+        for (const auto& p : continuous) {
+            size = std::max(size, p->index() + 1);
         }
+        return std::vector<int>(size, 0);
+    }
+    
+    void
+    ConstantRateProtonTransfer::relax_(const std::vector<cprot_bead_ptr_t>& continuous,
+                                       const prot_pair_list_t& pairList,
+                                       const std::vector<int>& dX,
+                                       const stime_t& dt,
+                                       std::size_t nsteps) const
+    {
+        using sum_t = std::pair<velocity_t, std::size_t>;
         
-        // Done.
+        // The current decays by a factor a = 1 - gamma per time step. Over the
+        // nsteps - 1 time steps without transfers, the state then changes by
+        // I * dt * (1 + a + ... + a^(nsteps-1)), and the current by a^(nsteps-1).
+        real_t a = 1.0 - gamma_;
+        real_t decay = std::pow(a, real_t(nsteps - 1));
+        real_t sum = gamma_ > 0.0 ? (1.0 - decay * a) / gamma_ : real_t(nsteps);
+        
+        // Assume an average.
+        auto sums = 
+            util::forEachRange<sum_t>(pairList.size(), [&pairList] (std::size_t k,
+                                                                     std::size_t begin,
+                                                                     std::size_t end) {
+                sum_t sum{velocity_t{0, 0, 0}, 0};
+                for (std::size_t i = begin; i != end; ++i) {
+                    const auto& pair = pairList[i];
+                    if ( hasProton_(pair) ) {
+                        sum.first += (pair.first->velocity() + pair.second->velocity());
+                        sum.second += 1;
+                    }
+                }
+                return sum;
+            });
+        velocity_t u{0, 0, 0};
+        std::size_t npairs = 0;
+        for (const auto& sum : sums) {
+            u += sum.first;
+            npairs += sum.second;
+        }
+        if ( npairs > 0 ) {
+            u *= 0.5 / real_t(npairs);
+        }
+        
+        real_t gamma = gamma_;
+        util::forEachRange<bool>(continuous.size(), [&continuous, &dX, &u, gamma, &dt,
+                                                      decay, sum] (std::size_t k,
+                                                                   std::size_t begin,
+                                                                   std::size_t end) {
+            for (std::size_t i = begin; i != end; ++i) {
+                const auto& p = continuous[i];
+                
+                mass_t m = p->mass();  // Just before mass transfer.
+
+                // Update state x and current I of protonatable.
+                std::size_t index = p->index();
+                real_t x = p->state();
+                real_t I0 = p->current();
+                real_t I = I0 - gamma * I0 + gamma * dX[index];
+                real_t dx = I * dt() * sum;
+                x += dx;
+                I *= decay;
+                real_t dI = I - I0;
+                p->state(x);
+                p->current(I);
+
+                // Update momentum due to mass transfer.
+                real_t f = dI * conf::MASS_PROTON() / m();
+                velocity_t v = p->velocity();
+                for (std::size_t j = 0; j != 3; ++j) {
+                    v[j] -= (v[j] - u[j]) * f;
+                }
+                p->velocity(v);
+            }
+            return true;
+        });
     }
     
-}
\ No newline at end of file
+}
@@ -0,0 +1,387 @@
+/*
+ * The MIT License
+ *
+ * Copyright 2019 André H. Juffer, Biocenter Oulu
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ */
+
+
+/*
+ * File:   coordinate-codec.cpp
+ * Author: André H. Juffer, Biocenter Oulu.
+ *
+ * Created on November 19, 2019, 10:05 AM
+ */
+
+#include "simploce/simulation/coordinate-codec.hpp"
+#include <algorithm>
+#include <numeric>
+#include <stdexcept>
+#include <cmath>
+
+namespace simploce {
+    
+    // Largest magnitude of a quantized position.
+    static const std::int64_t MAX_QUANTIZED = std::int64_t(1) << 29;
+    
+    // Longest unary prefix of a Golomb-Rice code, beyond which the value is 
+    // written as is.
+    static const std::uint32_t MAX_PREFIX = 24;
+    
+    /*
+     * Writes bits, least significant first.
+     */
+    class BitWriter_ {
+    public:
+        
+        BitWriter_(std::vector<std::uint8_t>& bytes) : bytes_(bytes), buffer_{0}, nbits_{0} {}
+        
+        void write(std::uint32_t value, std::uint32_t nbits)
+        {
+            buffer_ |= std::uint64_t(value) << nbits_;
+            nbits_ += nbits;
+            while ( nbits_ >= 8 ) {
+                bytes_.push_back(std::uint8_t(buffer_));
+                buffer_ >>= 8;
+                nbits_ -= 8;
+            }
+        }
+        
+        void flush()
+        {
+            if ( nbits_ > 0 ) {
+                bytes_.push_back(std::uint8_t(buffer_));
+                buffer_ = 0;
+                nbits_ = 0;
+            }
+        }
+        
+    private:
+        
+        std::vector<std::uint8_t>& bytes_;
+        std::uint64_t buffer_;
+        std::uint32_t nbits_;
+    };
+    
+    /*
+     * Reads bits, least significant first.
+     */
+    class BitReader_ {
+    public:
+        
+        BitReader_(const std::uint8_t* bytes, std::size_t size) : 
+            bytes_{bytes}, size_{size}, pos_{0}, buffer_{0}, nbits_{0} {}
+        
+        std::uint32_t read(std::uint32_t nbits)
+        {
+            if ( nbits_ < nbits ) {
+                this->refill_();
+                if ( nbits_ < nbits ) {
+                    throw std::domain_error("CoordinateCodec: Truncated frame.");
+                }
+            }
+            std::uint32_t value = 
+                std::uint32_t(buffer_ & ( ( std::uint64_t(1) << nbits ) - 1 ));
+            buffer_ >>= nbits;
+            nbits_ -= nbits;
+            return value;
+        }
+        
+        // Number of consecutive 1 bits, up to MAX_PREFIX, and the terminating
+        // 0 bit if present.
+        std::uint32_t readUnary()
+        {
+            std::uint32_t q = 0;
+            while ( q < MAX_PREFIX && this->read(1) == 1 ) {
+                q += 1;
+            }
+            return q;
+        }
+        
+    private:
+        
+        void refill_()
+        {
+            while ( nbits_ <= 56 && pos_ < size_ ) {
+                buffer_ |= std::uint64_t(bytes_[pos_]) << nbits_;
+                pos_ += 1;
+                nbits_ += 8;
+            }
+        }
+        
+        const std::uint8_t* bytes_;
+        std::size_t size_;
+        std::size_t pos_;
+        std::uint64_t buffer_;
+        std::uint32_t nbits_;
+    };
+    
+    /*
+     * Adaptive Golomb-Rice parameter, from the running mean of coded values 
+     * (as in LOCO-I).
+     */
+    struct RiceParameter_ {
+        
+        std::uint32_t k() const
+        {
+            std::uint32_t k = 0;
+            while ( ( n << k ) < a && k < 31 ) {
+                k += 1;
+            }
+            return k;
+        }
+        
+        void update(std::uint32_t u)
+        {
+            a += u;
+            n += 1;
+            if ( n == 64 ) {
+                a >>= 1;
+                n >>= 1;
+            }
+        }
+        
+        std::uint64_t a = 4;
+        std::uint64_t n = 1;
+    };
+    
+    static std::uint32_t
+    zigzag_(std::int32_t v)
+    {
+        return ( std::uint32_t(v) << 1 ) ^ std::uint32_t(v >> 31);
+    }
+    
+    static std::int32_t
+    unzigzag_(std::uint32_t u)
+    {
+        return std::int32_t(u >> 1) ^ -std::int32_t(u & 1);
+    }
+    
+    static void
+    encode_(BitWriter_& writer, RiceParameter_& parameter, std::int32_t v)
+    {
+        std::uint32_t u = zigzag_(v);
+        std::uint32_t k = parameter.k();
+        std::uint32_t q = u >> k;
+        if ( q < MAX_PREFIX ) {
+            writer.write(( std::uint32_t(1) << q ) - 1, q + 1);
+            if ( k > 0 ) {
+                writer.write(u & ( ( std::uint32_t(1) << k ) - 1 ), k);
+            }
+        } else {
+            writer.write(( std::uint32_t(1) << MAX_PREFIX ) - 1, MAX_PREFIX);
+            writer.write(u, 32);
+        }
+        parameter.update(u);
+    }
+    
+    static std::int32_t
+    decode_(BitReader_& reader, RiceParameter_& parameter)
+    {
+        std::uint32_t k = parameter.k();
+        std::uint32_t q = reader.readUnary();
+        std::uint32_t u;
+        if ( q < MAX_PREFIX ) {
+            u = k > 0 ? ( q << k ) | reader.read(k) : q;
+        } else {
+            u = reader.read(32);
+        }
+        parameter.update(u);
+        return unzigzag_(u);
+    }
+    
+    /*
+     * Spreads lower 21 bits, such that there are two zero bits between 
+     * successive bits.
+     */
+    static std::uint64_t
+    spread_(std::uint64_t x)
+    {
+        x &= 0x1fffff;
+        x = ( x | x << 32 ) & 0x1f00000000ffff;
+        x = ( x | x << 16 ) & 0x1f0000ff0000ff;
+        x = ( x | x << 8 ) & 0x100f00f00f00f00f;
+        x = ( x | x << 4 ) & 0x10c30c30c30c30c3;
+        x = ( x | x << 2 ) & 0x1249249249249249;
+        return x;
+    }
+    
+    /*
+     * Returns particle indices, sorted along a Morton curve.
+     */
+    template <typename QPOS>
+    static std::vector<std::uint32_t>
+    mortonOrder_(const std::vector<QPOS>& qs)
+    {
+        QPOS qmin = qs[0], qmax = qs[0];
+        for (const auto& q : qs) {
+            for (std::size_t k = 0; k != 3; ++k) {
+                qmin[k] = std::min(qmin[k], q[k]);
+                qmax[k] = std::max(qmax[k], q[k]);
+            }
+        }
+        std::uint32_t shift = 0;
+        for (std::size_t k = 0; k != 3; ++k) {
+            while ( ( std::int64_t(qmax[k]) - qmin[k] ) >> shift >= ( 1 << 21 ) ) {
+                shift += 1;
+            }
+        }
+        std::vector<std::uint64_t> codes(qs.size());
+        for (std::size_t i = 0; i != qs.size(); ++i) {
+            std::uint64_t code = 0;
+            for (std::size_t k = 0; k != 3; ++k) {
+                std::uint64_t x = std::uint64_t(std::int64_t(qs[i][k]) - qmin[k]) >> shift;
+                code |= spread_(x) << k;
+            }
+            codes[i] = code;
+        }
+        std::vector<std::uint32_t> order(qs.size());
+        std::iota(order.begin(), order.end(), 0);
+        std::sort(order.begin(), order.end(), [&codes] (std::uint32_t i, std::uint32_t j) {
+            return codes[i] < codes[j];
+        });
+        return order;
+    }
+    
+    /*
+     * Number of bits required for values in [0, n).
+     */
+    static std::uint32_t
+    width_(std::size_t n)
+    {
+        std::uint32_t nbits = 0;
+        while ( ( std::uint64_t(1) << nbits ) < n ) {
+            nbits += 1;
+        }
+        return nbits;
+    }
+    
+    CoordinateCodec::CoordinateCodec(const length_t& precision) :
+        precision_{precision()}, previous_{}, order_{}
+    {
+        if ( precision_ <= 0.0 ) {
+            throw std::domain_error("CoordinateCodec: Precision must be a positive number.");
+        }
+    }
+    
+    std::vector<std::uint8_t> 
+    CoordinateCodec::encode(const std::vector<position_t>& rs, bool key)
+    {
+        std::vector<qpos_t> qs(rs.size());
+        for (std::size_t i = 0; i != rs.size(); ++i) {
+            for (std::size_t k = 0; k != 3; ++k) {
+                std::int64_t q = std::llround(rs[i][k] / precision_);
+                if ( q >= MAX_QUANTIZED || q <= -MAX_QUANTIZED ) {
+                    throw std::domain_error(
+                        "CoordinateCodec: Position out of range for given precision."
+                    );
+                }
+                qs[i][k] = std::int32_t(q);
+            }
+        }
+        key = key || previous_.size() != qs.size();
+        
+        std::vector<std::uint8_t> bytes{};
+        bytes.reserve(4 * rs.size() + 16);
+        BitWriter_ writer(bytes);
+        writer.write(key ? 1 : 0, 1);
+        writer.write(std::uint32_t(qs.size()), 32);
+        std::array<RiceParameter_, 3> parameters{};
+        if ( key ) {
+            order_ = qs.empty() ? std::vector<std::uint32_t>{} : mortonOrder_(qs);
+            std::uint32_t nbits = width_(qs.size());
+            for (auto i : order_) {
+                writer.write(i, nbits);
+            }
+            for (std::size_t j = 0; j != order_.size(); ++j) {
+                const qpos_t& q = qs[order_[j]];
+                for (std::size_t k = 0; k != 3; ++k) {
+                    if ( j == 0 ) {
+                        writer.write(std::uint32_t(q[k]), 32);
+                    } else {
+                        encode_(writer, parameters[k], q[k] - qs[order_[j - 1]][k]);
+                    }
+                }
+            }
+        } else {
+            for (auto i : order_) {
+                for (std::size_t k = 0; k != 3; ++k) {
+                    encode_(writer, parameters[k], qs[i][k] - previous_[i][k]);
+                }
+            }
+        }
+        writer.flush();
+        previous_ = std::move(qs);
+        return bytes;
+    }
+    
+    void 
+    CoordinateCodec::decode(const std::uint8_t* bytes, 
+                            std::size_t size, 
+                            std::vector<position_t>& rs)
+    {
+        BitReader_ reader(bytes, size);
+        bool key = reader.read(1) == 1;
+        std::size_t n = reader.read(32);
+        if ( !key && previous_.size() != n ) {
+            throw std::domain_error("CoordinateCodec: Frame requires previous key frame.");
+        }
+        previous_.resize(n);
+        std::array<RiceParameter_, 3> parameters{};
+        if ( key ) {
+            order_.resize(n);
+            std::uint32_t nbits = width_(n);
+            for (auto& i : order_) {
+                i = reader.read(nbits);
+                if ( i >= n ) {
+                    throw std::domain_error("CoordinateCodec: Corrupt frame.");
+                }
+            }
+            for (std::size_t j = 0; j != n; ++j) {
+                qpos_t& q = previous_[order_[j]];
+                for (std::size_t k = 0; k != 3; ++k) {
+                    if ( j == 0 ) {
+                        q[k] = std::int32_t(reader.read(32));
+                    } else {
+                        q[k] = previous_[order_[j - 1]][k] + decode_(reader, parameters[k]);
+                    }
+                }
+            }
+        } else {
+            for (auto i : order_) {
+                for (std::size_t k = 0; k != 3; ++k) {
+                    previous_[i][k] += decode_(reader, parameters[k]);
+                }
+            }
+        }
+        rs.resize(n);
+        for (std::size_t i = 0; i != n; ++i) {
+            rs[i] = position_t{previous_[i][0] * precision_, 
+                               previous_[i][1] * precision_, 
+                               previous_[i][2] * precision_};
+        }
+    }
+    
+    length_t 
+    CoordinateCodec::precision() const
+    {
+        return precision_;
+    }
+}
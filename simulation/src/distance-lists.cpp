@@ -36,29 +36,22 @@
 #include <vector>
 #include <utility>
 #include <thread>
+#include <mutex>
 
 namespace simploce {
     
-    static real_t rcutoff2_(const box_ptr_t& box)
-    {
-        static length_t rc = util::cutoffDistance(box);
-        static real_t rc2 = rc * rc;
-        
-        return rc2;
-    }
-    
     /**
      * For -any- collection of particles.
      */
     template <typename P> 
     typename PairLists<P>::pp_list_cont_t
-    forParticles_(const box_ptr_t& box,
+    forParticles_(const length_t& rc,
                   const bc_ptr_t& bc,
                   const std::vector<std::shared_ptr<P>>& particles)
     {
         using pp_list_cont_t = typename PairLists<P>::pp_list_cont_t;
         
-        static real_t rc2 = rcutoff2_(box);
+        const real_t rc2 = rc * rc;
         
         if ( particles.empty() ) {
             return pp_list_cont_t{};  // Empty pair list.
@@ -90,14 +83,14 @@ namespace simploce {
     
     template <typename P> 
     typename PairLists<P>::pp_list_cont_t
-    forGroups_(const box_ptr_t& box,
+    forGroups_(const length_t& rc,
                const bc_ptr_t& bc,
                const std::vector<std::shared_ptr<ParticleGroup<P>>>& groups)
     {    
         using pp_list_cont_t = typename PairLists<P>::pp_list_cont_t;
         using pp_pair_t = typename PairLists<P>::pp_pair_t;
         
-        static real_t rc2 =  rcutoff2_(box);
+        const real_t rc2 = rc * rc;
 
         if ( groups.empty() ) {
             return pp_list_cont_t{};  // Empty list.
@@ -135,7 +128,7 @@ namespace simploce {
     
     template <typename P> 
     typename PairLists<P>::pp_list_cont_t
-    forParticlesAndGroups_(const box_ptr_t& box,
+    forParticlesAndGroups_(const length_t& rc,
                            const bc_ptr_t& bc,
                            const std::vector<std::shared_ptr<P>>& particles,
                            const std::vector<std::shared_ptr<ParticleGroup<P>>>& groups)
@@ -143,7 +136,7 @@ namespace simploce {
         using pp_list_cont_t = typename PairLists<P>::pp_list_cont_t;
         using pp_pair_t = typename PairLists<P>::pp_pair_t;
         
-        static real_t rc2 =  rcutoff2_(box);
+        const real_t rc2 = rc * rc;
 
         if ( particles.empty() || groups.empty() ) {
             return pp_list_cont_t{};  // Empty list.
@@ -175,31 +168,31 @@ namespace simploce {
         
     template <typename P>
     static PairLists<P>
-    makePairLists_(const box_ptr_t& box,
+    makePairLists_(const length_t& rc,
                    const bc_ptr_t& bc,
                    const std::vector<std::shared_ptr<P>>& all,
                    const std::vector<std::shared_ptr<P>>& free,
                    const std::vector<std::shared_ptr<ParticleGroup<P>>>& groups)
     {
-        static bool firstTime = true;
-        if ( firstTime ) {
-            std::clog << "Using particles pair lists based on distances "
-                         "between particles." 
-                      << std::endl;
-            std::clog << "Cutoff distance: " << util::cutoffDistance(box) << std::endl;
-        }
+        // Pair lists may be generated concurrently for several models, e.g.
+        // replicas. Log once only.
+        static std::once_flag logged;
         
         // Prepare new particle pair list.        
-        auto pairList = forParticles_<P>(box, bc, free);
+        auto pairList = forParticles_<P>(rc, bc, free);
         auto ppSize = pairList.size();
-        auto fgPairList = forParticlesAndGroups_<P>(box, bc, free, groups);
+        auto fgPairList = forParticlesAndGroups_<P>(rc, bc, free, groups);
         auto fgSize = fgPairList.size();
         pairList.insert(pairList.end(), fgPairList.begin(), fgPairList.end());
-        auto ggPairList = forGroups_<P>(box, bc, groups);
+        auto ggPairList = forGroups_<P>(rc, bc, groups);
         auto ggSize = ggPairList.size();
         pairList.insert(pairList.end(), ggPairList.begin(), ggPairList.end());
         
-        if ( firstTime ) {
+        std::call_once(logged, [&] () {
+            std::clog << "Using particles pair lists based on distances "
+                         "between particles." 
+                      << std::endl;
+            std::clog << "Cutoff distance: " << rc << std::endl;
             std::clog << "Number of free-particle/free-particle pairs: " 
                       << ppSize << std::endl;
             std::clog << "Number of free-particle/particle-in-group pairs: "
@@ -210,8 +203,7 @@ namespace simploce {
                       << pairList.size() << std::endl;
             std::clog << "Total number of POSSIBLE particle pairs: "
                       << all.size() * (all.size() - 1) / 2 << std::endl;
-            firstTime = false;
-        }
+        });
 
         // Done.
         return std::move(PairLists<P>(pairList));
@@ -219,7 +211,7 @@ namespace simploce {
     
     DistanceLists<Atom>::DistanceLists(const box_ptr_t& box,
                                        const bc_ptr_t& bc) :
-        box_{box}, bc_{bc}
+        box_{box}, bc_{bc}, rc_{util::cutoffDistance(box)}
     {        
     }
         
@@ -228,12 +220,18 @@ namespace simploce {
                                   const std::vector<atom_ptr_t>& free,
                                   const std::vector<atom_group_ptr_t>& groups) const 
     {
-        return std::move(makePairLists_<Atom>(box_, bc_, all, free, groups));
+        return std::move(makePairLists_<Atom>(rc_, bc_, all, free, groups));
+    }
+    
+    void
+    DistanceLists<Atom>::cutoffDistance(const length_t& rc)
+    {
+        rc_ = util::cutoffDistance(box_, rc);
     }
     
     DistanceLists<Bead>::DistanceLists(const box_ptr_t& box,
                                        const bc_ptr_t& bc) :
-        box_{box}, bc_{bc}
+        box_{box}, bc_{bc}, rc_{util::cutoffDistance(box)}
     {        
     }
         
@@ -242,7 +240,13 @@ namespace simploce {
                                   const std::vector<bead_ptr_t>& free,
                                   const std::vector<bead_group_ptr_t>& groups) const 
     {
-        return std::move(makePairLists_<Bead>(box_, bc_, all, free, groups));
+        return std::move(makePairLists_<Bead>(rc_, bc_, all, free, groups));
+    }
+    
+    void
+    DistanceLists<Bead>::cutoffDistance(const length_t& rc)
+    {
+        rc_ = util::cutoffDistance(box_, rc);
     }
     
 }
\ No newline at end of file
@@ -0,0 +1,259 @@
+/*
+ * The MIT License
+ *
+ * Copyright 2019 André H. Juffer, Biocenter Oulu
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ */
+
+
+/* 
+ * File:   event-driven-pt.cpp
+ * Author: André H. Juffer, Biocenter Oulu.
+ *
+ * Created on November 26, 2019, 9:40 AM
+ */
+
+#include "simploce/simulation/event-driven-pt.hpp"
+#include "simploce/simulation/sim-util.hpp"
+#include "simploce/particle/continuous-protonatable-bead.hpp"
+#include <stdexcept>
+#include <random>
+#include <limits>
+#include <cmath>
+
+namespace simploce {
+    
+    static const real_t NEVER = std::numeric_limits<real_t>::infinity();
+    
+    // Stream of event times, distinct from the ones of the Langevin noise (0) 
+    // and of the constant rate jumps (1).
+    static const std::uint32_t EVENTS = 2;
+    
+    EventDrivenProtonTransfer::EventDrivenProtonTransfer() :
+        ConstantRateProtonTransfer(), setup_{false}, rng_{}, ndraws_{0}, 
+        pairs_{}, events_{}
+    {        
+    }
+    
+    EventDrivenProtonTransfer::EventDrivenProtonTransfer(const rate_t& rate, 
+                                                         const real_t& gamma) :
+        ConstantRateProtonTransfer(rate, gamma), setup_{false}, rng_{}, 
+        ndraws_{0}, pairs_{}, events_{}
+    {   
+    }   
+        
+    void 
+    EventDrivenProtonTransfer::transfer(const sim_param_t& param,
+                                        const std::vector<cprot_bead_ptr_t>& continuous,
+                                        const prot_pair_list_t& pairList,
+                                        std::vector<ProtonationEvent>& events) const
+    {
+        if ( !setup_ ) {
+            rng_ = Philox(param.get<std::uint64_t>("seed", std::random_device{}()));
+            setup_ = true;
+            this->update(pairList);
+        }
+        
+        stime_t dt = param.get<real_t>("timestep");
+        std::size_t npt = param.get<std::size_t>("npt", 1);
+        real_t end = t_ + real_t(npt) * dt();
+        
+        // Fire events within these steps, in order of time.
+        std::vector<int> dX = changes_(continuous);
+        while ( !events_.empty() && std::get<0>(events_.top()) < end ) {
+            event_t event = events_.top();
+            events_.pop();
+            auto iter = pairs_.find(std::get<1>(event));
+            if ( iter == pairs_.end() || iter->second.version != std::get<2>(event) ) {
+                // Pair left the list, or was rescheduled.
+                continue;
+            }
+            Entry& entry = iter->second;
+            auto p1 = entry.pair.first;
+            auto p2 = entry.pair.second;
+            std::size_t X1 = p1->protonationState();
+            std::size_t X2 = p2->protonationState();
+            stime_t t{std::get<0>(event)};
+            if ( X1 == 1 && X2 == 0 ) {
+                // From X to Y.
+                p1->deprotonate();
+                p2->protonate();
+                dX[p1->index()] -= 1;
+                dX[p2->index()] += 1;
+            } else if ( X1 == 0 && X2 == 1 ) {
+                // From Y to X.
+                p1->protonate();
+                p2->deprotonate();
+                dX[p1->index()] += 1;
+                dX[p2->index()] -= 1;
+            }
+            if ( X1 != X2 ) {
+                events.push_back(ProtonationEvent{t, p1->index(), X1, p1->protonationState()});
+                events.push_back(ProtonationEvent{t, p2->index(), X2, p2->protonationState()});
+            }
+            entry.time = this->nextTime_(entry.time);
+            this->schedule_(iter->first, entry);
+        }
+        t_ = end;
+        
+        this->relax_(continuous, pairList, dX, dt, npt);
+    }
+    
+    void
+    EventDrivenProtonTransfer::update(const prot_pair_list_t& pairList) const
+    {
+        if ( !setup_ ) {
+            // Pairs are scheduled at the first transfer.
+            return;
+        }
+        std::map<key_t, Entry> pairs{};
+        for (const auto& pair : pairList) {
+            key_t key{pair.first->index(), pair.second->index()};
+            auto iter = pairs_.find(key);
+            if ( iter != pairs_.end() ) {
+                // Keeps its event time.
+                pairs.insert(*iter);
+            } else {
+                Entry entry{pair, this->nextTime_(t_), 0};
+                this->schedule_(key, entry);
+                pairs.insert(std::make_pair(key, entry));
+            }
+        }
+        pairs_.swap(pairs);
+        this->compact_();
+    }
+    
+    void 
+    EventDrivenProtonTransfer::writeCheckpoint(std::ostream& stream) const
+    {
+        ConstantRateProtonTransfer::writeCheckpoint(stream);
+        util::writeBinary(stream, setup_);
+        util::writeBinary(stream, rng_.seed());
+        util::writeBinary(stream, ndraws_);
+        util::writeBinary<std::uint64_t>(stream, pairs_.size());
+        for (const auto& p : pairs_) {
+            util::writeBinary(stream, p.first.first);
+            util::writeBinary(stream, p.first.second);
+            util::writeBinary(stream, p.second.time);
+            util::writeBinary(stream, p.second.version);
+        }
+        
+        // Pending events, including stale ones.
+        auto events = events_;
+        util::writeBinary<std::uint64_t>(stream, events.size());
+        while ( !events.empty() ) {
+            const event_t& event = events.top();
+            util::writeBinary(stream, std::get<0>(event));
+            util::writeBinary(stream, std::get<1>(event).first);
+            util::writeBinary(stream, std::get<1>(event).second);
+            util::writeBinary(stream, std::get<2>(event));
+            events.pop();
+        }
+    }
+    
+    void 
+    EventDrivenProtonTransfer::readCheckpoint(std::istream& stream, 
+                                              const prot_pair_list_t& pairList)
+    {
+        ConstantRateProtonTransfer::readCheckpoint(stream, pairList);
+        std::uint64_t seed, size;
+        util::readBinary(stream, setup_);
+        util::readBinary(stream, seed);
+        util::readBinary(stream, ndraws_);
+        rng_ = Philox(seed);
+        
+        std::map<key_t, prot_pair_t> pairs{};
+        for (const auto& pair : pairList) {
+            pairs[key_t{pair.first->index(), pair.second->index()}] = pair;
+        }
+        pairs_.clear();
+        util::readBinary(stream, size);
+        for (std::uint64_t k = 0; k != size; ++k) {
+            key_t key;
+            Entry entry;
+            util::readBinary(stream, key.first);
+            util::readBinary(stream, key.second);
+            util::readBinary(stream, entry.time);
+            util::readBinary(stream, entry.version);
+            auto iter = pairs.find(key);
+            if ( iter == pairs.end() ) {
+                throw std::domain_error(
+                    "EventDrivenProtonTransfer: Checkpoint does not match the pair list."
+                );
+            }
+            entry.pair = iter->second;
+            pairs_.insert(std::make_pair(key, entry));
+        }
+        
+        std::vector<event_t> events{};
+        util::readBinary(stream, size);
+        for (std::uint64_t k = 0; k != size; ++k) {
+            real_t time;
+            key_t key;
+            std::size_t version;
+            util::readBinary(stream, time);
+            util::readBinary(stream, key.first);
+            util::readBinary(stream, key.second);
+            util::readBinary(stream, version);
+            events.push_back(std::make_tuple(time, key, version));
+        }
+        events_ = std::priority_queue<event_t, std::vector<event_t>, std::greater<event_t>>(
+            std::greater<event_t>(), std::move(events)
+        );
+    }
+    
+    real_t
+    EventDrivenProtonTransfer::nextTime_(real_t t) const
+    {
+        if ( rate_() <= 0.0 ) {
+            return NEVER;
+        }
+        real_t u = rng_.uniform(ndraws_, 0, EVENTS)[0];
+        ndraws_ += 1;
+        return t - std::log(u) / rate_();
+    }
+    
+    void
+    EventDrivenProtonTransfer::schedule_(const key_t& key, Entry& entry) const
+    {
+        entry.version += 1;
+        if ( entry.time < NEVER ) {
+            events_.push(std::make_tuple(entry.time, key, entry.version));
+        }
+    }
+    
+    void
+    EventDrivenProtonTransfer::compact_() const
+    {
+        // Drops events of pairs that left the list, once they dominate the queue.
+        if ( events_.size() <= 2 * pairs_.size() ) {
+            return;
+        }
+        std::vector<event_t> events{};
+        for (const auto& p : pairs_) {
+            if ( p.second.time < NEVER ) {
+                events.push_back(std::make_tuple(p.second.time, p.first, p.second.version));
+            }
+        }
+        events_ = std::priority_queue<event_t, std::vector<event_t>, std::greater<event_t>>(
+            std::greater<event_t>(), std::move(events)
+        );
+    }
+}
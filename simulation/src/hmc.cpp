@@ -0,0 +1,229 @@
+/*
+ * The MIT License
+ *
+ * Copyright 2019 André H. Juffer, Biocenter Oulu
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ */
+
+
+/*
+ * File:   hmc.cpp
+ * Author: André H. Juffer, Biocenter Oulu.
+ *
+ * Created on November 25, 2019, 10:20 AM
+ */
+
+#include "simploce/simulation/hmc.hpp"
+#include "simploce/simulation/sim-model.hpp"
+#include "simploce/simulation/sim-data.hpp"
+#include "simploce/simulation/velocity-verlet.hpp"
+#include "simploce/simulation/sconf.hpp"
+#include "simploce/simulation/trajectory.hpp"
+#include "simploce/util/mu-units.hpp"
+#include <stdexcept>
+#include <iostream>
+#include <fstream>
+#include <iomanip>
+#include <random>
+#include <vector>
+#include <cmath>
+
+namespace simploce {
+    
+    static const real_t LIMIT = 75.0;
+    
+    /*
+     * Draws velocities from the Maxwell-Boltzmann distribution, and saves
+     * current positions and forces.
+     * @return Kinetic energy.
+     */
+    static energy_t
+    drawVelocities_(const std::vector<bead_ptr_t>& all,
+                    const Philox& rng,
+                    std::size_t step,
+                    real_t kT,
+                    std::vector<position_t>& ris,
+                    std::vector<force_t>& fis)
+    {
+        ris.clear();
+        fis.clear();
+        energy_t ekin{0.0};
+        for (std::size_t i = 0; i != all.size(); ++i) {
+            auto& bead = all[i];
+            ris.push_back(bead->position());
+            fis.push_back(bead->force());
+            real_t mass = bead->mass()();
+            real_t sigma = std::sqrt(kT / mass);
+            auto n = rng.normal(step, std::uint32_t(i), 0);
+            velocity_t v;
+            for (std::size_t k = 0; k != 3; ++k) {
+                v[k] = sigma * n[k];
+            }
+            bead->velocity(v);
+            ekin += 0.5 * mass * inner<real_t>(v, v);
+        }
+        return ekin;
+    }
+    
+    /*
+     * Restores positions and forces.
+     */
+    static void
+    restore_(const std::vector<bead_ptr_t>& all,
+             const std::vector<position_t>& ris,
+             const std::vector<force_t>& fis)
+    {
+        for (std::size_t i = 0; i != all.size(); ++i) {
+            all[i]->position(ris[i]);
+            all[i]->force(fis[i]);
+        }
+    }
+    
+    /*
+     * Replaces the displacer of a simulation model, and restores the original
+     * displacer when going out of scope, also if an exception is thrown.
+     */
+    class DisplacerSwap_ {
+    public:
+        
+        DisplacerSwap_(const cg_sim_model_ptr_t& sm, const cg_displacer_ptr_t& displacer) :
+            sm_{sm}, original_{sm->displacer()}
+        {
+            sm_->displacer(displacer);
+        }
+        
+        DisplacerSwap_(const DisplacerSwap_&) = delete;
+        
+        DisplacerSwap_& operator = (const DisplacerSwap_&) = delete;
+        
+        ~DisplacerSwap_()
+        {
+            sm_->displacer(original_);
+        }
+        
+    private:
+        
+        cg_sim_model_ptr_t sm_;
+        cg_displacer_ptr_t original_;
+    };
+    
+    HMC<Bead>::HMC(const cg_sim_model_ptr_t& sm) : sm_{sm}, rng_{}
+    {        
+    }
+    
+    void 
+    HMC<Bead>::perform(const sim_param_t& param,
+                       std::ofstream& trajStream,
+                       std::ofstream& dataStream)
+    {
+        const auto width = conf::WIDTH;
+        const auto space = conf::SPACE;
+        
+        if ( sm_->size() == 0 ) {
+            throw std::domain_error(
+                "No particles! Nothing to simulate."
+            );
+        }
+        
+        std::clog << "Performing a (CG) hybrid Monte Carlo simulation..." << std::endl;
+        
+        std::size_t nsteps = param.get<std::size_t>("nsteps", 10000);
+        std::size_t nwrite = param.get<std::size_t>("nwrite", 10);
+        std::size_t nmd = param.get<std::size_t>("nmd", 10);
+        temperature_t temperature = param.get<real_t>("temperature", 298.15);
+        real_t kT = MUUnits<real_t>::KB * temperature();
+        std::uint64_t seed = param.get<std::uint64_t>("seed", std::random_device{}());
+        rng_ = Philox(seed);
+        if ( nmd == 0 ) {
+            throw std::domain_error("HMC: At least one velocity Verlet step is required.");
+        }
+        
+        // Trajectories are generated by velocity Verlet, without constraints.
+        // At steps at which data is written, the virial is requested for the 
+        // pressure.
+        sim_param_t mdParam = param;
+        mdParam.put<std::string>("constraints", conf::NO_CONSTRAINTS);
+        sim_param_t writeParam = mdParam;
+        writeParam.put<bool>("virial", true);
+        DisplacerSwap_ swap{sm_, std::make_shared<VelocityVerlet<CoarseGrained>>(sm_->interactor())};
+        
+        // Forces and potential energy of the initial state.
+        SimulationData current = sm_->interact(mdParam);
+        
+        std::size_t numberAccepted = 0;
+        std::vector<position_t> ris{};
+        std::vector<force_t> fis{};
+        TrajectoryWriter<Bead> trajectory{trajStream, param};
+        for (std::size_t counter = 1; counter <= nsteps; ++counter) {
+            bool write = counter % nwrite == 0;
+            
+            // Fresh velocities.
+            energy_t ekin = 
+                sm_->doWithAllFreeGroups<energy_t>([this, counter, kT, &ris, &fis] (const std::vector<bead_ptr_t>& all,
+                                                                                    const std::vector<bead_ptr_t>& free,
+                                                                                    const std::vector<bead_group_ptr_t>& groups) {
+                    return drawVelocities_(all, this->rng_, counter, kT, ris, fis);
+                });
+            energy_t h_i = ekin + current.bepot + current.nbepot;
+            
+            // Trajectory.
+            SimulationData data;
+            for (std::size_t n = 1; n <= nmd; ++n) {
+                data = sm_->displace(write && n == nmd ? writeParam : mdParam);
+            }
+            energy_t h_f = data.ekin + data.bepot + data.nbepot;
+            
+            // Accept or reject end point. Also rejected if the energy is not 
+            // a number.
+            real_t difference_over_kT = ( h_f() - h_i() ) / kT;
+            real_t w = rng_.uniform(counter, 0, 1)[0];
+            bool accepted = 
+                difference_over_kT <= 0.0 || 
+                ( difference_over_kT < LIMIT && w < std::exp(-difference_over_kT) );
+            if ( accepted ) {
+                numberAccepted += 1;
+                current = data;
+            } else {
+                sm_->doWithAllFreeGroups<void>([&ris, &fis] (const std::vector<bead_ptr_t>& all,
+                                                             const std::vector<bead_ptr_t>& free,
+                                                             const std::vector<bead_group_ptr_t>& groups) {
+                    restore_(all, ris, fis);
+                });
+            }
+            current.t = data.t;
+            current.accepted = accepted;
+            
+            if ( write ) {
+                current.acceptanceRatio = real_t(numberAccepted)/real_t(counter) * 100.0;
+                dataStream << std::setw(width) << counter << space << current << std::endl;
+                trajectory.write(sm_);
+                dataStream.flush();
+            }
+        }
+        
+        trajectory.close();
+        
+        if ( nsteps > 0 ) {
+            std::clog << "Acceptance ratio (%): " 
+                      << real_t(numberAccepted)/real_t(nsteps) * 100.0 << std::endl;
+        }
+        std::clog << "Done." << std::endl;
+    }
+}
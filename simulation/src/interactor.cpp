@@ -33,10 +33,12 @@
 #include "simploce/simulation/pair-list-generator.hpp"
 #include "simploce/simulation/at-forcefield.hpp"
 #include "simploce/simulation/cg-forcefield.hpp"
+#include "simploce/simulation/sim-util.hpp"
 #include "simploce/particle/atomistic.hpp"
 #include "simploce/particle/coarse-grained.hpp"
 #include <memory>
 #include <utility>
+#include <stdexcept>
 
 namespace simploce {
     
@@ -67,7 +69,8 @@ namespace simploce {
     
     Interactor<Atom>::Interactor(const at_ff_ptr_t& forcefield,
                                  const at_ppair_list_gen_ptr_t& pairListGenerator) :
-        forcefield_{forcefield}, pairListGenerator_{pairListGenerator}
+        forcefield_{forcefield}, pairListGenerator_{pairListGenerator}, pairLists_{},
+        setup_{false}, npairlists_{0}, counter_{0}
     {        
     }
         
@@ -75,15 +78,11 @@ namespace simploce {
     Interactor<Atom>::interact(const sim_param_t& param, 
                                const at_ptr_t& at)
     {
-        static bool setup = false;
-        static std::size_t npairlist = 0;
-        static std::size_t counter = 0;
-        
-        if ( !setup ) {
-            npairlist = param.get<std::size_t>("npairlists");
-            setup = true;
+        if ( !setup_ ) {
+            npairlists_ = param.get<std::size_t>("npairlists");
+            setup_ = true;
         }
-        if ( counter % npairlist == 0 || counter == 0) {
+        if ( counter_ % npairlists_ == 0 || counter_ == 0) {
             this->updatePairLists_(at);
             pairLists_.updated_(true);
         } else {
@@ -100,7 +99,7 @@ namespace simploce {
             return this->forcefield_->interact(all, free, groups, atomPairLists_);
         });
         
-        counter += 1;
+        counter_ += 1;
         return result;
     }
     
@@ -134,7 +133,8 @@ namespace simploce {
     
     Interactor<Bead>::Interactor(const cg_ff_ptr_t& forcefield,
                                  const cg_ppair_list_gen_ptr_t& pairListGenerator) :
-        forcefield_{forcefield}, pairListGenerator_{pairListGenerator}
+        forcefield_{forcefield}, pairListGenerator_{pairListGenerator}, pairLists_{},
+        setup_{false}, cutoff_{false}, npairlists_{0}, counter_{0}, bvirial_{}, nbvirial_{}
     {      
     }
         
@@ -142,56 +142,211 @@ namespace simploce {
     Interactor<Bead>::interact(const sim_param_t& param, 
                                const cg_ptr_t& cg)
     {
-        static bool setup = false;
-        static std::size_t npairlist = 0;
-        static std::size_t counter = 0;
+        this->cutoffDistance_(param);
+        this->updatePairLists_(param, cg);
         
-        if ( !setup ) {
-            npairlist = param.get<std::size_t>("npairlists");
-            setup = true;
-        }
-        if ( counter % npairlist == 0 || counter == 0) {
-            this->updatePairLists_(cg);
-            pairLists_.updated_(true);
-        } else {
-            pairLists_.updated_(false);
+        virial_t* virial = nullptr;
+        if ( param.get<bool>("virial", false) ) {
+            bvirial_ = virial_t{};
+            nbvirial_ = virial_t{};
+            virial = &nbvirial_;
         }
-        
+        const auto& charges = cg->charges();
         result_t result = 
-            cg->doWithAllFreeGroups<result_t>([this] (const std::vector<bead_ptr_t>& all,
-                                                      const std::vector<bead_ptr_t>& free,
-                                                      const std::vector<bead_group_ptr_t>& groups) {
+            cg->doWithAllFreeGroups<result_t>([this, virial, &charges] (const std::vector<bead_ptr_t>& all,
+                                                              const std::vector<bead_ptr_t>& free,
+                                                              const std::vector<bead_group_ptr_t>& groups) {
                 for (auto p: all) {
                     p->resetForce();
                 }
-                return this->forcefield_->interact(all, free, groups, pairLists_);
+                return this->forcefield_->interact(all, free, groups, charges, pairLists_, virial);
             });
         
-        counter += 1;
+        counter_ += 1;
         return result;
     }
     
+    energy_t
+    Interactor<Bead>::bonded(const sim_param_t& param, 
+                             const cg_ptr_t& cg)
+    {
+        virial_t* virial = nullptr;
+        if ( param.get<bool>("virial", false) ) {
+            bvirial_ = virial_t{};
+            virial = &bvirial_;
+        }
+        return cg->doWithAllFreeGroups<energy_t>([this, virial] (const std::vector<bead_ptr_t>& all,
+                                                                 const std::vector<bead_ptr_t>& free,
+                                                                 const std::vector<bead_group_ptr_t>& groups) {
+            for (auto p: all) {
+                p->resetForce();
+            }
+            return this->forcefield_->bonded(all, free, groups, pairLists_, virial);
+        });
+    }
+    
+    energy_t
+    Interactor<Bead>::nonBonded(const sim_param_t& param, 
+                                const cg_ptr_t& cg)
+    {
+        this->cutoffDistance_(param);
+        this->updatePairLists_(param, cg);
+        
+        virial_t* virial = nullptr;
+        if ( param.get<bool>("virial", false) ) {
+            nbvirial_ = virial_t{};
+            virial = &nbvirial_;
+        }
+        const auto& charges = cg->charges();
+        energy_t nbepot = 
+            cg->doWithAllFreeGroups<energy_t>([this, virial, &charges] (const std::vector<bead_ptr_t>& all,
+                                                              const std::vector<bead_ptr_t>& free,
+                                                              const std::vector<bead_group_ptr_t>& groups) {
+                for (auto p: all) {
+                    p->resetForce();
+                }
+                return this->forcefield_->nonBonded(all, free, groups, charges, pairLists_, virial);
+            });
+        
+        counter_ += 1;
+        return nbepot;
+    }
+    
     std::pair<energy_t, energy_t>
     Interactor<Bead>::interact(const bead_ptr_t& bead,
                                const sim_param_t& param, 
                                const cg_ptr_t& cg)
     {
-        return cg->doWithAllFreeGroups<result_t>([this, bead] (const std::vector<bead_ptr_t>& all,
+        this->cutoffDistance_(param);
+        const auto& charges = cg->charges();
+        return cg->doWithAllFreeGroups<result_t>([this, bead, &charges] (const std::vector<bead_ptr_t>& all,
                                                                const std::vector<bead_ptr_t>& free,
                                                                const std::vector<bead_group_ptr_t>& groups) {
-            return this->forcefield_->interact(bead, all, free, groups);
+            return this->forcefield_->interact(bead, all, free, groups, charges);
+        });
+    }
+    
+    std::pair<energy_t, energy_t>
+    Interactor<Bead>::interact(const bead_ptr_t& bead,
+                               const std::vector<bead_ptr_t>& free,
+                               const std::vector<bead_group_ptr_t>& groups,
+                               const sim_param_t& param, 
+                               const cg_ptr_t& cg)
+    {
+        this->cutoffDistance_(param);
+        const auto& charges = cg->charges();
+        return cg->doWithAll<result_t>([this, &bead, &free, &groups, &charges] (const std::vector<bead_ptr_t>& all) {
+            return this->forcefield_->interact(bead, all, free, groups, charges);
         });
     }
     
+    energy_t
+    Interactor<Bead>::chargesChanged(const std::vector<std::pair<bead_ptr_t, charge_t>>& changed,
+                                     const sim_param_t& param)
+    {
+        if ( changed.empty() ) {
+            return 0.0;
+        }
+        virial_t* virial = param.get<bool>("virial", false) ? &nbvirial_ : nullptr;
+        return forcefield_->chargesChanged(changed, pairLists_, virial);
+    }
+    
+    virial_t
+    Interactor<Bead>::virial() const
+    {
+        virial_t virial = bvirial_;
+        for (std::size_t k = 0; k != 3; ++k) {
+            for (std::size_t l = 0; l != 3; ++l) {
+                virial[k][l] += nbvirial_[k][l];
+            }
+        }
+        return virial;
+    }
+    
+    void
+    Interactor<Bead>::writeCheckpoint(std::ostream& stream) const
+    {
+        util::writeBinary(stream, setup_);
+        util::writeBinary(stream, npairlists_);
+        util::writeBinary(stream, counter_);
+        util::writeBinary(stream, bvirial_);
+        util::writeBinary(stream, nbvirial_);
+        util::writeBinary(stream, pairLists_.isModified());
+        std::vector<std::uint64_t> indices{};
+        for (const auto& pair : pairLists_.particlePairList()) {
+            indices.push_back(pair.first->index());
+            indices.push_back(pair.second->index());
+        }
+        util::writeBinary(stream, indices);
+    }
+    
+    void
+    Interactor<Bead>::readCheckpoint(std::istream& stream, const cg_ptr_t& cg)
+    {
+        bool modified;
+        std::vector<std::uint64_t> indices{};
+        util::readBinary(stream, setup_);
+        util::readBinary(stream, npairlists_);
+        util::readBinary(stream, counter_);
+        util::readBinary(stream, bvirial_);
+        util::readBinary(stream, nbvirial_);
+        util::readBinary(stream, modified);
+        util::readBinary(stream, indices);
+        pairLists_ = cg->doWithAll<PairLists<Bead>>([&indices] (const std::vector<bead_ptr_t>& all) {
+            std::vector<bead_ptr_t> beads(all.size());
+            for (const auto& bead : all) {
+                beads.at(bead->index()) = bead;
+            }
+            PairLists<Bead>::pp_list_cont_t pairList{};
+            pairList.reserve(indices.size() / 2);
+            for (std::size_t k = 0; k + 1 < indices.size(); k += 2) {
+                if ( indices[k] >= beads.size() || indices[k + 1] >= beads.size() ) {
+                    throw std::domain_error(
+                        "Interactor: Checkpoint does not match the particle model."
+                    );
+                }
+                pairList.push_back(std::make_pair(beads[indices[k]], beads[indices[k + 1]]));
+            }
+            return PairLists<Bead>(pairList);
+        });
+        pairLists_.updated_(modified);
+    }
+    
     void
-    Interactor<Bead>::updatePairLists_(const cg_ptr_t& cg)
+    Interactor<Bead>::updatePairLists_(const sim_param_t& param, const cg_ptr_t& cg)
     {
+        if ( !setup_ ) {
+            npairlists_ = param.get<std::size_t>("npairlists");
+            setup_ = true;
+        }
+        if ( counter_ % npairlists_ != 0 && counter_ != 0) {
+            pairLists_.updated_(false);
+            return;
+        }
         pairLists_ = 
             cg->doWithAllFreeGroups<PairLists<Bead>>([this] (const std::vector<bead_ptr_t>& all,
                                                              const std::vector<bead_ptr_t>& free,
                                                              const std::vector<bead_group_ptr_t>& groups) {
                 return this->pairListGenerator_->generate(all, free, groups);
             });
+        pairLists_.updated_(true);
+    }
+    
+    void
+    Interactor<Bead>::cutoffDistance_(const sim_param_t& param)
+    {
+        if ( !cutoff_ ) {
+            length_t rc{param.get<real_t>("cutoff", 0.0)};
+            forcefield_->cutoffDistance(rc);
+            pairListGenerator_->cutoffDistance(rc);
+            cutoff_ = true;
+        }
+    }
+    
+    length_t
+    Interactor<Bead>::bondLength() const
+    {
+        return forcefield_->bondLength();
     }
     
     std::string
@@ -31,12 +31,12 @@
 
 #include "simploce/simulation/langevin-velocity-verlet.hpp"
 #include "simploce/simulation/interactor.hpp"
+#include "simploce/simulation/rattle.hpp"
 #include "simploce/simulation/sim-util.hpp"
 #include "simploce/simulation/sconf.hpp"
 #include "simploce/particle/atom.hpp"
 #include "simploce/particle/bead.hpp"
 #include "simploce/util/mu-units.hpp"
-#include "simploce/util/util.hpp"
 #include <random>
 #include <cmath>
 #include <array>
@@ -44,69 +44,54 @@
 
 namespace simploce {
     
-    // Helpers.
-    static std::vector<real_t> FC_{};
-    static std::vector<real_t> B_{};
-    static std::vector<real_t> A1_{};
-    static std::vector<real_t> A2_{};
-    static std::vector<real_t> strengths_{};
-    
-    static std::vector<force_t> fis_{};      // Forces at time t(n).
-    static std::vector<position_t> ris_{};   // Positions at time t(n).
-    
-    // Random vector W, each element is a array of size 3.
-    static std::random_device rd_{};
-    static std::mt19937 gen_(rd_());
-    static std::normal_distribution<real_t> dis_{0.0, 1.0}; // Standard Wiener/Brownian
-    static std::vector<std::array<real_t, 3>> W_{};
+    using helpers_t = LangevinVelocityVerletHelpers;
     
     /**
-     * Calculation of helper values.
+     * Calculation of helper values. Called again if the temperature or the time
+     * step changes.
      * @param T Particle type.
-     * @param dt Time step.
+     * @param helpers Helpers. Must provide time step, temperature and damping rate.
      * @param particles Particles.
      */
     template <typename T>
-    void setupHelpers_(const stime_t& dt,
-                       const temperature_t& temperature,
-                       real_t gamma,
+    void setupHelpers_(helpers_t& helpers,
                        const std::vector<std::shared_ptr<T>>& particles)
     {
-        real_t kT = MUUnits<real_t>::KB * temperature();
+        const stime_t& dt = helpers.dt;
+        real_t gamma = helpers.gamma;
+        real_t kT = MUUnits<real_t>::KB * helpers.temperature();
         std::size_t nparticles = particles.size();
         
-        FC_ = std::vector<real_t>(nparticles, 0.0);
-        B_ = std::vector<real_t>(nparticles, 0.0);
-        A1_ = std::vector<real_t>(nparticles, 0.0);
-        A2_ = std::vector<real_t>(nparticles, 0.0);
-        strengths_ = std::vector<real_t>(nparticles, 0.0);
+        helpers.FC = std::vector<real_t>(nparticles, 0.0);
+        helpers.B = std::vector<real_t>(nparticles, 0.0);
+        helpers.A1 = std::vector<real_t>(nparticles, 0.0);
+        helpers.A2 = std::vector<real_t>(nparticles, 0.0);
+        helpers.strengths = std::vector<real_t>(nparticles, 0.0);
         
-        fis_ = std::vector<force_t>(nparticles, force_t{});
-        ris_ = std::vector<position_t>(nparticles, position_t{});
+        helpers.fis = std::vector<force_t>(nparticles, force_t{});
+        helpers.ris = std::vector<position_t>(nparticles, position_t{});
         
-        W_ = std::vector<std::array<real_t, 3>>(nparticles, std::array<real_t, 3>{0.0, 0.0, 0.0});
-        auto value = util::seedValue<std::size_t>();
-        gen_.seed(value);
+        helpers.W = 
+            std::vector<std::array<real_t, 3>>(nparticles, std::array<real_t, 3>{0.0, 0.0, 0.0});
     
         for (auto p : particles) {
             auto& particle = *p;
             
             auto index = particle.index();
             
-            
             mass_t mass = particle.mass();                        // In u.
             real_t fc =  mass() * gamma;                          // Friction 
-            FC_[index] = fc;                                      // coefficient in u/ps.
+            helpers.FC[index] = fc;                               // coefficient in u/ps.
                                                                   
             // All kinds of constant factors for each particle.
             real_t a1 = dt() / (2.0 * mass());                    // ps/u
-            A1_[index] = a1;
+            helpers.A1[index] = a1;
             real_t a2 = a1 * dt();                                // ps^2/u
-            A2_[index] = a2;
+            helpers.A2[index] = a2;
             real_t strength = std::sqrt( dt() * 2.0 * fc * kT );  // In (u nm) / ps.
-            strengths_[index] = strength;
+            helpers.strengths[index] = strength;
             real_t b = 1.0 / ( 1.0 + fc * a1);                    // No units.
-            B_[index] = b;
+            helpers.B[index] = b;
 
             // Validate.
             real_t f1 = fc * a1;
@@ -118,95 +103,142 @@ namespace simploce {
             }
         }                
     }
+    
+    /**
+     * Reads time step, temperature and damping rate. Sets up helpers on the 
+     * first call, or whenever the temperature or the time step was changed.
+     * @param T Particle type.
+     * @param param Simulation parameters.
+     * @param helpers Helpers.
+     * @param particles Particles.
+     * @return True if helpers were (re)calculated.
+     */
+    template <typename T>
+    bool updateHelpers_(const sim_param_t& param,
+                        helpers_t& helpers,
+                        const std::vector<std::shared_ptr<T>>& particles)
+    {
+        temperature_t temperature = param.get<real_t>("temperature", 298.15);
+        stime_t dt = param.get<real_t>("timestep");
+        if ( helpers.setup && 
+             temperature() == helpers.temperature() && 
+             dt() == helpers.dt() ) {
+            return false;
+        }
+        if ( !helpers.setup ) {
+            helpers.gamma = param.get<real_t>("gamma", 0.5);
+            std::uint64_t seed = param.get<std::uint64_t>("seed", std::random_device{}());
+            helpers.rng = Philox(seed);
+        }
+        helpers.dt = dt;
+        helpers.temperature = temperature;
+        setupHelpers_<T>(helpers, particles);
+        return true;
+    }
 
     /**
      * Displace particle position.
      * @param T Particle type.
-     * @param dt Time step.
+     * @param helpers Helpers.
      * @param particles Particles.
      */
     template <typename T>
-    void displacePosition_(const stime_t& dt,
+    void displacePosition_(helpers_t& helpers,
                            const std::vector<std::shared_ptr<T>>& particles)
     {        
-        for (auto& p : particles) {
-            auto& particle = *p;
+        const stime_t& dt = helpers.dt;
+        util::forEachRange<bool>(particles.size(), [&dt, &helpers, &particles] (std::size_t k,
+                                                                                std::size_t begin,
+                                                                                std::size_t end) {
+            for (std::size_t i = begin; i != end; ++i) {
+                auto& particle = *particles[i];
             
-            auto index = particle.index();
+                auto index = particle.index();
     
-            // Update position, not velocity.
-            static std::array<real_t, 3> w;            // Random vector at t(n+1).
-            w[0] = dis_(gen_);
-            w[1] = dis_(gen_);
-            w[2] = dis_(gen_);
-            W_[index] = w;                             // Save for updating velocities.
+                // Update position, not velocity. Standard Wiener/Brownian.
+                auto n = helpers.rng.normal(helpers.counter, index);
+                std::array<real_t, 3> w{n[0], n[1], n[2]}; // Random vector at t(n+1).
+                helpers.W[index] = w;                      // Save for updating velocities.
         
-            force_t fi = particle.force();             // Force (kJ/(mol nm) = 
-            fis_[index] = fi;                          // (u nm)/(ps^2)) at time t(n)
+                force_t fi = particle.force();             // Force (kJ/(mol nm) = 
+                helpers.fis[index] = fi;                   // (u nm)/(ps^2)) at time t(n)
       
-            velocity_t vi = particle.velocity();       // Velocity (nm/ps) at time t(n).
-            position_t ri = particle.position();       // Position at time t(n).
-            ris_[index] = ri;                          // Save for velocity update.
-            static position_t rf;
-            real_t b = B_[index];                      // No units.
-            real_t a1 = A1_[index];                    // ps/u
-            real_t a2 = A2_[index];                    // ps^2/u
-            real_t strength = strengths_[index];
-            for (std::size_t k = 0; k != 3; ++k) { 
-                rf[k] = ri[k] +
-                    b * dt() * vi[k] +
-                    b * a2 * fi[k] +
-                    b * a1 * strength * w[k];          // Position at time t(n+1).
-            }
+                velocity_t vi = particle.velocity();       // Velocity (nm/ps) at time t(n).
+                position_t ri = particle.position();       // Position at time t(n).
+                helpers.ris[index] = ri;                   // Save for velocity update.
+                position_t rf;
+                real_t b = helpers.B[index];               // No units.
+                real_t a1 = helpers.A1[index];             // ps/u
+                real_t a2 = helpers.A2[index];             // ps^2/u
+                real_t strength = helpers.strengths[index];
+                for (std::size_t k = 0; k != 3; ++k) { 
+                    rf[k] = ri[k] +
+                        b * dt() * vi[k] +
+                        b * a2 * fi[k] +
+                        b * a1 * strength * w[k];          // Position at time t(n+1).
+                }
         
-            // Update position.
-            particle.position(rf);        
-        }
+                // Update position.
+                particle.position(rf);        
+            }
+            return true;
+        });
     }
     
     template <typename T>
-    SimulationData displaceVelocity_(const std::vector<std::shared_ptr<T>>& particles)
+    SimulationData displaceVelocity_(const helpers_t& helpers,
+                                     const std::vector<std::shared_ptr<T>>& particles)
     {
         SimulationData data;
         
-        // Kinetic energy at t(n+1).
-        data.ekin = 0.0;
-        
-        // Displace particles: momenta.
-        for (auto& p : particles) {
-            auto& particle = *p;
+        // Displace particles: momenta. Kinetic energy at t(n+1) per range.
+        auto ekins = 
+            util::forEachRange<real_t>(particles.size(), [&helpers, &particles] (std::size_t k,
+                                                                                 std::size_t begin,
+                                                                                 std::size_t end) {
+            real_t ekin = 0.0;
+            for (std::size_t i = begin; i != end; ++i) {
+                auto& particle = *particles[i];
             
-            auto index = particle.index();
+                auto index = particle.index();
             
-            mass_t mass = particle.mass();             // In u.
+                mass_t mass = particle.mass();             // In u.
       
-            std::array<real_t, 3> w = W_[index];       // Random vector at t(n+1).
-            force_t fi = fis_[index];                  // Force (kJ/(mol nm) = (u nm)/(ps^2)) 
-                                                       // at time t(n).
-            position_t ri = ris_[index];               // Position at time t(n).
+                std::array<real_t, 3> w = helpers.W[index];// Random vector at t(n+1).
+                force_t fi = helpers.fis[index];           // Force (kJ/(mol nm) = (u nm)/(ps^2)) 
+                                                           // at time t(n).
+                position_t ri = helpers.ris[index];        // Position at time t(n).
       
-            force_t ff = particle.force();             // Force (kJ/(mol nm) = (u nm)/(ps^2))
-                                                       // at time t(n+1).
-            velocity_t vi = particle.velocity();       // velocity (nm/ps) at time t(n).
-            position_t rf = particle.position();       // Position at time t(n+1).
+                force_t ff = particle.force();             // Force (kJ/(mol nm) = (u nm)/(ps^2))
+                                                           // at time t(n+1).
+                velocity_t vi = particle.velocity();       // velocity (nm/ps) at time t(n).
+                position_t rf = particle.position();       // Position at time t(n+1).
       
-            real_t fc = FC_[index];
-            real_t a1 = A1_[index];
-            real_t strength = strengths_[index];
+                real_t fc = helpers.FC[index];
+                real_t a1 = helpers.A1[index];
+                real_t strength = helpers.strengths[index];
       
-            static velocity_t vf{};
-            for (std::size_t k = 0; k != 3; ++k) {
-                vf[k] = vi[k] +
-                    a1 * ( fi[k] + ff[k] ) -
-                    fc * ( rf[k] - ri[k] ) / mass() +
-                    strength * w[k] / mass();          // Velocity at time t(n+1).
-            }
+                velocity_t vf{};
+                for (std::size_t k = 0; k != 3; ++k) {
+                    vf[k] = vi[k] +
+                        a1 * ( fi[k] + ff[k] ) -
+                        fc * ( rf[k] - ri[k] ) / mass() +
+                        strength * w[k] / mass();          // Velocity at time t(n+1).
+                }
       
-            // Update velocity.
-            particle.velocity(vf);
+                // Update velocity.
+                particle.velocity(vf);
       
-            // Kinetic energy at time t(n+1)..
-            data.ekin += 0.5 * mass() * inner<real_t>(vf, vf);
+                // Kinetic energy at time t(n+1)..
+                ekin += 0.5 * mass() * inner<real_t>(vf, vf);
+            }
+            return ekin;
+        });
+        
+        // Kinetic energy at t(n+1).
+        data.ekin = 0.0;
+        for (auto ekin : ekins) {
+            data.ekin += ekin;
         }
         
         // Instantaneous temperature at t(n+1).
@@ -218,7 +250,7 @@ namespace simploce {
     }
     
     LangevinVelocityVerlet<Atomistic>::LangevinVelocityVerlet(const at_interactor_ptr_t& interactor) :
-        AtomisticDisplacer{}, interactor_{interactor}
+        AtomisticDisplacer{}, interactor_{interactor}, helpers_{}
     {       
     }
         
@@ -226,46 +258,34 @@ namespace simploce {
     LangevinVelocityVerlet<Atomistic>::displace(const sim_param_t& param, 
                                                 const at_ptr_t& at) const
     {
-        static bool setup = false;
-
-        static stime_t dt{0.0};
-        static temperature_t temperature{0.0};
-        static real_t gamma{0.0};
-        static std::size_t counter = 0;
-
-        if ( !setup ) {            
-            dt = param.get<real_t>("timestep");
-            temperature = param.get<real_t>("temperature", 298.15);
-            gamma = param.get<real_t>("gamma", 0.5);
-
-            at->doWithAll<void>([] (const std::vector<atom_ptr_t>& atoms) {
-                setupHelpers_<Atom>(dt, temperature, gamma, atoms);
-            });
-            
+        bool firstTime = !helpers_.setup;
+        at->doWithAll<void>([this, &param] (const std::vector<atom_ptr_t>& atoms) {
+            updateHelpers_<Atom>(param, this->helpers_, atoms);
+        });
+        if ( firstTime ) {
             interactor_->interact(param, at);  // Initial forces.
-            
-            setup = true;
+            helpers_.setup = true;
         }
         
-        counter += 1;
+        helpers_.counter += 1;
                 
         // Displace atom positions.
-        at->doWithAll<void>([] (const std::vector<atom_ptr_t>& atoms) {
-            displacePosition_<Atom>(dt, atoms);
+        at->doWithAll<void>([this] (const std::vector<atom_ptr_t>& atoms) {
+            displacePosition_<Atom>(this->helpers_, atoms);
         });
         
         // Compute forces and potential energy at t(n+1) using positions at t(n+1).
         auto result = interactor_->interact(param, at);
         
         // Displace atom velocities.
-        SimulationData data = at->doWithAll<SimulationData>([] (const std::vector<atom_ptr_t>& atoms) {
-            return displaceVelocity_<Atom>(atoms);
+        SimulationData data = at->doWithAll<SimulationData>([this] (const std::vector<atom_ptr_t>& atoms) {
+            return displaceVelocity_<Atom>(this->helpers_, atoms);
         });
         
         // Save simulation data
         data.bepot = result.first;
         data.nbepot = result.second;        
-        data.t = counter * dt;
+        data.t = helpers_.counter * helpers_.dt;
         
         return data;
     }    
@@ -276,7 +296,7 @@ namespace simploce {
     }
 
     LangevinVelocityVerlet<CoarseGrained>::LangevinVelocityVerlet(const cg_interactor_ptr_t& interactor) :
-        CoarseGrainedDisplacer{}, interactor_{interactor}     
+        CoarseGrainedDisplacer{}, interactor_{interactor}, helpers_{}, rattle_{}
     {       
     }
 
@@ -284,46 +304,65 @@ namespace simploce {
     LangevinVelocityVerlet<CoarseGrained>::displace(const sim_param_t& param, 
                                                     const cg_ptr_t& cg) const
     {
-        static bool setup = false;
-
-        static stime_t dt{0.0};
-        static temperature_t temperature{0.0};
-        static real_t gamma{0.0};
-        static std::size_t counter = 0.0;
-        
-        counter += 1;
+        helpers_.counter += 1;
         
-        if ( !setup ) {            
-            dt = param.get<real_t>("timestep");
-            temperature = param.get<real_t>("temperature");
-            gamma = param.get<real_t>("gamma");
-            
-            cg->doWithAll<void>([] (const std::vector<bead_ptr_t>& beads) {
-                setupHelpers_<Bead>(dt, temperature, gamma, beads);
-            });
-            
+        bool firstTime = !helpers_.setup;
+        cg->doWithAll<void>([this, &param] (const std::vector<bead_ptr_t>& beads) {
+            updateHelpers_<Bead>(param, this->helpers_, beads);
+        });
+        if ( firstTime ) {
+            if ( param.get<std::string>("constraints", conf::NO_CONSTRAINTS) == conf::RATTLE ) {
+                rattle_ = 
+                    std::make_shared<Rattle<Bead>>(interactor_->bondLength());
+            }
             interactor_->interact(param, cg); // Initial forces.
-            
-            setup = true;
+            helpers_.setup = true;
         }
         
         // Displace bead positions.
-        cg->doWithAll<void>([] (const std::vector<bead_ptr_t>& beads) {
-            displacePosition_<Bead>(dt, beads);
+        cg->doWithAllFreeGroups<void>([this] (const std::vector<bead_ptr_t>& all,
+                                              const std::vector<bead_ptr_t>& free,
+                                              const std::vector<bead_group_ptr_t>& groups) {
+            if ( this->rattle_ ) {
+                this->rattle_->reference(all);
+            }
+            displacePosition_<Bead>(this->helpers_, all);
+            if ( this->rattle_ ) {
+                // Include constraint forces at t(n), such that the constraint
+                // displacements are carried over to the velocities.
+                auto drs = this->rattle_->constrainPositions(all, groups);
+                for (const auto& bead : all) {
+                    auto index = bead->index();
+                    real_t ba2 = this->helpers_.B[index] * this->helpers_.A2[index];
+                    for (std::size_t k = 0; k != 3; ++k) {
+                        this->helpers_.fis[index][k] += drs[index][k] / ba2;
+                    }
+                }
+            }
         });
         
         // Compute forces and potential energy at t(n+1) using positions at t(n+1).
         auto result = interactor_->interact(param, cg);
         
         // Displace bead velocities.
-        SimulationData data = cg->doWithAll<SimulationData>([] (const std::vector<bead_ptr_t>& beads) {
-            return displaceVelocity_<Bead>(beads);
+        SimulationData data = 
+            cg->doWithAllFreeGroups<SimulationData>([this] (const std::vector<bead_ptr_t>& all,
+                                                            const std::vector<bead_ptr_t>& free,
+                                                            const std::vector<bead_group_ptr_t>& groups) {
+            auto data = displaceVelocity_<Bead>(this->helpers_, all);
+            if ( this->rattle_ ) {
+                data.cvirial = this->rattle_->constrainVelocities(groups, this->helpers_.dt);
+                data.ekin = util::kineticEnergy<Bead>(all);
+                data.temperature = 
+                    util::temperature<Bead>(all, data.ekin, this->rattle_->numberOfConstraints(groups));
+            }
+            return data;
         });
         
         // Save simulation data.
         data.bepot = result.first;
         data.nbepot = result.second;                
-        data.t = counter * dt;
+        data.t = helpers_.counter * helpers_.dt;
 
         return data;
     }    
@@ -333,6 +372,58 @@ namespace simploce {
     {
         return conf::LANGEVIN_VELOCITY_VERLET;
     }
+    
+    void 
+    LangevinVelocityVerlet<CoarseGrained>::writeCheckpoint(std::ostream& stream) const
+    {
+        util::writeBinary(stream, helpers_.setup);
+        util::writeBinary(stream, helpers_.counter);
+        util::writeBinary(stream, helpers_.dt);
+        util::writeBinary(stream, helpers_.temperature);
+        util::writeBinary(stream, helpers_.gamma);
+        util::writeBinary(stream, helpers_.rng.seed());
+        
+        // Per particle factors depend on masses at the time they were calculated.
+        util::writeBinary(stream, helpers_.FC);
+        util::writeBinary(stream, helpers_.B);
+        util::writeBinary(stream, helpers_.A1);
+        util::writeBinary(stream, helpers_.A2);
+        util::writeBinary(stream, helpers_.strengths);
+        util::writeBinary(stream, bool(rattle_));
+    }
+    
+    void 
+    LangevinVelocityVerlet<CoarseGrained>::readCheckpoint(std::istream& stream, 
+                                                          const cg_ptr_t& cg)
+    {
+        std::uint64_t seed;
+        bool rattle;
+        util::readBinary(stream, helpers_.setup);
+        util::readBinary(stream, helpers_.counter);
+        util::readBinary(stream, helpers_.dt);
+        util::readBinary(stream, helpers_.temperature);
+        util::readBinary(stream, helpers_.gamma);
+        util::readBinary(stream, seed);
+        helpers_.rng = Philox(seed);
+        util::readBinary(stream, helpers_.FC);
+        util::readBinary(stream, helpers_.B);
+        util::readBinary(stream, helpers_.A1);
+        util::readBinary(stream, helpers_.A2);
+        util::readBinary(stream, helpers_.strengths);
+        util::readBinary(stream, rattle);
+        
+        // Intermediate results of a step.
+        std::size_t nparticles = helpers_.FC.size();
+        helpers_.fis = std::vector<force_t>(nparticles, force_t{});
+        helpers_.ris = std::vector<position_t>(nparticles, position_t{});
+        helpers_.W = 
+            std::vector<std::array<real_t, 3>>(nparticles, std::array<real_t, 3>{0.0, 0.0, 0.0});
+        
+        rattle_.reset();
+        if ( rattle ) {
+            rattle_ = 
+                std::make_shared<Rattle<Bead>>(interactor_->bondLength());
+        }
+    }
 
 }
-
@@ -50,11 +50,7 @@ namespace simploce {
     displace_(const stime_t dt, 
               const std::vector<std::shared_ptr<T>>& particles)
     {
-        static std::size_t counter = 0;
-        
         // Assume current step n-1/2 at time t(n-1/2).
-
-        counter += 1;
         
         // Compute linear momentum and position, plus kinetic energy.
         SimulationData data;
@@ -65,7 +61,7 @@ namespace simploce {
             velocity_t vi = particle.velocity();       // velocity (nm/ps) at time t(n-1/2).
             position_t r = particle.position();        // Position at time t(n).
       
-            static velocity_t vf{};
+            velocity_t vf{};
             for (std::size_t k = 0; k != 3; ++k) {
                 vf[k] = vi[k] + dt() * f[k] / mass();  // Velocity at time t(n+1/2)
                 r[k] += dt() * vf[k];                  // Position at time t(n+1).
@@ -83,14 +79,11 @@ namespace simploce {
         // Temperature at t(n).
         data.temperature = util::temperature<T>(particles, data.ekin);
         
-        // Time.
-        data.t = counter * dt;
-        
         return data;        
     }
     
     LeapFrog<Atomistic>::LeapFrog(const at_interactor_ptr_t& interactor) :
-        interactor_{interactor}
+        interactor_{interactor}, setup_{false}, counter_{0}, dt_{0.0}
     {        
     }
     
@@ -98,28 +91,25 @@ namespace simploce {
     LeapFrog<Atomistic>::displace(const sim_param_t& param, 
                                   const at_ptr_t& at) const
     {
-        static bool setup = false;
-        static stime_t dt{0.0};
-        static std::size_t counter = 0.0;
+        counter_ += 1;
         
-        counter += 1;
-        
-        if ( !setup ) {
-            dt = param.get<real_t>("timestep");        
+        if ( !setup_ ) {
+            dt_ = param.get<real_t>("timestep");
+            setup_ = true;
         }
         
         // Forces and energies.
         auto result = interactor_->interact(param, at);
         
         // Displace.
-        SimulationData data = at->doWithAll<SimulationData>([] (const std::vector<atom_ptr_t>& atoms) {
-            return displace_<Atom>(dt, atoms);
+        SimulationData data = at->doWithAll<SimulationData>([this] (const std::vector<atom_ptr_t>& atoms) {
+            return displace_<Atom>(this->dt_, atoms);
         });
         
         // Save simulation data.
         data.bepot = result.first;
         data.nbepot = result.second;
-        data.t = counter * dt;
+        data.t = counter_ * dt_;
         
         return data;
     }
@@ -131,7 +121,7 @@ namespace simploce {
     }
     
     LeapFrog<CoarseGrained>::LeapFrog(const cg_interactor_ptr_t& interactor) : 
-        interactor_{interactor}
+        interactor_{interactor}, setup_{false}, counter_{0}, dt_{0.0}
     {        
     }
     
@@ -139,26 +129,23 @@ namespace simploce {
     LeapFrog<CoarseGrained>::displace(const sim_param_t& param, 
                                       const cg_ptr_t& cg) const
     {
-        static bool setup = false;
-        static stime_t dt{0.0};
-        static std::size_t counter = 0.0;
-        
-        counter += 1;
+        counter_ += 1;
         
-        if ( !setup ) {
-            dt = param.get<real_t>("timestep");        
+        if ( !setup_ ) {
+            dt_ = param.get<real_t>("timestep");
+            setup_ = true;
         }
         
         // Forces and energies.
         auto result = interactor_->interact(param, cg);
-        SimulationData data = cg->doWithAll<SimulationData>([] (const std::vector<bead_ptr_t>& beads) {
-            return displace_<Bead>(dt, beads);
+        SimulationData data = cg->doWithAll<SimulationData>([this] (const std::vector<bead_ptr_t>& beads) {
+            return displace_<Bead>(this->dt_, beads);
         });
         
         // Save simulation data.
         data.bepot = result.first;
         data.nbepot = result.second;
-        data.t = counter * dt;
+        data.t = counter_ * dt_;
         
         return data;
     }
@@ -168,5 +155,21 @@ namespace simploce {
     {
         return conf::LEAP_FROG;
     }
+    
+    void 
+    LeapFrog<CoarseGrained>::writeCheckpoint(std::ostream& stream) const
+    {
+        util::writeBinary(stream, setup_);
+        util::writeBinary(stream, counter_);
+        util::writeBinary(stream, dt_);
+    }
+    
+    void 
+    LeapFrog<CoarseGrained>::readCheckpoint(std::istream& stream, const cg_ptr_t& cg)
+    {
+        util::readBinary(stream, setup_);
+        util::readBinary(stream, counter_);
+        util::readBinary(stream, dt_);
+    }
 }
 
@@ -41,37 +41,36 @@
 #include <future>
 #include <utility>
 #include <tuple>
+#include <map>
+#include <algorithm>
 #include <cassert>
 
 namespace simploce {
     
     using lj_params_t = ForceField::lj_params_t;
     using el_params_t = ForceField::el_params_t;
-    using result_t = std::pair<energy_t, std::vector<force_t>>;
+    using result_t = std::tuple<energy_t, std::vector<force_t>, virial_t>;
     using bead_pair_list_t = PairLists<Bead>::pp_list_cont_t;
     
     /**
      * Returns interaction potential energy and force on particle i. The Coulomb
      * interaction is calculated according to the shifted force (SF) method of 
      * Levitt, M. et al, Comput. Phys. Commun. 1995, 91, 215−231.
+     * @param rij Distance vector r_i - r_j, boundary condition applied.
+     * @param rc Cutoff distance.
      */
     static std::tuple<energy_t, force_t, length_t> 
-    ljCoulombForce_(const position_t& ri,
+    ljCoulombForce_(const dist_vect_t& rij,
                     const charge_t& qi,
-                    const position_t& rj,
                     const charge_t& qj,
                     real_t C12,
                     real_t C6,
                     real_t eps_r,
-                    const bc_ptr_t& bc,
-                    const box_ptr_t& box)
+                    const length_t& rc)
     {
         static const real_t four_pi_e0 = MUUnits<real_t>::FOUR_PI_E0;
-        static const length_t rc = util::cutoffDistance(box);
-        static const real_t rc2 = rc() * rc();
+        const real_t rc2 = rc() * rc();
         
-        // Apply boundary condition.
-        dist_vect_t rij = bc->apply(ri, rj);
         real_t Rij = norm<real_t>(rij);
         
         // Distance may be outside cutoff distance if the pair list was not updated.
@@ -112,19 +111,23 @@ namespace simploce {
         return std::make_tuple(epot, f, Rij);
     }
     
-    // Returns forces on beads and energy for bead pairs.
+    // Returns forces on beads and energy for bead pairs, as well as the virial
+    // tensor if requested. Charges are read from the given charge values.
     static result_t ppForces_(const bead_pair_list_t ppPairList,
+                              const std::vector<charge_t>& charges,
                               std::size_t nbeads,
                               const lj_params_t& ljParams,
                               const el_params_t& elParams,
                               const bc_ptr_t& bc,
-                              const box_ptr_t& box)
+                              const length_t& rc,
+                              bool computeVirial)
     {
         std::vector<force_t> forces(nbeads, force_t{});
         energy_t epot{0.0};
+        virial_t virial{};
         
         // Electrostatic parameters.
-        static const real_t eps_r = elParams.at("eps_r");
+        const real_t eps_r = elParams.at("eps_r");
             
         for (auto pp : ppPairList) {
             
@@ -132,21 +135,22 @@ namespace simploce {
             bead_ptr_t pi = pp.first;
             position_t ri = pi->position();
             std::string name_i = pi->spec()->name();
-            charge_t qi = pi->charge();
             std::size_t index_i = pi->index();
+            charge_t qi = charges[index_i];
       
             // Second particle.
             bead_ptr_t pj = pp.second;
             position_t rj = pj->position();
             std::string name_j = pj->spec()->name();
-            charge_t qj = pj->charge();
             std::size_t index_j = pj->index();
+            charge_t qj = charges[index_j];
             
             // Calculate interaction.
             auto ljParam = ljParams.at(name_i, name_j);
             auto C12 = ljParam.first;
             auto C6 = ljParam.second;
-            auto ef = ljCoulombForce_(ri, qi, rj, qj, C12, C6, eps_r, bc, box);
+            dist_vect_t rij = bc->apply(ri, rj);
+            auto ef = ljCoulombForce_(rij, qi, qj, C12, C6, eps_r, rc);
 
 #ifdef _DEBUG
             // Too close?
@@ -157,23 +161,26 @@ namespace simploce {
             epot += std::get<0>(ef);
             forces[index_i] += std::get<1>(ef);
             forces[index_j] -= std::get<1>(ef);
+            if ( computeVirial ) {
+                util::addToVirial(virial, rij, std::get<1>(ef));
+            }
         }
     
-        return std::make_pair(epot, forces);
+        return std::make_tuple(epot, forces, virial);
     }
     
     // Interaction energy only, forces are ignored.
     static energy_t energy_(const bead_ptr_t& bead,
                             const std::vector<bead_ptr_t>& free,
+                            const std::vector<charge_t>& charges,
                             const lj_params_t& ljParams,
                             const el_params_t& elParams,
                             const bc_ptr_t& bc,
-                            const box_ptr_t& box)
+                            const length_t& rc)
     {
         // Electrostatic parameters.
-        static const real_t eps_r = elParams.at("eps_r");
+        const real_t eps_r = elParams.at("eps_r");
 
-        length_t rc = util::cutoffDistance(box);
         real_t rc2 = rc * rc;
         energy_t epot{0.0};
         
@@ -181,7 +188,7 @@ namespace simploce {
         auto pi = bead;
         position_t ri = pi->position();
         std::string name_i = pi->spec()->name();
-        charge_t qi = pi->charge();
+        charge_t qi = charges[pi->index()];
         std::size_t index_i = pi->index();
 
         for (auto pj : free) {            
@@ -192,16 +199,16 @@ namespace simploce {
                 position_t rj = pj->position();
                 auto rij = bc->apply(ri, rj);
                 auto Rij2 = norm2<real_t>(rij);
-                if ( Rij2 < rc2 ) {
+                if ( Rij2 <= rc2 ) {
                     std::string name_j = pj->spec()->name();
-                    charge_t qj = pj->charge();
+                    charge_t qj = charges[pj->index()];
                                   
                     // Calculate interaction.      
                     auto ljParam = ljParams.at(name_i, name_j);
                     auto C12 = ljParam.first;
                     auto C6 = ljParam.second;
                     auto ef = 
-                        ljCoulombForce_(ri, qi, rj, qj, C12, C6, eps_r, bc, box);
+                        ljCoulombForce_(rij, qi, qj, C12, C6, eps_r, rc);
                     
 #ifdef _DEBUG
                     // Too close?
@@ -217,18 +224,21 @@ namespace simploce {
         return epot;
     }
     
-    energy_t 
+    // Interaction energy with particles in groups, forces are ignored. As for 
+    // the pair lists, the cutoff applies to the distance between groups if the
+    // bead is in a group, and to the distance between particles otherwise.
+    static energy_t 
     energy_(const bead_ptr_t& bead,
             const std::vector<bead_group_ptr_t>& groups,
+            const std::vector<charge_t>& charges,
             const lj_params_t& ljParams,
             const el_params_t& elParams,
             const bc_ptr_t& bc,
-            const box_ptr_t& box)
+            const length_t& rc)
     {
         // Electrostatic parameters.
-        static const real_t eps_r = elParams.at("eps_r");
+        const real_t eps_r = elParams.at("eps_r");
 
-        length_t rc = util::cutoffDistance(box);
         real_t rc2 = rc * rc;
         energy_t epot{0.0};
                 
@@ -236,27 +246,39 @@ namespace simploce {
         auto pi = bead;
         position_t ri = pi->position();
         std::string name_i = pi->spec()->name();
-        charge_t qi = pi->charge();
+        charge_t qi = charges[pi->index()];
         
+        // Group of bead, if any.
+        bead_group_ptr_t own{};
         for (auto g : groups) {
-            if ( !g->contains(bead) ) {
-                position_t rj = g->position();
-                auto rij = bc->apply(ri, rj);
-                auto Rij2 = norm2<real_t>(rij);
-                if ( Rij2 < rc2 ) {
+            if ( g->contains(bead) ) {
+                own = g;
+                break;
+            }
+        }
+        
+        for (auto g : groups) {
+            if ( g != own ) {
+                real_t Rij2 = 0.0;
+                if ( own ) {
+                    auto rij = bc->apply(own->position(), g->position());
+                    Rij2 = norm2<real_t>(rij);
+                }
+                if ( Rij2 <= rc2 ) {
                     for (auto pj : g->particles()) {
                         
-                        // Second particle.
-                        rj = pj->position();
+                        // Second particle. Pairs beyond the cutoff distance 
+                        // contribute nothing.
+                        position_t rj = pj->position();
                         std::string name_j = pj->spec()->name();
-                        charge_t qj = pj->charge();
+                        charge_t qj = charges[pj->index()];
                         
                         // Calculate interaction.
                         auto ljParam = ljParams.at(name_i, name_j);
                         auto C12 = ljParam.first;
                         auto C6 = ljParam.second;
                         auto ef = 
-                            ljCoulombForce_(ri, qi, rj, qj, C12, C6, eps_r, bc, box);
+                            ljCoulombForce_(bc->apply(ri, rj), qi, qj, C12, C6, eps_r, rc);
                         
 #ifdef _DEBUG           
                         // Too close?
@@ -277,7 +299,9 @@ namespace simploce {
                                            const el_params_t& elParams, 
                                            const bc_ptr_t& bc,
                                            const box_ptr_t& box) :
-        ljParams_{ljParams}, elParams_{elParams}, bc_{bc}, box_{box}
+        ljParams_{ljParams}, elParams_{elParams}, bc_{bc}, box_{box},
+        rc_{util::cutoffDistance(box)}, subPairLists_{}, firstTime_{true}, pairsOf_{}, 
+        indexed_{false}
     {        
     }
         
@@ -285,14 +309,17 @@ namespace simploce {
     LJCoulombForces<Bead>::interact(const std::vector<bead_ptr_t>& all,
                                     const std::vector<bead_ptr_t>& free,
                                     const std::vector<bead_group_ptr_t>& groups,
-                                    const PairLists<Bead>& pairLists)
+                                    const std::vector<charge_t>& charges,
+                                    const PairLists<Bead>& pairLists,
+                                    virial_t* virial)
     {         
-        static std::vector<PairLists<Bead>::pp_list_cont_t> subPairLists{};
-        static bool firstTime = true;
-        
         // Holds all force calculation results.
         std::vector<result_t> results{};
         
+        if ( pairLists.isModified() ) {
+            indexed_ = false;
+        }
+        
         auto nbeads = all.size();
         
         // Concurrent calculation only for large number of particles.
@@ -304,25 +331,27 @@ namespace simploce {
                         
             // Handle particle group/particle group interaction concurrently,
             // where one task is executed by the current thread.
-            if ( pairLists.isModified() || firstTime) {
-                subPairLists = util::makeSubLists(pairLists.particlePairList());
-                firstTime = false;
+            if ( pairLists.isModified() || firstTime_) {
+                subPairLists_ = util::makeSubLists(pairLists.particlePairList());
+                firstTime_ = false;
             }
-            std::size_t ntasks = subPairLists.size() - 1;
+            std::size_t ntasks = subPairLists_.size() - 1;
             if ( ntasks > 1 ) {
                 // Set up concurrent force calculations.
                 for (std::size_t k = 0; k != ntasks; ++k) {
-                    const auto& single = subPairLists[k];
+                    const auto& single = subPairLists_[k];
                     futures.push_back(
                         std::async(
                             std::launch::async, 
                             ppForces_,
                             std::ref(single),
+                            std::ref(charges),
                             nbeads,
                             std::ref(ljParams_),
                             std::ref(elParams_),
                             std::ref(bc_),
-                            std::ref(box_)
+                            std::ref(rc_),
+                            virial != nullptr
                         )
                     );
                 }
@@ -333,10 +362,10 @@ namespace simploce {
             
             // One remaining particle group/particle group interaction is handled
             // by the current thread.
-            const auto& single = *(subPairLists.end() - 1);
+            const auto& single = *(subPairLists_.end() - 1);
             if ( !single.empty() ) {
                 auto result = 
-                    ppForces_(single, nbeads, ljParams_, elParams_, bc_, box_);
+                    ppForces_(single, charges, nbeads, ljParams_, elParams_, bc_, rc_, virial != nullptr);
                 results.push_back(result);
             }
             
@@ -346,11 +375,13 @@ namespace simploce {
             // Interaction between all particle groups.
             auto result =
                 ppForces_(pairLists.particlePairList(),
+                          charges,
                           nbeads,
                           ljParams_, 
                           elParams_, 
                           bc_,
-                          box_);
+                          rc_,
+                          virial != nullptr);
             results.push_back(result);            
         }
         
@@ -358,14 +389,21 @@ namespace simploce {
                     
         // Collect non-bonded potential energies and forces.
         energy_t nbepot{0.0};
-        for (auto result : results) {
-            const auto& forces = result.second;
+        for (const auto& result : results) {
+            const auto& forces = std::get<1>(result);
             for (auto bead : all) {
                 auto index = bead->index();
                 force_t f = forces[index] + bead->force();
                 bead->force(f);
             }
-            nbepot += result.first;
+            nbepot += std::get<0>(result);
+            if ( virial ) {
+                for (std::size_t k = 0; k != 3; ++k) {
+                    for (std::size_t l = 0; l != 3; ++l) {
+                        (*virial)[k][l] += std::get<2>(result)[k][l];
+                    }
+                }
+            }
         }
 
         // Done. No bonded potential energy.
@@ -376,10 +414,11 @@ namespace simploce {
     LJCoulombForces<Bead>::interact(const bead_ptr_t& bead,
                                     const std::vector<bead_ptr_t>& all,
                                     const std::vector<bead_ptr_t>& free,
-                                    const std::vector<bead_group_ptr_t>& groups)
+                                    const std::vector<bead_group_ptr_t>& groups,
+                                    const std::vector<charge_t>& charges)
     {
-        auto nbepot = energy_(bead, free, ljParams_, elParams_, bc_, box_);
-        nbepot += energy_(bead, groups, ljParams_, elParams_, bc_, box_);
+        auto nbepot = energy_(bead, free, charges, ljParams_, elParams_, bc_, rc_);
+        nbepot += energy_(bead, groups, charges, ljParams_, elParams_, bc_, rc_);
         
         // No bonded interaction energies.
         return std::make_pair(0.0, nbepot);
@@ -389,10 +428,93 @@ namespace simploce {
     LJCoulombForces<Bead>::bonded(const std::vector<bead_ptr_t>& all,
                                   const std::vector<bead_ptr_t>& free,
                                   const std::vector<bead_group_ptr_t>& groups,
-                                  const PairLists<Bead>& pairLists)
+                                  const PairLists<Bead>& pairLists,
+                                  virial_t* virial)
     {
         return 0.0;
     }
+
+    energy_t 
+    LJCoulombForces<Bead>::nonBonded(const std::vector<bead_ptr_t>& all,
+                                     const std::vector<bead_ptr_t>& free,
+                                     const std::vector<bead_group_ptr_t>& groups,
+                                     const std::vector<charge_t>& charges,
+                                     const PairLists<Bead>& pairLists,
+                                     virial_t* virial)
+    {
+        return this->interact(all, free, groups, charges, pairLists, virial).second;
+    }
+    
+    energy_t
+    LJCoulombForces<Bead>::chargesChanged(const std::vector<std::pair<bead_ptr_t, charge_t>>& changed,
+                                          const PairLists<Bead>& pairLists,
+                                          virial_t* virial)
+    {
+        // Electrostatic parameters.
+        const real_t eps_r = elParams_.at("eps_r");
+        
+        const auto& pairList = pairLists.particlePairList();
+        if ( !indexed_ ) {
+            pairsOf_.clear();
+            for (std::size_t k = 0; k != pairList.size(); ++k) {
+                std::size_t index_i = pairList[k].first->index();
+                std::size_t index_j = pairList[k].second->index();
+                std::size_t n = std::max(index_i, index_j) + 1;
+                if ( pairsOf_.size() < n ) {
+                    pairsOf_.resize(n);
+                }
+                pairsOf_[index_i].push_back(k);
+                pairsOf_[index_j].push_back(k);
+            }
+            indexed_ = true;
+        }
+        
+        // Previous charges, per bead index.
+        std::map<std::size_t, charge_t> previous{};
+        for (const auto& c : changed) {
+            previous[c.first->index()] = c.second;
+        }
+        auto previousCharge = [&previous] (const bead_ptr_t& p) {
+            auto iter = previous.find(p->index());
+            return iter != previous.end() ? iter->second : p->charge();
+        };
+        
+        energy_t depot{0.0};
+        for (const auto& c : changed) {
+            std::size_t index = c.first->index();
+            if ( index >= pairsOf_.size() ) {
+                continue;
+            }
+            for (auto k : pairsOf_[index]) {
+                bead_ptr_t pi = pairList[k].first;
+                bead_ptr_t pj = pairList[k].second;
+                
+                // A pair of two changed beads is handled once, for the bead 
+                // with the lowest index.
+                std::size_t other = pi->index() == index ? pj->index() : pi->index();
+                if ( other < index && previous.find(other) != previous.end() ) {
+                    continue;
+                }
+                
+                // Only the Coulomb interaction depends on charges. Apply the
+                // change in the product of charges.
+                real_t dqq = pi->charge() * pj->charge() - previousCharge(pi) * previousCharge(pj);
+                if ( dqq == 0.0 ) {
+                    continue;
+                }
+                dist_vect_t rij = bc_->apply(pi->position(), pj->position());
+                auto ef = ljCoulombForce_(rij, charge_t{dqq}, charge_t{1.0}, 0.0, 0.0, eps_r, rc_);
+                depot += std::get<0>(ef);
+                pi->force(pi->force() + std::get<1>(ef));
+                pj->force(pj->force() - std::get<1>(ef));
+                if ( virial ) {
+                    util::addToVirial(*virial, rij, std::get<1>(ef));
+                }
+            }
+        }
+        
+        return depot;
+    }
     
     std::string 
     LJCoulombForces<Bead>::id() const
@@ -405,4 +527,10 @@ namespace simploce {
     {
         return std::make_pair(lj_params_t{}, el_params_t{});
     }
+    
+    void
+    LJCoulombForces<Bead>::cutoffDistance(const length_t& rc)
+    {
+        rc_ = util::cutoffDistance(box_, rc);
+    }
 }
@@ -25,9 +25,13 @@
 #include "simploce/simulation/mc.hpp"
 #include "simploce/simulation/sim-model.hpp"
 #include "simploce/simulation/sim-data.hpp"
+#include "simploce/simulation/sim-util.hpp"
+#include "simploce/simulation/neighbor-grid.hpp"
 #include "simploce/simulation/sconf.hpp"
+#include "simploce/simulation/trajectory.hpp"
 #include "simploce/util/util.hpp"
 #include "simploce/util/mu-units.hpp"
+#include "simploce/util/math-constants.hpp"
 #include <stdexcept>
 #include <iostream>
 #include <fstream>
@@ -37,121 +41,541 @@
 #include <utility>
 #include <cmath>
 #include <tuple>
+#include <array>
+#include <algorithm>
+#include <future>
+#include <limits>
+#include <chrono>
+#include <sstream>
 
 namespace simploce {
     
     static const real_t RANGE = 0.1;
+    static const real_t ANGLE = 0.5;
+    static const real_t MAX_RANGE = 0.5;
     static const real_t LIMIT = 75.0;
     static const real_t LARGE = 1.0e+20;
+    static const std::size_t TUNE_WINDOW = 100;
+    static const real_t TUNE_FACTOR = 1.1;
+    static const std::size_t NO_CELL = std::numeric_limits<std::size_t>::max();
+    static const std::size_t NO_MOVE = std::numeric_limits<std::size_t>::max();
     
-    // Returns differences in bonded and non-bonded potential energy, and acceptance.
+    // Differences in bonded and non-bonded potential energy, acceptance, move 
+    // type (index), and time spent (microseconds).
+    using result_t = std::tuple<energy_t, energy_t, bool, std::size_t, real_t>;
+    
+    // Differences in bonded and non-bonded potential energy, and statistics 
+    // per move type.
+    using sweep_result_t = std::tuple<energy_t, energy_t, std::vector<MCMove>>;
+    
+    MCMove::MCMove(const std::string& id) :
+        id{id}, stepSize{RANGE}, maxStepSize{MAX_RANGE}, trials{0}, accepted{0}, 
+        windowTrials{0}, windowAccepted{0}, time{0.0}
+    {
+        if ( id == conf::MC_GROUP_ROTATE ) {
+            stepSize = ANGLE;
+            maxStepSize = 2.0 * MathConstants<real_t>::PI;
+        } else if ( id != conf::MC_TRANSLATE && id != conf::MC_GROUP_TRANSLATE ) {
+            throw std::domain_error(id + ": No such Monte Carlo move.");
+        }
+    }
+    
+    // Returns move types given by parameter mcmoves.
+    static std::vector<MCMove>
+    makeMoves_(const sim_param_t& param)
+    {
+        std::string ids = param.get<std::string>("mcmoves", conf::MC_TRANSLATE);
+        std::vector<MCMove> moves{};
+        std::istringstream stream(ids);
+        std::string id;
+        while ( std::getline(stream, id, ',') ) {
+            if ( !id.empty() ) {
+                moves.push_back(MCMove{id});
+            }
+        }
+        if ( moves.empty() ) {
+            throw std::domain_error("MC: No Monte Carlo moves.");
+        }
+        return moves;
+    }
+    
+    // Returns copies of the given move types, without statistics.
+    static std::vector<MCMove>
+    emptyTallies_(const std::vector<MCMove>& moves)
+    {
+        std::vector<MCMove> tallies{};
+        for (const auto& move : moves) {
+            MCMove tally{move.id};
+            tally.stepSize = move.stepSize;
+            tallies.push_back(tally);
+        }
+        return tallies;
+    }
+    
+    // Records the outcome of one trial move.
+    static void
+    record_(MCMove& move, bool accepted, real_t time)
+    {
+        move.trials += 1;
+        move.windowTrials += 1;
+        if ( accepted ) {
+            move.accepted += 1;
+            move.windowAccepted += 1;
+        }
+        move.time += time;
+    }
+    
+    // Adds statistics in tallies to moves.
+    static void
+    merge_(std::vector<MCMove>& moves, const std::vector<MCMove>& tallies)
+    {
+        for (std::size_t m = 0; m != moves.size(); ++m) {
+            moves[m].trials += tallies[m].trials;
+            moves[m].accepted += tallies[m].accepted;
+            moves[m].windowTrials += tallies[m].windowTrials;
+            moves[m].windowAccepted += tallies[m].windowAccepted;
+            moves[m].time += tallies[m].time;
+        }
+    }
+    
+    // Adjusts step size of the given move type toward the target acceptance 
+    // ratio (in %), once enough trial moves were performed since the last
+    // adjustment.
+    static void
+    tune_(MCMove& move, real_t acceptance)
+    {
+        if ( move.windowTrials < TUNE_WINDOW ) {
+            return;
+        }
+        real_t ratio = real_t(move.windowAccepted) / real_t(move.windowTrials) * 100.0;
+        real_t factor = ratio > acceptance ? TUNE_FACTOR : 1.0 / TUNE_FACTOR;
+        move.stepSize = std::min(move.stepSize * factor, move.maxStepSize);
+        move.windowTrials = 0;
+        move.windowAccepted = 0;
+    }
+    
+    // Returns statistics per move type.
+    static std::vector<MCMoveStatistics>
+    statistics_(const std::vector<MCMove>& moves)
+    {
+        std::vector<MCMoveStatistics> statistics{};
+        for (const auto& move : moves) {
+            MCMoveStatistics s;
+            s.id = move.id;
+            s.acceptanceRatio = 
+                move.trials > 0 ? real_t(move.accepted) / real_t(move.trials) * 100.0 : 0.0;
+            s.stepSize = move.stepSize;
+            s.time = move.trials > 0 ? move.time / real_t(move.trials) : 0.0;
+            statistics.push_back(s);
+        }
+        return statistics;
+    }
+    
+    // Writes statistics per move type.
+    static void
+    report_(const std::vector<MCMove>& moves)
+    {
+        std::clog << "Trial moves (type, acceptance ratio (%), step size, time per move (us)):" 
+                  << std::endl;
+        for (const auto& s : statistics_(moves)) {
+            std::clog << s.id << conf::SPACE << s.acceptanceRatio 
+                      << conf::SPACE << s.stepSize 
+                      << conf::SPACE << s.time << std::endl;
+        }
+    }
+    
+    // Returns largest translation step size.
+    static real_t
+    maxTranslation_(const std::vector<MCMove>& moves)
+    {
+        real_t range = 0.0;
+        for (const auto& move : moves) {
+            if ( move.id != conf::MC_GROUP_ROTATE ) {
+                range = std::max(range, move.stepSize);
+            }
+        }
+        return range;
+    }
+    
+    // Selects one of the move types that apply to a particle, given the uniform 
+    // random number w. Group rotations do not apply to free particles.
+    static std::size_t
+    selectMove_(const std::vector<MCMove>& moves, bool isFree, real_t w)
+    {
+        std::size_t napplicable = 0;
+        for (const auto& move : moves) {
+            if ( !isFree || move.id != conf::MC_GROUP_ROTATE ) {
+                napplicable += 1;
+            }
+        }
+        if ( napplicable == 0 ) {
+            return NO_MOVE;
+        }
+        std::size_t selected = std::min(std::size_t(w * napplicable), napplicable - 1);
+        for (std::size_t m = 0; m != moves.size(); ++m) {
+            if ( !isFree || moves[m].id != conf::MC_GROUP_ROTATE ) {
+                if ( selected == 0 ) {
+                    return m;
+                }
+                selected -= 1;
+            }
+        }
+        return NO_MOVE;
+    }
+    
+    // Returns energy of given particles with their neighbors. The particles 
+    // are one free particle, or all particles of one group, and share their 
+    // neighbors. The bonded energy of the group is counted once, and ignored 
+    // for rigid moves, since it does not change.
+    template <typename P>
+    static std::pair<energy_t, energy_t>
+    energy_(const std::vector<std::shared_ptr<P>>& particles,
+            bool rigid,
+            const cg_sim_model_ptr_t& sm,
+            const sim_param_t& param,
+            const NeighborGrid<P>& grid,
+            std::size_t cell,
+            std::vector<std::shared_ptr<P>>& free,
+            std::vector<std::shared_ptr<ParticleGroup<P>>>& groups)
+    {
+        energy_t bepot{0.0};
+        energy_t nbepot{0.0};
+        if ( cell == NO_CELL ) {
+            grid.neighbors(particles.front(), free, groups);
+        }
+        for (const auto& p : particles) {
+            auto result = sm->interact(p, free, groups, param);
+            if ( !rigid && p == particles.front() ) {
+                bepot += result.bepot;
+            }
+            nbepot += result.nbepot;
+        }
+        return std::make_pair(bepot, nbepot);
+    }
+    
+    // Returns differences in bonded and non-bonded potential energy, acceptance,
+    // move type, and time spent. The move type is selected with v[1]. The uniform 
+    // random numbers u[1], u[2], u[3] are used for a translation, and u[1], v[2], 
+    // v[3] for a rotation (angle and axis). v[0] is used for acceptance. 
+    // Energies are calculated with neighbors in the grid only, and the grid is 
+    // updated if the move is accepted. If cell is NO_CELL, free and groups are 
+    // filled with the neighbors of the particles. Otherwise, free and groups must
+    // hold the neighbors of the given cell, and the move is rejected if the 
+    // particle (or its group) leaves the cell.
     template <typename P>
-    static std::tuple<energy_t, energy_t, bool> 
+    static result_t 
     displaceParticle_(std::shared_ptr<P>& particle,
+                      const std::vector<MCMove>& moves,
                       const cg_sim_model_ptr_t& sm,
-                      const sim_param_t& param)
-    {
-        // Setup
-        static bool setup = false;
-        static temperature_t temperature = param.get<real_t>("temperature");
-        static std::random_device rd;
-        static std::mt19937 gen(rd());
-        static std::uniform_real_distribution<real_t> disCoordinate(0.0, RANGE);
-        static std::uniform_real_distribution<real_t> dis01(0.0, 1.0);
-        static const real_t kT = MUUnits<real_t>::KB * temperature();
-        if ( !setup ) {      
-            gen.seed(util::seedValue<std::size_t>());
-            setup = true;
+                      const sim_param_t& param,
+                      real_t kT,
+                      NeighborGrid<P>& grid,
+                      std::size_t cell,
+                      std::vector<std::shared_ptr<P>>& free,
+                      std::vector<std::shared_ptr<ParticleGroup<P>>>& groups,
+                      const std::array<real_t, 4>& u,
+                      const std::array<real_t, 4>& v)
+    {
+        auto start = std::chrono::steady_clock::now();
+        auto elapsed = [start] () {
+            std::chrono::duration<real_t, std::micro> time = 
+                std::chrono::steady_clock::now() - start;
+            return time.count();
+        };
+        
+        auto group = grid.groupOf(particle);
+        std::size_t m = selectMove_(moves, !group, v[1]);
+        if ( m == NO_MOVE ) {
+            return std::make_tuple(0.0, 0.0, false, NO_MOVE, 0.0);
+        }
+        const MCMove& move = moves[m];
+        bool rigid = group && move.id != conf::MC_TRANSLATE;
+        std::vector<std::shared_ptr<P>> particles{particle};
+        if ( rigid ) {
+            particles.assign(group->particles().begin(), group->particles().end());
+        }
+        
+        // Current positions.
+        std::vector<position_t> ris{};
+        for (const auto& p : particles) {
+            ris.push_back(p->position());
+        }
+        auto restore = [&particles, &ris] () {
+            for (std::size_t i = 0; i != particles.size(); ++i) {
+                particles[i]->position(ris[i]);
+            }
+        };
+        
+        // Interactions between groups are cut off at the distance between 
+        // their positions, so moving one particle of a group changes the 
+        // interactions of all its particles.
+        std::vector<std::shared_ptr<P>> members{particle};
+        if ( group ) {
+            members.assign(group->particles().begin(), group->particles().end());
         }
-
-        // Current position.
-        position_t ri = particle->position();
         
         // Calculate initial (current) energy.
-        auto result_i = sm->interact(particle, param);
-        auto energy_i = result_i.bepot + result_i.nbepot;
+        auto result_i = energy_(members, rigid, sm, param, grid, cell, free, groups);
+        auto energy_i = result_i.first + result_i.second;
         if ( energy_i() >= LARGE || std::isnan(energy_i()) ) {
             energy_i = LARGE;
         }
 
-        // Move particle.
-        position_t rf;                         // Displaced position.
-        for ( std::size_t k = 0; k != 3; ++k ) {
-            rf[k] = ri[k] - 0.5 * RANGE + disCoordinate(gen);
+        // Move particles.
+        if ( move.id == conf::MC_GROUP_ROTATE ) {
+            // Rotation about a random axis through the center of mass (Rodrigues).
+            position_t center = group->position();
+            real_t angle = move.stepSize * ( u[1] - 0.5 );
+            real_t cosTheta = 2.0 * v[2] - 1.0;
+            real_t sinTheta = std::sqrt(std::max(0.0, 1.0 - cosTheta * cosTheta));
+            real_t phi = 2.0 * MathConstants<real_t>::PI * v[3];
+            std::array<real_t, 3> axis{{sinTheta * std::cos(phi), 
+                                        sinTheta * std::sin(phi), 
+                                        cosTheta}};
+            real_t c = std::cos(angle);
+            real_t s = std::sin(angle);
+            for (std::size_t i = 0; i != particles.size(); ++i) {
+                std::array<real_t, 3> d;
+                for (std::size_t k = 0; k != 3; ++k) {
+                    d[k] = ris[i][k] - center[k];
+                }
+                real_t ad = axis[0] * d[0] + axis[1] * d[1] + axis[2] * d[2];
+                std::array<real_t, 3> axd{{axis[1] * d[2] - axis[2] * d[1],
+                                           axis[2] * d[0] - axis[0] * d[2],
+                                           axis[0] * d[1] - axis[1] * d[0]}};
+                position_t rf;
+                for (std::size_t k = 0; k != 3; ++k) {
+                    rf[k] = center[k] + c * d[k] + s * axd[k] + ( 1.0 - c ) * ad * axis[k];
+                }
+                particles[i]->position(rf);
+            }
+        } else {
+            // Translation, of one particle or of a whole group.
+            for (std::size_t i = 0; i != particles.size(); ++i) {
+                position_t rf;
+                for (std::size_t k = 0; k != 3; ++k) {
+                    rf[k] = ris[i][k] - 0.5 * move.stepSize + move.stepSize * u[k + 1];
+                }
+                particles[i]->position(rf);
+            }
+        }
+        if ( cell != NO_CELL && grid.cellOf(particle) != cell ) {
+            // Reject. Left the cell.
+            restore();
+            return std::make_tuple(0.0, 0.0, false, m, elapsed());
         }
-        particle->position(rf);
                 
         // Calculate final (new) energy.
-        auto result_f = sm->interact(particle, param);
-        auto energy_f = result_f.bepot + result_f.nbepot;
+        auto result_f = energy_(members, rigid, sm, param, grid, cell, free, groups);
+        auto energy_f = result_f.first + result_f.second;
         if ( energy_f()  >= LARGE || std::isnan(energy_f()) ) {
             energy_f = 2.0 * LARGE;
         }
         
-        // Accept or reject displacement.
+        // Accept or reject move.
         energy_t difference = energy_f() - energy_i();
         real_t difference_over_kT = difference() / kT;
         if ( difference_over_kT < LIMIT && energy_f() < LARGE) {
             if ( difference_over_kT > 0.0 ) {
                 real_t w = std::exp(-difference_over_kT);
-                real_t rv = dis01(gen);
-                if ( rv > w ) {
-                    // Reject. Restore previous position.
-                    particle->position(ri);
-                    return std::make_tuple(0.0, 0.0, false);
+                if ( v[0] > w ) {
+                    // Reject. Restore previous positions.
+                    restore();
+                    return std::make_tuple(0.0, 0.0, false, m, elapsed());
                 } else {
-                    // Accept. Keep new position.
-                    return std::make_tuple(result_f.bepot - result_i.bepot, 
-                                           result_f.nbepot - result_i.nbepot,
-                                           true);
+                    // Accept. Keep new positions.
+                    grid.update(particle);
+                    return std::make_tuple(result_f.first - result_i.first, 
+                                           result_f.second - result_i.second,
+                                           true, m, elapsed());
                 }
             } else {
-                // Accept. Keep new position.
-                return std::make_tuple(result_f.bepot - result_i.bepot, 
-                                       result_f.nbepot - result_i.nbepot,
-                                       true);
+                // Accept. Keep new positions.
+                grid.update(particle);
+                return std::make_tuple(result_f.first - result_i.first, 
+                                       result_f.second - result_i.second,
+                                       true, m, elapsed());
             }
         } else {
-            // Reject. Restore position.
-            particle->position(ri);
-            return std::make_tuple(0.0, 0.0, false);
+            // Reject. Restore positions.
+            restore();
+            return std::make_tuple(0.0, 0.0, false, m, elapsed());
         }
     }
     
+    // Returns differences in bonded and non-bonded potential energy, acceptance,
+    // move type, and time spent.
     template <typename P>
-    static SimulationData 
+    static result_t
     displaceOneParticle_(const std::vector<std::shared_ptr<P>>& all,
+                         const std::vector<MCMove>& moves,
                          const cg_sim_model_ptr_t& sm,
-                         const sim_param_t& param)
+                         const sim_param_t& param,
+                         real_t kT,
+                         NeighborGrid<P>& grid,
+                         const Philox& rng,
+                         std::size_t step)
     {
+        // Random numbers for this step.
+        auto u = rng.uniform(step, 0, 0);
+        auto v = rng.uniform(step, 0, 1);
         
-        // Set up.
-        static bool setup = false;
-        static energy_t bepot = 0.0;
-        static energy_t nbepot = 0.0;
-        static std::random_device rd;
-        static std::mt19937 gen(rd());
-        static std::uniform_int_distribution<std::size_t> dis(0, all.size() - 1);
-        if ( !setup ) {
-            gen.seed(util::seedValue<std::size_t>());
-            setup = true;
-        }
-        
-        auto index = dis(gen);
+        std::size_t index = std::min(std::size_t(u[0] * all.size()), all.size() - 1);
         auto particle = all[index];
-        auto result = displaceParticle_(particle, sm, param);
-        
-        SimulationData data;
-        bepot += std::get<0>(result);
-        nbepot += std::get<1>(result);
-        data.bepot = bepot; 
-        data.nbepot = nbepot;
-        data.accepted = std::get<2>(result);
+        std::vector<std::shared_ptr<P>> free{};
+        std::vector<std::shared_ptr<ParticleGroup<P>>> groups{};
+        return displaceParticle_(particle, moves, sm, param, kT, grid, NO_CELL, 
+                                 free, groups, u, v);
+    }
+    // Executes task for each of the given cells, in nranges concurrent ranges 
+    // of cells. Returns results of task, in order of cells.
+    template <typename R, typename TASK>
+    static std::vector<R>
+    forEachCell_(const std::vector<std::size_t>& cells,
+                 std::size_t nranges,
+                 const TASK& task)
+    {
+        if ( nranges < 2 ) {
+            std::vector<R> results{};
+            for (auto c : cells) {
+                results.push_back(task(c));
+            }
+            return results;
+        }
+        auto range = [&cells, &task] (std::size_t begin, std::size_t end) {
+            std::vector<R> results{};
+            for (std::size_t i = begin; i != end; ++i) {
+                results.push_back(task(cells[i]));
+            }
+            return results;
+        };
+        std::size_t size = cells.size() / nranges;
+        std::vector<std::future<std::vector<R>>> futures{};
+        for (std::size_t k = 0; k + 1 < nranges; ++k) {
+            futures.push_back(
+                std::async(std::launch::async, range, k * size, (k + 1) * size)
+            );
+        }
+        std::vector<R> last = range((nranges - 1) * size, cells.size());
+        std::vector<R> results{};
+        for (auto& f : futures) {
+            auto r = f.get();
+            results.insert(results.end(), r.begin(), r.end());
+        }
+        results.insert(results.end(), last.begin(), last.end());
+        return results;
+    }
+    
+    // Returns largest distance of a particle from the position of its group.
+    template <typename P>
+    static real_t
+    maxGroupRadius_(const std::vector<std::shared_ptr<ParticleGroup<P>>>& groups)
+    {
+        real_t radius = 0.0;
+        for (const auto& g : groups) {
+            position_t r = g->position();
+            for (const auto& p : g->particles()) {
+                radius = std::max(radius, norm<real_t>(p->position() - r));
+            }
+        }
+        return radius;
+    }
+    
+    // Performs one checkerboard sweep. Returns differences in bonded and 
+    // non-bonded potential energy, and statistics per move type. Cells are at
+    // least as large as the cutoff distance plus twice the size of particle 
+    // groups and the translation step, such that particles in cells of the
+    // same color do not interact and are displaced concurrently. The grid 
+    // is shifted randomly in every sweep. Receives the number of cells, and 
+    // the smallest numbers of cells per color and of cells of one color 
+    // displaced concurrently.
+    template <typename P>
+    static sweep_result_t
+    sweep_(const std::vector<std::shared_ptr<P>>& all,
+           const std::vector<std::shared_ptr<P>>& free,
+           const std::vector<std::shared_ptr<ParticleGroup<P>>>& groups,
+           const std::vector<MCMove>& moves,
+           const cg_sim_model_ptr_t& sm,
+           const sim_param_t& param,
+           real_t kT,
+           const Philox& rng,
+           std::size_t sweep,
+           std::size_t& ncells,
+           std::size_t& cellsPerColor,
+           std::size_t& concurrentCells)
+    {
+        auto box = sm->box();
+        real_t margin = 2.0 * ( maxGroupRadius_<P>(groups) + maxTranslation_(moves) );
+        length_t rc = util::cutoffDistance(box, length_t{param.get<real_t>("cutoff", 0.0)});
+        length_t side = rc() + margin;
+        NeighborGrid<P> grid{box, side, true};
+        if ( grid.numberOfCells1D() < 2 ) {
+            throw std::domain_error(
+                "MC: Box too small for checkerboard sweeps. Cells of at least " + 
+                std::to_string(side()) + " nm are required, at least two per edge."
+            );
+        }
+        ncells = grid.numberOfCells();
+        cellsPerColor = ncells;
+        concurrentCells = ncells;
+        auto s = rng.uniform(8 * sweep, 0, 0);
+        dist_vect_t offset{s[0] * box->edgeLength(), 
+                           s[1] * box->edgeLength(), 
+                           s[2] * box->edgeLength()};
+        grid.place(all, free, groups, offset);
         
-        return data;
+        sweep_result_t total{0.0, 0.0, emptyTallies_(moves)};
+        for (std::size_t color = 0; color != 8; ++color) {
+            std::size_t step = 8 * sweep + color;
+            std::vector<std::size_t> cells{};
+            for (std::size_t c = 0; c != grid.numberOfCells(); ++c) {
+                if ( grid.color(c) == color ) {
+                    cells.push_back(c);
+                }
+            }
+            std::size_t nranges = std::min(util::numberOfRanges(all.size()), cells.size());
+            cellsPerColor = std::min(cellsPerColor, cells.size());
+            concurrentCells = std::min(concurrentCells, std::max(nranges, std::size_t(1)));
+            auto results = 
+                forEachCell_<sweep_result_t>(cells, nranges, [&] (std::size_t c) {
+                    sweep_result_t result{0.0, 0.0, emptyTallies_(moves)};
+                    auto particles = grid.particles(c);
+                    if ( particles.empty() ) {
+                        return result;
+                    }
+                    std::vector<std::shared_ptr<P>> cfree{};
+                    std::vector<std::shared_ptr<ParticleGroup<P>>> cgroups{};
+                    grid.neighbors(c, cfree, cgroups);
+                    for (std::size_t n = 0; n != particles.size(); ++n) {
+                        auto u = rng.uniform(step, c + 1, 2 * n);
+                        auto v = rng.uniform(step, c + 1, 2 * n + 1);
+                        std::size_t index = 
+                            std::min(std::size_t(u[0] * particles.size()), particles.size() - 1);
+                        auto particle = particles[index];
+                        auto r = displaceParticle_(particle, moves, sm, param, kT, grid, c, 
+                                                   cfree, cgroups, u, v);
+                        std::get<0>(result) += std::get<0>(r);
+                        std::get<1>(result) += std::get<1>(r);
+                        if ( std::get<3>(r) != NO_MOVE ) {
+                            record_(std::get<2>(result)[std::get<3>(r)], 
+                                    std::get<2>(r), 
+                                    std::get<4>(r));
+                        }
+                    }
+                    return result;
+                });
+            for (const auto& r : results) {
+                std::get<0>(total) += std::get<0>(r);
+                std::get<1>(total) += std::get<1>(r);
+                merge_(std::get<2>(total), std::get<2>(r));
+            }
+        }
+        return total;
     }
     
-    MC<Bead>::MC(const cg_sim_model_ptr_t& sm) : sm_{sm}
+    MC<Bead>::MC(const cg_sim_model_ptr_t& sm) : 
+        sm_{sm}, rng_{}, moves_{}, numberOfCells_{0}, cellsPerColor_{0}, 
+        concurrentCells_{0}
     {        
     }
     
@@ -174,29 +598,141 @@ namespace simploce {
         std::size_t numberAccepted = 0;
         std::size_t nsteps = param.get<std::size_t>("nsteps", 10000);
         std::size_t nwrite = param.get<std::size_t>("nwrite", 10);
+        std::size_t ntune = param.get<std::size_t>("ntune", 0);
+        real_t acceptance = param.get<real_t>("acceptance", 50.0);
         temperature_t temperature = param.get<real_t>("temperature", 298.15);
+        real_t kT = MUUnits<real_t>::KB * temperature();
+        std::uint64_t seed = param.get<std::uint64_t>("seed", std::random_device{}());
+        rng_ = Philox(seed);
+        moves_ = makeMoves_(param);
+        numberOfCells_ = 0;
+        cellsPerColor_ = 0;
+        concurrentCells_ = 0;
+        TrajectoryWriter<Bead> trajectory{trajStream, param};
+        
+        if ( param.get<bool>("checkerboard", false) ) {
+            this->performSweeps_(param, trajectory, dataStream);
+            trajectory.close();
+            report_(moves_);
+            std::clog << "Done." << std::endl;
+            return;
+        }
+        
+        // Neighbors of particles, for local energies. With cells of the cutoff 
+        // distance, all interactions of a particle are found in the 
+        // surrounding cells.
+        length_t rc = util::cutoffDistance(sm_->box(), length_t{param.get<real_t>("cutoff", 0.0)});
+        NeighborGrid<Bead> grid{sm_->box(), rc};
+        numberOfCells_ = grid.numberOfCells();
+        sm_->doWithAllFreeGroups<void>([&grid] (const std::vector<bead_ptr_t>& all,
+                                                const std::vector<bead_ptr_t>& free,
+                                                const std::vector<bead_group_ptr_t>& groups) {
+            grid.place(all, free, groups);
+        });
         
+        energy_t bepot{0.0};
+        energy_t nbepot{0.0};
         for (std::size_t counter = 1; counter <= nsteps; ++counter) {
-            SimulationData data = 
-                sm_->doWithAllFreeGroups<SimulationData>([this, param] (std::vector<bead_ptr_t>& all,
-                                                                        const std::vector<bead_ptr_t>& free,
-                                                                        const std::vector<bead_group_ptr_t>& groups) {
-                    return displaceOneParticle_<Bead>(all, this->sm_, param);
+            result_t result = 
+                sm_->doWithAllFreeGroups<result_t>([this, &param, kT, &grid, counter] (std::vector<bead_ptr_t>& all,
+                                                                                       const std::vector<bead_ptr_t>& free,
+                                                                                       const std::vector<bead_group_ptr_t>& groups) {
+                    return displaceOneParticle_<Bead>(all, this->moves_, this->sm_, param, kT, 
+                                                      grid, this->rng_, counter);
                 });
-                if ( data.accepted ) {
-                    numberAccepted += 1;
+            std::size_t m = std::get<3>(result);
+            if ( m != NO_MOVE ) {
+                record_(moves_[m], std::get<2>(result), std::get<4>(result));
+                if ( counter <= ntune ) {
+                    tune_(moves_[m], acceptance);
                 }
+            }
+            SimulationData data;
+            bepot += std::get<0>(result);
+            nbepot += std::get<1>(result);
+            data.bepot = bepot;
+            data.nbepot = nbepot;
+            data.accepted = std::get<2>(result);
+            if ( data.accepted ) {
+                numberAccepted += 1;
+            }
             if ( counter % nwrite == 0 ) {
                 data.acceptanceRatio = real_t(numberAccepted)/real_t(counter) * 100.0;
                 data.temperature = temperature;
+                data.moves = statistics_(moves_);
                 dataStream << std::setw(width) << counter << space << data << std::endl;
-                sm_->saveState(trajStream);
-                trajStream.flush();
+                trajectory.write(sm_);
                 dataStream.flush();
             }
         }
+        trajectory.close();
         
+        report_(moves_);
         std::clog << "Done." << std::endl;
     }
     
-}
\ No newline at end of file
+    void 
+    MC<Bead>::performSweeps_(const sim_param_t& param,
+                             TrajectoryWriter<Bead>& trajectory,
+                             std::ofstream& dataStream)
+    {
+        const auto width = conf::WIDTH;
+        const auto space = conf::SPACE;
+        
+        std::clog << "Checkerboard sweeps, trial moves in non-adjacent cells concurrently."
+                  << std::endl;
+        
+        std::size_t nsweeps = param.get<std::size_t>("nsteps", 10000);
+        std::size_t nwrite = param.get<std::size_t>("nwrite", 10);
+        std::size_t ntune = param.get<std::size_t>("ntune", 0);
+        real_t acceptance = param.get<real_t>("acceptance", 50.0);
+        temperature_t temperature = param.get<real_t>("temperature", 298.15);
+        real_t kT = MUUnits<real_t>::KB * temperature();
+        
+        std::size_t numberAccepted = 0;
+        std::size_t numberOfTrials = 0;
+        energy_t bepot{0.0};
+        energy_t nbepot{0.0};
+        for (std::size_t counter = 1; counter <= nsweeps; ++counter) {
+            sweep_result_t result = 
+                sm_->doWithAllFreeGroups<sweep_result_t>([this, &param, kT, counter] (std::vector<bead_ptr_t>& all,
+                                                                                      const std::vector<bead_ptr_t>& free,
+                                                                                      const std::vector<bead_group_ptr_t>& groups) {
+                    return sweep_<Bead>(all, free, groups, this->moves_, this->sm_, param, kT, 
+                                        this->rng_, counter, this->numberOfCells_,
+                                        this->cellsPerColor_, this->concurrentCells_);
+                });
+            if ( counter == 1 && cellsPerColor_ < 2 ) {
+                std::clog << "WARNING: One cell per color. Trial moves are not performed "
+                             "concurrently in this box." << std::endl;
+            }
+            std::size_t accepted = 0;
+            for (const auto& tally : std::get<2>(result)) {
+                accepted += tally.accepted;
+                numberOfTrials += tally.trials;
+            }
+            numberAccepted += accepted;
+            merge_(moves_, std::get<2>(result));
+            if ( counter <= ntune ) {
+                for (auto& move : moves_) {
+                    tune_(move, acceptance);
+                }
+            }
+            SimulationData data;
+            bepot += std::get<0>(result);
+            nbepot += std::get<1>(result);
+            data.bepot = bepot;
+            data.nbepot = nbepot;
+            data.accepted = accepted > 0;
+            if ( counter % nwrite == 0 ) {
+                data.acceptanceRatio = 
+                    numberOfTrials > 0 ? real_t(numberAccepted)/real_t(numberOfTrials) * 100.0 : 0.0;
+                data.temperature = temperature;
+                data.moves = statistics_(moves_);
+                dataStream << std::setw(width) << counter << space << data << std::endl;
+                trajectory.write(sm_);
+                dataStream.flush();
+            }
+        }
+    }
+}
@@ -0,0 +1,294 @@
+/*
+ * The MIT License
+ *
+ * Copyright 2019 André H. Juffer, Biocenter Oulu
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ */
+
+/*
+ * File:   minimizer.cpp
+ * Author: André H. Juffer, Biocenter Oulu.
+ *
+ * Created on November 20, 2019, 9:48 AM
+ */
+
+#include "simploce/simulation/minimizer.hpp"
+#include "simploce/simulation/sim-model.hpp"
+#include "simploce/simulation/sconf.hpp"
+#include "simploce/particle/bead.hpp"
+#include <stdexcept>
+#include <iomanip>
+#include <algorithm>
+#include <vector>
+#include <cmath>
+
+namespace simploce {
+
+    /*
+     * Returns largest force on any particle.
+     */
+    static real_t
+    maxForce_(const std::vector<bead_ptr_t>& all)
+    {
+        real_t fmax2 = 0.0;
+        for (const auto& bead : all) {
+            force_t f = bead->force();
+            fmax2 = std::max(fmax2, inner<real_t>(f, f));
+        }
+        return std::sqrt(fmax2);
+    }
+
+    /*
+     * Writes progress.
+     */
+    static void
+    write_(std::ostream& stream, std::size_t step, real_t epot, real_t fmax)
+    {
+        const auto width = conf::WIDTH;
+        const auto space = conf::SPACE;
+
+        stream << std::setw(width) << step
+               << space << std::setw(width) << epot
+               << space << std::setw(width) << fmax << std::endl;
+    }
+
+    Minimizer<Bead>::Minimizer(const cg_sim_model_ptr_t& sm) : sm_{sm}
+    {
+        if ( !sm_ ) {
+            throw std::domain_error("Minimizer: Missing simulation model.");
+        }
+    }
+
+    SimulationData
+    Minimizer<Bead>::perform(const sim_param_t& param,
+                             std::ostream& stream)
+    {
+        if ( sm_->size() == 0 ) {
+            throw std::domain_error(
+                "No particles! Nothing to minimize."
+            );
+        }
+
+        std::string minimizer = param.get<std::string>("minimizer", conf::FIRE);
+        if ( minimizer == conf::FIRE ) {
+            return this->fire_(param, stream);
+        } else if ( minimizer == conf::STEEPEST_DESCENT ) {
+            return this->steepestDescent_(param, stream);
+        } else {
+            throw std::domain_error(minimizer + ": No such minimizer.");
+        }
+    }
+
+    /*
+     * FIRE, Bitzek et al, Phys. Rev. Lett. 97, 170201, 2006. Fictitious 
+     * velocities are kept separately from particle velocities.
+     */
+    SimulationData
+    Minimizer<Bead>::fire_(const sim_param_t& param,
+                           std::ostream& stream)
+    {
+        static const std::size_t NMIN = 5;
+        static const real_t FINC = 1.1;
+        static const real_t FDEC = 0.5;
+        static const real_t ALPHA_START = 0.1;
+        static const real_t FALPHA = 0.99;
+
+        std::size_t nsteps = param.get<std::size_t>("nminsteps", 1000);
+        std::size_t nwrite = param.get<std::size_t>("nwrite", 10);
+        real_t ftol = param.get<real_t>("fmax", 10.0);
+        real_t emstep = param.get<real_t>("emstep", 0.01);
+        real_t dt = param.get<real_t>("timestep", 0.01);
+        real_t dtmax = 10.0 * dt;
+
+        std::clog << "Minimizing potential energy (FIRE)..." << std::endl;
+
+        SimulationData data = sm_->interact(param);
+        real_t epot = data.bepot() + data.nbepot();
+        real_t alpha = ALPHA_START;
+        std::size_t npositive = 0;
+        std::size_t step = 0;
+        real_t fmax = 0.0;
+        std::vector<velocity_t> vs(sm_->size(), velocity_t{});
+        while ( true ) {
+            fmax = sm_->doWithAllFreeGroups<real_t>([] (const std::vector<bead_ptr_t>& all,
+                                                        const std::vector<bead_ptr_t>& free,
+                                                        const std::vector<bead_group_ptr_t>& groups) {
+                return maxForce_(all);
+            });
+            if ( step % nwrite == 0 ) {
+                write_(stream, step, epot, fmax);
+            }
+            if ( fmax < ftol || step == nsteps ) {
+                break;
+            }
+            step += 1;
+
+            sm_->doWithAllFreeGroups<void>([&] (const std::vector<bead_ptr_t>& all,
+                                                const std::vector<bead_ptr_t>& free,
+                                                const std::vector<bead_group_ptr_t>& groups) {
+                // Power, and velocity and force norms.
+                real_t power = 0.0, v2 = 0.0, f2 = 0.0;
+                for (const auto& bead : all) {
+                    const velocity_t& v = vs[bead->index()];
+                    force_t f = bead->force();
+                    power += inner<real_t>(f, v);
+                    v2 += inner<real_t>(v, v);
+                    f2 += inner<real_t>(f, f);
+                }
+
+                // Mix velocities with the force direction, or stop.
+                real_t a = 1.0 - alpha;
+                real_t b = f2 > 0.0 ? alpha * std::sqrt(v2 / f2) : 0.0;
+                if ( power > 0.0 ) {
+                    if ( npositive > NMIN ) {
+                        dt = std::min(dt * FINC, dtmax);
+                        alpha *= FALPHA;
+                    }
+                    npositive += 1;
+                } else {
+                    a = 0.0;
+                    b = 0.0;
+                    dt *= FDEC;
+                    alpha = ALPHA_START;
+                    npositive = 0;
+                }
+
+                // Euler step, with a limited displacement.
+                for (const auto& bead : all) {
+                    velocity_t& v = vs[bead->index()];
+                    force_t f = bead->force();
+                    real_t rm = 1.0 / bead->mass()();
+                    dist_vect_t dr{};
+                    for (std::size_t k = 0; k != 3; ++k) {
+                        v[k] = a * v[k] + b * f[k] + dt * rm * f[k];
+                        dr[k] = dt * v[k];
+                    }
+                    real_t ndr = norm<real_t>(dr);
+                    if ( ndr > emstep ) {
+                        dr *= emstep / ndr;
+                    }
+                    position_t r = bead->position();
+                    r += dr;
+                    bead->position(r);
+                }
+            });
+
+            data = sm_->interact(param);
+            epot = data.bepot() + data.nbepot();
+        }
+
+        if ( fmax < ftol ) {
+            std::clog << "Converged to largest force " << fmax << " after " 
+                      << step << " steps." << std::endl;
+        } else {
+            std::clog << "WARNING: Minimizer: No convergence after " << step 
+                      << " steps. Largest force: " << fmax << std::endl;
+        }
+        return data;
+    }
+
+    /*
+     * Steepest descent with adaptive step size. Steps that increase the 
+     * potential energy are rejected.
+     */
+    SimulationData
+    Minimizer<Bead>::steepestDescent_(const sim_param_t& param,
+                                      std::ostream& stream)
+    {
+        static const real_t HMIN = 1.0e-08;   // nm.
+
+        std::size_t nsteps = param.get<std::size_t>("nminsteps", 1000);
+        std::size_t nwrite = param.get<std::size_t>("nwrite", 10);
+        real_t ftol = param.get<real_t>("fmax", 10.0);
+        real_t h = param.get<real_t>("emstep", 0.01);
+        real_t hmax = param.get<real_t>("emstepmax", 10.0 * h);
+
+        std::clog << "Minimizing potential energy (steepest descent)..." << std::endl;
+
+        SimulationData data = sm_->interact(param);
+        real_t epot = data.bepot() + data.nbepot();
+        std::size_t step = 0;
+        real_t fmax = 0.0;
+        std::vector<position_t> rs(sm_->size(), position_t{});
+        std::vector<force_t> fs(sm_->size(), force_t{});
+        while ( true ) {
+            fmax = sm_->doWithAllFreeGroups<real_t>([] (const std::vector<bead_ptr_t>& all,
+                                                        const std::vector<bead_ptr_t>& free,
+                                                        const std::vector<bead_group_ptr_t>& groups) {
+                return maxForce_(all);
+            });
+            if ( step % nwrite == 0 ) {
+                write_(stream, step, epot, fmax);
+            }
+            if ( fmax < ftol || step == nsteps || h < HMIN ) {
+                break;
+            }
+            step += 1;
+
+            // Trial positions. The particle with the largest force is displaced by h.
+            sm_->doWithAllFreeGroups<void>([&] (const std::vector<bead_ptr_t>& all,
+                                                const std::vector<bead_ptr_t>& free,
+                                                const std::vector<bead_group_ptr_t>& groups) {
+                for (const auto& bead : all) {
+                    auto index = bead->index();
+                    rs[index] = bead->position();
+                    fs[index] = bead->force();
+                    position_t r = bead->position();
+                    for (std::size_t k = 0; k != 3; ++k) {
+                        r[k] += h * fs[index][k] / fmax;
+                    }
+                    bead->position(r);
+                }
+            });
+
+            SimulationData trial = sm_->interact(param);
+            real_t etrial = trial.bepot() + trial.nbepot();
+            if ( etrial < epot ) {
+                data = trial;
+                epot = etrial;
+                h = std::min(1.2 * h, hmax);
+            } else {
+                // Reject.
+                sm_->doWithAllFreeGroups<void>([&] (const std::vector<bead_ptr_t>& all,
+                                                    const std::vector<bead_ptr_t>& free,
+                                                    const std::vector<bead_group_ptr_t>& groups) {
+                    for (const auto& bead : all) {
+                        auto index = bead->index();
+                        bead->position(rs[index]);
+                        bead->force(fs[index]);
+                    }
+                });
+                h *= 0.2;
+            }
+        }
+
+        if ( fmax < ftol ) {
+            std::clog << "Converged to largest force " << fmax << " after " 
+                      << step << " steps." << std::endl;
+        } else if ( h < HMIN ) {
+            std::clog << "WARNING: Minimizer: No further decrease of the potential energy after "
+                      << step << " steps. Largest force: " << fmax << std::endl;
+        } else {
+            std::clog << "WARNING: Minimizer: No convergence after " << step 
+                      << " steps. Largest force: " << fmax << std::endl;
+        }
+        return data;
+    }
+}
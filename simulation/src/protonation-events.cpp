@@ -0,0 +1,234 @@
+/*
+ * The MIT License
+ *
+ * Copyright 2019 André H. Juffer, Biocenter Oulu
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ */
+
+
+/*
+ * File:   protonation-events.cpp
+ * Author: André H. Juffer, Biocenter Oulu.
+ *
+ * Created on November 29, 2019, 10:14 AM
+ */
+
+#include "simploce/simulation/protonation-events.hpp"
+#include "simploce/simulation/sim-model.hpp"
+#include "simploce/particle/discrete-protonatable-bead.hpp"
+#include "simploce/particle/continuous-protonatable-bead.hpp"
+#include <stdexcept>
+#include <algorithm>
+#include <iomanip>
+#include <sstream>
+#include <string>
+
+namespace simploce {
+    
+    ProtonationEventWriter<Bead>::ProtonationEventWriter(std::ostream& stream,
+                                                         std::size_t keyInterval) :
+        stream_{&stream}, keyInterval_{keyInterval}, nevents_{0}, nsinceKey_{0},
+        started_{false}, states_{}
+    {
+        if ( keyInterval_ == 0 ) {
+            throw std::domain_error(
+                "ProtonationEventWriter: Number of events between key records must be positive."
+            );
+        }
+        *stream_ << std::fixed << std::setprecision(conf::PRECISION);
+    }
+    
+    void 
+    ProtonationEventWriter<Bead>::start(const stime_t& t, const cg_sim_model_ptr_t& sm)
+    {
+        states_.clear();
+        sm->doWithProtBeads<void>([this] (const std::vector<dprot_bead_ptr_t>& discrete,
+                                          const std::vector<cprot_bead_ptr_t>& continuous) {
+            for (const auto& d : discrete) {
+                this->states_[d->index()] = d->protonationState();
+            }
+            for (const auto& c : continuous) {
+                this->states_[c->index()] = c->protonationState();
+            }
+        });
+        started_ = true;
+        this->writeKey_(t);
+    }
+    
+    void 
+    ProtonationEventWriter<Bead>::record(const std::vector<ProtonationEvent>& events)
+    {
+        const auto space = conf::SPACE;
+        
+        if ( events.empty() ) {
+            return;
+        }
+        if ( !started_ ) {
+            throw std::domain_error(
+                "ProtonationEventWriter: No key record written. Call start() first."
+            );
+        }
+        for (const auto& event : events) {
+            auto iter = states_.find(event.index);
+            if ( iter == states_.end() || iter->second != event.oldState ) {
+                throw std::domain_error(
+                    "ProtonationEventWriter: Event does not match the protonation state of bead " + 
+                    std::to_string(event.index) + "."
+                );
+            }
+            *stream_ << 'E' << space << event.t() << space << event.index 
+                     << space << event.oldState << space << event.newState << '\n';
+            iter->second = event.newState;
+        }
+        nevents_ += events.size();
+        nsinceKey_ += events.size();
+        if ( nsinceKey_ >= keyInterval_ ) {
+            this->writeKey_(events.back().t);
+        } else {
+            stream_->flush();
+        }
+    }
+    
+    std::size_t 
+    ProtonationEventWriter<Bead>::numberOfEvents() const
+    {
+        return nevents_;
+    }
+    
+    void 
+    ProtonationEventWriter<Bead>::writeKey_(const stime_t& t)
+    {
+        const auto space = conf::SPACE;
+        
+        *stream_ << 'K' << space << t() << space << states_.size();
+        for (const auto& state : states_) {
+            *stream_ << space << state.first << space << state.second;
+        }
+        *stream_ << std::endl;
+        nsinceKey_ = 0;
+    }
+    
+    ProtonationEventReader<Bead>::ProtonationEventReader(std::istream& stream) :
+        stream_{&stream}, keys_{}, states_{}, pending_{false}, event_{}
+    {
+        std::string line;
+        std::streampos position = stream_->tellg();
+        while ( std::getline(*stream_, line) ) {
+            std::istringstream record{line};
+            char type;
+            real_t t;
+            if ( record >> type >> t && type == 'K' ) {
+                keys_.push_back(std::make_pair(t, position));
+            }
+            position = stream_->tellg();
+        }
+        stream_->clear();
+        if ( !keys_.empty() ) {
+            this->seek(stime_t{keys_.front().first});
+        }
+    }
+    
+    bool 
+    ProtonationEventReader<Bead>::next(ProtonationEvent& event)
+    {
+        if ( pending_ ) {
+            event = event_;
+            pending_ = false;
+        } else if ( !this->readEvent_(event) ) {
+            return false;
+        }
+        states_[event.index] = event.newState;
+        return true;
+    }
+    
+    void 
+    ProtonationEventReader<Bead>::seek(const stime_t& t)
+    {
+        if ( keys_.empty() ) {
+            return;
+        }
+        auto iter = std::upper_bound(keys_.begin(), keys_.end(), t(),
+                                     [] (real_t t, const std::pair<real_t, std::streampos>& key) {
+            return t < key.first;
+        });
+        if ( iter != keys_.begin() ) {
+            --iter;
+        }
+        stream_->clear();
+        stream_->seekg(iter->second);
+        pending_ = false;
+        ProtonationEvent event;
+        while ( this->readEvent_(event) ) {
+            if ( event.t() > t() ) {
+                event_ = event;
+                pending_ = true;
+                return;
+            }
+            states_[event.index] = event.newState;
+        }
+    }
+    
+    const std::map<std::size_t, std::size_t>& 
+    ProtonationEventReader<Bead>::states() const
+    {
+        return states_;
+    }
+    
+    std::size_t 
+    ProtonationEventReader<Bead>::numberOfKeys() const
+    {
+        return keys_.size();
+    }
+    
+    bool 
+    ProtonationEventReader<Bead>::readEvent_(ProtonationEvent& event)
+    {
+        std::string line;
+        while ( std::getline(*stream_, line) ) {
+            std::istringstream record{line};
+            char type;
+            real_t t;
+            record >> type >> t;
+            if ( type == 'K' ) {
+                // Key record, replaces all protonation states.
+                std::size_t n;
+                record >> n;
+                states_.clear();
+                for (std::size_t k = 0; k != n; ++k) {
+                    std::size_t index, state;
+                    record >> index >> state;
+                    states_[index] = state;
+                }
+            } else if ( type == 'E' ) {
+                event.t = stime_t{t};
+                record >> event.index >> event.oldState >> event.newState;
+            }
+            if ( !record || ( type != 'K' && type != 'E' ) ) {
+                throw std::domain_error(
+                    "ProtonationEventReader: Invalid record '" + line + "'."
+                );
+            }
+            if ( type == 'E' ) {
+                return true;
+            }
+        }
+        return false;
+    }
+}
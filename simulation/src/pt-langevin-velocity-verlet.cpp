@@ -33,19 +33,25 @@
 #include "simploce/simulation/pt-pair-list-generator.hpp"
 #include "simploce/simulation/sconf.hpp"
 #include "simploce/simulation/pt.hpp"
-#include "simploce/simulation/sfactory.hpp"
+#include "simploce/simulation/langevin-velocity-verlet.hpp"
+#include "simploce/simulation/interactor.hpp"
+#include "simploce/simulation/sim-util.hpp"
 #include "simploce/particle/coarse-grained.hpp"
+#include "simploce/particle/continuous-protonatable-bead.hpp"
 #include <stdexcept>
+#include <vector>
+#include <utility>
+#include <map>
+#include <cmath>
 
 namespace simploce {
     
-    static cg_displacer_ptr_t lvv_{};
-    
     ProtonTransferLangevinVelocityVerlet::
         ProtonTransferLangevinVelocityVerlet(const cg_interactor_ptr_t& interactor,
                                              const pt_pair_list_gen_ptr_t& generator,
                                              const pt_displacer_ptr_t& displacer) : 
-    interactor_{interactor}, generator_{generator}, displacer_{displacer}
+    interactor_{interactor}, generator_{generator}, displacer_{displacer}, lvv_{},
+    setup_{false}, npairlists_{0}, npt_{1}, counter_{0}, generated_{0}, pairlist_{}
     {        
         if ( !interactor ) {
             throw std::domain_error(
@@ -62,38 +68,72 @@ namespace simploce {
                 "PT LangevinVelocityVerlet: Missing displacer for proton transfer."
             );
         }
-        lvv_ = factory::langevinVelocityVerlet(interactor_);
+        lvv_ = std::make_shared<LangevinVelocityVerlet<CoarseGrained>>(interactor_);
     }
     
     SimulationData 
     ProtonTransferLangevinVelocityVerlet::displace(const sim_param_t& param, 
                                                    const cg_ptr_t& cg) const
     {
-        using prot_pair_list_t = 
-            ProtonTransferPairListGenerator::prot_pair_list_t;
-        
-        static std::size_t counter = 0;
-        static prot_pair_list_t pairlist{};
-        
-        counter += 1;
+        if ( !setup_ ) {
+            npairlists_ = param.get<std::size_t>("npairlists");
+            npt_ = param.get<std::size_t>("npt", 1);
+            if ( npt_ == 0 ) {
+                throw std::domain_error(
+                    "PT LangevinVelocityVerlet: "
+                    "Number of steps between proton transfers must be positive."
+                );
+            }
+            setup_ = true;
+        }
         
-        std::size_t npairlists = param.get<std::size_t>("npairlists");
+        counter_ += 1;
+        bool transfer = counter_ % npt_ == 0;
         
-        if ( counter % npairlists == 0 ) {
-            pairlist = generator_->generate(cg);
+        // The pair list is only needed for transfers.
+        if ( transfer && counter_ - generated_ >= npairlists_ ) {
+            pairlist_ = generator_->generate(cg);
+            displacer_->update(pairlist_);
+            generated_ = counter_;
         }
         
-        // Transfer protons to update mass and charge values.
-        if ( !pairlist.empty() ) {
-            cg->doWithProtBeads<void>([this, param] (const std::vector<dprot_bead_ptr_t>& discrete,
-                                                     const std::vector<cprot_bead_ptr_t>& continuous) {                                                
-                this->displacer_->transfer(param, continuous, pairlist);                
-            });
+        // Transfer protons to update mass and charge values. Forces at the 
+        // current time are then corrected for the new charge values.
+        energy_t ptepot{0.0};
+        std::vector<ProtonationEvent> events{};
+        if ( transfer && !pairlist_.empty() ) {
+            ptepot = 
+                cg->doWithProtBeads<energy_t>([this, &param, &events] (const std::vector<dprot_bead_ptr_t>& discrete,
+                                                                       const std::vector<cprot_bead_ptr_t>& continuous) {
+                    std::vector<charge_t> charges{};
+                    charges.reserve(continuous.size());
+                    for (const auto& p : continuous) {
+                        charges.push_back(p->charge());
+                    }
+                
+                    this->displacer_->transfer(param, continuous, this->pairlist_, events);
+                
+                    std::vector<std::pair<bead_ptr_t, charge_t>> changed{};
+                    for (std::size_t i = 0; i != continuous.size(); ++i) {
+                        if ( !(continuous[i]->charge() == charges[i]) ) {
+                            changed.push_back(std::make_pair(continuous[i], charges[i]));
+                        }
+                    }
+                    return this->interactor_->chargesChanged(changed, param);
+                });
+            if ( !std::isfinite(ptepot()) ) {
+                throw std::domain_error(
+                    "PT LangevinVelocityVerlet: "
+                    "Non-finite change in potential energy upon proton transfer."
+                );
+            }
         }
         
         // Update positions and velocities.
         SimulationData data = lvv_->displace(param, cg);
-        data.numberOfProtonTransferPairs = pairlist.size();
+        data.numberOfProtonTransferPairs = pairlist_.size();
+        data.ptepot = ptepot;
+        data.ptEvents.swap(events);
                 
         return data;
     }
@@ -103,5 +143,58 @@ namespace simploce {
     {
         return conf::PT_LANGEVIN_VELOCITY_VERLET;
     }
+    
+    void 
+    ProtonTransferLangevinVelocityVerlet::writeCheckpoint(std::ostream& stream) const
+    {
+        util::writeBinary(stream, setup_);
+        util::writeBinary(stream, npairlists_);
+        util::writeBinary(stream, npt_);
+        util::writeBinary(stream, counter_);
+        util::writeBinary(stream, generated_);
+        std::vector<std::uint64_t> indices{};
+        for (const auto& pair : pairlist_) {
+            indices.push_back(pair.first->index());
+            indices.push_back(pair.second->index());
+        }
+        util::writeBinary(stream, indices);
+        lvv_->writeCheckpoint(stream);
+        displacer_->writeCheckpoint(stream);
+    }
+    
+    void 
+    ProtonTransferLangevinVelocityVerlet::readCheckpoint(std::istream& stream, 
+                                                         const cg_ptr_t& cg)
+    {
+        std::vector<std::uint64_t> indices{};
+        util::readBinary(stream, setup_);
+        util::readBinary(stream, npairlists_);
+        util::readBinary(stream, npt_);
+        util::readBinary(stream, counter_);
+        util::readBinary(stream, generated_);
+        util::readBinary(stream, indices);
+        pairlist_ = 
+            cg->doWithProtBeads<prot_pair_list_t>([&indices] (const std::vector<dprot_bead_ptr_t>& discrete,
+                                                              const std::vector<cprot_bead_ptr_t>& continuous) {
+            std::map<std::size_t, cprot_bead_ptr_t> beads{};
+            for (const auto& c : continuous) {
+                beads[c->index()] = c;
+            }
+            prot_pair_list_t pairlist{};
+            for (std::size_t k = 0; k + 1 < indices.size(); k += 2) {
+                auto first = beads.find(indices[k]);
+                auto second = beads.find(indices[k + 1]);
+                if ( first == beads.end() || second == beads.end() ) {
+                    throw std::domain_error(
+                        "PT LangevinVelocityVerlet: Checkpoint does not match the particle model."
+                    );
+                }
+                pairlist.push_back(std::make_pair(first->second, second->second));
+            }
+            return pairlist;
+        });
+        lvv_->readCheckpoint(stream, cg);
+        displacer_->readCheckpoint(stream, pairlist_);
+    }
 }
 
@@ -0,0 +1,222 @@
+/*
+ * The MIT License
+ *
+ * Copyright 2019 André H. Juffer, Biocenter Oulu
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ */
+
+/*
+ * File:   rattle.cpp
+ * Author: André H. Juffer, Biocenter Oulu.
+ *
+ * Created on November 14, 2019, 9:52 AM
+ */
+
+#include "simploce/simulation/rattle.hpp"
+#include "simploce/simulation/sconf.hpp"
+#include "simploce/simulation/sim-util.hpp"
+#include "simploce/particle/particle-group.hpp"
+#include "simploce/particle/bead.hpp"
+#include <stdexcept>
+#include <cmath>
+
+namespace simploce {
+
+    /*
+     * SHAKE for one particle group.
+     */
+    static void
+    constrainPositions_(const bead_group_ptr_t& group,
+                        const std::vector<position_t>& ris,
+                        real_t d2,
+                        real_t tolerance,
+                        std::size_t maxIterations,
+                        std::vector<dist_vect_t>& drs)
+    {
+        const auto& bonds = group->bonds();
+        bool done = bonds.empty();
+        std::size_t counter = 0;
+        while ( !done && counter < maxIterations ) {
+            done = true;
+            for (const auto& bond : bonds) {
+                auto pi = bond.getParticleOne();
+                auto pj = bond.getParticleTwo();
+                std::size_t index_i = pi->index();
+                std::size_t index_j = pj->index();
+
+                position_t ri = pi->position();
+                position_t rj = pj->position();
+                dist_vect_t rij = ri - rj;                         // At t(n+1), unconstrained.
+                real_t diff = d2 - inner<real_t>(rij, rij);
+                if ( std::fabs(diff) > 2.0 * tolerance * d2 ) {
+                    done = false;
+                    dist_vect_t rij_ref = ris[index_i] - ris[index_j];  // At t(n).
+                    real_t rmi = 1.0 / pi->mass()();
+                    real_t rmj = 1.0 / pj->mass()();
+                    real_t g = diff / ( 2.0 * inner<real_t>(rij, rij_ref) * ( rmi + rmj ) );
+                    for (std::size_t k = 0; k != 3; ++k) {
+                        real_t dri = g * rmi * rij_ref[k];
+                        real_t drj = -g * rmj * rij_ref[k];
+                        ri[k] += dri;
+                        rj[k] += drj;
+                        drs[index_i][k] += dri;
+                        drs[index_j][k] += drj;
+                    }
+                    pi->position(ri);
+                    pj->position(rj);
+                }
+            }
+            counter += 1;
+        }
+        if ( !done ) {
+            throw std::domain_error(
+                "Rattle: No convergence for bond lengths. Time step too large?"
+            );
+        }
+    }
+
+    /*
+     * RATTLE for one particle group. The constraint force on particle i follows 
+     * from its velocity correction, f_i = 2 m_i dv_i / dt, and is added to the 
+     * virial.
+     */
+    static void
+    constrainVelocities_(const bead_group_ptr_t& group,
+                         real_t d2,
+                         real_t tolerance,
+                         std::size_t maxIterations,
+                         real_t dt,
+                         virial_t& virial)
+    {
+        const auto& bonds = group->bonds();
+        bool done = bonds.empty();
+        std::size_t counter = 0;
+        while ( !done && counter < maxIterations ) {
+            done = true;
+            for (const auto& bond : bonds) {
+                auto pi = bond.getParticleOne();
+                auto pj = bond.getParticleTwo();
+
+                dist_vect_t rij = pi->position() - pj->position();
+                velocity_t vi = pi->velocity();
+                velocity_t vj = pj->velocity();
+                velocity_t vij = vi - vj;
+                real_t rv = 0.0;
+                for (std::size_t k = 0; k != 3; ++k) {
+                    rv += rij[k] * vij[k];
+                }
+                if ( std::fabs(rv) > tolerance * d2 ) {
+                    done = false;
+                    real_t rmi = 1.0 / pi->mass()();
+                    real_t rmj = 1.0 / pj->mass()();
+                    real_t g = -rv / ( d2 * ( rmi + rmj ) );
+                    force_t fij{};
+                    for (std::size_t k = 0; k != 3; ++k) {
+                        vi[k] += g * rmi * rij[k];
+                        vj[k] -= g * rmj * rij[k];
+                        fij[k] = 2.0 * g * rij[k] / dt;
+                    }
+                    pi->velocity(vi);
+                    pj->velocity(vj);
+                    util::addToVirial(virial, rij, fij);
+                }
+            }
+            counter += 1;
+        }
+        if ( !done ) {
+            throw std::domain_error(
+                "Rattle: No convergence for bond velocities. Time step too large?"
+            );
+        }
+    }
+
+    Rattle<Bead>::Rattle(const length_t& length,
+                         real_t tolerance,
+                         std::size_t maxIterations) :
+        length_{length}, tolerance_{tolerance}, maxIterations_{maxIterations}, ris_{}
+    {
+        if ( length_() <= 0.0 ) {
+            throw std::domain_error("Rattle: Bond length must be a positive number.");
+        }
+    }
+
+    void
+    Rattle<Bead>::reference(const std::vector<bead_ptr_t>& all)
+    {
+        ris_.resize(all.size());
+        for (const auto& p : all) {
+            ris_[p->index()] = p->position();
+        }
+    }
+
+    std::vector<dist_vect_t>
+    Rattle<Bead>::constrainPositions(const std::vector<bead_ptr_t>& all,
+                                     const std::vector<bead_group_ptr_t>& groups) const
+    {
+        std::vector<dist_vect_t> drs(all.size(), dist_vect_t{});
+        real_t d2 = length_() * length_();
+        util::forEachRange<bool>(groups.size(), [this, &groups, d2, &drs] (std::size_t k,
+                                                                            std::size_t begin,
+                                                                            std::size_t end) {
+            for (std::size_t i = begin; i != end; ++i) {
+                constrainPositions_(groups[i], this->ris_, d2, this->tolerance_,
+                                    this->maxIterations_, drs);
+            }
+            return true;
+        });
+        return drs;
+    }
+
+    virial_t
+    Rattle<Bead>::constrainVelocities(const std::vector<bead_group_ptr_t>& groups,
+                                      const stime_t& dt) const
+    {
+        real_t d2 = length_() * length_();
+        auto ws = util::forEachRange<virial_t>(groups.size(), [this, &groups, d2, &dt] (std::size_t k,
+                                                                                         std::size_t begin,
+                                                                                         std::size_t end) {
+            virial_t w{};
+            for (std::size_t i = begin; i != end; ++i) {
+                constrainVelocities_(groups[i], d2, this->tolerance_, this->maxIterations_, 
+                                     dt(), w);
+            }
+            return w;
+        });
+        virial_t virial{};
+        for (const auto& w : ws) {
+            for (std::size_t k = 0; k != 3; ++k) {
+                for (std::size_t l = 0; l != 3; ++l) {
+                    virial[k][l] += w[k][l];
+                }
+            }
+        }
+        return virial;
+    }
+
+    std::size_t
+    Rattle<Bead>::numberOfConstraints(const std::vector<bead_group_ptr_t>& groups) const
+    {
+        std::size_t nconstraints = 0;
+        for (const auto& g : groups) {
+            nconstraints += g->bonds().size();
+        }
+        return nconstraints;
+    }
+}
@@ -0,0 +1,276 @@
+/*
+ * The MIT License
+ *
+ * Copyright 2019 André H. Juffer, Biocenter Oulu
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ */
+
+/*
+ * File:   replica-exchange.cpp
+ * Author: André H. Juffer, Biocenter Oulu.
+ *
+ * Created on November 12, 2019, 10:23 AM
+ */
+
+#include "simploce/simulation/replica-exchange.hpp"
+#include "simploce/simulation/sim-model.hpp"
+#include "simploce/simulation/sim-data.hpp"
+#include "simploce/simulation/sim-util.hpp"
+#include "simploce/simulation/sconf.hpp"
+#include "simploce/simulation/trajectory.hpp"
+#include "simploce/util/mu-units.hpp"
+#include "simploce/util/util.hpp"
+#include <future>
+#include <memory>
+#include <stdexcept>
+#include <iomanip>
+#include <cmath>
+#include <random>
+
+namespace simploce {
+    
+    // Stream of exchange attempts, distinct from the streams of the displacers.
+    static const std::uint32_t EXCHANGES = 3;
+
+    /*
+     * Displaces a replica over a given number of steps.
+     * @param sm Replica.
+     * @param param Parameters for the temperature the replica is currently at.
+     * @param counter Step number preceding the first step.
+     * @param nsteps Number of steps.
+     * @param nwrite Number of steps between writing data and saving state.
+     * @param trajectory Trajectory for the current temperature.
+     * @param dataStream Data stream for the current temperature.
+     * @return Simulation data of the last step.
+     */
+    static SimulationData
+    displace_(const cg_sim_model_ptr_t& sm,
+              const sim_param_t& param,
+              std::size_t counter,
+              std::size_t nsteps,
+              std::size_t nwrite,
+              TrajectoryWriter<Bead>& trajectory,
+              std::ofstream& dataStream)
+    {
+        const auto width = conf::WIDTH;
+        const auto space = conf::SPACE;
+
+        // Parameters for steps at which data is written, also requesting the 
+        // virial for the pressure.
+        sim_param_t writeParam = param;
+        writeParam.put<bool>("virial", true);
+
+        SimulationData data;
+        for (std::size_t n = 1; n <= nsteps; ++n) {
+            std::size_t step = counter + n;
+            if ( step % nwrite == 0 ) {
+                data = sm->displace(writeParam);
+                dataStream << std::setw(width) << step << space << data << std::endl;
+                trajectory.write(sm);
+                dataStream.flush();
+            } else {
+                data = sm->displace(param);
+            }
+        }
+        return data;
+    }
+
+    /*
+     * Scales all velocities, by sqrt(Tnew/Told).
+     */
+    static void
+    rescaleVelocities_(const cg_sim_model_ptr_t& sm,
+                       const temperature_t& Told,
+                       const temperature_t& Tnew)
+    {
+        real_t factor = std::sqrt(Tnew() / Told());
+        sm->doWithAllFreeGroups<void>([factor] (const std::vector<bead_ptr_t>& all,
+                                                const std::vector<bead_ptr_t>& free,
+                                                const std::vector<bead_group_ptr_t>& groups) {
+            for (auto bead : all) {
+                velocity_t v = bead->velocity();
+                v *= factor;
+                bead->velocity(v);
+            }
+        });
+    }
+
+    ReplicaExchange<Bead>::ReplicaExchange(const std::vector<cg_sim_model_ptr_t>& replicas,
+                                           const std::vector<temperature_t>& temperatures) :
+        replicas_{replicas}, temperatures_{temperatures}, replicaAt_{},
+        attempted_{}, accepted_{}, rng_{}
+    {
+        if ( replicas_.size() < 2 ) {
+            throw std::domain_error(
+                "ReplicaExchange: At least two replicas are required."
+            );
+        }
+        if ( replicas_.size() != temperatures_.size() ) {
+            throw std::domain_error(
+                "ReplicaExchange: Number of replicas and temperatures differ."
+            );
+        }
+        for (std::size_t k = 0; k != replicas_.size(); ++k) {
+            if ( !replicas_[k] ) {
+                throw std::domain_error("ReplicaExchange: Missing replica.");
+            }
+            if ( k > 0 && !(temperatures_[k-1]() < temperatures_[k]()) ) {
+                throw std::domain_error(
+                    "ReplicaExchange: Temperatures must be increasing."
+                );
+            }
+            replicaAt_.push_back(k);
+        }
+        attempted_ = std::vector<std::size_t>(replicas_.size() - 1, 0);
+        accepted_ = std::vector<std::size_t>(replicas_.size() - 1, 0);
+    }
+
+    void
+    ReplicaExchange<Bead>::perform(const sim_param_t& param,
+                                   std::vector<std::ofstream>& trajStreams,
+                                   std::vector<std::ofstream>& dataStreams,
+                                   std::ostream& exchangeStream)
+    {
+        const auto width = conf::WIDTH;
+        const auto space = conf::SPACE;
+        const std::size_t nreplicas = replicas_.size();
+
+        if ( trajStreams.size() != nreplicas || dataStreams.size() != nreplicas ) {
+            throw std::domain_error(
+                "ReplicaExchange: One trajectory and data stream per temperature required."
+            );
+        }
+        for (auto sm : replicas_) {
+            if ( sm->size() == 0 ) {
+                throw std::domain_error(
+                    "No particles! Nothing to simulate."
+                );
+            }
+        }
+
+        std::clog << "Performing a (CG) replica exchange MD simulation with "
+                  << nreplicas << " replicas..." << std::endl;
+
+        std::size_t nsteps = param.get<std::size_t>("nsteps", 10000);
+        std::size_t nwrite = param.get<std::size_t>("nwrite", 10);
+        std::size_t nexchange = param.get<std::size_t>("nexchange", 100);
+
+        // Parameters at each temperature. Replicas get different seeds.
+        std::vector<sim_param_t> params(nreplicas, param);
+        auto seed = param.get_optional<std::uint64_t>("seed");
+        for (std::size_t k = 0; k != nreplicas; ++k) {
+            params[k].put<real_t>("temperature", temperatures_[k]());
+            if ( seed ) {
+                params[k].put<std::uint64_t>("seed", *seed + k);
+            }
+        }
+        rng_ = Philox(seed ? *seed : std::random_device{}());
+
+        // Trajectories at each temperature.
+        std::vector<std::unique_ptr<TrajectoryWriter<Bead>>> trajectories{};
+        for (auto& trajStream : trajStreams) {
+            trajectories.emplace_back(new TrajectoryWriter<Bead>(trajStream, param));
+        }
+
+        std::vector<SimulationData> data(nreplicas);
+        std::size_t cycle = 0;
+        std::size_t counter = 0;
+        while ( counter < nsteps ) {
+
+            // Simulate all replicas concurrently over nexchange steps.
+            std::size_t n = std::min(nexchange, nsteps - counter);
+            std::vector<std::future<SimulationData>> futures{};
+            for (std::size_t k = 0; k != nreplicas; ++k) {
+                futures.push_back(
+                    std::async(
+                        std::launch::async,
+                        displace_,
+                        std::ref(replicas_[replicaAt_[k]]),
+                        std::ref(params[k]),
+                        counter,
+                        n,
+                        nwrite,
+                        std::ref(*trajectories[k]),
+                        std::ref(dataStreams[k])
+                    )
+                );
+            }
+            data = util::waitForAll<SimulationData>(futures);
+            counter += n;
+            if ( counter == nsteps ) {
+                break;
+            }
+
+            // Attempt exchanges between neighbouring temperatures, alternating
+            // between even and odd pairs.
+            for (std::size_t k = cycle % 2; k + 1 < nreplicas; k += 2) {
+                real_t beta_k = 1.0 / (MUUnits<real_t>::KB * temperatures_[k]());
+                real_t beta_l = 1.0 / (MUUnits<real_t>::KB * temperatures_[k+1]());
+                real_t epot_k = data[k].bepot() + data[k].nbepot();
+                real_t epot_l = data[k+1].bepot() + data[k+1].nbepot();
+                real_t delta = (beta_k - beta_l) * (epot_k - epot_l);
+                attempted_[k] += 1;
+                real_t u = rng_.uniform(cycle, std::uint32_t(k), EXCHANGES)[0];
+                if ( delta >= 0.0 || u < std::exp(delta) ) {
+                    accepted_[k] += 1;
+                    std::swap(replicaAt_[k], replicaAt_[k+1]);
+                    rescaleVelocities_(replicas_[replicaAt_[k]],
+                                       temperatures_[k+1],
+                                       temperatures_[k]);
+                    rescaleVelocities_(replicas_[replicaAt_[k+1]],
+                                       temperatures_[k],
+                                       temperatures_[k+1]);
+                }
+            }
+            cycle += 1;
+
+            // Replica at each temperature.
+            exchangeStream << std::setw(width) << counter;
+            for (auto index : replicaAt_) {
+                exchangeStream << space << std::setw(width) << index;
+            }
+            exchangeStream << std::endl;
+        }
+        for (auto& trajectory : trajectories) {
+            trajectory->close();
+        }
+
+        // Exchange statistics.
+        exchangeStream << "# Temperatures, attempted and accepted exchanges, acceptance ratio:"
+                       << std::endl;
+        for (std::size_t k = 0; k + 1 < nreplicas; ++k) {
+            real_t ratio = attempted_[k] > 0 ? real_t(accepted_[k]) / real_t(attempted_[k]) : 0.0;
+            exchangeStream << "# " << std::setw(width) << temperatures_[k]
+                           << space << std::setw(width) << temperatures_[k+1]
+                           << space << std::setw(width) << attempted_[k]
+                           << space << std::setw(width) << accepted_[k]
+                           << space << std::setw(width) << ratio << std::endl;
+        }
+
+        std::clog << "Done." << std::endl;
+    }
+
+    cg_sim_model_ptr_t
+    ReplicaExchange<Bead>::replicaAt(std::size_t k) const
+    {
+        return replicas_.at(replicaAt_.at(k));
+    }
+
+}
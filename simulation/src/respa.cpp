@@ -0,0 +1,241 @@
+/*
+ * The MIT License
+ *
+ * Copyright 2019 André H. Juffer, Biocenter Oulu
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ */
+
+/*
+ * File:   respa.cpp
+ * Author: André H. Juffer, Biocenter Oulu.
+ *
+ * Created on November 19, 2019, 9:40 AM
+ */
+
+#include "simploce/simulation/respa.hpp"
+#include "simploce/simulation/interactor.hpp"
+#include "simploce/simulation/sim-util.hpp"
+#include "simploce/simulation/sconf.hpp"
+#include "simploce/particle/bead.hpp"
+#include <stdexcept>
+#include <iostream>
+
+namespace simploce {
+
+    /*
+     * Updates velocities with bonded and non-bonded forces (kick), followed
+     * by updating positions (drift).
+     * @param T Particle type.
+     * @param dtnb Time step for non-bonded forces.
+     * @param dtb Time step for bonded forces, the particle forces.
+     * @param dt Time step for positions.
+     * @param fnbs Non-bonded forces.
+     * @param particles Particles.
+     */
+    template <typename T>
+    static void
+    kickDrift_(real_t dtnb,
+               real_t dtb,
+               real_t dt,
+               const std::vector<force_t>& fnbs,
+               const std::vector<std::shared_ptr<T>>& particles)
+    {
+        util::forEachRange<bool>(particles.size(), [&] (std::size_t k,
+                                                        std::size_t begin,
+                                                        std::size_t end) {
+            for (std::size_t i = begin; i != end; ++i) {
+                T& particle = *particles[i];
+
+                real_t rm = 1.0 / particle.mass()();
+                const force_t& fnb = fnbs[particle.index()];
+                force_t fb = particle.force();
+                position_t r = particle.position();
+                velocity_t v = particle.velocity();
+                for (std::size_t k = 0; k != 3; ++k) {
+                    v[k] += ( dtnb * fnb[k] + dtb * fb[k] ) * rm;
+                    r[k] += dt * v[k];
+                }
+                particle.velocity(v);
+                particle.position(r);
+            }
+            return true;
+        });
+    }
+
+    /*
+     * Final update of velocities with bonded and non-bonded forces (kick).
+     * @param T Particle type.
+     * @param dtnb Time step for non-bonded forces.
+     * @param dtb Time step for bonded forces, the particle forces.
+     * @param fnbs Non-bonded forces.
+     * @param particles Particles.
+     * @return Kinetic energy and temperature.
+     */
+    template <typename T>
+    static SimulationData
+    kick_(real_t dtnb,
+          real_t dtb,
+          const std::vector<force_t>& fnbs,
+          const std::vector<std::shared_ptr<T>>& particles)
+    {
+        SimulationData data;
+
+        auto ekins =
+            util::forEachRange<real_t>(particles.size(), [&] (std::size_t k,
+                                                              std::size_t begin,
+                                                              std::size_t end) {
+            real_t ekin = 0.0;
+            for (std::size_t i = begin; i != end; ++i) {
+                T& particle = *particles[i];
+
+                mass_t mass = particle.mass();
+                const force_t& fnb = fnbs[particle.index()];
+                force_t fb = particle.force();
+                velocity_t v = particle.velocity();
+                for (std::size_t k = 0; k != 3; ++k) {
+                    v[k] += ( dtnb * fnb[k] + dtb * fb[k] ) / mass();
+                }
+                particle.velocity(v);
+
+                ekin += 0.5 * mass() * inner<real_t>(v, v);
+            }
+            return ekin;
+        });
+
+        // Kinetic energy at t(n+1).
+        data.ekin = 0.0;
+        for (auto ekin : ekins) {
+            data.ekin += ekin;
+        }
+
+        // Instantaneous temperature at t(n+1).
+        data.temperature = util::temperature<T>(particles, data.ekin);
+
+        return data;
+    }
+
+    /*
+     * Saves current particle forces.
+     */
+    template <typename T>
+    static void
+    saveForces_(const std::vector<std::shared_ptr<T>>& particles,
+                std::vector<force_t>& forces)
+    {
+        forces.resize(particles.size());
+        for (const auto& particle : particles) {
+            forces[particle->index()] = particle->force();
+        }
+    }
+
+    RESPA<CoarseGrained>::RESPA(const cg_interactor_ptr_t& interactor) :
+        CoarseGrainedDisplacer{}, interactor_{interactor}, setup_{false}, counter_{0},
+        dt_{0.0}, ninner_{1}, fnbs_{}
+    {
+    }
+
+    SimulationData
+    RESPA<CoarseGrained>::displace(const sim_param_t& param,
+                                   const cg_ptr_t& cg) const
+    {
+        counter_ += 1;
+        if ( !setup_ ) {
+            dt_ = param.get<real_t>("timestep");
+            ninner_ = param.get<std::size_t>("ninner", 4);
+            if ( ninner_ == 0 ) {
+                throw std::domain_error("RESPA: Number of inner steps must be at least 1.");
+            }
+            if ( param.get<std::string>("constraints", conf::NO_CONSTRAINTS) != conf::NO_CONSTRAINTS ) {
+                std::clog << "WARNING: RESPA: Bond constraints are not supported, "
+                          << "and are ignored." << std::endl;
+            }
+
+            // Initial forces.
+            interactor_->nonBonded(param, cg);
+            cg->doWithAll<void>([this] (const std::vector<bead_ptr_t>& beads) {
+                saveForces_<Bead>(beads, this->fnbs_);
+            });
+            interactor_->bonded(param, cg);
+            setup_ = true;
+        }
+
+        real_t dt = dt_();
+        real_t dti = dt / real_t(ninner_);
+
+        // Half step for non-bonded forces, followed by the first inner step.
+        cg->doWithAll<void>([this, dt, dti] (const std::vector<bead_ptr_t>& beads) {
+            kickDrift_<Bead>(0.5 * dt, 0.5 * dti, dti, this->fnbs_, beads);
+        });
+
+        // Remaining inner steps, bonded forces only. The half kicks of
+        // consecutive inner steps are combined.
+        for (std::size_t n = 1; n < ninner_; ++n) {
+            interactor_->bonded(param, cg);
+            cg->doWithAll<void>([this, dti] (const std::vector<bead_ptr_t>& beads) {
+                kickDrift_<Bead>(0.0, dti, dti, this->fnbs_, beads);
+            });
+        }
+
+        // Non-bonded and bonded forces at t(n+1).
+        energy_t nbepot = interactor_->nonBonded(param, cg);
+        cg->doWithAll<void>([this] (const std::vector<bead_ptr_t>& beads) {
+            saveForces_<Bead>(beads, this->fnbs_);
+        });
+        energy_t bepot = interactor_->bonded(param, cg);
+
+        // Last inner half step and half step for non-bonded forces.
+        SimulationData data = cg->doWithAll<SimulationData>([this, dt, dti] (const std::vector<bead_ptr_t>& beads) {
+            return kick_<Bead>(0.5 * dt, 0.5 * dti, this->fnbs_, beads);
+        });
+
+        // Save simulation data.
+        data.bepot = bepot;
+        data.nbepot = nbepot;
+        data.t = counter_ * dt_;
+
+        return data;
+    }
+
+    std::string
+    RESPA<CoarseGrained>::id() const
+    {
+        return conf::RESPA;
+    }
+
+    void
+    RESPA<CoarseGrained>::writeCheckpoint(std::ostream& stream) const
+    {
+        util::writeBinary(stream, setup_);
+        util::writeBinary(stream, counter_);
+        util::writeBinary(stream, dt_);
+        util::writeBinary(stream, ninner_);
+        util::writeBinary(stream, fnbs_);
+    }
+
+    void
+    RESPA<CoarseGrained>::readCheckpoint(std::istream& stream, const cg_ptr_t& cg)
+    {
+        util::readBinary(stream, setup_);
+        util::readBinary(stream, counter_);
+        util::readBinary(stream, dt_);
+        util::readBinary(stream, ninner_);
+        util::readBinary(stream, fnbs_);
+    }
+}
@@ -41,12 +41,16 @@
 #include "simploce/simulation/leap-frog.hpp"
 #include "simploce/simulation/velocity-verlet.hpp"
 #include "simploce/simulation/langevin-velocity-verlet.hpp"
+#include "simploce/simulation/baoab.hpp"
+#include "simploce/simulation/respa.hpp"
+#include "simploce/simulation/adaptive-timestep.hpp"
 #include "simploce/simulation/interactor.hpp"
 #include "simploce/simulation/sim-model-factory.hpp"
 #include "simploce/simulation/pt-pair-list-generator.hpp"
 #include "simploce/simulation/pt-langevin-velocity-verlet.hpp"
 #include "simploce/simulation/pbc.hpp"
 #include "simploce/simulation/constant-rate-pt.hpp"
+#include "simploce/simulation/event-driven-pt.hpp"
 #include "simploce/simulation/cg-hp.hpp"
 #include "simploce/simulation/sconf.hpp"
 #include "simploce/particle/bead.hpp"
@@ -66,6 +70,9 @@ namespace simploce {
         using cg_vv_t = VelocityVerlet<CoarseGrained>;
         using at_lvv_t = LangevinVelocityVerlet<Atomistic>;
         using cg_lvv_t = LangevinVelocityVerlet<CoarseGrained>;
+        using cg_baoab_t = BAOAB<CoarseGrained>;
+        using cg_respa_t = RESPA<CoarseGrained>;
+        using cg_adaptive_timestep_t = AdaptiveTimestep<CoarseGrained>;
         
         // Force fields.
         static cg_ff_ptr_t cgPolWaterFF_{};             // Polarizable water.
@@ -74,8 +81,8 @@ namespace simploce {
         static cg_ff_ptr_t cgLJFluid_{};                // LJ fluid.
         static cg_ff_ptr_t cgHPFF_;                       // Harmonic potentials.
         
-        // Pair lists generators.
-        static cg_ppair_list_gen_ptr_t  cgPairlistGen_{};
+        // Pair lists generators. Coarse grained pair list generators are not
+        // shared, since several models (replicas) may be simulated concurrently.
         static at_ppair_list_gen_ptr_t atPairListGen_{};
         
         // Leap Frog
@@ -90,6 +97,12 @@ namespace simploce {
         static at_displacer_ptr_t atLVV_{};
         static cg_displacer_ptr_t cgLVV_{};
         
+        // BAOAB
+        static cg_displacer_ptr_t cgBAOAB_{};
+        
+        // r-RESPA
+        static cg_displacer_ptr_t cgRESPA_{};
+        
         // Langevin Proton Transfer Langevin Velocity Verlet
         static cg_displacer_ptr_t cgPTLVV_{};
         
@@ -104,10 +117,6 @@ namespace simploce {
         static std::shared_ptr<Interactor<Bead>> cgLJFluidInteractor_{};
         static std::shared_ptr<Interactor<Bead>> cgHPInteractor_;
         
-        static pt_pair_list_gen_ptr_t ptPairlisGen_{};
-        
-        static pt_displacer_ptr_t constantRate_{};
-        
         cg_ff_ptr_t
         harmonicPotentialForceField(const spec_catalog_ptr_t& catalog,
                                     const bc_ptr_t& bc,
@@ -194,11 +203,8 @@ namespace simploce {
         coarseGrainedPairListGenerator(const box_ptr_t& box,
                                        const bc_ptr_t& bc)
         {
-            if ( !cgPairlistGen_ ) {
-                cgPairlistGen_ = std::make_shared<DistanceLists<Bead>>(box, bc);
-                //cgPairlistGen_ = std::make_shared<CellLists<Bead>>(box, bc);
-            }
-            return cgPairlistGen_;
+            return std::make_shared<DistanceLists<Bead>>(box, bc);
+            //return std::make_shared<CellLists<Bead>>(box, bc);
         }
         
         at_ppair_list_gen_ptr_t 
@@ -352,6 +358,24 @@ namespace simploce {
             return cgLVV_;                                    
         }
         
+        cg_displacer_ptr_t 
+        baoab(cg_interactor_ptr_t& interactor)
+        {
+            if ( !cgBAOAB_ ) {
+                cgBAOAB_ = std::make_shared<cg_baoab_t>(interactor);
+            }
+            return cgBAOAB_;
+        }
+        
+        cg_displacer_ptr_t 
+        respa(cg_interactor_ptr_t& interactor)
+        {
+            if ( !cgRESPA_ ) {
+                cgRESPA_ = std::make_shared<cg_respa_t>(interactor);
+            }
+            return cgRESPA_;
+        }
+        
         cg_displacer_ptr_t
         protonTransferlangevinVelocityVerlet(const cg_interactor_ptr_t& interactor,
                                              const pt_pair_list_gen_ptr_t& generator,
@@ -367,9 +391,14 @@ namespace simploce {
         }   
         
         void 
-        changeDisplacer(std::string displacerId, cg_sim_model_ptr_t& sm)
+        changeDisplacer(std::string displacerId, 
+                        cg_sim_model_ptr_t& sm,
+                        const std::string& ptMethod)
         {
-            if ( sm->displacer()->id() != displacerId) {                            
+            // Proton transfer displacers are always replaced, so that the
+            // requested proton transfer method is used.
+            bool pt = displacerId.find(conf::PT_LANGEVIN_VELOCITY_VERLET) != std::string::npos;
+            if ( sm->displacer()->id() != displacerId || pt ) {                            
                 auto interactor = sm->interactor();
                 cg_displacer_ptr_t displacer;
                 if ( displacerId == conf::LEAP_FROG ) {
@@ -378,13 +407,16 @@ namespace simploce {
                     displacer = factory::velocityVerlet(interactor);
                 } else if ( displacerId == conf::LANGEVIN_VELOCITY_VERLET ) {
                     displacer = factory::langevinVelocityVerlet(interactor);                
-                } else if ( displacerId == conf::PT_LANGEVIN_VELOCITY_VERLET ) {
-                    auto bc = sm->boundaryCondition();
-                    auto ptGenerator = factory::protonTransferPairListGenerator(bc);
-                    auto ptDisplacer = factory::protonTransferDisplacer();
-                    displacer = factory::protonTransferlangevinVelocityVerlet(interactor, 
-                                                                              ptGenerator, 
-                                                                              ptDisplacer);
+                } else if ( displacerId == conf::BAOAB ) {
+                    displacer = factory::baoab(interactor);
+                } else if ( displacerId == conf::RESPA ) {
+                    displacer = factory::respa(interactor);
+                } else if ( displacerId.find(conf::ADAPTIVE_TIMESTEP + "-") == 0 ||
+                            displacerId == conf::PT_LANGEVIN_VELOCITY_VERLET ) {
+                    displacer = factory::makeDisplacer(displacerId, 
+                                                       interactor, 
+                                                       sm->boundaryCondition(),
+                                                       ptMethod);
                 } else {
                     throw std::domain_error(displacerId + ": No such displacer.");
                 }
@@ -404,21 +436,91 @@ namespace simploce {
         pt_pair_list_gen_ptr_t 
         protonTransferPairListGenerator(const bc_ptr_t& bc)
         {
-            if ( !ptPairlisGen_) {
-                ptPairlisGen_ = 
-                    std::make_shared<ProtonTransferPairListGenerator>(bc);
-            }
-            return ptPairlisGen_;
+            return std::make_shared<ProtonTransferPairListGenerator>(bc);
         }
         
         pt_displacer_ptr_t 
-        protonTransferDisplacer()
+        protonTransferDisplacer(const std::string& method)
         {
-            if ( !constantRate_ ) {
-                constantRate_ = 
-                    std::make_shared<ConstantRateProtonTransfer>();
+            // Not shared, it holds the state of one model.
+            if ( method == conf::PT_CONSTANT_RATE ) {
+                return std::make_shared<ConstantRateProtonTransfer>();
+            } else if ( method == conf::PT_EVENT_DRIVEN ) {
+                return std::make_shared<EventDrivenProtonTransfer>();
+            } else {
+                throw std::domain_error(method + ": No such proton transfer method.");
+            }
+        }
+        
+        cg_interactor_ptr_t
+        makeInteractor(const std::string& forceFieldId,
+                       const spec_catalog_ptr_t& catalog,
+                       const box_ptr_t& box,
+                       const bc_ptr_t& bc)
+        {
+            cg_ppair_list_gen_ptr_t generator = 
+                factory::coarseGrainedPairListGenerator(box, bc);
+            cg_ff_ptr_t forcefield;
+            if ( forceFieldId == conf::POLARIZABLE_WATER ) {
+                forcefield = 
+                    std::make_shared<CoarseGrainedPolarizableWater>(catalog, bc, box, false);
+            } else if ( forceFieldId == conf::ACID_BASE_SOLUTION ) {
+                cg_ff_ptr_t water = 
+                    std::make_shared<CoarseGrainedPolarizableWater>(catalog, bc, box, true);
+                forcefield = 
+                    std::make_shared<AcidBaseSolution>(catalog, bc, box, water);
+            } else if ( forceFieldId == conf::ELECTROLYTE ) {
+                forcefield = 
+                    std::make_shared<CoarseGrainedElectrolyte>(catalog, bc, box);
+            } else if ( forceFieldId == conf::LJ_FLUID ) {
+                forcefield = 
+                    std::make_shared<CoarseGrainedLJFluid>(catalog, bc, box);
+            } else {
+                throw std::domain_error(forceFieldId + ": No such force field.");
+            }
+            return std::make_shared<Interactor<Bead>>(forcefield, generator);
+        }
+        
+        cg_displacer_ptr_t
+        makeDisplacer(const std::string& displacerId,
+                      const cg_interactor_ptr_t& interactor,
+                      const bc_ptr_t& bc,
+                      const std::string& ptMethod)
+        {
+            if ( displacerId == conf::LEAP_FROG ) {
+                return std::make_shared<cg_leap_frog_t>(interactor);
+            } else if ( displacerId == conf::VELOCITY_VERLET ) {
+                return std::make_shared<cg_vv_t>(interactor);
+            } else if ( displacerId == conf::LANGEVIN_VELOCITY_VERLET ) {
+                return std::make_shared<cg_lvv_t>(interactor);
+            } else if ( displacerId == conf::BAOAB ) {
+                return std::make_shared<cg_baoab_t>(interactor);
+            } else if ( displacerId == conf::RESPA ) {
+                return std::make_shared<cg_respa_t>(interactor);
+            } else if ( displacerId.find(conf::ADAPTIVE_TIMESTEP + "-") == 0 ) {
+                std::string innerId = displacerId.substr(conf::ADAPTIVE_TIMESTEP.size() + 1);
+                
+                // The time step is adapted from the total forces at the end of
+                // a step. Leap-frog computes forces at the start of a step, and
+                // RESPA leaves only the bonded forces on beads.
+                if ( innerId == conf::LEAP_FROG || 
+                     innerId == conf::RESPA ||
+                     innerId.find(conf::ADAPTIVE_TIMESTEP) == 0 ) {
+                    throw std::domain_error(
+                        displacerId + ": Time step of '" + innerId + "' cannot be adapted."
+                    );
+                }
+                auto displacer = makeDisplacer(innerId, interactor, bc, ptMethod);
+                return std::make_shared<cg_adaptive_timestep_t>(displacer);
+            } else if ( displacerId == conf::PT_LANGEVIN_VELOCITY_VERLET ) {
+                auto ptGenerator = factory::protonTransferPairListGenerator(bc);
+                auto ptDisplacer = factory::protonTransferDisplacer(ptMethod);
+                return std::make_shared<ProtonTransferLangevinVelocityVerlet>(interactor,
+                                                                              ptGenerator,
+                                                                              ptDisplacer);
+            } else {
+                throw std::domain_error(displacerId + ": No such displacer.");
             }
-            return constantRate_;
         }
         
     }
@@ -38,7 +38,7 @@ namespace simploce {
     
     SimulationData::SimulationData() :
         t{0.0}, ekin{0.0}, bepot{0.0}, nbepot{0.0}, temperature{0.0}, pressure{0.0},
-        numberOfProtonTransferPairs{0}, accepted{false}, acceptanceRatio{0.0}
+        cvirial{}, numberOfProtonTransferPairs{0}, ptepot{0.0}, ptEvents{}, accepted{false}, acceptanceRatio{0.0}, dt{0.0}, moves{}
     {            
     }
         
@@ -60,7 +60,13 @@ namespace simploce {
                << space << std::setw(width) << data.pressure
                << space << std::setw(width) << data.numberOfProtonTransferPairs
                << space << data.accepted
-               << space << std::setw(width) << data.acceptanceRatio;
+               << space << std::setw(width) << data.acceptanceRatio
+               << space << std::setw(width) << data.dt;
+        for (const auto& move : data.moves) {
+            stream << space << std::setw(width) << move.acceptanceRatio
+                   << space << std::setw(width) << move.stepSize
+                   << space << std::setw(width) << move.time;
+        }
 #ifdef _DEBUG
         if ( etot() > conf::LARGE ) {
             std::clog << "Total energy: "  << etot << std::endl;
@@ -46,6 +46,7 @@
 #include <random>
 #include <cmath>
 #include <memory>
+#include <sstream>
 
 namespace simploce {
     
@@ -251,6 +252,29 @@ namespace simploce {
         cg->readFrom(stream, catalog_);
         return cg;
     }
+    
+    cg_sim_model_ptr_t 
+    SimulationModelFactory::replicate(const cg_sim_model_ptr_t& sm,
+                                      const std::string& ptMethod)
+    {
+        // Copy particles, including their current state.
+        std::stringstream stream;
+        stream << *sm->cg_;
+        
+        cg_sim_model_ptr_t replica{new SimulationModel<Bead>};
+        replica->cg_ = CoarseGrained::readFrom(stream, catalog_);
+        replica->box_ = sm->box_;
+        replica->bc_ = sm->bc_;
+        replica->interactor_ = factory::makeInteractor(sm->interactor_->id(), 
+                                                       catalog_, 
+                                                       replica->box_, 
+                                                       replica->bc_);
+        replica->displacer_ = factory::makeDisplacer(sm->displacer_->id(), 
+                                                     replica->interactor_, 
+                                                     replica->bc_,
+                                                     ptMethod);
+        return replica;
+    }
   
 }
 
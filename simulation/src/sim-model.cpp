@@ -33,6 +33,7 @@
 #include "simploce/simulation/interactor.hpp"
 #include "simploce/simulation/pair-list-generator.hpp"
 #include "simploce/simulation/sconf.hpp"
+#include "simploce/simulation/sim-util.hpp"
 #include "simploce/simulation/cg-displacer.hpp"
 #include "simploce/simulation/sfactory.hpp"
 #include "simploce/simulation/sfactory.hpp"
@@ -91,10 +92,33 @@ namespace simploce {
         return data;
     }
     
+    SimulationData 
+    SimulationModel<Bead>::interact(const bead_ptr_t& bead,
+                                    const std::vector<bead_ptr_t>& free,
+                                    const std::vector<bead_group_ptr_t>& groups,
+                                    const sim_param_t& param)
+    {
+        SimulationData data;
+        auto result = interactor_->interact(bead, free, groups, param, cg_);
+        data.bepot = result.first;
+        data.nbepot = result.second;
+        return data;
+    }
+    
     SimulationData 
     SimulationModel<Bead>::displace(const sim_param_t& param)
     { 
-        return displacer_->displace(param, cg_); 
+        SimulationData data = displacer_->displace(param, cg_);
+        if ( param.get<bool>("virial", false) ) {
+            virial_t virial = interactor_->virial();
+            for (std::size_t k = 0; k != 3; ++k) {
+                for (std::size_t l = 0; l != 3; ++l) {
+                    virial[k][l] += data.cvirial[k][l];
+                }
+            }
+            data.pressure = util::pressure(virial, data.ekin, box_);
+        }
+        return data;
     }
         
     void 
@@ -135,6 +159,116 @@ namespace simploce {
         });       
     }
     
+    void
+    SimulationModel<Bead>::writeCheckpoint(std::ostream& stream) const
+    {
+        util::writeBinary<real_t>(stream, box_->size());
+        cg_->doWithAll<void>([&stream] (const std::vector<bead_ptr_t>& beads) {
+            std::vector<position_t> rs(beads.size());
+            std::vector<velocity_t> vs(beads.size());
+            std::vector<force_t> fs(beads.size());
+            for (const auto& bead : beads) {
+                rs.at(bead->index()) = bead->position();
+                vs.at(bead->index()) = bead->velocity();
+                fs.at(bead->index()) = bead->force();
+            }
+            util::writeBinary(stream, rs);
+            util::writeBinary(stream, vs);
+            util::writeBinary(stream, fs);
+        });
+        cg_->doWithProtBeads<void>([&stream] (const std::vector<dprot_bead_ptr_t>& discrete,
+                                              const std::vector<cprot_bead_ptr_t>& continuous) {
+            std::vector<std::uint64_t> dstates{}, cstates{};
+            std::vector<real_t> xs{}, Is{};
+            for (const auto& d : discrete) {
+                dstates.push_back(d->protonationState());
+            }
+            for (const auto& c : continuous) {
+                cstates.push_back(c->protonationState());
+                xs.push_back(c->state());
+                Is.push_back(c->current());
+            }
+            util::writeBinary(stream, dstates);
+            util::writeBinary(stream, cstates);
+            util::writeBinary(stream, xs);
+            util::writeBinary(stream, Is);
+        });
+        interactor_->writeCheckpoint(stream);
+        std::string id = displacer_->id();
+        util::writeBinary<std::uint64_t>(stream, id.size());
+        stream.write(id.data(), id.size());
+        displacer_->writeCheckpoint(stream);
+    }
+    
+    void
+    SimulationModel<Bead>::readCheckpoint(std::istream& stream)
+    {
+        real_t boxSize;
+        util::readBinary(stream, boxSize);
+        if ( boxSize != box_->size() ) {
+            throw std::domain_error("SimulationModel: Checkpoint box size differs.");
+        }
+        cg_->doWithAll<void>([&stream] (const std::vector<bead_ptr_t>& beads) {
+            std::vector<position_t> rs{};
+            std::vector<velocity_t> vs{};
+            std::vector<force_t> fs{};
+            util::readBinary(stream, rs);
+            util::readBinary(stream, vs);
+            util::readBinary(stream, fs);
+            if ( rs.size() != beads.size() || vs.size() != beads.size() || fs.size() != beads.size() ) {
+                throw std::domain_error("SimulationModel: Checkpoint number of particles differs.");
+            }
+            for (const auto& bead : beads) {
+                bead->position(rs[bead->index()]);
+                bead->velocity(vs[bead->index()]);
+                bead->force(fs[bead->index()]);
+            }
+        });
+        cg_->doWithProtBeads<void>([&stream] (const std::vector<dprot_bead_ptr_t>& discrete,
+                                              const std::vector<cprot_bead_ptr_t>& continuous) {
+            std::vector<std::uint64_t> dstates{}, cstates{};
+            std::vector<real_t> xs{}, Is{};
+            util::readBinary(stream, dstates);
+            util::readBinary(stream, cstates);
+            util::readBinary(stream, xs);
+            util::readBinary(stream, Is);
+            if ( dstates.size() != discrete.size() || cstates.size() != continuous.size() ) {
+                throw std::domain_error(
+                    "SimulationModel: Checkpoint number of protonatable particles differs."
+                );
+            }
+            for (std::size_t k = 0; k != discrete.size(); ++k) {
+                const auto& d = discrete[k];
+                while ( d->protonationState() > dstates[k] ) {
+                    d->deprotonate();
+                }
+                while ( d->protonationState() < dstates[k] ) {
+                    d->protonate();
+                }
+            }
+            for (std::size_t k = 0; k != continuous.size(); ++k) {
+                const auto& c = continuous[k];
+                if ( c->protonationState() > cstates[k] ) {
+                    c->deprotonate();
+                } else if ( c->protonationState() < cstates[k] ) {
+                    c->protonate();
+                }
+                c->state(xs[k]);
+                c->current(Is[k]);
+            }
+        });
+        interactor_->readCheckpoint(stream, cg_);
+        std::uint64_t size;
+        util::readBinary(stream, size);
+        std::string id(size, ' ');
+        if ( !stream.read(&id[0], size) || id != displacer_->id() ) {
+            throw std::domain_error(
+                "SimulationModel: Checkpoint was written with displacer '" + id + "'."
+            );
+        }
+        displacer_->readCheckpoint(stream, cg_);
+    }
+    
     void 
     SimulationModel<Bead>::readFrom(std::istream& stream,
                                     const spec_catalog_ptr_t& catalog)
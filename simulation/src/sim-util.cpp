@@ -39,12 +39,20 @@ namespace simploce {
         length_t cutoffDistance(const box_ptr_t& box)
         {
             return 0.5 * box->size();            
-            /*
-            length_t halve = 0.5 * box->size();
-            return conf::RCUTOFF_DISTANCE_() > halve() ? 
-                   halve : 
-                   conf::RCUTOFF_DISTANCE_;             
-             */
+        }
+        
+        length_t cutoffDistance(const box_ptr_t& box, const length_t& rc)
+        {
+            length_t halve = cutoffDistance(box);
+            if ( rc() <= 0.0 ) {
+                return halve;
+            }
+            if ( rc() > halve() ) {
+                throw std::domain_error(
+                    std::to_string(rc()) + ": Cutoff distance exceeds half the box size."
+                );
+            }
+            return rc;
         }
         
         real_t squareCutoffDistance(const box_ptr_t& box)
@@ -68,6 +76,16 @@ namespace simploce {
             assert(D > 0);
             return (-b + std::sqrt(D)) / (2.0 * a);
         }
+        
+        std::size_t numberOfRanges(std::size_t n)
+        {
+            static const std::size_t nthreads = std::thread::hardware_concurrency();
+            
+            if ( n <= conf::MIN_NUMBER_OF_PARTICLES || nthreads < 2 ) {
+                return 1;
+            }
+            return nthreads;
+        }
                 
     }
 }
\ No newline at end of file
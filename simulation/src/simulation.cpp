@@ -34,10 +34,15 @@
 #include "simploce/simulation/sim-data.hpp"
 #include "simploce/simulation/sim-util.hpp"
 #include "simploce/simulation/sconf.hpp"
+#include "simploce/simulation/trajectory.hpp"
+#include "simploce/simulation/protonation-events.hpp"
+#include "simploce/simulation/checkpoint.hpp"
+#include <memory>
 #include <stdexcept>
 #include <iostream>
 #include <iomanip>
 #include <iostream>
+#include <string>
 
 namespace simploce {
     
@@ -48,6 +53,22 @@ namespace simploce {
     void Simulation<Bead>::perform(const sim_param_t& param,
                                    std::ofstream& trajStream,
                                    std::ofstream& dataStream)
+    {
+        this->perform_(param, trajStream, dataStream, nullptr);
+    }
+    
+    void Simulation<Bead>::perform(const sim_param_t& param,
+                                   std::ofstream& trajStream,
+                                   std::ofstream& dataStream,
+                                   std::ofstream& eventStream)
+    {
+        this->perform_(param, trajStream, dataStream, &eventStream);
+    }
+    
+    void Simulation<Bead>::perform_(const sim_param_t& param,
+                                    std::ofstream& trajStream,
+                                    std::ofstream& dataStream,
+                                    std::ofstream* eventStream)
     {
         const auto width = conf::WIDTH;
         const auto space = conf::SPACE;
@@ -62,27 +83,72 @@ namespace simploce {
         
         std::size_t nsteps = param.get<std::size_t>("nsteps", 10000);
         std::size_t nwrite = param.get<std::size_t>("nwrite", 10);
+        std::string fileName = param.get<std::string>("checkpoint", "");
         
-        for (std::size_t counter = 1; counter <= nsteps; ++counter) {
+        // Continue from checkpoint, if requested.
+        std::size_t first = 1;
+        std::unique_ptr<Checkpoint<Bead>> checkpoint{};
+        if ( !fileName.empty() ) {
+            checkpoint.reset(
+                new Checkpoint<Bead>(fileName, param.get<std::size_t>("ncheckpoint", 0))
+            );
+            if ( param.get<bool>("restart", false) ) {
+                first = checkpoint->read(sm_) + 1;
+                std::clog << "Continuing from checkpoint at step " << first - 1 
+                          << "." << std::endl;
+            }
+        }
+        
+        // Parameters for steps at which data is written, also requesting the 
+        // virial for the pressure.
+        sim_param_t writeParam = param;
+        writeParam.put<bool>("virial", true);
+        
+        TrajectoryWriter<Bead> trajectory{trajStream, param};
+        std::unique_ptr<ProtonationEventWriter<Bead>> events{};
+        if ( eventStream ) {
+            events.reset(new ProtonationEventWriter<Bead>(*eventStream));
+            events->start(stime_t{real_t(first - 1) * param.get<real_t>("timestep")}, sm_);
+        }
+        std::size_t last = first - 1;
+        bool saved = true;
+        for (std::size_t counter = first; counter <= nsteps; ++counter) {
             
 #ifdef _DEBUG
             std::clog << "Step #" << counter << std::endl;
 #endif
             
-            SimulationData data = sm_->displace(param);
+            SimulationData data;
             if ( counter % nwrite == 0 ) {
-                data.pressure = 
-                    sm_->doWithAllFreeGroups<pressure_t>([this, data] (const std::vector<bead_ptr_t>& all,
-                                                                       const std::vector<bead_ptr_t>& free,
-                                                                       const std::vector<bead_group_ptr_t>& groups) {
-                    return util::pressure(all, data.temperature, this->sm_->box());
-                });
+                data = sm_->displace(writeParam);
                 dataStream << std::setw(width) << counter << space << data << std::endl;
-                sm_->saveState(trajStream);
-                trajStream.flush();
+                trajectory.write(sm_);
                 dataStream.flush();
+            } else {
+                data = sm_->displace(param);
+            }
+            if ( events ) {
+                events->record(data.ptEvents);
             }
+            last = counter;
+            saved = false;
+            if ( checkpoint ) {
+                bool stop = Checkpoint<Bead>::requested();
+                if ( stop || checkpoint->due(counter) ) {
+                    checkpoint->write(sm_, counter);
+                    saved = true;
+                }
+                if ( stop ) {
+                    std::clog << "Checkpoint written at step " << counter 
+                              << ". Stopping." << std::endl;
+                    break;
+                }
+            }
+        }
+        if ( checkpoint && !saved ) {
+            checkpoint->write(sm_, last);
         }
+        trajectory.close();
         
         std::clog << "Done." << std::endl;
     }
@@ -0,0 +1,722 @@
+/*
+ * The MIT License
+ *
+ * Copyright 2019 André H. Juffer, Biocenter Oulu
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ */
+
+
+/*
+ * File:   trajectory.cpp
+ * Author: André H. Juffer, Biocenter Oulu.
+ *
+ * Created on November 18, 2019, 9:41 AM
+ */
+
+#include "simploce/simulation/trajectory.hpp"
+#include "simploce/simulation/sim-model.hpp"
+#include "simploce/particle/discrete-protonatable-bead.hpp"
+#include "simploce/particle/continuous-protonatable-bead.hpp"
+#include "simploce/particle/particle-spec.hpp"
+#include <stdexcept>
+#include <map>
+#include <cstring>
+
+namespace simploce {
+    
+    // Marks the start of a binary trajectory.
+    static const char HEADER_MAGIC[4] = {'S', 'C', 'G', 'T'};
+    
+    // Marks the start of a compressed trajectory.
+    static const char COMPRESSED_MAGIC[4] = {'S', 'C', 'G', 'C'};
+    
+    // Marks the end of the frame index, at the end of a binary trajectory.
+    static const char INDEX_MAGIC[4] = {'S', 'C', 'G', 'I'};
+    
+    static const std::uint32_t VERSION = 1;
+    
+    // Size of the index trailer: number of frames, index offset, magic.
+    static const std::uint64_t TRAILER_SIZE = 2 * sizeof(std::uint64_t) + sizeof(INDEX_MAGIC);
+    
+    template <typename T>
+    static void 
+    write_(std::ostream& stream, T value)
+    {
+        stream.write(reinterpret_cast<const char*>(&value), sizeof(T));
+    }
+    
+    template <typename T>
+    static void 
+    writeBlock_(std::ostream& stream, const std::vector<T>& values)
+    {
+        stream.write(reinterpret_cast<const char*>(values.data()), values.size() * sizeof(T));
+    }
+    
+    template <typename T>
+    static T
+    read_(std::istream& stream)
+    {
+        T value{};
+        stream.read(reinterpret_cast<char*>(&value), sizeof(T));
+        return value;
+    }
+    
+    template <typename T>
+    static void 
+    readBlock_(std::istream& stream, std::vector<T>& values)
+    {
+        stream.read(reinterpret_cast<char*>(values.data()), values.size() * sizeof(T));
+    }
+    
+    /*
+     * Returns size of the protonation states in one frame, in bytes.
+     */
+    static std::uint64_t
+    bytesPerStates_(std::size_t ndiscrete, 
+                    std::size_t ncontinuous,
+                    std::size_t realSize)
+    {
+        return ndiscrete * sizeof(std::uint32_t) + 
+               ncontinuous * ( sizeof(std::uint32_t) + 2 * realSize );
+    }
+    
+    /*
+     * Sets protonation state of a discrete protonatable bead.
+     */
+    static void
+    protonationState_(const dprot_bead_ptr_t& d, std::size_t state)
+    {
+        while ( d->protonationState() > state ) {
+            d->deprotonate();
+        }
+        while ( d->protonationState() < state ) {
+            d->protonate();
+        }
+    }
+    
+    TrajectoryWriter<Bead>::TrajectoryWriter(std::ostream& stream,
+                                             const std::string& format,
+                                             bool doublePrecision,
+                                             const length_t& precision,
+                                             std::size_t nbuffers) :
+        stream_{&stream}, binary_{false}, compressed_{false}, 
+        doublePrecision_{doublePrecision}, closed_{false}, nframes_{0}, 
+        nwritten_{0}, offsets_{}, codec_{precision}, order_{}, dindices_{}, 
+        cindices_{}, kinds_{}, slots_{}, frame_{}, nbuffers_{nbuffers}, buffers_{}
+    {
+        if ( format == conf::BINARY_TRAJECTORY ) {
+            binary_ = true;
+        } else if ( format == conf::COMPRESSED_TRAJECTORY ) {
+            binary_ = true;
+            compressed_ = true;
+            doublePrecision_ = false;
+        } else if ( format != conf::TEXT_TRAJECTORY ) {
+            throw std::domain_error(format + ": No such trajectory format.");
+        }
+    }
+    
+    TrajectoryWriter<Bead>::TrajectoryWriter(std::ostream& stream, 
+                                             const sim_param_t& param) :
+        TrajectoryWriter(stream,
+                         param.get<std::string>("trajectory", conf::TEXT_TRAJECTORY),
+                         param.get<bool>("doubleprecision", false),
+                         length_t{param.get<real_t>("trajprecision", 0.001)},
+                         param.get<std::size_t>("ntrajbuffers", conf::NUMBER_OF_FRAME_BUFFERS))
+    {        
+    }
+    
+    TrajectoryWriter<Bead>::~TrajectoryWriter()
+    {
+        this->stop_();
+    }
+    
+    void 
+    TrajectoryWriter<Bead>::write(const cg_sim_model_ptr_t& sm)
+    {
+        if ( closed_ ) {
+            throw std::domain_error("TrajectoryWriter: Trajectory is closed.");
+        }
+        if ( nframes_ == 0 ) {
+            this->layout_(sm);
+            if ( binary_ ) {
+                this->writeHeader_(sm);
+            }
+            if ( nbuffers_ > 0 ) {
+                buffers_.reset(new Buffers_);
+                buffers_->frames.resize(nbuffers_);
+                buffers_->thread = std::thread([this] () { this->run_(); });
+            }
+        }
+        nframes_ += 1;
+        
+        if ( !buffers_ ) {
+            snapshot_(sm, frame_);
+            this->writeFrame_(frame_);
+            return;
+        }
+        
+        // Wait for a free buffer. Only this thread fills buffers, so the buffer 
+        // can be filled without holding the lock.
+        std::size_t slot;
+        {
+            std::unique_lock<std::mutex> lock(buffers_->mutex);
+            buffers_->notFull.wait(lock, [this] () {
+                return this->buffers_->count < this->nbuffers_ || this->buffers_->error; 
+            });
+            if ( buffers_->error ) {
+                std::rethrow_exception(buffers_->error);
+            }
+            slot = ( buffers_->head + buffers_->count ) % nbuffers_;
+        }
+        snapshot_(sm, buffers_->frames[slot]);
+        {
+            std::lock_guard<std::mutex> lock(buffers_->mutex);
+            buffers_->count += 1;
+        }
+        buffers_->notEmpty.notify_one();
+    }
+    
+    void 
+    TrajectoryWriter<Bead>::close()
+    {
+        if ( closed_ ) {
+            return;
+        }
+        closed_ = true;
+        this->stop_();
+        if ( buffers_ && buffers_->error ) {
+            std::rethrow_exception(buffers_->error);
+        }
+        if ( !binary_ || nframes_ == 0 ) {
+            return;
+        }
+        std::uint64_t indexOffset = std::uint64_t(stream_->tellp());
+        writeBlock_(*stream_, offsets_);
+        write_<std::uint64_t>(*stream_, offsets_.size());
+        write_<std::uint64_t>(*stream_, indexOffset);
+        stream_->write(INDEX_MAGIC, sizeof(INDEX_MAGIC));
+        stream_->flush();
+    }
+    
+    std::size_t 
+    TrajectoryWriter<Bead>::numberOfFrames() const
+    {
+        return nframes_;
+    }
+    
+    void 
+    TrajectoryWriter<Bead>::layout_(const cg_sim_model_ptr_t& sm)
+    {
+        sm->doWithAllFreeGroups<void>([this] (const std::vector<bead_ptr_t>& all,
+                                              const std::vector<bead_ptr_t>& free,
+                                              const std::vector<bead_group_ptr_t>& groups) {
+            for (const auto& bead : all) {
+                this->order_.push_back(bead->index());
+            }
+            this->kinds_.assign(all.size(), 0);
+            this->slots_.assign(all.size(), 0);
+        });
+        sm->doWithProtBeads<void>([this] (const std::vector<dprot_bead_ptr_t>& discrete,
+                                          const std::vector<cprot_bead_ptr_t>& continuous) {
+            for (std::size_t k = 0; k != discrete.size(); ++k) {
+                std::size_t index = discrete[k]->index();
+                this->dindices_.push_back(index);
+                this->kinds_[index] = 1;
+                this->slots_[index] = k;
+            }
+            for (std::size_t k = 0; k != continuous.size(); ++k) {
+                std::size_t index = continuous[k]->index();
+                this->cindices_.push_back(index);
+                this->kinds_[index] = 2;
+                this->slots_[index] = k;
+            }
+        });
+    }
+    
+    void 
+    TrajectoryWriter<Bead>::writeHeader_(const cg_sim_model_ptr_t& sm)
+    {
+        stream_->write(compressed_ ? COMPRESSED_MAGIC : HEADER_MAGIC, sizeof(HEADER_MAGIC));
+        write_<std::uint32_t>(*stream_, VERSION);
+        write_<std::uint32_t>(*stream_, doublePrecision_ ? sizeof(double) : sizeof(float));
+        if ( compressed_ ) {
+            write_<double>(*stream_, codec_.precision()());
+            write_<std::uint32_t>(*stream_, conf::KEY_FRAME_INTERVAL);
+        }
+        
+        // Particle specifications, and the specification of each particle.
+        sm->doWithAllFreeGroups<void>([this] (const std::vector<bead_ptr_t>& all,
+                                              const std::vector<bead_ptr_t>& free,
+                                              const std::vector<bead_group_ptr_t>& groups) {
+            std::map<std::string, std::uint32_t> specIndex{};
+            std::vector<std::string> names{};
+            std::vector<std::uint32_t> specs(all.size());
+            for (const auto& bead : all) {
+                std::string name = bead->spec()->name();
+                auto iter = specIndex.find(name);
+                if ( iter == specIndex.end() ) {
+                    iter = specIndex.emplace(name, std::uint32_t(names.size())).first;
+                    names.push_back(name);
+                }
+                specs[bead->index()] = iter->second;
+            }
+            write_<std::uint64_t>(*this->stream_, all.size());
+            write_<std::uint32_t>(*this->stream_, names.size());
+            for (const auto& name : names) {
+                write_<std::uint32_t>(*this->stream_, name.size());
+                this->stream_->write(name.data(), name.size());
+            }
+            writeBlock_(*this->stream_, specs);
+        });
+        write_<double>(*stream_, sm->box()->size());
+        
+        // Indices of the protonatable beads, in the order of their states in a frame.
+        sm->doWithProtBeads<void>([this] (const std::vector<dprot_bead_ptr_t>& discrete,
+                                          const std::vector<cprot_bead_ptr_t>& continuous) {
+            write_<std::uint64_t>(*this->stream_, discrete.size());
+            for (const auto& d : discrete) {
+                write_<std::uint64_t>(*this->stream_, d->index());
+            }
+            write_<std::uint64_t>(*this->stream_, continuous.size());
+            for (const auto& c : continuous) {
+                write_<std::uint64_t>(*this->stream_, c->index());
+            }
+        });
+    }
+    
+    void 
+    TrajectoryWriter<Bead>::snapshot_(const cg_sim_model_ptr_t& sm, Frame_& frame)
+    {
+        sm->doWithAllFreeGroups<void>([&frame] (const std::vector<bead_ptr_t>& all,
+                                                const std::vector<bead_ptr_t>& free,
+                                                const std::vector<bead_group_ptr_t>& groups) {
+            frame.rs.resize(all.size());
+            frame.vs.resize(all.size());
+            for (const auto& bead : all) {
+                frame.rs[bead->index()] = bead->position();
+                frame.vs[bead->index()] = bead->velocity();
+            }
+        });
+        sm->doWithProtBeads<void>([&frame] (const std::vector<dprot_bead_ptr_t>& discrete,
+                                            const std::vector<cprot_bead_ptr_t>& continuous) {
+            frame.dstates.resize(discrete.size());
+            for (std::size_t k = 0; k != discrete.size(); ++k) {
+                frame.dstates[k] = discrete[k]->protonationState();
+            }
+            frame.cstates.resize(continuous.size());
+            frame.xs.resize(continuous.size());
+            frame.Is.resize(continuous.size());
+            for (std::size_t k = 0; k != continuous.size(); ++k) {
+                frame.cstates[k] = continuous[k]->protonationState();
+                frame.xs[k] = continuous[k]->state();
+                frame.Is[k] = continuous[k]->current();
+            }
+        });
+    }
+    
+    void 
+    TrajectoryWriter<Bead>::writeFrame_(const Frame_& frame)
+    {
+        if ( compressed_ ) {
+            offsets_.push_back(std::uint64_t(stream_->tellp()));
+            this->writeCompressed_(frame);
+        } else if ( binary_ ) {
+            offsets_.push_back(std::uint64_t(stream_->tellp()));
+            if ( doublePrecision_ ) {
+                this->writeBinary_<double>(frame);
+            } else {
+                this->writeBinary_<float>(frame);
+            }
+        } else {
+            this->writeText_(frame);
+        }
+        stream_->flush();
+        nwritten_ += 1;
+    }
+    
+    void 
+    TrajectoryWriter<Bead>::writeText_(const Frame_& frame)
+    {
+        const auto space = conf::SPACE;
+        
+        // As SimulationModel::saveState().
+        auto writeState = [this, &frame, space] (std::size_t index) {
+            std::ostream& stream = *this->stream_;
+            stream << space << frame.rs[index];
+            stream << space << frame.vs[index];
+            std::size_t k = this->slots_[index];
+            if ( this->kinds_[index] == 1 ) {
+                stream << space << frame.dstates[k];
+            } else if ( this->kinds_[index] == 2 ) {
+                stream << space << frame.cstates[k] << space << frame.xs[k] 
+                       << space << frame.Is[k];
+            }
+        };
+        for (auto index : order_) {
+            writeState(index);
+        }
+        for (auto index : dindices_) {
+            writeState(index);
+        }
+        for (auto index : cindices_) {
+            writeState(index);
+        }
+    }
+    
+    template <typename T>
+    void 
+    TrajectoryWriter<Bead>::writeBinary_(const Frame_& frame)
+    {
+        std::size_t nbeads = frame.rs.size();
+        std::vector<T> rs(3 * nbeads), vs(3 * nbeads);
+        for (std::size_t i = 0; i != nbeads; ++i) {
+            for (std::size_t k = 0; k != 3; ++k) {
+                rs[3 * i + k] = T(frame.rs[i][k]);
+                vs[3 * i + k] = T(frame.vs[i][k]);
+            }
+        }
+        writeBlock_(*stream_, rs);
+        writeBlock_(*stream_, vs);
+        this->writeStates_<T>(frame);
+    }
+    
+    void 
+    TrajectoryWriter<Bead>::writeCompressed_(const Frame_& frame)
+    {
+        bool key = nwritten_ % conf::KEY_FRAME_INTERVAL == 0;
+        std::vector<std::uint8_t> bytes = codec_.encode(frame.rs, key);
+        write_<std::uint64_t>(*stream_, bytes.size());
+        writeBlock_(*stream_, bytes);
+        this->writeStates_<float>(frame);
+    }
+    
+    template <typename T>
+    void 
+    TrajectoryWriter<Bead>::writeStates_(const Frame_& frame)
+    {
+        std::vector<std::uint32_t> states(frame.dstates.begin(), frame.dstates.end());
+        writeBlock_(*stream_, states);
+        for (std::size_t k = 0; k != frame.cstates.size(); ++k) {
+            write_<std::uint32_t>(*stream_, frame.cstates[k]);
+            write_<T>(*stream_, frame.xs[k]);
+            write_<T>(*stream_, frame.Is[k]);
+        }
+    }
+    
+    void 
+    TrajectoryWriter<Bead>::run_()
+    {
+        while ( true ) {
+            std::size_t slot;
+            {
+                std::unique_lock<std::mutex> lock(buffers_->mutex);
+                buffers_->notEmpty.wait(lock, [this] () {
+                    return this->buffers_->count > 0 || this->buffers_->done;
+                });
+                if ( buffers_->count == 0 ) {
+                    return;
+                }
+                slot = buffers_->head;
+            }
+            try {
+                this->writeFrame_(buffers_->frames[slot]);
+            } catch (...) {
+                std::lock_guard<std::mutex> lock(buffers_->mutex);
+                buffers_->error = std::current_exception();
+                buffers_->count = 0;
+                buffers_->notFull.notify_one();
+                return;
+            }
+            {
+                std::lock_guard<std::mutex> lock(buffers_->mutex);
+                buffers_->head = ( buffers_->head + 1 ) % nbuffers_;
+                buffers_->count -= 1;
+            }
+            buffers_->notFull.notify_one();
+        }
+    }
+    
+    void 
+    TrajectoryWriter<Bead>::stop_()
+    {
+        if ( !buffers_ || !buffers_->thread.joinable() ) {
+            return;
+        }
+        {
+            std::lock_guard<std::mutex> lock(buffers_->mutex);
+            buffers_->done = true;
+        }
+        buffers_->notEmpty.notify_one();
+        buffers_->thread.join();
+    }
+    
+    
+    TrajectoryReader<Bead>::TrajectoryReader(std::istream& stream) :
+        stream_{&stream}, binary_{false}, compressed_{false}, doublePrecision_{false}, 
+        nbeads_{0}, ndiscrete_{0}, ncontinuous_{0}, begin_{0}, frameSize_{0}, 
+        frame_{0}, offsets_{}, codec_{}, nkey_{1}, next_{0}, buffer_{}, rs_{}
+    {
+        auto start = stream_->tellg();
+        char magic[sizeof(HEADER_MAGIC)];
+        stream_->read(magic, sizeof(magic));
+        bool complete = stream_->gcount() == sizeof(magic);
+        if ( complete && std::memcmp(magic, HEADER_MAGIC, sizeof(magic)) == 0 ) {
+            binary_ = true;
+            this->readHeader_();
+        } else if ( complete && std::memcmp(magic, COMPRESSED_MAGIC, sizeof(magic)) == 0 ) {
+            binary_ = true;
+            compressed_ = true;
+            this->readHeader_();
+        } else {
+            stream_->clear();
+            stream_->seekg(start);
+        }
+    }
+    
+    bool 
+    TrajectoryReader<Bead>::read(const cg_sim_model_ptr_t& sm)
+    {
+        if ( !binary_ ) {
+            sm->readState(*stream_);
+            return stream_->good();
+        }
+        if ( frame_ >= offsets_.size() ) {
+            return false;
+        }
+        if ( sm->size() != nbeads_ ) {
+            throw std::domain_error(
+                "TrajectoryReader: Number of particles does not match trajectory."
+            );
+        }
+        if ( compressed_ ) {
+            this->readCompressedFrame_(sm);
+        } else if ( doublePrecision_ ) {
+            this->readFrame_<double>(sm);
+        } else {
+            this->readFrame_<float>(sm);
+        }
+        if ( !stream_->good() ) {
+            throw std::domain_error("TrajectoryReader: Incomplete frame.");
+        }
+        frame_ += 1;
+        return true;
+    }
+    
+    void 
+    TrajectoryReader<Bead>::seek(std::size_t frame)
+    {
+        if ( !binary_ ) {
+            throw std::domain_error(
+                "TrajectoryReader: Seeking requires a binary trajectory."
+            );
+        }
+        frame_ = std::min(frame, offsets_.size());
+    }
+    
+    std::size_t 
+    TrajectoryReader<Bead>::numberOfFrames() const
+    {
+        return offsets_.size();
+    }
+    
+    bool 
+    TrajectoryReader<Bead>::isBinary() const
+    {
+        return binary_;
+    }
+    
+    void 
+    TrajectoryReader<Bead>::readHeader_()
+    {
+        auto version = read_<std::uint32_t>(*stream_);
+        if ( version != VERSION ) {
+            throw std::domain_error(
+                "TrajectoryReader: Unsupported binary trajectory version " + 
+                std::to_string(version) + "."
+            );
+        }
+        auto realSize = read_<std::uint32_t>(*stream_);
+        if ( realSize != sizeof(float) && realSize != sizeof(double) ) {
+            throw std::domain_error("TrajectoryReader: Corrupt binary trajectory.");
+        }
+        doublePrecision_ = realSize == sizeof(double);
+        if ( compressed_ ) {
+            real_t precision = read_<double>(*stream_);
+            nkey_ = read_<std::uint32_t>(*stream_);
+            if ( !( precision > 0.0 ) || nkey_ == 0 ) {
+                throw std::domain_error("TrajectoryReader: Corrupt compressed trajectory.");
+            }
+            codec_ = CoordinateCodec{length_t{precision}};
+        }
+        
+        // Particle specifications and box are not needed for reading states.
+        nbeads_ = read_<std::uint64_t>(*stream_);
+        auto nspecs = read_<std::uint32_t>(*stream_);
+        for (std::size_t k = 0; k != nspecs; ++k) {
+            auto length = read_<std::uint32_t>(*stream_);
+            stream_->ignore(length);
+        }
+        stream_->ignore(nbeads_ * sizeof(std::uint32_t) + sizeof(double));
+        ndiscrete_ = read_<std::uint64_t>(*stream_);
+        stream_->ignore(ndiscrete_ * sizeof(std::uint64_t));
+        ncontinuous_ = read_<std::uint64_t>(*stream_);
+        stream_->ignore(ncontinuous_ * sizeof(std::uint64_t));
+        if ( !stream_->good() ) {
+            throw std::domain_error("TrajectoryReader: Corrupt binary trajectory.");
+        }
+        begin_ = std::uint64_t(stream_->tellg());
+        std::uint64_t statesSize = bytesPerStates_(ndiscrete_, ncontinuous_, realSize);
+        frameSize_ = compressed_ ? 0 : 6 * nbeads_ * realSize + statesSize;
+        
+        // Frame index. If absent, e.g. due to an interrupted simulation, offsets
+        // follow from the fixed frame size, or from the sizes of compressed 
+        // positions.
+        stream_->seekg(0, std::ios_base::end);
+        std::uint64_t end = std::uint64_t(stream_->tellg());
+        bool indexed = false;
+        if ( end >= begin_ + TRAILER_SIZE ) {
+            stream_->seekg(end - TRAILER_SIZE);
+            auto nframes = read_<std::uint64_t>(*stream_);
+            auto indexOffset = read_<std::uint64_t>(*stream_);
+            char magic[sizeof(INDEX_MAGIC)];
+            stream_->read(magic, sizeof(magic));
+            if ( stream_->good() && 
+                 std::memcmp(magic, INDEX_MAGIC, sizeof(magic)) == 0 &&
+                 indexOffset + nframes * sizeof(std::uint64_t) + TRAILER_SIZE == end ) {
+                offsets_.resize(nframes);
+                stream_->seekg(indexOffset);
+                readBlock_(*stream_, offsets_);
+                indexed = stream_->good();
+            }
+        }
+        if ( !indexed && compressed_ ) {
+            stream_->clear();
+            offsets_.clear();
+            std::uint64_t offset = begin_;
+            while ( offset + sizeof(std::uint64_t) <= end ) {
+                stream_->seekg(offset);
+                std::uint64_t size = 
+                    sizeof(std::uint64_t) + read_<std::uint64_t>(*stream_) + statesSize;
+                if ( !stream_->good() || offset + size > end ) {
+                    break;
+                }
+                offsets_.push_back(offset);
+                offset += size;
+            }
+        } else if ( !indexed ) {
+            stream_->clear();
+            std::size_t nframes = frameSize_ > 0 ? ( end - begin_ ) / frameSize_ : 0;
+            offsets_.resize(nframes);
+            for (std::size_t k = 0; k != nframes; ++k) {
+                offsets_[k] = begin_ + k * frameSize_;
+            }
+        }
+        stream_->clear();
+        stream_->seekg(begin_);
+    }
+    
+    template <typename T>
+    void 
+    TrajectoryReader<Bead>::readFrame_(const cg_sim_model_ptr_t& sm)
+    {
+        stream_->seekg(offsets_[frame_]);
+        sm->doWithAllFreeGroups<void>([this] (const std::vector<bead_ptr_t>& all,
+                                              const std::vector<bead_ptr_t>& free,
+                                              const std::vector<bead_group_ptr_t>& groups) {
+            std::vector<T> rs(3 * all.size()), vs(3 * all.size());
+            readBlock_(*this->stream_, rs);
+            readBlock_(*this->stream_, vs);
+            for (const auto& bead : all) {
+                std::size_t i = 3 * bead->index();
+                bead->position(position_t{rs[i], rs[i + 1], rs[i + 2]});
+                bead->velocity(velocity_t{vs[i], vs[i + 1], vs[i + 2]});
+            }
+        });
+        this->readStates_<T>(sm);
+    }
+    
+    void 
+    TrajectoryReader<Bead>::readCompressedFrame_(const cg_sim_model_ptr_t& sm)
+    {
+        // Positions depend on those in preceding frames, up to the last key frame.
+        if ( frame_ != next_ ) {
+            for (std::size_t k = frame_ - frame_ % nkey_; k != frame_; ++k) {
+                this->decode_(k);
+            }
+        }
+        this->decode_(frame_);
+        next_ = frame_ + 1;
+        sm->doWithAllFreeGroups<void>([this] (const std::vector<bead_ptr_t>& all,
+                                              const std::vector<bead_ptr_t>& free,
+                                              const std::vector<bead_group_ptr_t>& groups) {
+            if ( all.size() != this->rs_.size() ) {
+                throw std::domain_error(
+                    "TrajectoryReader: Number of particles does not match trajectory."
+                );
+            }
+            for (const auto& bead : all) {
+                bead->position(this->rs_[bead->index()]);
+                bead->velocity(velocity_t{});
+            }
+        });
+        this->readStates_<float>(sm);
+    }
+    
+    void 
+    TrajectoryReader<Bead>::decode_(std::size_t frame)
+    {
+        stream_->seekg(offsets_[frame]);
+        auto size = read_<std::uint64_t>(*stream_);
+        buffer_.resize(size);
+        readBlock_(*stream_, buffer_);
+        if ( !stream_->good() ) {
+            throw std::domain_error("TrajectoryReader: Incomplete frame.");
+        }
+        codec_.decode(buffer_.data(), buffer_.size(), rs_);
+    }
+    
+    template <typename T>
+    void 
+    TrajectoryReader<Bead>::readStates_(const cg_sim_model_ptr_t& sm)
+    {
+        sm->doWithProtBeads<void>([this] (const std::vector<dprot_bead_ptr_t>& discrete,
+                                          const std::vector<cprot_bead_ptr_t>& continuous) {
+            if ( discrete.size() != this->ndiscrete_ || continuous.size() != this->ncontinuous_ ) {
+                throw std::domain_error(
+                    "TrajectoryReader: Protonatable particles do not match trajectory."
+                );
+            }
+            std::vector<std::uint32_t> states(discrete.size());
+            readBlock_(*this->stream_, states);
+            for (std::size_t k = 0; k != discrete.size(); ++k) {
+                protonationState_(discrete[k], states[k]);
+            }
+            for (const auto& c : continuous) {
+                if ( read_<std::uint32_t>(*this->stream_) > 0 ) {
+                    c->protonate();
+                } else {
+                    c->deprotonate();
+                }
+                c->state(read_<T>(*this->stream_));
+                c->current(read_<T>(*this->stream_));
+            }
+        });
+    }
+}
@@ -31,6 +31,7 @@
 
 #include "simploce/simulation/velocity-verlet.hpp"
 #include "simploce/simulation/interactor.hpp"
+#include "simploce/simulation/rattle.hpp"
 #include "simploce/simulation/sim-util.hpp"
 #include "simploce/simulation/sconf.hpp"
 #include "simploce/particle/atom.hpp"
@@ -40,86 +41,89 @@
 namespace simploce {
     
     /*
-     * Displaces particle positions.
+     * Displaces particle positions. Velocities are updated to half step 
+     * velocities (half-kick) in the same pass.
      * @param T Particle type.
      * @param dt Time step.
      * @param particles Particles.
-     * @return Forces at time t(n).
      */
     template <typename T>
-    std::vector<force_t> 
+    void 
     displacePosition_(const stime_t& dt,
                       const std::vector<std::shared_ptr<T>>& particles)
     {
-        // Initial forces (forces at time t(n).
-        std::vector<force_t> fis(particles.size(), force_t{});
-        
-        // Displace particles: Positions.
-        for (std::size_t index = 0; index != particles.size(); ++index) {
-            T& particle = *particles[index];
-
-            mass_t mass = particle.mass();
-            real_t a1 = dt() / ( 2.0 * mass() );
-            real_t a2 = dt() * a1;
+        util::forEachRange<bool>(particles.size(), [&dt, &particles] (std::size_t k, 
+                                                                      std::size_t begin, 
+                                                                      std::size_t end) {
+            for (std::size_t index = begin; index != end; ++index) {
+                T& particle = *particles[index];
+                
+                mass_t mass = particle.mass();
+                real_t a1 = dt() / ( 2.0 * mass() );
 
-            force_t fi = particle.force();                 // Force (kJ/(mol nm) = (u nm)/(ps^2)) 
-            fis[index] = fi;                               // at time t(n).
-      
-            position_t ri = particle.position();           // Position at time t(n).
-            velocity_t vi = particle.velocity();           // Velocity at time t(n).
-            static position_t rf{};
-            for ( std::size_t k = 0; k != 3; ++k) {
-                rf[k] = ri[k] + dt() * vi[k] + a2 * fi[k]; // Position at time t(n+1).
-            }
+                force_t fi = particle.force();             // Force (kJ/(mol nm) = (u nm)/(ps^2)) 
+                                                           // at time t(n).
+                position_t ri = particle.position();       // Position at time t(n).
+                velocity_t vi = particle.velocity();       // Velocity at time t(n).
+                for ( std::size_t k = 0; k != 3; ++k) {
+                    vi[k] += a1 * fi[k];                   // Velocity at time t(n+1/2).
+                    ri[k] += dt() * vi[k];                 // Position at time t(n+1).
+                }
         
-            // Save new position.       
-            particle.position(rf);
-        }
-        return std::move(fis);
+                // Save half step velocity and new position.
+                particle.velocity(vi);
+                particle.position(ri);
+            }
+            return true;
+        });
     }
     
     /*
-     * Displaces particle velocities.
+     * Displaces particle velocities, from half step velocities.
      * @param T Particle type.
      * @param dt Time step.
-     * @param fis Forces at t(n)
      * @param particles Particles.
-     * @return Kinetic, potential energy, and temperature.
+     * @return Kinetic energy and temperature.
      */
     template <typename T>
     SimulationData 
     displaceMomentum_(const stime_t& dt,
-                      const std::vector<force_t>& fis,
                       const std::vector<std::shared_ptr<T>>& particles)
     {
         SimulationData data;
         
-        // Kinetic energy at t(n+1).
-        data.ekin = 0.0;
-        
-        // Displace particles: Momenta/velocities.
-        std::size_t nparticles = particles.size();
-        for (std::size_t index = 0; index != nparticles; ++index) {
-            T& particle = *particles[index];
-            mass_t mass = particle.mass();
-            real_t a1 = dt() / ( 2.0 * mass() );
+        // Displace particles: Momenta/velocities. Kinetic energy at t(n+1) per 
+        // range.
+        auto ekins = 
+            util::forEachRange<real_t>(particles.size(), [&dt, &particles] (std::size_t k,
+                                                                            std::size_t begin,
+                                                                            std::size_t end) {
+            real_t ekin = 0.0;
+            for (std::size_t index = begin; index != end; ++index) {
+                T& particle = *particles[index];
+                mass_t mass = particle.mass();
+                real_t a1 = dt() / ( 2.0 * mass() );
 
-            force_t fi = fis[index];                       // Force (kJ/(mol nm) = (u nm)/(ps^2)) 
-                                                           // at time t(n).
-            force_t ff = particle.force();                 // Force (kJ/(mol nm) = (u nm)/(ps^2))
+                force_t ff = particle.force();             // Force (kJ/(mol nm) = (u nm)/(ps^2))
                                                            // at time t(n+1).
-
-            velocity_t vi = particle.velocity();           // velocity (nm/ps) at time t(n).
-            static velocity_t vf{};
-            for (std::size_t k = 0; k != 3; ++k) {
-                vf[k] = vi[k] + a1 * ( fi[k] + ff[k] );    // Velocity at time t(n+1).
-            }
+                velocity_t vf = particle.velocity();       // Velocity (nm/ps) at time t(n+1/2).
+                for (std::size_t k = 0; k != 3; ++k) {
+                    vf[k] += a1 * ff[k];                   // Velocity at time t(n+1).
+                }
       
-            // Save velocity
-            particle.velocity(vf);
+                // Save velocity
+                particle.velocity(vf);
       
-            // Kinetic energy at t(n+1).
-            data.ekin += 0.5 * mass() * inner<real_t>(vf, vf);
+                // Kinetic energy at t(n+1).
+                ekin += 0.5 * mass() * inner<real_t>(vf, vf);
+            }
+            return ekin;
+        });
+        
+        // Kinetic energy at t(n+1).
+        data.ekin = 0.0;
+        for (auto ekin : ekins) {
+            data.ekin += ekin;
         }
     
         // Instantaneous temperature at t(n+1).
@@ -129,7 +133,7 @@ namespace simploce {
     }
        
     VelocityVerlet<Atomistic>::VelocityVerlet(const at_interactor_ptr_t& interactor) :
-        interactor_{interactor}
+        interactor_{interactor}, setup_{false}, counter_{0}, dt_{0.0}
     {       
     }
         
@@ -137,37 +141,31 @@ namespace simploce {
     VelocityVerlet<Atomistic>::displace(const sim_param_t& param, 
                                         const at_ptr_t& at) const
     {        
-        static std::size_t counter = 0;
-        static bool firstTime = true;
-        
-        static stime_t dt{0.0};        
-        static std::vector<force_t> fis{};
+        counter_ += 1;
         
-        counter += 1;
-        
-        if ( firstTime) {
-            dt = param.get<real_t>("timestep");
+        if ( !setup_ ) {
+            dt_ = param.get<real_t>("timestep");
             interactor_->interact(param, at); // Initial forces.
-            firstTime = false;
+            setup_ = true;
         }
         
         // Displace atom positions.
-        at->doWithAll<void>([] (const std::vector<atom_ptr_t>& atoms) {
-            fis = displacePosition_<Atom>(dt, atoms);
+        at->doWithAll<void>([this] (const std::vector<atom_ptr_t>& atoms) {
+            displacePosition_<Atom>(this->dt_, atoms);
         });
         
         // Compute forces and potential energy at t(n+1) using positions at t(n+1).
         auto result = interactor_->interact(param, at);
         
         // Displace atom momenta.
-        SimulationData data = at->doWithAll<SimulationData>([] (const std::vector<atom_ptr_t>& atoms) {
-            return displaceMomentum_<Atom>(dt, fis, atoms);
+        SimulationData data = at->doWithAll<SimulationData>([this] (const std::vector<atom_ptr_t>& atoms) {
+            return displaceMomentum_<Atom>(this->dt_, atoms);
         });
         
         // Save simulation data.
         data.bepot = result.first;
         data.nbepot = result.second;       
-        data.t = counter * dt;
+        data.t = counter_ * dt_;
         
         return data;
     }
@@ -179,7 +177,7 @@ namespace simploce {
     }
         
     VelocityVerlet<CoarseGrained>::VelocityVerlet(const cg_interactor_ptr_t& interactor) :
-        interactor_{interactor}
+        interactor_{interactor}, setup_{false}, counter_{0}, dt_{0.0}, rattle_{}
     {       
     }
         
@@ -187,36 +185,62 @@ namespace simploce {
     VelocityVerlet<CoarseGrained>::displace(const sim_param_t& param, 
                                             const cg_ptr_t& cg) const
     {        
-        static std::size_t counter = 0;
-        static bool firstTime = true;
-        
-        static stime_t dt{0.0};      
-        static std::vector<force_t> fis{};
-        
-        counter += 1;
-        if ( firstTime) {
-            dt = param.get<real_t>("timestep");
+        counter_ += 1;
+        dt_ = param.get<real_t>("timestep");  // May change between steps.
+        if ( !setup_ ) {
+            if ( param.get<std::string>("constraints", conf::NO_CONSTRAINTS) == conf::RATTLE ) {
+                rattle_ = 
+                    std::make_shared<Rattle<Bead>>(interactor_->bondLength());
+            }
             interactor_->interact(param, cg);
-            firstTime = false;
+            setup_ = true;
         }
         
         // Displace atom positions.
-        cg->doWithAll<void>([] (const std::vector<bead_ptr_t>& beads) {
-            fis = displacePosition_<Bead>(dt, beads);
+        cg->doWithAllFreeGroups<void>([this] (const std::vector<bead_ptr_t>& all,
+                                              const std::vector<bead_ptr_t>& free,
+                                              const std::vector<bead_group_ptr_t>& groups) {
+            if ( this->rattle_ ) {
+                this->rattle_->reference(all);
+            }
+            displacePosition_<Bead>(this->dt_, all);
+            if ( this->rattle_ ) {
+                // Constraint displacements are carried over to the half step 
+                // velocities.
+                auto drs = this->rattle_->constrainPositions(all, groups);
+                for (const auto& bead : all) {
+                    auto index = bead->index();
+                    velocity_t v = bead->velocity();
+                    for (std::size_t k = 0; k != 3; ++k) {
+                        v[k] += drs[index][k] / this->dt_();
+                    }
+                    bead->velocity(v);
+                }
+            }
         });
         
         // Compute forces and potential energy at t(n+1) using positions at t(n+1).
         auto result = interactor_->interact(param, cg);
         
         // Displace atom momenta.
-        SimulationData data = cg->doWithAll<SimulationData>([] (const std::vector<bead_ptr_t>& beads) {
-            return displaceMomentum_<Bead>(dt, fis, beads);
+        SimulationData data = 
+            cg->doWithAllFreeGroups<SimulationData>([this] (const std::vector<bead_ptr_t>& all,
+                                                            const std::vector<bead_ptr_t>& free,
+                                                            const std::vector<bead_group_ptr_t>& groups) {
+            auto data = displaceMomentum_<Bead>(this->dt_, all);
+            if ( this->rattle_ ) {
+                data.cvirial = this->rattle_->constrainVelocities(groups, this->dt_);
+                data.ekin = util::kineticEnergy<Bead>(all);
+                data.temperature = 
+                    util::temperature<Bead>(all, data.ekin, this->rattle_->numberOfConstraints(groups));
+            }
+            return data;
         });
         
         // Save simulation data.
         data.bepot = result.first;
         data.nbepot = result.second;        
-        data.t = counter * dt;
+        data.t = counter_ * dt_;
         
         return data;
     }
@@ -226,6 +250,29 @@ namespace simploce {
     {
         return conf::VELOCITY_VERLET;
     }
+    
+    void 
+    VelocityVerlet<CoarseGrained>::writeCheckpoint(std::ostream& stream) const
+    {
+        util::writeBinary(stream, setup_);
+        util::writeBinary(stream, counter_);
+        util::writeBinary(stream, dt_);
+        util::writeBinary(stream, bool(rattle_));
+    }
+    
+    void 
+    VelocityVerlet<CoarseGrained>::readCheckpoint(std::istream& stream, const cg_ptr_t& cg)
+    {
+        bool rattle;
+        util::readBinary(stream, setup_);
+        util::readBinary(stream, counter_);
+        util::readBinary(stream, dt_);
+        util::readBinary(stream, rattle);
+        rattle_.reset();
+        if ( rattle ) {
+            rattle_ = std::make_shared<Rattle<Bead>>(interactor_->bondLength());
+        }
+    }
         
     
 }
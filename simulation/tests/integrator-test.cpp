@@ -0,0 +1,468 @@
+/*
+ * The MIT License
+ *
+ * Copyright 2019 André H. Juffer, Biocenter Oulu
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ */
+
+/* 
+ * File:   integrator-test.cpp
+ * Author: ajuffer
+ *
+ * Created on November 24, 2019, 10:12 AM
+ */
+
+#include "simploce/simulation/sim-model.hpp"
+#include "simploce/simulation/sim-data.hpp"
+#include "simploce/simulation/cg-pol-water.hpp"
+#include "simploce/simulation/sfactory.hpp"
+#include "simploce/simulation/pbc.hpp"
+#include "simploce/simulation/rattle.hpp"
+#include "simploce/simulation/sconf.hpp"
+#include "simploce/simulation/stypes.hpp"
+#include "simploce/particle/bead.hpp"
+#include "simploce/particle/coarse-grained.hpp"
+#include "simploce/particle/particle-group.hpp"
+#include "simploce/particle/particle-spec.hpp"
+#include "simploce/particle/particle-spec-catalog.hpp"
+#include "simploce/particle/particle-model-factory.hpp"
+#include "simploce/util/param.hpp"
+#include "test-models.hpp"
+#include <cstdlib>
+#include <cmath>
+#include <iostream>
+#include <stdexcept>
+#include <utility>
+#include <vector>
+
+using namespace simploce;
+using namespace simploce::param;
+
+/*
+ * Simple C++ Test Suite
+ */
+
+/*
+ * Equilibrates particle model by strongly damped Langevin dynamics, such that
+ * the initial lattice has melted.
+ */
+static void equilibrate_(const cg_ptr_t& cg,
+                         const std::string& forceFieldId,
+                         const spec_catalog_ptr_t& catalog,
+                         const box_ptr_t& box,
+                         sim_param_t param)
+{
+    auto sm = 
+        test::simulationModel(cg, forceFieldId, conf::LANGEVIN_VELOCITY_VERLET, catalog, box);
+    param.put<real_t>("gamma", 5.0);
+    for (std::size_t n = 0; n != 500; ++n) {
+        sm->displace(param);
+    }
+}
+
+/*
+ * Returns largest deviation of total energy from its initial value, relative to 
+ * the average kinetic energy.
+ */
+static real_t energyDrift_(const cg_sim_model_ptr_t& sm,
+                           const sim_param_t& param,
+                           std::size_t nsteps)
+{
+    real_t e0 = 0.0, ekin = 0.0, maxDeviation = 0.0;
+    for (std::size_t n = 0; n != nsteps; ++n) {
+        SimulationData data = sm->displace(param);
+        real_t e = data.ekin() + data.bepot() + data.nbepot();
+        if ( n == 0 ) {
+            e0 = e;
+        }
+        ekin += data.ekin();
+        maxDeviation = std::max(maxDeviation, std::fabs(e - e0));
+    }
+    ekin /= nsteps;
+    return maxDeviation / ekin;
+}
+
+/*
+ * RATTLE keeps CW-DP distances of polarizable water at their ideal value, and
+ * is rejected for force fields without a bond length.
+ */
+void test1() {
+    std::cout << "integrator-test test 1" << std::endl;
+    
+    sim_param_t param{};
+    param.add<real_t>("timestep", 0.002);
+    param.add<std::size_t>("npairlists", 10);
+    param.add<real_t>("temperature", 298.15);
+    param.add<std::uint64_t>("seed", 7);
+    param.add<std::string>("constraints", conf::RATTLE);
+    
+    spec_catalog_ptr_t catalog = test::catalog();
+    box_ptr_t box = factory::cube(length_t{2.5});
+    cg_ptr_t cg = factory::particleModelFactory(catalog)->polarizableWater(box);
+    
+    for (auto displacerId : {conf::VELOCITY_VERLET, conf::LANGEVIN_VELOCITY_VERLET}) {
+        auto sm = test::simulationModel(cg, conf::POLARIZABLE_WATER, displacerId, catalog, box);
+        for (std::size_t n = 0; n != 100; ++n) {
+            sm->displace(param);
+        }
+        
+        real_t d = CoarseGrainedPolarizableWater::idealDistanceCWDP()();
+        real_t maxError = 0.0;
+        cg->doWithAllFreeGroups<void>([d, &maxError] (const std::vector<bead_ptr_t>& all,
+                                                      const std::vector<bead_ptr_t>& free,
+                                                      const std::vector<bead_group_ptr_t>& groups) {
+            for (const auto& group : groups) {
+                for (const auto& bond : group->bonds()) {
+                    dist_vect_t rij = 
+                        bond.getParticleOne()->position() - bond.getParticleTwo()->position();
+                    real_t error = std::fabs(norm<real_t>(rij) - d) / d;
+                    maxError = std::max(maxError, error);
+                }
+            }
+        });
+        std::cout << displacerId << ": Largest relative bond length error: " 
+                  << maxError << std::endl;
+        if ( maxError > 1.0e-05 ) {
+            std::cout << "%TEST_FAILED% time=0 testname=test1 (integrator-test) "
+                      << "message=" << displacerId << ": Bond lengths not constrained." 
+                      << std::endl;
+        }
+    }
+    
+    // A force field without bonds defines no bond length to constrain.
+    box_ptr_t ljBox = factory::cube(length_t{2.0});
+    cg_ptr_t lj = factory::particleModelFactory(catalog)->ljFluid(ljBox);
+    for (auto displacerId : {conf::VELOCITY_VERLET, conf::LANGEVIN_VELOCITY_VERLET}) {
+        auto sm = test::simulationModel(lj, conf::LJ_FLUID, displacerId, catalog, ljBox);
+        bool failed = false;
+        try {
+            sm->displace(param);
+        } catch (std::domain_error& exception) {
+            failed = true;
+        }
+        if ( !failed ) {
+            std::cout << "%TEST_FAILED% time=0 testname=test1 (integrator-test) "
+                      << "message=" << displacerId << ": Constraints accepted without bond length." 
+                      << std::endl;
+        }
+    }
+}
+
+/*
+ * Without friction, BAOAB reduces to velocity Verlet and conserves total energy.
+ */
+void test2() {
+    std::cout << "integrator-test test 2" << std::endl;
+    
+    sim_param_t param{};
+    param.add<real_t>("timestep", 0.002);
+    param.add<std::size_t>("npairlists", 10);
+    param.add<real_t>("temperature", 298.15);
+    param.add<std::uint64_t>("seed", 7);
+    
+    spec_catalog_ptr_t catalog = test::catalog();
+    box_ptr_t box = factory::cube(length_t{3.0});
+    cg_ptr_t cg = factory::particleModelFactory(catalog)->ljFluid(box);
+    equilibrate_(cg, conf::LJ_FLUID, catalog, box, param);
+    
+    param.put<real_t>("gamma", 0.0);
+    auto sm = test::simulationModel(cg, conf::LJ_FLUID, conf::BAOAB, catalog, box);
+    real_t drift = energyDrift_(sm, param, 500);
+    std::cout << "BAOAB: Relative energy drift: " << drift << std::endl;
+    if ( drift > 0.02 ) {
+        std::cout << "%TEST_FAILED% time=0 testname=test2 (integrator-test) "
+                  << "message=BAOAB does not conserve energy without friction." 
+                  << std::endl;
+    }
+}
+
+/*
+ * RESPA conserves total energy, with bonded forces of polarizable water 
+ * evaluated in the inner steps.
+ */
+void test3() {
+    std::cout << "integrator-test test 3" << std::endl;
+    
+    sim_param_t param{};
+    param.add<real_t>("timestep", 0.001);
+    param.add<std::size_t>("npairlists", 10);
+    param.add<real_t>("temperature", 298.15);
+    param.add<std::uint64_t>("seed", 7);
+    
+    spec_catalog_ptr_t catalog = test::catalog();
+    box_ptr_t box = factory::cube(length_t{2.5});
+    cg_ptr_t cg = factory::particleModelFactory(catalog)->polarizableWater(box);
+    equilibrate_(cg, conf::POLARIZABLE_WATER, catalog, box, param);
+    
+    param.put<real_t>("timestep", 0.004);
+    param.put<std::size_t>("ninner", 4);
+    auto sm = test::simulationModel(cg, conf::POLARIZABLE_WATER, conf::RESPA, catalog, box);
+    real_t drift = energyDrift_(sm, param, 500);
+    std::cout << "RESPA: Relative energy drift: " << drift << std::endl;
+    if ( drift > 0.02 ) {
+        std::cout << "%TEST_FAILED% time=0 testname=test3 (integrator-test) "
+                  << "message=RESPA does not conserve energy." 
+                  << std::endl;
+    }
+}
+
+/*
+ * For a freely rotating rigid dimer, the virial of the constraint forces 
+ * balances the kinetic energy, trace(W) = -2 Ekin.
+ */
+void test4() {
+    std::cout << "integrator-test test 4" << std::endl;
+    
+    spec_catalog_ptr_t catalog = test::catalog();
+    auto cwSpec = catalog->lookup("CW");
+    auto dpSpec = catalog->lookup("DP");
+    length_t d = CoarseGrainedPolarizableWater::idealDistanceCWDP();
+    
+    cg_ptr_t cg = std::make_shared<CoarseGrained>();
+    auto cw = cg->addBead(1, "CW", position_t{1.0, 1.0, 1.0}, cwSpec, false);
+    auto dp = cg->addBead(2, "DP", position_t{1.0 + d(), 1.0, 1.0}, dpSpec, false);
+    cg->addBeadGroup({cw, dp}, {std::make_pair<int, int>(1, 2)});
+    
+    // Rotation around the center of mass, relative velocity u.
+    real_t u = 1.0;
+    real_t m1 = cwSpec->mass()();
+    real_t m2 = dpSpec->mass()();
+    cw->velocity(velocity_t{0.0, u * m2 / (m1 + m2), 0.0});
+    dp->velocity(velocity_t{0.0, -u * m1 / (m1 + m2), 0.0});
+    
+    // Velocity Verlet without forces.
+    Rattle<Bead> rattle{d};
+    stime_t dt{0.002};
+    real_t maxError = 0.0;
+    cg->doWithAllFreeGroups<void>([&] (const std::vector<bead_ptr_t>& all,
+                                       const std::vector<bead_ptr_t>& free,
+                                       const std::vector<bead_group_ptr_t>& groups) {
+        for (std::size_t n = 0; n != 100; ++n) {
+            rattle.reference(all);
+            for (const auto& bead : all) {
+                position_t r = bead->position();
+                velocity_t v = bead->velocity();
+                for (std::size_t k = 0; k != 3; ++k) {
+                    r[k] += dt() * v[k];
+                }
+                bead->position(r);
+            }
+            auto drs = rattle.constrainPositions(all, groups);
+            for (const auto& bead : all) {
+                velocity_t v = bead->velocity();
+                for (std::size_t k = 0; k != 3; ++k) {
+                    v[k] += drs[bead->index()][k] / dt();
+                }
+                bead->velocity(v);
+            }
+            virial_t virial = rattle.constrainVelocities(groups, dt);
+            real_t ekin = 0.0;
+            for (const auto& bead : all) {
+                ekin += 0.5 * bead->mass()() * inner<real_t>(bead->velocity(), bead->velocity());
+            }
+            real_t trace = virial[0][0] + virial[1][1] + virial[2][2];
+            maxError = std::max(maxError, std::fabs(trace + 2.0 * ekin) / (2.0 * ekin));
+        }
+    });
+    std::cout << "Largest relative error in constraint virial: " << maxError << std::endl;
+    if ( maxError > 0.01 ) {
+        std::cout << "%TEST_FAILED% time=0 testname=test4 (integrator-test) "
+                  << "message=Constraint virial does not balance kinetic energy." 
+                  << std::endl;
+    }
+}
+
+/*
+ * An adaptive time step keeps displacements below dxmax, stays within 
+ * [dtmin, dtmax], and accumulates the simulation time from the time steps taken.
+ * Also for BAOAB. Leap-frog and RESPA are rejected.
+ */
+void test5() {
+    std::cout << "integrator-test test 5" << std::endl;
+    
+    sim_param_t param{};
+    param.add<real_t>("timestep", 0.002);
+    param.add<std::size_t>("npairlists", 10);
+    param.add<real_t>("temperature", 298.15);
+    param.add<std::uint64_t>("seed", 7);
+    
+    spec_catalog_ptr_t catalog = test::catalog();
+    box_ptr_t box = factory::cube(length_t{3.0});
+    cg_ptr_t cg = factory::particleModelFactory(catalog)->ljFluid(box);
+    equilibrate_(cg, conf::LJ_FLUID, catalog, box, param);
+    
+    real_t dxmax = 0.002, dtmin = 0.0002, dtmax = 0.008;
+    param.put<real_t>("dxmax", dxmax);
+    param.put<real_t>("dtmin", dtmin);
+    param.put<real_t>("dtmax", dtmax);
+    for (auto displacerId : {conf::VELOCITY_VERLET, conf::BAOAB}) {
+        auto sm = test::simulationModel(cg, 
+                                        conf::LJ_FLUID, 
+                                        conf::ADAPTIVE_TIMESTEP + "-" + displacerId, 
+                                        catalog, 
+                                        box);
+
+        std::vector<position_t> rs(cg->numberOfBeads(), position_t{});
+        real_t t = 0.0, maxDisplacement = 0.0, dtsmallest = dtmax, dtlargest = 0.0;
+        bool limited = true;
+        for (std::size_t n = 0; n != 200; ++n) {
+            cg->doWithAll<void>([&rs] (const std::vector<bead_ptr_t>& beads) {
+                for (const auto& bead : beads) {
+                    rs[bead->index()] = bead->position();
+                }
+            });
+            SimulationData data = sm->displace(param);
+            real_t dx = cg->doWithAll<real_t>([&rs] (const std::vector<bead_ptr_t>& beads) {
+                real_t dx = 0.0;
+                for (const auto& bead : beads) {
+                    dx = std::max(dx, norm<real_t>(bead->position() - rs[bead->index()]));
+                }
+                return dx;
+            });
+            t += data.dt();
+            dtsmallest = std::min(dtsmallest, data.dt());
+            dtlargest = std::max(dtlargest, data.dt());
+            maxDisplacement = std::max(maxDisplacement, dx);
+
+            // The first step is taken with the initial time step. BAOAB adds
+            // a small random displacement, which is not predicted.
+            real_t tolerance = displacerId == conf::BAOAB ? 0.05 : 1.0e-06;
+            if ( n > 0 && dx > dxmax * (1.0 + tolerance) && data.dt() > dtmin ) {
+                limited = false;
+            }
+            if ( std::fabs(data.t() - t) > 1.0e-09 ) {
+                std::cout << "%TEST_FAILED% time=0 testname=test5 (integrator-test) "
+                          << "message=Time is not the sum of time steps." << std::endl;
+                break;
+            }
+        }
+        std::cout << displacerId << ": Time step range: " 
+                  << dtsmallest << " " << dtlargest << std::endl;
+        std::cout << displacerId << ": Largest displacement: " << maxDisplacement << std::endl;
+        if ( !limited ) {
+            std::cout << "%TEST_FAILED% time=0 testname=test5 (integrator-test) "
+                      << "message=Displacement exceeds dxmax." << std::endl;
+        }
+        if ( dtsmallest < dtmin || dtlargest > dtmax ) {
+            std::cout << "%TEST_FAILED% time=0 testname=test5 (integrator-test) "
+                      << "message=Time step out of range." << std::endl;
+        }
+    }
+    
+    for (auto displacerId : {conf::LEAP_FROG, conf::RESPA}) {
+        try {
+            test::simulationModel(cg, 
+                                  conf::LJ_FLUID, 
+                                  conf::ADAPTIVE_TIMESTEP + "-" + displacerId, 
+                                  catalog, 
+                                  box);
+            std::cout << "%TEST_FAILED% time=0 testname=test5 (integrator-test) "
+                      << "message=Adaptive " << displacerId << " is accepted." << std::endl;
+        } catch (std::domain_error& exception) {
+            std::cout << "Expected: " << exception.what() << std::endl;
+        }
+    }
+}
+
+/*
+ * With friction, BAOAB samples the same canonical ensemble as Langevin velocity 
+ * Verlet. At a small time step, average kinetic and potential energies of the 
+ * LJ fluid must agree.
+ */
+void test6() {
+    std::cout << "integrator-test test 6" << std::endl;
+    
+    sim_param_t param{};
+    param.add<real_t>("timestep", 0.002);
+    param.add<std::size_t>("npairlists", 10);
+    param.add<real_t>("temperature", 298.15);
+    param.add<std::uint64_t>("seed", 7);
+    
+    spec_catalog_ptr_t catalog = test::catalog();
+    box_ptr_t box = factory::cube(length_t{3.0});
+    cg_ptr_t cg = factory::particleModelFactory(catalog)->ljFluid(box);
+    equilibrate_(cg, conf::LJ_FLUID, catalog, box, param);
+    
+    param.put<real_t>("timestep", 0.001);
+    param.put<real_t>("gamma", 5.0);
+    std::size_t nequilibrate = 1000, nsteps = 20000;
+    std::vector<std::pair<real_t, real_t>> averages{};
+    for (auto displacerId : {conf::LANGEVIN_VELOCITY_VERLET, conf::BAOAB}) {
+        auto sm = test::simulationModel(cg, conf::LJ_FLUID, displacerId, catalog, box);
+        real_t ekin = 0.0, epot = 0.0;
+        for (std::size_t n = 0; n != nequilibrate + nsteps; ++n) {
+            SimulationData data = sm->displace(param);
+            if ( n >= nequilibrate ) {
+                ekin += data.ekin();
+                epot += data.bepot() + data.nbepot();
+            }
+        }
+        ekin /= nsteps;
+        epot /= nsteps;
+        std::cout << displacerId << ": Average kinetic and potential energy: " 
+                  << ekin << " " << epot << std::endl;
+        averages.push_back(std::make_pair(ekin, epot));
+    }
+    
+    // Differences relative to the average kinetic energy. The average potential
+    // energy converges more slowly.
+    real_t ekin = averages[0].first;
+    real_t dekin = std::fabs(averages[1].first - averages[0].first) / ekin;
+    real_t depot = std::fabs(averages[1].second - averages[0].second) / ekin;
+    std::cout << "Relative differences: " << dekin << " " << depot << std::endl;
+    if ( dekin > 0.02 || depot > 0.05 ) {
+        std::cout << "%TEST_FAILED% time=0 testname=test6 (integrator-test) "
+                  << "message=BAOAB and LVV sample different energies with friction." 
+                  << std::endl;
+    }
+}
+
+int main(int argc, char** argv) {
+    std::cout << "%SUITE_STARTING% integrator-test" << std::endl;
+    std::cout << "%SUITE_STARTED%" << std::endl;
+
+    std::cout << "%TEST_STARTED% test1 (integrator-test)" << std::endl;
+    test1();
+    std::cout << "%TEST_FINISHED% time=0 test1 (integrator-test)" << std::endl;
+
+    std::cout << "%TEST_STARTED% test2 (integrator-test)" << std::endl;
+    test2();
+    std::cout << "%TEST_FINISHED% time=0 test2 (integrator-test)" << std::endl;
+
+    std::cout << "%TEST_STARTED% test3 (integrator-test)" << std::endl;
+    test3();
+    std::cout << "%TEST_FINISHED% time=0 test3 (integrator-test)" << std::endl;
+
+    std::cout << "%TEST_STARTED% test4 (integrator-test)" << std::endl;
+    test4();
+    std::cout << "%TEST_FINISHED% time=0 test4 (integrator-test)" << std::endl;
+
+    std::cout << "%TEST_STARTED% test5 (integrator-test)" << std::endl;
+    test5();
+    std::cout << "%TEST_FINISHED% time=0 test5 (integrator-test)" << std::endl;
+
+    std::cout << "%TEST_STARTED% test6 (integrator-test)" << std::endl;
+    test6();
+    std::cout << "%TEST_FINISHED% time=0 test6 (integrator-test)" << std::endl;
+
+    std::cout << "%SUITE_FINISHED% time=0" << std::endl;
+    
+    return (EXIT_SUCCESS);
+}
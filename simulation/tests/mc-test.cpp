@@ -0,0 +1,488 @@
+/*
+ * The MIT License
+ *
+ * Copyright 2019 André H. Juffer, Biocenter Oulu
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ */
+
+
+/* 
+ * File:   mc-test.cpp
+ * Author: ajuffer
+ *
+ * Created on November 25, 2019, 9:30 AM
+ */
+
+#include "simploce/simulation/mc.hpp"
+#include "simploce/simulation/hmc.hpp"
+#include "simploce/simulation/neighbor-grid.hpp"
+#include "simploce/simulation/sim-model.hpp"
+#include "simploce/simulation/sim-data.hpp"
+#include "simploce/simulation/sim-util.hpp"
+#include "simploce/simulation/sfactory.hpp"
+#include "simploce/simulation/pbc.hpp"
+#include "simploce/simulation/sconf.hpp"
+#include "simploce/simulation/stypes.hpp"
+#include "simploce/particle/bead.hpp"
+#include "simploce/particle/coarse-grained.hpp"
+#include "simploce/particle/particle-group.hpp"
+#include "simploce/particle/particle-spec-catalog.hpp"
+#include "simploce/particle/particle-model-factory.hpp"
+#include "simploce/util/param.hpp"
+#include "simploce/util/mu-units.hpp"
+#include "test-models.hpp"
+#include <algorithm>
+#include <sstream>
+#include <fstream>
+#include <cstdio>
+#include <cstdlib>
+#include <cmath>
+#include <thread>
+#include <iostream>
+
+using namespace simploce;
+using namespace simploce::param;
+
+/*
+ * Simple C++ Test Suite
+ */
+
+/*
+ * With cells of the cutoff distance, energies of beads with their grid 
+ * neighbors equal energies with all other particles.
+ */
+void test1() {
+    std::cout << "mc-test test 1" << std::endl;
+    
+    sim_param_t param{};
+    param.add<std::size_t>("npairlists", 10);
+    
+    spec_catalog_ptr_t catalog = test::catalog();
+    box_ptr_t box = factory::cube(length_t{2.5});
+    cg_ptr_t cg = factory::particleModelFactory(catalog)->polarizableWater(box);
+    auto sm = 
+        test::simulationModel(cg, conf::POLARIZABLE_WATER, conf::VELOCITY_VERLET, catalog, box);
+    sm->interact(param);
+    
+    NeighborGrid<Bead> grid{box, util::cutoffDistance(box)};
+    real_t maxError = 0.0;
+    cg->doWithAllFreeGroups<void>([&] (const std::vector<bead_ptr_t>& all,
+                                       const std::vector<bead_ptr_t>& free,
+                                       const std::vector<bead_group_ptr_t>& groups) {
+        grid.place(all, free, groups);
+        for (const auto& bead : all) {
+            std::vector<bead_ptr_t> nfree{};
+            std::vector<bead_group_ptr_t> ngroups{};
+            grid.neighbors(bead, nfree, ngroups);
+            SimulationData local = sm->interact(bead, nfree, ngroups, param);
+            SimulationData full = sm->interact(bead, param);
+            real_t elocal = local.bepot() + local.nbepot();
+            real_t efull = full.bepot() + full.nbepot();
+            maxError = std::max(maxError, std::fabs(elocal - efull));
+        }
+    });
+    std::cout << "Largest energy difference: " << maxError << std::endl;
+    if ( maxError > 1.0e-09 ) {
+        std::cout << "%TEST_FAILED% time=0 testname=test1 (mc-test) "
+                  << "message=Local energy differs from full evaluation." << std::endl;
+    }
+}
+
+/*
+ * Cells smaller than the cutoff distance still hold all particles within 
+ * their side length as neighbors.
+ */
+void test2() {
+    std::cout << "mc-test test 2" << std::endl;
+    
+    spec_catalog_ptr_t catalog = test::catalog();
+    box_ptr_t box = factory::cube(length_t{6.0});
+    bc_ptr_t bc = std::make_shared<PeriodicBoundaryCondition>(box);
+    cg_ptr_t cg = factory::particleModelFactory(catalog)->ljFluid(box);
+    
+    length_t rgrid{1.0};
+    NeighborGrid<Bead> grid{box, rgrid};
+    std::size_t missing = 0, nneighbors = 0, npairs = 0;
+    cg->doWithAllFreeGroups<void>([&] (const std::vector<bead_ptr_t>& all,
+                                       const std::vector<bead_ptr_t>& free,
+                                       const std::vector<bead_group_ptr_t>& groups) {
+        grid.place(all, free, groups);
+        for (const auto& bead : free) {
+            std::vector<bead_ptr_t> nfree{};
+            std::vector<bead_group_ptr_t> ngroups{};
+            grid.neighbors(bead, nfree, ngroups);
+            nneighbors += nfree.size();
+            for (const auto& other : free) {
+                dist_vect_t rij = bc->apply(bead->position(), other->position());
+                if ( norm<real_t>(rij) < rgrid() ) {
+                    npairs += 1;
+                    if ( std::find(nfree.begin(), nfree.end(), other) == nfree.end() ) {
+                        missing += 1;
+                    }
+                }
+            }
+        }
+        std::cout << "Average number of neighbors: " 
+                  << real_t(nneighbors) / free.size() << " of " << free.size() << std::endl;
+    });
+    if ( npairs == 0 || missing > 0 ) {
+        std::cout << "%TEST_FAILED% time=0 testname=test2 (mc-test) "
+                  << "message=Neighbors within grid cell size are missing." << std::endl;
+    }
+}
+
+/*
+ * Checkerboard sweeps are reproducible although cells of one color are handled
+ * concurrently, and the accumulated energy changes agree with full evaluations.
+ */
+void test3() {
+    std::cout << "mc-test test 3" << std::endl;
+    
+    sim_param_t param{};
+    param.add<std::size_t>("npairlists", 10);
+    param.add<std::size_t>("nsteps", 5);
+    param.add<std::size_t>("nwrite", 5);
+    param.add<real_t>("temperature", 298.15);
+    param.add<std::uint64_t>("seed", 7);
+    param.add<bool>("checkerboard", true);
+    param.add<real_t>("cutoff", 2.5);
+    
+    spec_catalog_ptr_t catalog = test::catalog();
+    box_ptr_t box = factory::cube(length_t{6.0});
+    std::stringstream initial;
+    factory::particleModelFactory(catalog)->ljFluid(box)->write(initial);
+    
+    std::vector<std::vector<position_t>> rss{};
+    for (std::size_t n = 0; n != 2; ++n) {
+        std::stringstream stream{initial.str()};
+        cg_ptr_t cg = CoarseGrained::readFrom(stream, catalog);
+        auto sm = test::simulationModel(cg, conf::LJ_FLUID, conf::VELOCITY_VERLET, catalog, box);
+        SimulationData data = sm->interact(param);
+        real_t e0 = data.bepot() + data.nbepot();
+        
+        std::ofstream trajStream{"mc-test.trj"}, dataStream{"mc-test.dat"};
+        MC<Bead> mc{sm};
+        mc.perform(param, trajStream, dataStream);
+        trajStream.close();
+        dataStream.close();
+        
+        // Last line holds the accumulated energy changes.
+        std::ifstream input{"mc-test.dat"};
+        std::size_t step;
+        real_t t, ekin, bepot, nbepot;
+        input >> step >> t >> ekin >> bepot >> nbepot;
+        data = sm->interact(param);
+        real_t de = data.bepot() + data.nbepot() - e0;
+        std::cout << "Energy change, accumulated and full: " 
+                  << bepot + nbepot << " " << de << std::endl;
+        if ( std::fabs(bepot + nbepot - de) > 0.01 * std::fabs(de) ) {
+            std::cout << "%TEST_FAILED% time=0 testname=test3 (mc-test) "
+                      << "message=Accumulated energy changes are wrong." << std::endl;
+        }
+        
+        std::vector<position_t> rs{};
+        cg->doWithAll<void>([&rs] (const std::vector<bead_ptr_t>& beads) {
+            for (const auto& bead : beads) {
+                rs.push_back(bead->position());
+            }
+        });
+        rss.push_back(rs);
+    }
+    std::remove("mc-test.trj");
+    std::remove("mc-test.dat");
+    
+    if ( rss[0] != rss[1] ) {
+        std::cout << "%TEST_FAILED% time=0 testname=test3 (mc-test) "
+                  << "message=Checkerboard sweeps are not reproducible." << std::endl;
+    }
+}
+
+/*
+ * With a tiny time step, hybrid Monte Carlo trajectories conserve energy and 
+ * nearly all are accepted. The original displacer is restored afterwards, also 
+ * if the simulation fails.
+ */
+void test4() {
+    std::cout << "mc-test test 4" << std::endl;
+    
+    sim_param_t param{};
+    param.add<std::size_t>("npairlists", 10);
+    param.add<std::size_t>("nsteps", 20);
+    param.add<std::size_t>("nwrite", 20);
+    param.add<std::size_t>("nmd", 10);
+    param.add<real_t>("timestep", 0.0001);
+    param.add<real_t>("temperature", 298.15);
+    param.add<std::uint64_t>("seed", 7);
+    
+    // An odd number of lattice sites per edge, so that no pair of the initial 
+    // lattice is at the cutoff distance.
+    spec_catalog_ptr_t catalog = test::catalog();
+    box_ptr_t box = factory::cube(length_t{3.5});
+    cg_ptr_t cg = factory::particleModelFactory(catalog)->ljFluid(box);
+    auto sm = test::simulationModel(cg, conf::LJ_FLUID, conf::VELOCITY_VERLET, catalog, box);
+    auto displacer = sm->displacer();
+    
+    std::ofstream trajStream{"mc-test.trj"}, dataStream{"mc-test.dat"};
+    HMC<Bead> hmc{sm};
+    hmc.perform(param, trajStream, dataStream);
+    trajStream.close();
+    dataStream.close();
+    if ( sm->displacer() != displacer ) {
+        std::cout << "%TEST_FAILED% time=0 testname=test4 (mc-test) "
+                  << "message=Displacer not restored." << std::endl;
+    }
+    
+    std::ifstream input{"mc-test.dat"};
+    std::size_t step, npairs;
+    real_t t, ekin, bepot, nbepot, etot, temperature, pressure, ratio;
+    bool accepted;
+    input >> step >> t >> ekin >> bepot >> nbepot >> etot >> temperature >> pressure 
+          >> npairs >> accepted >> ratio;
+    std::cout << "Acceptance ratio (%): " << ratio << std::endl;
+    if ( ratio < 95.0 ) {
+        std::cout << "%TEST_FAILED% time=0 testname=test4 (mc-test) "
+                  << "message=Acceptance ratio too low for tiny time step." << std::endl;
+    }
+    
+    // One trajectory, continued from the final state.
+    real_t kT = MUUnits<real_t>::KB * 298.15;
+    auto vv = test::simulationModel(cg, conf::LJ_FLUID, conf::VELOCITY_VERLET, catalog, box);
+    SimulationData data = vv->displace(param);
+    real_t h0 = data.ekin() + data.bepot() + data.nbepot();
+    for (std::size_t n = 1; n != 10; ++n) {
+        data = vv->displace(param);
+    }
+    real_t h1 = data.ekin() + data.bepot() + data.nbepot();
+    std::cout << "Energy change over trajectory (kT): " << (h1 - h0) / kT << std::endl;
+    if ( std::fabs(h1 - h0) > 0.1 * kT ) {
+        std::cout << "%TEST_FAILED% time=0 testname=test4 (mc-test) "
+                  << "message=Trajectory does not conserve energy." << std::endl;
+    }
+    
+    // Failure, here due to an unknown trajectory format.
+    param.put<std::string>("trajectory", "unknown");
+    bool failed = false;
+    try {
+        trajStream.open("mc-test.trj");
+        dataStream.open("mc-test.dat");
+        hmc.perform(param, trajStream, dataStream);
+    } catch (std::exception& exception) {
+        failed = true;
+    }
+    trajStream.close();
+    dataStream.close();
+    std::remove("mc-test.trj");
+    std::remove("mc-test.dat");
+    if ( !failed || sm->displacer() != displacer ) {
+        std::cout << "%TEST_FAILED% time=0 testname=test4 (mc-test) "
+                  << "message=Displacer not restored after failure." << std::endl;
+    }
+}
+
+/*
+ * With a cutoff distance well below half the box size, neighbors are found in 
+ * a grid of more than 27 cells in a large box, and the accumulated energy 
+ * changes agree with full evaluations.
+ */
+void test5() {
+    std::cout << "mc-test test 5" << std::endl;
+    
+    sim_param_t param{};
+    param.add<std::size_t>("npairlists", 1);
+    param.add<std::size_t>("nsteps", 2000);
+    param.add<std::size_t>("nwrite", 2000);
+    param.add<std::uint64_t>("seed", 7);
+    param.add<real_t>("cutoff", 2.5);
+    
+    spec_catalog_ptr_t catalog = test::catalog();
+    box_ptr_t box = factory::cube(length_t{11.0});
+    cg_ptr_t cg = factory::particleModelFactory(catalog)->ljFluid(box);
+    auto sm = test::simulationModel(cg, conf::LJ_FLUID, conf::VELOCITY_VERLET, catalog, box);
+    SimulationData data = sm->interact(param);
+    real_t e0 = data.bepot() + data.nbepot();
+    
+    std::ofstream trajStream{"mc-test.trj"}, dataStream{"mc-test.dat"};
+    MC<Bead> mc{sm};
+    mc.perform(param, trajStream, dataStream);
+    trajStream.close();
+    dataStream.close();
+    std::cout << "Number of grid cells: " << mc.numberOfCells() << std::endl;
+    if ( mc.numberOfCells() <= 27 ) {
+        std::cout << "%TEST_FAILED% time=0 testname=test5 (mc-test) "
+                  << "message=Every grid cell is a neighbor of every other cell." << std::endl;
+    }
+    
+    std::ifstream input{"mc-test.dat"};
+    std::size_t step;
+    real_t t, ekin, bepot, nbepot;
+    input >> step >> t >> ekin >> bepot >> nbepot;
+    input.close();
+    std::remove("mc-test.trj");
+    std::remove("mc-test.dat");
+    data = sm->interact(param);
+    real_t de = data.bepot() + data.nbepot() - e0;
+    std::cout << "Energy change, accumulated and full: " 
+              << bepot + nbepot << " " << de << std::endl;
+    if ( de == 0.0 || std::fabs(bepot + nbepot - de) > 1.0e-06 * std::fabs(e0) ) {
+        std::cout << "%TEST_FAILED% time=0 testname=test5 (mc-test) "
+                  << "message=Accumulated energy changes are wrong." << std::endl;
+    }
+}
+
+/*
+ * With a cutoff distance well below half the box size, checkerboard sweeps in 
+ * a large box use more than one cell per color, and these are displaced 
+ * concurrently if the hardware supports it. The accumulated energy changes 
+ * agree with full evaluations.
+ */
+void test6() {
+    std::cout << "mc-test test 6" << std::endl;
+    
+    sim_param_t param{};
+    param.add<std::size_t>("npairlists", 1);
+    param.add<std::size_t>("nsteps", 1);
+    param.add<std::size_t>("nwrite", 1);
+    param.add<std::uint64_t>("seed", 7);
+    param.add<bool>("checkerboard", true);
+    param.add<real_t>("cutoff", 2.5);
+    
+    spec_catalog_ptr_t catalog = test::catalog();
+    box_ptr_t box = factory::cube(length_t{11.0});
+    cg_ptr_t cg = factory::particleModelFactory(catalog)->ljFluid(box);
+    auto sm = test::simulationModel(cg, conf::LJ_FLUID, conf::VELOCITY_VERLET, catalog, box);
+    SimulationData data = sm->interact(param);
+    real_t e0 = data.bepot() + data.nbepot();
+    
+    std::ofstream trajStream{"mc-test.trj"}, dataStream{"mc-test.dat"};
+    MC<Bead> mc{sm};
+    mc.perform(param, trajStream, dataStream);
+    trajStream.close();
+    dataStream.close();
+    std::cout << "Number of cells, per color, concurrently: " << mc.numberOfCells() 
+              << " " << mc.cellsPerColor() << " " << mc.concurrentCells() << std::endl;
+    if ( mc.cellsPerColor() < 2 ) {
+        std::cout << "%TEST_FAILED% time=0 testname=test6 (mc-test) "
+                  << "message=One cell per color." << std::endl;
+    }
+    if ( std::thread::hardware_concurrency() > 1 && mc.concurrentCells() < 2 ) {
+        std::cout << "%TEST_FAILED% time=0 testname=test6 (mc-test) "
+                  << "message=Cells of one color are not displaced concurrently." << std::endl;
+    }
+    
+    std::ifstream input{"mc-test.dat"};
+    std::size_t step;
+    real_t t, ekin, bepot, nbepot;
+    input >> step >> t >> ekin >> bepot >> nbepot;
+    input.close();
+    std::remove("mc-test.trj");
+    std::remove("mc-test.dat");
+    data = sm->interact(param);
+    real_t de = data.bepot() + data.nbepot() - e0;
+    std::cout << "Energy change, accumulated and full: " 
+              << bepot + nbepot << " " << de << std::endl;
+    if ( de == 0.0 || std::fabs(bepot + nbepot - de) > 1.0e-06 * std::fabs(e0) ) {
+        std::cout << "%TEST_FAILED% time=0 testname=test6 (mc-test) "
+                  << "message=Accumulated energy changes are wrong." << std::endl;
+    }
+}
+
+/*
+ * Monte Carlo of polarizable water, with translations of single beads, and 
+ * translations and rotations of water groups. Accumulated energy changes equal
+ * the change in the full energy.
+ */
+void test7() {
+    std::cout << "mc-test test 7" << std::endl;
+    
+    sim_param_t param{};
+    param.add<std::size_t>("npairlists", 1);
+    param.add<std::size_t>("nsteps", 2000);
+    param.add<std::size_t>("nwrite", 2000);
+    param.add<std::uint64_t>("seed", 7);
+    param.add<std::string>("mcmoves", 
+                           conf::MC_TRANSLATE + "," + conf::MC_GROUP_TRANSLATE + "," + conf::MC_GROUP_ROTATE);
+    
+    spec_catalog_ptr_t catalog = test::catalog();
+    box_ptr_t box = factory::cube(length_t{5.0});
+    cg_ptr_t cg = factory::particleModelFactory(catalog)->polarizableWater(box);
+    auto sm = 
+        test::simulationModel(cg, conf::POLARIZABLE_WATER, conf::VELOCITY_VERLET, catalog, box);
+    SimulationData data = sm->interact(param);
+    real_t e0 = data.bepot() + data.nbepot();
+    
+    std::ofstream trajStream{"mc-test.trj"}, dataStream{"mc-test.dat"};
+    MC<Bead> mc{sm};
+    mc.perform(param, trajStream, dataStream);
+    trajStream.close();
+    dataStream.close();
+    
+    std::ifstream input{"mc-test.dat"};
+    std::size_t step;
+    real_t t, ekin, bepot, nbepot;
+    input >> step >> t >> ekin >> bepot >> nbepot;
+    input.close();
+    std::remove("mc-test.trj");
+    std::remove("mc-test.dat");
+    data = sm->interact(param);
+    real_t de = data.bepot() + data.nbepot() - e0;
+    std::cout << "Energy change, accumulated and full: " 
+              << bepot + nbepot << " " << de << std::endl;
+    if ( de == 0.0 || std::fabs(bepot + nbepot - de) > 1.0e-06 * std::fabs(e0) ) {
+        std::cout << "%TEST_FAILED% time=0 testname=test7 (mc-test) "
+                  << "message=Accumulated energy changes are wrong." << std::endl;
+    }
+}
+
+int main(int argc, char** argv) {
+    std::cout << "%SUITE_STARTING% mc-test" << std::endl;
+    std::cout << "%SUITE_STARTED%" << std::endl;
+
+    std::cout << "%TEST_STARTED% test1 (mc-test)" << std::endl;
+    test1();
+    std::cout << "%TEST_FINISHED% time=0 test1 (mc-test)" << std::endl;
+
+    std::cout << "%TEST_STARTED% test2 (mc-test)" << std::endl;
+    test2();
+    std::cout << "%TEST_FINISHED% time=0 test2 (mc-test)" << std::endl;
+
+    std::cout << "%TEST_STARTED% test3 (mc-test)" << std::endl;
+    test3();
+    std::cout << "%TEST_FINISHED% time=0 test3 (mc-test)" << std::endl;
+
+    std::cout << "%TEST_STARTED% test4 (mc-test)" << std::endl;
+    test4();
+    std::cout << "%TEST_FINISHED% time=0 test4 (mc-test)" << std::endl;
+
+    std::cout << "%TEST_STARTED% test5 (mc-test)" << std::endl;
+    test5();
+    std::cout << "%TEST_FINISHED% time=0 test5 (mc-test)" << std::endl;
+
+    std::cout << "%TEST_STARTED% test6 (mc-test)" << std::endl;
+    test6();
+    std::cout << "%TEST_FINISHED% time=0 test6 (mc-test)" << std::endl;
+
+    std::cout << "%TEST_STARTED% test7 (mc-test)" << std::endl;
+    test7();
+    std::cout << "%TEST_FINISHED% time=0 test7 (mc-test)" << std::endl;
+
+    std::cout << "%SUITE_FINISHED% time=0" << std::endl;
+    
+    return (EXIT_SUCCESS);
+}
@@ -0,0 +1,163 @@
+/*
+ * The MIT License
+ *
+ * Copyright 2019 André H. Juffer, Biocenter Oulu
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ */
+
+
+/* 
+ * File:   minimizer-test.cpp
+ * Author: ajuffer
+ *
+ * Created on November 24, 2019, 2:40 PM
+ */
+
+#include "simploce/simulation/minimizer.hpp"
+#include "simploce/simulation/sim-model.hpp"
+#include "simploce/simulation/sim-data.hpp"
+#include "simploce/simulation/sfactory.hpp"
+#include "simploce/simulation/pbc.hpp"
+#include "simploce/simulation/sconf.hpp"
+#include "simploce/simulation/stypes.hpp"
+#include "simploce/particle/bead.hpp"
+#include "simploce/particle/coarse-grained.hpp"
+#include "simploce/particle/particle-spec-catalog.hpp"
+#include "simploce/particle/particle-model-factory.hpp"
+#include "simploce/util/param.hpp"
+#include "test-models.hpp"
+#include <cstdlib>
+#include <iostream>
+
+using namespace simploce;
+using namespace simploce::param;
+
+/*
+ * Simple C++ Test Suite
+ */
+
+/*
+ * Returns polarizable water, with its own interactor.
+ */
+static cg_sim_model_ptr_t polarizableWater_()
+{
+    spec_catalog_ptr_t catalog = test::catalog();
+    box_ptr_t box = factory::cube(length_t{2.5});
+    cg_ptr_t cg = factory::particleModelFactory(catalog)->polarizableWater(box);
+    return test::simulationModel(cg, conf::POLARIZABLE_WATER, conf::VELOCITY_VERLET, catalog, box);
+}
+
+/*
+ * Both minimizers lower the potential energy.
+ */
+void test1() {
+    std::cout << "minimizer-test test 1" << std::endl;
+    
+    for (auto minimizer : {conf::FIRE, conf::STEEPEST_DESCENT}) {
+        sim_param_t param{};
+        param.add<std::size_t>("npairlists", 10);
+        param.add<std::string>("minimizer", minimizer);
+        param.add<std::size_t>("nminsteps", 100);
+        param.add<std::size_t>("nwrite", 100);
+        param.add<real_t>("fmax", 1.0);
+        
+        auto sm = polarizableWater_();
+        SimulationData data = sm->interact(param);
+        real_t e0 = data.bepot() + data.nbepot();
+        Minimizer<Bead> em{sm};
+        data = em.perform(param, std::cout);
+        real_t e1 = data.bepot() + data.nbepot();
+        std::cout << minimizer << ": Initial and final potential energy: " 
+                  << e0 << " " << e1 << std::endl;
+        if ( !(e1 < e0) ) {
+            std::cout << "%TEST_FAILED% time=0 testname=test1 (minimizer-test) "
+                      << "message=" << minimizer << ": Potential energy not lowered." 
+                      << std::endl;
+        }
+    }
+}
+
+/*
+ * The step size of steepest descent grows beyond its initial value, such that 
+ * a small initial step does not slow down minimization.
+ */
+void test2() {
+    std::cout << "minimizer-test test 2" << std::endl;
+    
+    sim_param_t param{};
+    param.add<std::size_t>("npairlists", 10);
+    param.add<std::string>("minimizer", conf::STEEPEST_DESCENT);
+    param.add<std::size_t>("nminsteps", 50);
+    param.add<std::size_t>("nwrite", 50);
+    param.add<real_t>("fmax", 1.0);
+    param.add<real_t>("emstep", 0.0001);
+    
+    auto sm = polarizableWater_();
+    std::vector<position_t> rs{};
+    sm->doWithAllFreeGroups<void>([&rs] (const std::vector<bead_ptr_t>& all,
+                                         const std::vector<bead_ptr_t>& free,
+                                         const std::vector<bead_group_ptr_t>& groups) {
+        for (const auto& bead : all) {
+            rs.push_back(bead->position());
+        }
+    });
+    
+    // Step size may grow.
+    Minimizer<Bead> em{sm};
+    SimulationData data = em.perform(param, std::cout);
+    real_t e1 = data.bepot() + data.nbepot();
+    
+    // Same start, step size fixed at its initial value.
+    sm->doWithAllFreeGroups<void>([&rs] (const std::vector<bead_ptr_t>& all,
+                                         const std::vector<bead_ptr_t>& free,
+                                         const std::vector<bead_group_ptr_t>& groups) {
+        for (const auto& bead : all) {
+            bead->position(rs[bead->index()]);
+        }
+    });
+    param.add<real_t>("emstepmax", 0.0001);
+    data = em.perform(param, std::cout);
+    real_t e2 = data.bepot() + data.nbepot();
+    
+    std::cout << "Potential energy, growing and fixed step size: " 
+              << e1 << " " << e2 << std::endl;
+    if ( !(e1 < e2) ) {
+        std::cout << "%TEST_FAILED% time=0 testname=test2 (minimizer-test) "
+                  << "message=Step size of steepest descent does not grow." 
+                  << std::endl;
+    }
+}
+
+int main(int argc, char** argv) {
+    std::cout << "%SUITE_STARTING% minimizer-test" << std::endl;
+    std::cout << "%SUITE_STARTED%" << std::endl;
+
+    std::cout << "%TEST_STARTED% test1 (minimizer-test)" << std::endl;
+    test1();
+    std::cout << "%TEST_FINISHED% time=0 test1 (minimizer-test)" << std::endl;
+
+    std::cout << "%TEST_STARTED% test2 (minimizer-test)" << std::endl;
+    test2();
+    std::cout << "%TEST_FINISHED% time=0 test2 (minimizer-test)" << std::endl;
+
+    std::cout << "%SUITE_FINISHED% time=0" << std::endl;
+    
+    return (EXIT_SUCCESS);
+}
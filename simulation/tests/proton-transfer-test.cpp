@@ -0,0 +1,375 @@
+/*
+ * The MIT License
+ *
+ * Copyright 2019 André H. Juffer, Biocenter Oulu
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ */
+
+
+/* 
+ * File:   proton-transfer-test.cpp
+ * Author: ajuffer
+ *
+ * Created on November 2019
+ */
+
+#include "simploce/simulation/constant-rate-pt.hpp"
+#include "simploce/simulation/event-driven-pt.hpp"
+#include "simploce/simulation/sfactory.hpp"
+#include "simploce/simulation/sconf.hpp"
+#include "simploce/simulation/stypes.hpp"
+#include "simploce/particle/coarse-grained.hpp"
+#include "simploce/particle/continuous-protonatable-bead.hpp"
+#include "simploce/particle/particle-spec.hpp"
+#include "simploce/util/param.hpp"
+#include <stdexcept>
+#include <cstdlib>
+#include <iostream>
+#include <vector>
+#include <map>
+
+using namespace simploce;
+using namespace simploce::param;
+
+using prot_pair_list_t = ProtonTransfer::prot_pair_list_t;
+
+/*
+ * Pairs of continuous protonatables, one of which holds a proton. These may be
+ * preceded by other beads, so that bead indices exceed the number of 
+ * protonatables.
+ */
+static cg_ptr_t pairs_(std::size_t npairs, std::size_t nothers = 0)
+{
+    spec_ptr_t acid = ParticleSpec::create("HCOOH", 0.0, 46.0, 0.3, 3.75, true);
+    spec_ptr_t water = ParticleSpec::create("AP", 0.0, 72.0, 0.3);
+    cg_ptr_t cg = factory::coarseGrained();
+    for (std::size_t i = 0; i != nothers; ++i) {
+        cg->addBead(i + 1, "AP", position_t{0.5 * real_t(i), 1.0, 0.0}, water);
+    }
+    for (std::size_t i = 0; i != npairs; ++i) {
+        real_t x = 0.5 * real_t(i);
+        std::size_t id = nothers + 2 * i + 1;
+        cg->addContinuousProtonatableBead(id, "HCOOH", position_t{x, 0.0, 0.0}, 1, acid, true);
+        cg->addContinuousProtonatableBead(id + 1, "HCOOH", position_t{x, 0.3, 0.0}, 0, acid, true);
+    }
+    return cg;
+}
+
+static std::vector<cprot_bead_ptr_t> continuous_(const cg_ptr_t& cg)
+{
+    return cg->doWithProtBeads<std::vector<cprot_bead_ptr_t>>([] (const std::vector<dprot_bead_ptr_t>& discrete,
+                                                                  const std::vector<cprot_bead_ptr_t>& continuous) {
+        return continuous;
+    });
+}
+
+static prot_pair_list_t pairList_(const std::vector<cprot_bead_ptr_t>& continuous)
+{
+    prot_pair_list_t pairList{};
+    for (std::size_t i = 0; i + 1 < continuous.size(); i += 2) {
+        pairList.push_back(std::make_pair(continuous[i], continuous[i + 1]));
+    }
+    return pairList;
+}
+
+/*
+ * Runs proton transfer for nsteps steps, and returns the protonation states 
+ * after each step. Fails if a pair lost or gained a proton.
+ */
+static std::vector<std::size_t> transfer_(const std::string& method, 
+                                          std::size_t nsteps,
+                                          const std::string& testname)
+{
+    pt_displacer_ptr_t displacer = factory::protonTransferDisplacer(method);
+    cg_ptr_t cg = pairs_(20);
+    auto continuous = continuous_(cg);
+    auto pairList = pairList_(continuous);
+    for (const auto& p : continuous) {
+        // Away from the bounds, a transfer changes the state by about dt only.
+        p->state(0.5);
+    }
+    
+    sim_param_t param;
+    param.put<real_t>("timestep", 0.01);
+    param.put<std::uint64_t>("seed", 12345);
+    
+    std::vector<std::size_t> states{};
+    std::vector<ProtonationEvent> events{};
+    for (std::size_t step = 0; step != nsteps; ++step) {
+        displacer->transfer(param, continuous, pairList, events);
+        for (const auto& pair : pairList) {
+            std::size_t nprotons = pair.first->protonationState() + pair.second->protonationState();
+            if ( nprotons != 1 ) {
+                std::cout << "%TEST_FAILED% time=0 testname=" << testname << " (proton-transfer-test) "
+                          << "message=" << method << ": Proton not conserved." << std::endl;
+                return states;
+            }
+        }
+        for (const auto& p : continuous) {
+            states.push_back(p->protonationState());
+        }
+    }
+    return states;
+}
+
+/*
+ * The factory returns constant rate proton transfer by default, and 
+ * event-driven proton transfer on request.
+ */
+void test1() {
+    std::cout << "proton-transfer-test test 1" << std::endl;
+    
+    auto constantRate = factory::protonTransferDisplacer();
+    if ( !std::dynamic_pointer_cast<ConstantRateProtonTransfer>(constantRate) ||
+         std::dynamic_pointer_cast<EventDrivenProtonTransfer>(constantRate) ) {
+        std::cout << "%TEST_FAILED% time=0 testname=test1 (proton-transfer-test) "
+                  << "message=Default is not constant rate." << std::endl;
+    }
+    auto eventDriven = factory::protonTransferDisplacer(conf::PT_EVENT_DRIVEN);
+    if ( !std::dynamic_pointer_cast<EventDrivenProtonTransfer>(eventDriven) ) {
+        std::cout << "%TEST_FAILED% time=0 testname=test1 (proton-transfer-test) "
+                  << "message=Event-driven not selected." << std::endl;
+    }
+    bool failed = false;
+    try {
+        factory::protonTransferDisplacer("unknown");
+    } catch (std::domain_error& exception) {
+        failed = true;
+    }
+    if ( !failed ) {
+        std::cout << "%TEST_FAILED% time=0 testname=test1 (proton-transfer-test) "
+                  << "message=Unknown method accepted." << std::endl;
+    }
+}
+
+/*
+ * Both methods transfer protons, conserve protons per pair, and are 
+ * reproducible for a given seed.
+ */
+void test2() {
+    std::cout << "proton-transfer-test test 2" << std::endl;
+    
+    for (const auto& method : {conf::PT_CONSTANT_RATE, conf::PT_EVENT_DRIVEN}) {
+        auto states1 = transfer_(method, 500, "test2");
+        auto states2 = transfer_(method, 500, "test2");
+        
+        std::size_t ntransfers = 0;
+        for (std::size_t i = 40; i < states1.size(); ++i) {
+            if ( states1[i] != states1[i - 40] ) {
+                ntransfers += 1;
+            }
+        }
+        std::cout << method << ": Number of changes in protonation state: " 
+                  << ntransfers << std::endl;
+        if ( ntransfers == 0 ) {
+            std::cout << "%TEST_FAILED% time=0 testname=test2 (proton-transfer-test) "
+                      << "message=" << method << ": No proton transfers." << std::endl;
+        }
+        if ( states1 != states2 ) {
+            std::cout << "%TEST_FAILED% time=0 testname=test2 (proton-transfer-test) "
+                      << "message=" << method << ": Not reproducible." << std::endl;
+        }
+    }
+}
+
+/*
+ * Beads shared by many pairs: All pairs between a few beads, so that there are 
+ * more pairs than beads. Protons are conserved, and each pair gets its own 
+ * jumps.
+ */
+void test3() {
+    std::cout << "proton-transfer-test test 3" << std::endl;
+    
+    for (const auto& method : {conf::PT_CONSTANT_RATE, conf::PT_EVENT_DRIVEN}) {
+        pt_displacer_ptr_t displacer = factory::protonTransferDisplacer(method);
+        cg_ptr_t cg = pairs_(3);
+        auto continuous = continuous_(cg);
+        prot_pair_list_t pairList{};
+        for (std::size_t i = 0; i != continuous.size(); ++i) {
+            continuous[i]->state(0.5);
+            for (std::size_t j = i + 1; j != continuous.size(); ++j) {
+                pairList.push_back(std::make_pair(continuous[i], continuous[j]));
+            }
+        }
+
+        sim_param_t param;
+        param.put<real_t>("timestep", 0.01);
+        param.put<std::uint64_t>("seed", 2019);
+        
+        // Replaying the reported events must reproduce the protonation states,
+        // also if a bead changes more than once per transfer.
+        std::size_t nchanges = 0;
+        std::map<std::size_t, std::size_t> replayed{};
+        for (const auto& p : continuous) {
+            replayed[p->index()] = p->protonationState();
+        }
+        bool valid = true;
+        for (std::size_t step = 0; step != 500 && valid; ++step) {
+            std::vector<ProtonationEvent> events{};
+            displacer->transfer(param, continuous, pairList, events);
+            real_t t = real_t(step) * 0.01;
+            for (const auto& event : events) {
+                if ( replayed[event.index] != event.oldState || 
+                     event.t() < t - 1.0e-10 || event.t() >= real_t(step + 1) * 0.01 ) {
+                    valid = false;
+                }
+                t = event.t();
+                replayed[event.index] = event.newState;
+            }
+            nchanges += events.size();
+            std::size_t nprotons = 0;
+            for (const auto& p : continuous) {
+                nprotons += p->protonationState();
+                if ( replayed[p->index()] != p->protonationState() ) {
+                    valid = false;
+                }
+            }
+            if ( nprotons != 3 ) {
+                std::cout << "%TEST_FAILED% time=0 testname=test3 (proton-transfer-test) "
+                          << "message=" << method << ": Proton not conserved." << std::endl;
+                break;
+            }
+        }
+        if ( !valid ) {
+            std::cout << "%TEST_FAILED% time=0 testname=test3 (proton-transfer-test) "
+                      << "message=" << method << ": Events do not reproduce protonation states." 
+                      << std::endl;
+        }
+        std::cout << method << ": Number of changes in protonation state: " 
+                  << nchanges << std::endl;
+        if ( nchanges == 0 ) {
+            std::cout << "%TEST_FAILED% time=0 testname=test3 (proton-transfer-test) "
+                      << "message=" << method << ": No proton transfers." << std::endl;
+        }
+    }
+}
+
+/*
+ * Protonatables preceded by other beads, and a pair list regenerated with the 
+ * same number of pairs. Changes in protonation state must reach the beads that
+ * transferred protons.
+ */
+void test4() {
+    std::cout << "proton-transfer-test test 4" << std::endl;
+    
+    for (const auto& method : {conf::PT_CONSTANT_RATE, conf::PT_EVENT_DRIVEN}) {
+        pt_displacer_ptr_t displacer = factory::protonTransferDisplacer(method);
+        cg_ptr_t cg = pairs_(10, 50);
+        auto continuous = continuous_(cg);
+        auto pairList = pairList_(continuous);
+        for (const auto& p : continuous) {
+            p->state(0.5);
+        }
+        
+        sim_param_t param;
+        param.put<real_t>("timestep", 0.01);
+        param.put<std::uint64_t>("seed", 2019);
+        
+        bool valid = true;
+        for (std::size_t step = 0; step != 1000 && valid; ++step) {
+            if ( step == 500 ) {
+                // Same size, other pairs.
+                prot_pair_list_t other{};
+                for (std::size_t i = 0; i + 3 < continuous.size(); i += 4) {
+                    other.push_back(std::make_pair(continuous[i], continuous[i + 3]));
+                    other.push_back(std::make_pair(continuous[i + 1], continuous[i + 2]));
+                }
+                other.push_back(pairList.back());
+                pairList = other;
+                displacer->update(pairList);
+            }
+            std::vector<std::size_t> states{};
+            for (const auto& p : continuous) {
+                states.push_back(p->protonationState());
+            }
+            std::vector<ProtonationEvent> events{};
+            displacer->transfer(param, continuous, pairList, events);
+            std::size_t nprotons = 0;
+            for (std::size_t i = 0; i != continuous.size(); ++i) {
+                const auto& p = continuous[i];
+                nprotons += p->protonationState();
+                
+                // The current of a bead that gained (lost) a proton grows
+                // (decreases).
+                int dX = int(p->protonationState()) - int(states[i]);
+                if ( dX > 0 && p->current() <= 0.0 ) {
+                    valid = false;
+                }
+                if ( dX < 0 && p->current() >= 0.0 ) {
+                    valid = false;
+                }
+            }
+            if ( nprotons != 10 ) {
+                valid = false;
+            }
+        }
+        if ( !valid ) {
+            std::cout << "%TEST_FAILED% time=0 testname=test4 (proton-transfer-test) "
+                      << "message=" << method << ": Wrong changes in protonation states." 
+                      << std::endl;
+        }
+    }
+    
+    // A pair list of another size without update() is an error.
+    pt_displacer_ptr_t displacer = factory::protonTransferDisplacer();
+    cg_ptr_t cg = pairs_(4);
+    auto continuous = continuous_(cg);
+    auto pairList = pairList_(continuous);
+    sim_param_t param;
+    param.put<real_t>("timestep", 0.01);
+    std::vector<ProtonationEvent> events{};
+    displacer->transfer(param, continuous, pairList, events);
+    pairList.pop_back();
+    bool failed = false;
+    try {
+        displacer->transfer(param, continuous, pairList, events);
+    } catch (std::domain_error& exception) {
+        failed = true;
+    }
+    if ( !failed ) {
+        std::cout << "%TEST_FAILED% time=0 testname=test4 (proton-transfer-test) "
+                  << "message=Changed pair list accepted without update()." << std::endl;
+    }
+}
+
+int main(int argc, char** argv) {
+    std::cout << "%SUITE_STARTING% proton-transfer-test" << std::endl;
+    std::cout << "%SUITE_STARTED%" << std::endl;
+
+    std::cout << "%TEST_STARTED% test1 (proton-transfer-test)" << std::endl;
+    test1();
+    std::cout << "%TEST_FINISHED% time=0 test1 (proton-transfer-test)" << std::endl;
+
+    std::cout << "%TEST_STARTED% test2 (proton-transfer-test)" << std::endl;
+    test2();
+    std::cout << "%TEST_FINISHED% time=0 test2 (proton-transfer-test)" << std::endl;
+
+    std::cout << "%TEST_STARTED% test3 (proton-transfer-test)" << std::endl;
+    test3();
+    std::cout << "%TEST_FINISHED% time=0 test3 (proton-transfer-test)" << std::endl;
+
+    std::cout << "%TEST_STARTED% test4 (proton-transfer-test)" << std::endl;
+    test4();
+    std::cout << "%TEST_FINISHED% time=0 test4 (proton-transfer-test)" << std::endl;
+
+    std::cout << "%SUITE_FINISHED% time=0" << std::endl;
+    
+    return (EXIT_SUCCESS);
+}
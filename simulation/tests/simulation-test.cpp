@@ -41,37 +41,65 @@
 #include "simploce/particle/particle-spec-catalog.hpp"
 #include "simploce/simulation/cg-forcefield.hpp"
 #include "simploce/simulation/pair-lists.hpp"
+#include "simploce/simulation/pbc.hpp"
+#include "simploce/simulation/lj-coulomb-forces.hpp"
+#include "simploce/particle/continuous-protonatable-bead.hpp"
 #include "simploce/util/file.hpp"
 #include <cstdlib>
 #include <iostream>
 #include <fstream>
 #include <memory>
+#include <vector>
+#include <utility>
+#include <algorithm>
+#include <cmath>
 
 using namespace simploce;
 
 struct SimpleForceField : public CoarseGrainedForceField{
     
-    energy_t interact(const std::vector<bead_ptr_t>& all,
-                      const std::vector<bead_ptr_t>& free,
-                      const std::vector<bead_group_ptr_t>& groups,
-                      const PairLists<Bead>& pairLists) override    
+    std::pair<energy_t, energy_t> 
+    interact(const std::vector<bead_ptr_t>& all,
+             const std::vector<bead_ptr_t>& free,
+             const std::vector<bead_group_ptr_t>& groups,
+             const std::vector<charge_t>& charges,
+             const PairLists<Bead>& pairLists,
+             virial_t* virial) override    
     {
         std::clog << "Computing forces for simulation for all, free, and groups...Done" << std::endl;
-        return 0.0;        
+        return std::make_pair(0.0, 0.0);        
     }
     
     energy_t bonded(const std::vector<bead_ptr_t>& all,
                     const std::vector<bead_ptr_t>& free,
                     const std::vector<bead_group_ptr_t>& groups,
-                    const PairLists<Bead>& pairLists)  override {
+                    const PairLists<Bead>& pairLists,
+                    virial_t* virial)  override {
         return 0.0;
     }
     
-    energy_t interact(const bead_ptr_t& bead,
-                      const std::vector<bead_ptr_t>& all,
-                      const std::vector<bead_ptr_t>& free,
-                      const std::vector<bead_group_ptr_t>& groups) override
+    energy_t nonBonded(const std::vector<bead_ptr_t>& all,
+                       const std::vector<bead_ptr_t>& free,
+                       const std::vector<bead_group_ptr_t>& groups,
+                       const std::vector<charge_t>& charges,
+                       const PairLists<Bead>& pairLists,
+                       virial_t* virial)  override {
+        return 0.0;
+    }
+    
+    std::pair<energy_t, energy_t> 
+    interact(const bead_ptr_t& bead,
+             const std::vector<bead_ptr_t>& all,
+             const std::vector<bead_ptr_t>& free,
+             const std::vector<bead_group_ptr_t>& groups,
+             const std::vector<charge_t>& charges) override
     {
+        return std::make_pair(0.0, 0.0);
+    }
+    
+    energy_t chargesChanged(const std::vector<std::pair<bead_ptr_t, charge_t>>& changed,
+                            const PairLists<Bead>& pairLists,
+                            virial_t* virial) override {
         return 0.0;
     }
     
@@ -141,6 +169,93 @@ void test2() {
     std::cout << "%TEST_FAILED% time=0 testname=test2 (simulation-test) message=error message sample" << std::endl;
 }
 
+/*
+ * Forces and energy corrected by chargesChanged() agree with a full 
+ * recomputation after changing protonation states.
+ */
+void test3() {
+    std::cout << "simulation-test test 3" << std::endl;
+    
+    spec_ptr_t HCOOH = ParticleSpec::create("HCOOH", -1.0, 46.00926, 0.0, 3.77, true);
+    
+    // Formic acid on a dense lattice, with varying protonation states.
+    box_ptr_t box = factory::cube(length_t{3.0});
+    cg_ptr_t cg = factory::coarseGrained();
+    std::vector<cprot_bead_ptr_t> beads{};
+    std::size_t id = 1;
+    for (std::size_t i = 0; i != 4; ++i) {
+        for (std::size_t j = 0; j != 4; ++j) {
+            for (std::size_t k = 0; k != 4; ++k) {
+                position_t r{0.45 * i + 0.05 * j, 0.45 * j + 0.05 * k, 0.45 * k + 0.05 * i};
+                auto bead = cg->addContinuousProtonatableBead(id, "HCOOH", r, 1, HCOOH, true);
+                bead->state(0.1 + 0.8 * real_t(id % 7) / 6.0);
+                beads.push_back(bead);
+                id += 1;
+            }
+        }
+    }
+    
+    bc_ptr_t bc = std::make_shared<PeriodicBoundaryCondition>(box);
+    CoarseGrainedForceField::lj_params_t ljParams{};
+    ljParams.add("HCOOH", "HCOOH", std::make_pair(1.0e-6, 1.0e-3));
+    CoarseGrainedForceField::el_params_t elParams{{"eps_r", 2.5}};
+    cg_ff_ptr_t forcefield = 
+        std::make_shared<LJCoulombForces<Bead>>(ljParams, elParams, bc, box);
+    cg_interactor_ptr_t interactor = 
+        std::make_shared<Interactor<Bead>>(forcefield, 
+                                           factory::coarseGrainedPairListGenerator(box, bc));
+    sim_param_t param;
+    param.put<std::size_t>("npairlists", 1000);
+    param.put<bool>("virial", true);
+    energy_t epot0 = interactor->interact(param, cg).second;
+    
+    // Change protonation states of some beads.
+    std::vector<std::pair<bead_ptr_t, charge_t>> changed{};
+    for (std::size_t n = 0; n < beads.size(); n += 5) {
+        changed.push_back(std::make_pair(beads[n], beads[n]->charge()));
+        beads[n]->state(1.0 - beads[n]->state());
+    }
+    energy_t depot = interactor->chargesChanged(changed, param);
+    std::vector<force_t> corrected{};
+    for (const auto& bead : beads) {
+        corrected.push_back(bead->force());
+    }
+    virial_t vcorrected = interactor->virial();
+    
+    // Full recomputation.
+    energy_t epot1 = interactor->interact(param, cg).second;
+    virial_t vfull = interactor->virial();
+    
+    real_t scale = std::max(real_t(1.0), std::fabs(epot1()));
+    real_t error = std::fabs(epot0() + depot() - epot1()) / scale;
+    std::cout << "Change in energy: " << depot << ", full: " << epot1 - epot0 << std::endl;
+    real_t ferror = 0.0, fmax = 0.0, verror = 0.0, vmax = 0.0;
+    for (std::size_t n = 0; n != beads.size(); ++n) {
+        for (std::size_t k = 0; k != 3; ++k) {
+            ferror = std::max(ferror, std::fabs(corrected[n][k] - beads[n]->force()[k]));
+            fmax = std::max(fmax, std::fabs(beads[n]->force()[k]));
+        }
+    }
+    for (std::size_t k = 0; k != 3; ++k) {
+        for (std::size_t l = 0; l != 3; ++l) {
+            verror = std::max(verror, std::fabs(vcorrected[k][l] - vfull[k][l]));
+            vmax = std::max(vmax, std::fabs(vfull[k][l]));
+        }
+    }
+    ferror /= std::max(real_t(1.0), fmax);
+    verror /= std::max(real_t(1.0), vmax);
+    std::cout << "Relative errors energy, forces, virial: " 
+              << error << ", " << ferror << ", " << verror << std::endl;
+    if ( changed.empty() || depot() == 0.0 ) {
+        std::cout << "%TEST_FAILED% time=0 testname=test3 (simulation-test) "
+                  << "message=No change in energy." << std::endl;
+    }
+    if ( error > 1.0e-10 || ferror > 1.0e-10 || verror > 1.0e-10 ) {
+        std::cout << "%TEST_FAILED% time=0 testname=test3 (simulation-test) "
+                  << "message=Correction differs from full recomputation." << std::endl;
+    }
+}
+
 int main(int argc, char** argv) {
     std::cout << "%SUITE_STARTING% simulation-test" << std::endl;
     std::cout << "%SUITE_STARTED%" << std::endl;
@@ -153,6 +268,10 @@ int main(int argc, char** argv) {
 //    test2();
 //    std::cout << "%TEST_FINISHED% time=0 test2 (simulation-test)" << std::endl;
 
+    std::cout << "%TEST_STARTED% test3 (simulation-test)" << std::endl;
+    test3();
+    std::cout << "%TEST_FINISHED% time=0 test3 (simulation-test)" << std::endl;
+
     std::cout << "%SUITE_FINISHED% time=0" << std::endl;
 
     return (EXIT_SUCCESS);
@@ -0,0 +1,90 @@
+/*
+ * The MIT License
+ *
+ * Copyright 2019 André H. Juffer, Biocenter Oulu
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ */
+
+
+/* 
+ * File:   test-models.hpp
+ * Author: ajuffer
+ *
+ * Created on November 26, 2019, 10:15 AM
+ */
+
+#ifndef TEST_MODELS_HPP
+#define TEST_MODELS_HPP
+
+#include "simploce/simulation/sim-model.hpp"
+#include "simploce/simulation/sfactory.hpp"
+#include "simploce/simulation/pbc.hpp"
+#include "simploce/simulation/sconf.hpp"
+#include "simploce/simulation/stypes.hpp"
+#include "simploce/particle/particle-spec-catalog.hpp"
+#include <memory>
+#include <sstream>
+#include <string>
+
+namespace simploce {
+    namespace test {
+        
+        /**
+         * Returns particle specifications for LJ fluids and polarizable water.
+         * @return Catalog.
+         */
+        inline spec_catalog_ptr_t catalog()
+        {
+            std::stringstream specs{
+                "# header\n"
+                "0          AP         39.948 0.0 0.17\n"
+                "0          CW         22.0 0.46 0.2\n"
+                "0          DP         14.0 -0.46 0.1\n"
+                "0          mH2O       18.0 0.0 0.15\n"
+            };
+            return ParticleSpecCatalog::create(specs);
+        }
+        
+        /**
+         * Returns new simulation model with its own boundary condition, 
+         * interactor and displacer.
+         * @param cg Particle model.
+         * @param forceFieldId Force field identifier.
+         * @param displacerId Displacer identifier.
+         * @param catalog Particle specifications.
+         * @param box Simulation box.
+         * @return Simulation model.
+         */
+        inline cg_sim_model_ptr_t simulationModel(const cg_ptr_t& cg,
+                                                  const std::string& forceFieldId,
+                                                  const std::string& displacerId,
+                                                  const spec_catalog_ptr_t& catalog,
+                                                  const box_ptr_t& box)
+        {
+            bc_ptr_t bc = std::make_shared<PeriodicBoundaryCondition>(box);
+            cg_interactor_ptr_t interactor = 
+                factory::makeInteractor(forceFieldId, catalog, box, bc);
+            cg_displacer_ptr_t displacer = factory::makeDisplacer(displacerId, interactor, bc);
+            return std::make_shared<cg_sim_model_t>(cg, displacer, interactor, box, bc);
+        }
+    }
+}
+
+#endif /* TEST_MODELS_HPP */
@@ -0,0 +1,363 @@
+/*
+ * The MIT License
+ *
+ * Copyright 2019 André H. Juffer, Biocenter Oulu
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ */
+
+
+/* 
+ * File:   trajectory-test.cpp
+ * Author: André H. Juffer, Biocenter Oulu.
+ *
+ * Created on November 18, 2019, 2:30 PM
+ */
+
+#include "simploce/simulation/trajectory.hpp"
+#include "simploce/simulation/protonation-events.hpp"
+#include "simploce/simulation/checkpoint.hpp"
+#include "simploce/simulation/sim-model.hpp"
+#include "simploce/simulation/sfactory.hpp"
+#include "simploce/particle/coarse-grained.hpp"
+#include "simploce/particle/particle-spec.hpp"
+#include "simploce/particle/particle-spec-catalog.hpp"
+#include "simploce/particle/particle-model-factory.hpp"
+#include "simploce/particle/pfactory.hpp"
+#include "simploce/particle/discrete-protonatable-bead.hpp"
+#include "simploce/particle/continuous-protonatable-bead.hpp"
+#include <cstdlib>
+#include <iostream>
+#include <sstream>
+#include <cmath>
+#include <cstdio>
+#include <stdexcept>
+#include <vector>
+
+using namespace simploce;
+
+/*
+ * Simple C++ Test Suite
+ */
+
+static cg_sim_model_ptr_t
+model_(dprot_bead_ptr_t& d, cprot_bead_ptr_t& c)
+{
+    spec_ptr_t spec = ParticleSpec::create("W", 0.0, 72.0, 0.2);
+    spec_ptr_t dspec = ParticleSpec::create("DA", 0.0, 30.0, 0.2, 4.0, false);
+    spec_ptr_t cspec = ParticleSpec::create("CA", 0.0, 30.0, 0.2, 4.0, true);
+    cg_ptr_t cg = factory::coarseGrained();
+    cg->addBead(1, "W", position_t{0.1, 0.2, 0.3}, spec, true);
+    d = cg->addDiscreteProtonatableBead(2, "DA", position_t{0.4, 0.5, 0.6}, 0, dspec, true);
+    c = cg->addContinuousProtonatableBead(3, "CA", position_t{0.7, 0.8, 0.9}, 1, cspec, true);
+    box_ptr_t box = factory::cube(length_t{2.0});
+    return std::make_shared<cg_sim_model_t>(cg, nullptr, nullptr, box, factory::pbc(box));
+}
+
+/*
+ * Writes three frames, then reads them back, also after seeking.
+ */
+static bool 
+roundTrip_(bool doublePrecision, bool close)
+{
+    dprot_bead_ptr_t d;
+    cprot_bead_ptr_t c;
+    cg_sim_model_ptr_t sm = model_(d, c);
+    
+    std::stringstream stream;
+    TrajectoryWriter<Bead> writer{stream, conf::BINARY_TRAJECTORY, doublePrecision};
+    for (std::size_t k = 0; k != 3; ++k) {
+        d->protonate();
+        c->state(0.25 * (k + 1));
+        c->current(-0.5 * k);
+        d->position(position_t{0.4, 0.5, 0.6 + k});
+        d->velocity(velocity_t{1.0 * k, 0.0, -1.0});
+        writer.write(sm);
+    }
+    if ( close ) {
+        writer.close();
+    }
+    
+    TrajectoryReader<Bead> reader{stream};
+    if ( !reader.isBinary() || reader.numberOfFrames() != 3 ) {
+        return false;
+    }
+    reader.seek(1);
+    if ( !reader.read(sm) ) {
+        return false;
+    }
+    bool ok = d->protonationState() == 2 && 
+              std::fabs(c->state() - 0.5) < 1.0e-06 &&
+              std::fabs(c->current() + 0.5) < 1.0e-06 &&
+              std::fabs(d->position()[2] - 1.6) < 1.0e-06 &&
+              std::fabs(d->velocity()[0] - 1.0) < 1.0e-06 &&
+              std::fabs(d->charge()() - 2.0) < 1.0e-06;
+    ok = ok && reader.read(sm) && d->protonationState() == 3 && !reader.read(sm);
+    reader.seek(0);
+    ok = ok && reader.read(sm) && d->protonationState() == 1;
+    return ok;
+}
+
+void test1() {
+    std::cout << "trajectory-test test 1" << std::endl;
+    if ( !roundTrip_(false, true) || !roundTrip_(true, true) ) {
+        std::cout << "%TEST_FAILED% time=0 testname=test1 (trajectory-test) "
+                  << "message=States not reproduced." << std::endl;
+    }
+}
+
+void test2() {
+    std::cout << "trajectory-test test 2" << std::endl;
+    if ( !roundTrip_(false, false) ) {
+        std::cout << "%TEST_FAILED% time=0 testname=test2 (trajectory-test) "
+                  << "message=States not reproduced without frame index." << std::endl;
+    }
+}
+
+/*
+ * Compressed positions are reproduced within the precision, also after seeking
+ * past a key frame.
+ */
+void test3() {
+    std::cout << "trajectory-test test 3" << std::endl;
+    
+    dprot_bead_ptr_t d;
+    cprot_bead_ptr_t c;
+    cg_sim_model_ptr_t sm = model_(d, c);
+    
+    const std::size_t nframes = 2 * conf::KEY_FRAME_INTERVAL + 50;
+    std::stringstream stream;
+    TrajectoryWriter<Bead> writer{stream, conf::COMPRESSED_TRAJECTORY, false, length_t{0.001}};
+    for (std::size_t k = 0; k != nframes; ++k) {
+        c->position(position_t{0.7 + 0.0123 * k, 0.8 - 0.05 * k, 0.9});
+        writer.write(sm);
+    }
+    writer.close();
+    
+    TrajectoryReader<Bead> reader{stream};
+    bool ok = reader.isBinary() && reader.numberOfFrames() == nframes;
+    for (std::size_t frame : {std::size_t(230), std::size_t(5), std::size_t(6)}) {
+        reader.seek(frame);
+        ok = ok && reader.read(sm) &&
+             std::fabs(c->position()[0] - ( 0.7 + 0.0123 * frame )) <= 0.0005 + 1.0e-09 &&
+             std::fabs(c->position()[1] - ( 0.8 - 0.05 * frame )) <= 0.0005 + 1.0e-09 &&
+             std::fabs(d->position()[2] - 0.6) <= 0.0005 + 1.0e-09;
+    }
+    if ( !ok ) {
+        std::cout << "%TEST_FAILED% time=0 testname=test3 (trajectory-test) "
+                  << "message=Compressed positions not reproduced." << std::endl;
+    }
+}
+
+/*
+ * Asynchronously written trajectories equal synchronously written ones, and
+ * text trajectories equal saved states.
+ */
+void test4() {
+    std::cout << "trajectory-test test 4" << std::endl;
+    
+    dprot_bead_ptr_t d;
+    cprot_bead_ptr_t c;
+    cg_sim_model_ptr_t sm = model_(d, c);
+    
+    bool ok = true;
+    for (auto format : {conf::TEXT_TRAJECTORY, conf::BINARY_TRAJECTORY}) {
+        std::stringstream saved, sync, async;
+        TrajectoryWriter<Bead> writer1{sync, format, false, length_t{0.001}, 0};
+        TrajectoryWriter<Bead> writer2{async, format, false, length_t{0.001}, 2};
+        for (std::size_t k = 0; k != 50; ++k) {
+            d->protonate();
+            c->state(0.01 * k);
+            c->position(position_t{0.7 + 0.01 * k, 0.8, 0.9});
+            sm->saveState(saved);
+            writer1.write(sm);
+            writer2.write(sm);
+        }
+        writer1.close();
+        writer2.close();
+        ok = ok && sync.str() == async.str();
+        if ( format == conf::TEXT_TRAJECTORY ) {
+            ok = ok && saved.str() == sync.str();
+        }
+    }
+    if ( !ok ) {
+        std::cout << "%TEST_FAILED% time=0 testname=test4 (trajectory-test) "
+                  << "message=Trajectories differ." << std::endl;
+    }
+}
+
+/*
+ * Protonation event log, read from the start and after seeking.
+ */
+void test5() {
+    std::cout << "trajectory-test test 5" << std::endl;
+    
+    dprot_bead_ptr_t d;
+    cprot_bead_ptr_t c;
+    cg_sim_model_ptr_t sm = model_(d, c);
+    
+    std::stringstream stream;
+    ProtonationEventWriter<Bead> writer{stream, 2};
+    writer.start(stime_t{0.0}, sm);
+    for (std::size_t k = 1; k != 9; ++k) {
+        std::vector<ProtonationEvent> events{};
+        stime_t t{real_t(k)};
+        if ( k % 2 == 1 ) {
+            std::size_t state = d->protonationState();
+            d->protonate();
+            events.push_back(ProtonationEvent{t, d->index(), state, d->protonationState()});
+        }
+        if ( k % 3 == 0 ) {
+            std::size_t state = c->protonationState();
+            if ( c->isProtonated() ) {
+                c->deprotonate();
+            } else {
+                c->protonate();
+            }
+            events.push_back(ProtonationEvent{t, c->index(), state, c->protonationState()});
+        }
+        writer.record(events);
+    }
+    
+    // An event that does not match the recorded state is an error.
+    bool failed = false;
+    try {
+        writer.record({ProtonationEvent{stime_t{9.0}, c->index(), 0, 1}});
+    } catch (std::domain_error& exception) {
+        failed = true;
+    }
+    
+    ProtonationEventReader<Bead> reader{stream};
+    ProtonationEvent event;
+    std::size_t nevents = 0;
+    while ( reader.next(event) ) {
+        nevents += 1;
+    }
+    bool ok = failed && writer.numberOfEvents() == 6 && nevents == 6 && reader.numberOfKeys() == 3 &&
+              reader.states().at(d->index()) == 4 && reader.states().at(c->index()) == 1;
+    reader.seek(stime_t{4.5});
+    ok = ok && reader.states().at(d->index()) == 2 && reader.states().at(c->index()) == 0;
+    ok = ok && reader.next(event) && event.index == d->index() && 
+         event.oldState == 2 && event.newState == 3 && std::fabs(event.t() - 5.0) < 1.0e-06;
+    reader.seek(stime_t{0.0});
+    ok = ok && reader.states().at(d->index()) == 0 && reader.states().at(c->index()) == 1;
+    if ( !ok ) {
+        std::cout << "%TEST_FAILED% time=0 testname=test5 (trajectory-test) "
+                  << "message=Protonation events not reproduced." << std::endl;
+    }
+}
+
+/*
+ * Checkpoint of a LJ fluid displaced by Langevin dynamics. Continuing from the
+ * checkpoint must reproduce the same positions and velocities, bit for bit.
+ */
+void test6() {
+    std::cout << "trajectory-test test 6" << std::endl;
+    
+    std::stringstream specs{"# header\n0          AP         39.948 0.0 0.17\n"};
+    spec_catalog_ptr_t catalog = ParticleSpecCatalog::create(specs);
+    box_ptr_t box = factory::cube(length_t{2.0});
+    bc_ptr_t bc = factory::pbc(box);
+    cg_ptr_t cg = factory::particleModelFactory(catalog)->ljFluid(box);
+    cg_interactor_ptr_t interactor = factory::ljFluidInteractor(catalog, box, bc);
+    cg_displacer_ptr_t displacer = factory::langevinVelocityVerlet(interactor);
+    cg_sim_model_ptr_t sm = 
+        std::make_shared<cg_sim_model_t>(cg, displacer, interactor, box, bc);
+    
+    sim_param_t param;
+    param.add<real_t>("timestep", 0.005);
+    param.add<real_t>("temperature", 298.15);
+    param.add<real_t>("gamma", 1.0);
+    param.add<std::size_t>("npairlists", 10);
+    param.add<std::size_t>("seed", 20191130);
+    
+    const std::string fileName = "trajectory-test.chk";
+    Checkpoint<Bead> checkpoint{fileName};
+    for (std::size_t k = 0; k != 15; ++k) {
+        sm->displace(param);
+    }
+    checkpoint.write(sm, 15);
+    
+    // Continue, then again from the checkpoint.
+    std::vector<position_t> rs{};
+    std::vector<velocity_t> vs{};
+    for (std::size_t n = 0; n != 2; ++n) {
+        if ( n == 1 && checkpoint.read(sm) != 15 ) {
+            std::cout << "%TEST_FAILED% time=0 testname=test6 (trajectory-test) "
+                      << "message=Wrong step number." << std::endl;
+        }
+        for (std::size_t k = 0; k != 15; ++k) {
+            sm->displace(param);
+        }
+        bool same = true;
+        sm->doWithAllFreeGroups<void>([n, &rs, &vs, &same] (const std::vector<bead_ptr_t>& all,
+                                                            const std::vector<bead_ptr_t>& free,
+                                                            const std::vector<bead_group_ptr_t>& groups) {
+            for (const auto& bead : all) {
+                if ( n == 0 ) {
+                    rs.push_back(bead->position());
+                    vs.push_back(bead->velocity());
+                } else {
+                    for (std::size_t i = 0; i != 3; ++i) {
+                        same = same && rs[bead->index()][i] == bead->position()[i] &&
+                                       vs[bead->index()][i] == bead->velocity()[i];
+                    }
+                }
+            }
+        });
+        if ( !same ) {
+            std::cout << "%TEST_FAILED% time=0 testname=test6 (trajectory-test) "
+                      << "message=Continuation from checkpoint differs." << std::endl;
+        }
+    }
+    std::remove(fileName.c_str());
+}
+
+int main(int argc, char** argv) {
+    std::cout << "%SUITE_STARTING% trajectory-test" << std::endl;
+    std::cout << "%SUITE_STARTED%" << std::endl;
+
+    std::cout << "%TEST_STARTED% test1 (trajectory-test)" << std::endl;
+    test1();
+    std::cout << "%TEST_FINISHED% time=0 test1 (trajectory-test)" << std::endl;
+
+    std::cout << "%TEST_STARTED% test2 (trajectory-test)" << std::endl;
+    test2();
+    std::cout << "%TEST_FINISHED% time=0 test2 (trajectory-test)" << std::endl;
+
+    std::cout << "%TEST_STARTED% test3 (trajectory-test)" << std::endl;
+    test3();
+    std::cout << "%TEST_FINISHED% time=0 test3 (trajectory-test)" << std::endl;
+
+    std::cout << "%TEST_STARTED% test4 (trajectory-test)" << std::endl;
+    test4();
+    std::cout << "%TEST_FINISHED% time=0 test4 (trajectory-test)" << std::endl;
+
+    std::cout << "%TEST_STARTED% test5 (trajectory-test)" << std::endl;
+    test5();
+    std::cout << "%TEST_FINISHED% time=0 test5 (trajectory-test)" << std::endl;
+
+    std::cout << "%TEST_STARTED% test6 (trajectory-test)" << std::endl;
+    test6();
+    std::cout << "%TEST_FINISHED% time=0 test6 (trajectory-test)" << std::endl;
+
+    std::cout << "%SUITE_FINISHED% time=0" << std::endl;
+
+    return (EXIT_SUCCESS);
+}